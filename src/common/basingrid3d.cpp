@@ -0,0 +1,674 @@
+/*
+ *                    This source code is part of
+ *
+ *                  D  E  N  S  T  O  O  L  K  I  T
+ *
+ *                         VERSION: 1.2.0
+ *
+ *             Contributors: Juan Manuel Solano-Altamirano
+ *                           Julio Manuel Hernandez-Perez
+ *        Copyright (c) 2013-2015, Juan Manuel Solano-Altamirano
+ *                                 <jmsolanoalt@gmail.com>
+ *
+ * -------------------------------------------------------------------
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * ---------------------------------------------------------------------
+ *
+ * If you want to redistribute modifications of the suite, please
+ * consider to include your modifications in our official release.
+ * We will be pleased to consider the inclusion of your code
+ * within the official distribution. Please keep in mind that
+ * scientific software is very special, and version control is 
+ * crucial for tracing bugs. If in despite of this you distribute
+ * your modified version, please do not call it DensToolKit.
+ *
+ * If you find DensToolKit useful, we humbly ask that you cite
+ * the paper(s) on the package --- you can find them on the top
+ * README file.
+ *
+ */
+
+
+#ifndef _BASINGRID3D_CPP_
+#define _BASINGRID3D_CPP_
+
+#include "basingrid3d.h"
+#include "solmemhand.h"
+#include "solscrutils.h"
+#include <iostream>
+using std::cout;
+using std::endl;
+#include <fstream>
+using std::ofstream;
+#include <iomanip>
+using std::setw;
+using std::setprecision;
+#include <cmath>
+
+/* ************************************************************************************ */
+basinGrid3D::basinGrid3D()
+{
+   for ( int k=0 ; k<3 ; k++ ) {
+      npts[k]=0;
+      xin[k]=0.0e0;
+      hh[k]=1.0e0;
+   }
+   nTot=nBas=nFld=0;
+   nRoots=nFarRoots=nBndPts=nBndChanged=0;
+   dV=farRootPop=0.0e0;
+   rho=NULL;
+   lbl=NULL;
+   basPop=basVol=basFld=NULL;
+   fldTyp=NULL;
+   imsetup=iknowbasins=false;
+   refBnd=true;
+   int n=0;
+   for ( int di=-1 ; di<=1 ; di++ ) {
+      for ( int dj=-1 ; dj<=1 ; dj++ ) {
+         for ( int dk=-1 ; dk<=1 ; dk++ ) {
+            if ( di==0 && dj==0 && dk==0 ) {continue;}
+            nbOff[n][0]=di;
+            nbOff[n][1]=dj;
+            nbOff[n][2]=dk;
+            nbOOD[n]=1.0e0;
+            ++n;
+         }
+      }
+   }
+}
+/* ************************************************************************************ */
+basinGrid3D::~basinGrid3D()
+{
+   destroyArrays();
+}
+/* ************************************************************************************ */
+void basinGrid3D::destroyArrays(void)
+{
+   dealloc1DRealArray(rho);
+   dealloc1DIntArray(lbl);
+   dealloc1DRealArray(basPop);
+   dealloc1DRealArray(basVol);
+   dealloc1DRealArray(basFld);
+   if ( fldTyp!=NULL ) {
+      delete[] fldTyp;
+      fldTyp=NULL;
+   }
+   nBas=nFld=0;
+   iknowbasins=false;
+}
+/* ************************************************************************************ */
+bool basinGrid3D::setUpFromGrid(waveFunctionGrid3D &grd)
+{
+   destroyArrays();
+   imsetup=false;
+   for ( int k=0 ; k<3 ; k++ ) {
+      npts[k]=grd.getNPts(k);
+      xin[k]=grd.xin[k];
+      hh[k]=grd.dx[k][k];
+      if ( npts[k]<2 || hh[k]<=0.0e0 ) {
+         displayErrorMessage("The grid for the basins is not set up!");
+         return false;
+      }
+      for ( int l=0 ; l<3 ; l++ ) {
+         if ( l!=k && grd.dx[k][l]!=0.0e0 ) {
+            displayErrorMessage("The grid for the basins must be orthogonal!");
+            return false;
+         }
+      }
+   }
+   nTot=npts[0]*npts[1]*npts[2];
+   dV=hh[0]*hh[1]*hh[2];
+   solreal dd;
+   for ( int n=0 ; n<26 ; n++ ) {
+      dd=0.0e0;
+      for ( int k=0 ; k<3 ; k++ ) {dd+=solreal(nbOff[n][k]*nbOff[n][k])*hh[k]*hh[k];}
+      nbOOD[n]=1.0e0/sqrt(dd);
+   }
+   imsetup=true;
+   return true;
+}
+/* ************************************************************************************ */
+bool basinGrid3D::assignBasins(GaussWaveFunction &wf,critPtNetWork &cpn)
+{
+   if ( !imsetup ) {
+      displayErrorMessage("The grid for the basins is not set up!");
+      return false;
+   }
+   if ( cpn.nACP<1 ) {
+      displayErrorMessage("There are no ACPs to label the basins!");
+      return false;
+   }
+   destroyArrays();
+   nBas=cpn.nACP;
+   cout << "Assigning basins (" << npts[0] << "x" << npts[1] << "x" << npts[2]
+        << " points, spacing: " << hh[0] << ")..." << endl;
+   evalRhoOnGrid(wf);
+   int *asc;
+   alloc1DIntArray(string("asc"),nTot,asc);
+   setAscentNeighbours(asc);
+   followAscentPaths(asc);
+   alloc1DIntArray(string("lbl"),nTot,lbl,-1);
+   labelFromRoots(asc,cpn);
+   dealloc1DIntArray(asc);
+   cout << "  Ascent paths: " << nRoots << " roots." << endl;
+   if ( nFarRoots>0 ) {
+      displayWarningMessage(string("Some maxima of the grid are far from every ACP!"));
+      cout << "  (" << nFarRoots << " roots, population: " << farRootPop
+           << "; they were assigned to the closest ACP)" << endl;
+   }
+   if ( refBnd ) {
+      refineBoundaryPoints(wf,cpn);
+      cout << "  Boundary points: " << nBndPts << " (reassigned: " << nBndChanged
+           << ")" << endl;
+   }
+   integrateRho(wf);
+   iknowbasins=true;
+   return true;
+}
+/* ************************************************************************************ */
+void basinGrid3D::evalRhoOnGrid(GaussWaveFunction &wf)
+{
+   alloc1DRealArray(string("rho"),nTot,rho);
+#if PARALLELISEDTK
+   const int nsl=npts[1]*npts[2];
+#pragma omp parallel
+   {
+      GaussWaveFunction twf;
+      GaussWaveFunction *pwf=&wf;
+      if ( omp_get_thread_num()>0 ) {
+         twf.shareDataFrom(wf);
+         pwf=&twf;
+      }
+      solreal x[3];
+#pragma omp for schedule(dynamic,1)
+      for ( int i=0 ; i<npts[0] ; i++ ) {
+         for ( int m=i*nsl ; m<(i+1)*nsl ; m++ ) {
+            getPointCoords(m,x);
+            rho[m]=pwf->evalDensity(x[0],x[1],x[2]);
+         }
+      }
+   }
+#else
+   solreal x[3];
+   for ( int m=0 ; m<nTot ; m++ ) {
+      getPointCoords(m,x);
+      rho[m]=wf.evalDensity(x[0],x[1],x[2]);
+   }
+#endif
+}
+/* ************************************************************************************ */
+void basinGrid3D::setAscentNeighbours(int * (&asc))
+{
+#if PARALLELISEDTK
+#pragma omp parallel for schedule(static)
+#endif
+   for ( int i=0 ; i<npts[0] ; i++ ) {
+      int m,q,ii,jj,kk,best;
+      solreal slope,bslope;
+      for ( int j=0 ; j<npts[1] ; j++ ) {
+         for ( int k=0 ; k<npts[2] ; k++ ) {
+            m=getIdx(i,j,k);
+            if ( rho[m]<BASINGRID_MINRHO ) {
+               asc[m]=-1;
+               continue;
+            }
+            best=m;
+            bslope=0.0e0;
+            for ( int n=0 ; n<26 ; n++ ) {
+               ii=i+nbOff[n][0];
+               jj=j+nbOff[n][1];
+               kk=k+nbOff[n][2];
+               if ( ii<0 || jj<0 || kk<0 || ii>=npts[0] || jj>=npts[1] || kk>=npts[2] ) {
+                  continue;
+               }
+               q=getIdx(ii,jj,kk);
+               slope=(rho[q]-rho[m])*nbOOD[n];
+               if ( slope>bslope ) {
+                  bslope=slope;
+                  best=q;
+               }
+            }
+            asc[m]=best;
+         }
+      }
+   }
+}
+/* ************************************************************************************ */
+void basinGrid3D::followAscentPaths(int * (&asc))
+{
+   /* Every sweep doubles the length of the path cached at every point. The new
+      pointers are written into a second array, so that the result does not depend
+      on the order (nor on the threads) in which the points are processed.  */
+   int *nxt,*tmp;
+   alloc1DIntArray(string("nxt"),nTot,nxt);
+   const int nsl=npts[1]*npts[2];
+   int nchg=1;
+   while ( nchg>0 ) {
+      nchg=0;
+#if PARALLELISEDTK
+#pragma omp parallel for schedule(static) reduction(+:nchg)
+#endif
+      for ( int i=0 ; i<npts[0] ; i++ ) {
+         int a,b;
+         for ( int m=i*nsl ; m<(i+1)*nsl ; m++ ) {
+            a=asc[m];
+            if ( a<0 ) {
+               nxt[m]=a;
+               continue;
+            }
+            b=asc[a];
+            nxt[m]=b;
+            if ( b!=a ) {++nchg;}
+         }
+      }
+      tmp=asc;
+      asc=nxt;
+      nxt=tmp;
+   }
+   dealloc1DIntArray(nxt);
+}
+/* ************************************************************************************ */
+int basinGrid3D::findClosestACP(critPtNetWork &cpn,solreal const (&x)[3],solreal &dd)
+{
+   int res=0;
+   solreal d2,dmin=1.0e+50;
+   for ( int a=0 ; a<cpn.nACP ; a++ ) {
+      d2=0.0e0;
+      for ( int k=0 ; k<3 ; k++ ) {d2+=(cpn.RACP[a][k]-x[k])*(cpn.RACP[a][k]-x[k]);}
+      if ( d2<dmin ) {
+         dmin=d2;
+         res=a;
+      }
+   }
+   dd=sqrt(dmin);
+   return res;
+}
+/* ************************************************************************************ */
+void basinGrid3D::labelFromRoots(int * (&asc),critPtNetWork &cpn)
+{
+   solreal x[3],dd;
+   nRoots=nFarRoots=0;
+   farRootPop=0.0e0;
+   for ( int m=0 ; m<nTot ; m++ ) {
+      if ( asc[m]!=m ) {continue;}
+      getPointCoords(m,x);
+      lbl[m]=findClosestACP(cpn,x,dd);
+      ++nRoots;
+      if ( dd>BASINGRID_MAXROOTACPDIST ) {
+         ++nFarRoots;
+         lbl[m]=(-2-lbl[m]); //Marked, to collect their population below.
+      }
+   }
+   for ( int m=0 ; m<nTot ; m++ ) {
+      if ( asc[m]>=0 && lbl[asc[m]]<=-2 ) {farRootPop+=rho[m];}
+   }
+   farRootPop*=dV;
+   for ( int m=0 ; m<nTot ; m++ ) {
+      if ( lbl[m]<=-2 ) {lbl[m]=(-2-lbl[m]);}
+   }
+   const int nsl=npts[1]*npts[2];
+#if PARALLELISEDTK
+#pragma omp parallel for schedule(static)
+#endif
+   for ( int i=0 ; i<npts[0] ; i++ ) {
+      for ( int m=i*nsl ; m<(i+1)*nsl ; m++ ) {
+         if ( asc[m]>=0 && asc[m]!=m ) {lbl[m]=lbl[asc[m]];}
+      }
+   }
+}
+/* ************************************************************************************ */
+void basinGrid3D::refineBoundaryPoints(GaussWaveFunction &wf,critPtNetWork &cpn)
+{
+   bool *isbnd;
+   alloc1DBoolArray(string("isbnd"),nTot,isbnd,false);
+#if PARALLELISEDTK
+#pragma omp parallel for schedule(static)
+#endif
+   for ( int i=0 ; i<npts[0] ; i++ ) {
+      const int fo[6][3]={{-1,0,0},{1,0,0},{0,-1,0},{0,1,0},{0,0,-1},{0,0,1}};
+      int m,q,ii,jj,kk;
+      for ( int j=0 ; j<npts[1] ; j++ ) {
+         for ( int k=0 ; k<npts[2] ; k++ ) {
+            m=getIdx(i,j,k);
+            if ( lbl[m]<0 || rho[m]<BASINGRID_MINREFINERHO ) {continue;}
+            for ( int n=0 ; n<6 ; n++ ) {
+               ii=i+fo[n][0];
+               jj=j+fo[n][1];
+               kk=k+fo[n][2];
+               if ( ii<0 || jj<0 || kk<0 || ii>=npts[0] || jj>=npts[1] || kk>=npts[2] ) {
+                  continue;
+               }
+               q=getIdx(ii,jj,kk);
+               if ( lbl[q]>=0 && lbl[q]!=lbl[m] ) {
+                  isbnd[m]=true;
+                  break;
+               }
+            }
+         }
+      }
+   }
+   int *bnd;
+   nBndPts=0;
+   for ( int m=0 ; m<nTot ; m++ ) {if ( isbnd[m] ) {++nBndPts;}}
+   alloc1DIntArray(string("bnd"),((nBndPts>0)? nBndPts : 1),bnd);
+   nBndPts=0;
+   for ( int m=0 ; m<nTot ; m++ ) {if ( isbnd[m] ) {bnd[nBndPts++]=m;}}
+   /* The paths only read the labels of the interior points, hence the new labels of
+      the boundary points can be written in place.  */
+   nBndChanged=0;
+   int nchg=0;
+#if PARALLELISEDTK
+#pragma omp parallel reduction(+:nchg)
+   {
+      GaussWaveFunction twf;
+      GaussWaveFunction *pwf=&wf;
+      if ( omp_get_thread_num()>0 ) {
+         twf.shareDataFrom(wf);
+         pwf=&twf;
+      }
+      int nl;
+#pragma omp for schedule(dynamic,16)
+      for ( int b=0 ; b<nBndPts ; b++ ) {
+         nl=traceBoundaryPoint(*pwf,cpn,isbnd,bnd[b]);
+         if ( nl!=lbl[bnd[b]] ) {
+            lbl[bnd[b]]=nl;
+            ++nchg;
+         }
+      }
+   }
+#else
+   int nl;
+   for ( int b=0 ; b<nBndPts ; b++ ) {
+      nl=traceBoundaryPoint(wf,cpn,isbnd,bnd[b]);
+      if ( nl!=lbl[bnd[b]] ) {
+         lbl[bnd[b]]=nl;
+         ++nchg;
+      }
+   }
+#endif
+   nBndChanged=nchg;
+   dealloc1DIntArray(bnd);
+   dealloc1DBoolArray(isbnd);
+}
+/* ************************************************************************************ */
+int basinGrid3D::traceBoundaryPoint(GaussWaveFunction &twf,critPtNetWork &cpn,\
+      bool * (&isbnd),const int m)
+{
+   solreal x[3],g[3],rr,gm,dd;
+   solreal hmin=hh[0];
+   if ( hh[1]<hmin ) {hmin=hh[1];}
+   if ( hh[2]<hmin ) {hmin=hh[2];}
+   const solreal step=BASINGRID_TRACESTEPFACTOR*hmin;
+   int n[3],q;
+   bool inside;
+   getPointCoords(m,x);
+   for ( int s=0 ; s<BASINGRID_MAXTRACESTEPS ; s++ ) {
+      twf.evalRhoGradRho(x[0],x[1],x[2],rr,g);
+      gm=sqrt(g[0]*g[0]+g[1]*g[1]+g[2]*g[2]);
+      if ( gm<BASINGRID_MINGRADMAG ) {break;}
+      gm=step/gm;
+      inside=true;
+      for ( int k=0 ; k<3 ; k++ ) {
+         x[k]+=gm*g[k];
+         n[k]=int(floor((x[k]-xin[k])/hh[k]+0.5e0));
+         if ( n[k]<0 || n[k]>=npts[k] ) {inside=false;}
+      }
+      if ( !inside ) {return lbl[m];}
+      q=getIdx(n[0],n[1],n[2]);
+      if ( (!isbnd[q]) && lbl[q]>=0 ) {return lbl[q];}
+   }
+   /* The path ended at a maximum (or it is too long): the closest ACP, if any.  */
+   q=findClosestACP(cpn,x,dd);
+   return ((dd<=BASINGRID_MAXROOTACPDIST)? q : lbl[m]);
+}
+/* ************************************************************************************ */
+void basinGrid3D::averageOverSubcells(GaussWaveFunction &twf,const int m,\
+      const ScalarFieldType *ft,const int nf,solreal *res)
+{
+   const int ns=BASINGRID_NSUBCELLS;
+   const int nr=((nf>0)? nf : 1);
+   solreal x0[3],x[3],hs[3],*tmp=NULL;
+   if ( nf>0 ) {alloc1DRealArray(string("tmp"),nf,tmp);}
+   getPointCoords(m,x0);
+   for ( int k=0 ; k<3 ; k++ ) {
+      hs[k]=hh[k]/solreal(ns);
+      x0[k]-=(0.5e0*hh[k]-0.5e0*hs[k]);
+   }
+   for ( int f=0 ; f<nr ; f++ ) {res[f]=0.0e0;}
+   for ( int a=0 ; a<ns ; a++ ) {
+      x[0]=x0[0]+solreal(a)*hs[0];
+      for ( int b=0 ; b<ns ; b++ ) {
+         x[1]=x0[1]+solreal(b)*hs[1];
+         for ( int c=0 ; c<ns ; c++ ) {
+            x[2]=x0[2]+solreal(c)*hs[2];
+            if ( nf>0 ) {
+               twf.evalMultipleFields(x[0],x[1],x[2],ft,nf,tmp);
+               for ( int f=0 ; f<nf ; f++ ) {res[f]+=tmp[f];}
+            } else {
+               res[0]+=twf.evalDensity(x[0],x[1],x[2]);
+            }
+         }
+      }
+   }
+   const solreal oon=1.0e0/solreal(ns*ns*ns);
+   for ( int f=0 ; f<nr ; f++ ) {res[f]*=oon;}
+   dealloc1DRealArray(tmp);
+}
+/* ************************************************************************************ */
+void basinGrid3D::integrateRho(GaussWaveFunction &wf)
+{
+   /* The partial sums of every slab are added in the order of the slabs, so that
+      the results do not depend on the number of threads.  */
+   solreal **part;
+   allocFlat2DRealArray(string("part"),npts[0],2*nBas,part,0.0e0);
+   const int nsl=npts[1]*npts[2];
+#if PARALLELISEDTK
+#pragma omp parallel
+   {
+      GaussWaveFunction twf;
+      GaussWaveFunction *pwf=&wf;
+      if ( omp_get_thread_num()>0 ) {
+         twf.shareDataFrom(wf);
+         pwf=&twf;
+      }
+      solreal rr;
+#pragma omp for schedule(dynamic,1)
+      for ( int i=0 ; i<npts[0] ; i++ ) {
+         for ( int m=i*nsl ; m<(i+1)*nsl ; m++ ) {
+            if ( lbl[m]<0 ) {continue;}
+            rr=rho[m];
+            if ( rr>=BASINGRID_SUBCELLRHO ) {averageOverSubcells(*pwf,m,NULL,0,&rr);}
+            part[i][lbl[m]]+=rr;
+            if ( rho[m]>=BASINGRID_VOLISOVAL ) {part[i][nBas+lbl[m]]+=1.0e0;}
+         }
+      }
+   }
+#else
+   solreal rr;
+   for ( int i=0 ; i<npts[0] ; i++ ) {
+      for ( int m=i*nsl ; m<(i+1)*nsl ; m++ ) {
+         if ( lbl[m]<0 ) {continue;}
+         rr=rho[m];
+         if ( rr>=BASINGRID_SUBCELLRHO ) {averageOverSubcells(wf,m,NULL,0,&rr);}
+         part[i][lbl[m]]+=rr;
+         if ( rho[m]>=BASINGRID_VOLISOVAL ) {part[i][nBas+lbl[m]]+=1.0e0;}
+      }
+   }
+#endif
+   alloc1DRealArray(string("basPop"),nBas,basPop,0.0e0);
+   alloc1DRealArray(string("basVol"),nBas,basVol,0.0e0);
+   for ( int i=0 ; i<npts[0] ; i++ ) {
+      for ( int b=0 ; b<nBas ; b++ ) {
+         basPop[b]+=part[i][b];
+         basVol[b]+=part[i][nBas+b];
+      }
+   }
+   for ( int b=0 ; b<nBas ; b++ ) {
+      basPop[b]*=dV;
+      basVol[b]*=dV;
+   }
+   deallocFlat2DRealArray(part);
+}
+/* ************************************************************************************ */
+bool basinGrid3D::integrateFields(GaussWaveFunction &wf,const ScalarFieldType *ft,\
+      const int nf)
+{
+   if ( !iknowbasins ) {
+      displayErrorMessage("The basins must be assigned before integrating the fields!");
+      return false;
+   }
+   if ( nf<1 ) {return true;}
+   dealloc1DRealArray(basFld);
+   if ( fldTyp!=NULL ) {delete[] fldTyp;}
+   nFld=nf;
+   fldTyp=new ScalarFieldType[nf];
+   for ( int f=0 ; f<nf ; f++ ) {fldTyp[f]=ft[f];}
+   const int nv=nBas*nFld;
+   solreal **part;
+   allocFlat2DRealArray(string("part"),npts[0],nv,part,0.0e0);
+   const int nsl=npts[1]*npts[2];
+   cout << "Integrating " << nf << " field(s) over the basins..." << endl;
+#if PARALLELISEDTK
+#pragma omp parallel
+   {
+      GaussWaveFunction twf;
+      GaussWaveFunction *pwf=&wf;
+      if ( omp_get_thread_num()>0 ) {
+         twf.shareDataFrom(wf);
+         pwf=&twf;
+      }
+      solreal x[3],*res;
+      alloc1DRealArray(string("res"),nf,res);
+#pragma omp for schedule(dynamic,1)
+      for ( int i=0 ; i<npts[0] ; i++ ) {
+         for ( int m=i*nsl ; m<(i+1)*nsl ; m++ ) {
+            if ( lbl[m]<0 ) {continue;}
+            if ( rho[m]>=BASINGRID_SUBCELLRHO ) {
+               averageOverSubcells(*pwf,m,fldTyp,nf,res);
+            } else {
+               getPointCoords(m,x);
+               pwf->evalMultipleFields(x[0],x[1],x[2],fldTyp,nf,res);
+            }
+            for ( int f=0 ; f<nf ; f++ ) {part[i][lbl[m]*nf+f]+=res[f];}
+         }
+      }
+      dealloc1DRealArray(res);
+   }
+#else
+   solreal x[3],*res;
+   alloc1DRealArray(string("res"),nf,res);
+   for ( int i=0 ; i<npts[0] ; i++ ) {
+      for ( int m=i*nsl ; m<(i+1)*nsl ; m++ ) {
+         if ( lbl[m]<0 ) {continue;}
+         if ( rho[m]>=BASINGRID_SUBCELLRHO ) {
+            averageOverSubcells(wf,m,fldTyp,nf,res);
+         } else {
+            getPointCoords(m,x);
+            wf.evalMultipleFields(x[0],x[1],x[2],fldTyp,nf,res);
+         }
+         for ( int f=0 ; f<nf ; f++ ) {part[i][lbl[m]*nf+f]+=res[f];}
+      }
+   }
+   dealloc1DRealArray(res);
+#endif
+   alloc1DRealArray(string("basFld"),nv,basFld,0.0e0);
+   for ( int i=0 ; i<npts[0] ; i++ ) {
+      for ( int v=0 ; v<nv ; v++ ) {basFld[v]+=part[i][v];}
+   }
+   for ( int v=0 ; v<nv ; v++ ) {basFld[v]*=dV;}
+   deallocFlat2DRealArray(part);
+   return true;
+}
+/* ************************************************************************************ */
+void basinGrid3D::printResults(ostream &os,GaussWaveFunction &wf,critPtNetWork &cpn)
+{
+   if ( !iknowbasins ) {return;}
+   /* The nucleus of every basin (if any), and the number of electrons.  */
+   int *nuc;
+   alloc1DIntArray(string("nuc"),nBas,nuc,-1);
+   solreal dd,dmin;
+   for ( int b=0 ; b<nBas ; b++ ) {
+      dmin=BASINGRID_MAXACPNUCDIST;
+      for ( int a=0 ; a<wf.nNuc ; a++ ) {
+         dd=0.0e0;
+         for ( int k=0 ; k<3 ; k++ ) {
+            dd+=(cpn.RACP[b][k]-wf.R[3*a+k])*(cpn.RACP[b][k]-wf.R[3*a+k]);
+         }
+         dd=sqrt(dd);
+         if ( dd<dmin ) {
+            dmin=dd;
+            nuc[b]=a;
+         }
+      }
+   }
+   solreal nel=0.0e0;
+   for ( int i=0 ; i<wf.nMOr ; i++ ) {nel+=wf.occN[i];}
+   if ( wf.ihaveEDF ) {nel+=solreal(wf.coreElec);}
+   solreal zz,sump=0.0e0,sumq=0.0e0,sumv=0.0e0,*sumf=NULL;
+   if ( nFld>0 ) {alloc1DRealArray(string("sumf"),nFld,sumf,0.0e0);}
+   os << "#Grid: " << npts[0] << "x" << npts[1] << "x" << npts[2] << " points, spacing: "
+      << hh[0] << " " << hh[1] << " " << hh[2] << endl;
+   os << "#Boundary points refined: " << (refBnd? "yes" : "no") << endl;
+   os << "#Volumes within the isosurface Rho=" << BASINGRID_VOLISOVAL << endl;
+   os << "#Basin(ACP)       N            q            Vol";
+   for ( int f=0 ; f<nFld ; f++ ) {
+      os << setw(13) << getFieldTypeKeyShort(convertScalarFieldType2Char(fldTyp[f]));
+   }
+   os << endl;
+   os << std::scientific << setprecision(5);
+   for ( int b=0 ; b<nBas ; b++ ) {
+      if ( nuc[b]>=0 ) {
+         zz=(wf.ihaveEDF? solreal(wf.atNum[nuc[b]]+1) : wf.atCharge[nuc[b]]);
+      } else {
+         zz=0.0e0;
+      }
+      os << setw(10) << cpn.lblACP[b] << " " << setw(12) << basPop[b] << " "
+         << setw(12) << (zz-basPop[b]) << " " << setw(12) << basVol[b];
+      for ( int f=0 ; f<nFld ; f++ ) {
+         os << " " << setw(12) << basFld[b*nFld+f];
+         sumf[f]+=basFld[b*nFld+f];
+      }
+      os << endl;
+      sump+=basPop[b];
+      sumq+=(zz-basPop[b]);
+      sumv+=basVol[b];
+   }
+   os << setw(10) << "Total" << " " << setw(12) << sump << " " << setw(12) << sumq
+      << " " << setw(12) << sumv;
+   for ( int f=0 ; f<nFld ; f++ ) {os << " " << setw(12) << sumf[f];}
+   os << endl;
+   os << "#Number of electrons (wave function): " << nel
+      << ", integration error: " << (sump-nel) << endl;
+   os.unsetf(std::ios::scientific);
+   os << setprecision(6);
+   dealloc1DRealArray(sumf);
+   dealloc1DIntArray(nuc);
+}
+/* ************************************************************************************ */
+void basinGrid3D::writeResults(string &onam,string &wfnam,GaussWaveFunction &wf,\
+      critPtNetWork &cpn)
+{
+   ofstream ofil(onam.c_str());
+   if ( !ofil.good() ) {
+      displayErrorMessage(string("The file ")+onam+string(" could not be opened!"));
+      return;
+   }
+   ofil << "#Basins of the electron density of the wave function: " << wfnam << endl;
+   printResults(ofil,wf,cpn);
+   ofil.close();
+}
+/* ************************************************************************************ */
+#endif//_BASINGRID3D_CPP_
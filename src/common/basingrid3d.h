@@ -0,0 +1,211 @@
+/*
+ *                    This source code is part of
+ *
+ *                  D  E  N  S  T  O  O  L  K  I  T
+ *
+ *                         VERSION: 1.2.0
+ *
+ *             Contributors: Juan Manuel Solano-Altamirano
+ *                           Julio Manuel Hernandez-Perez
+ *        Copyright (c) 2013-2015, Juan Manuel Solano-Altamirano
+ *                                 <jmsolanoalt@gmail.com>
+ *
+ * -------------------------------------------------------------------
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * ---------------------------------------------------------------------
+ *
+ * If you want to redistribute modifications of the suite, please
+ * consider to include your modifications in our official release.
+ * We will be pleased to consider the inclusion of your code
+ * within the official distribution. Please keep in mind that
+ * scientific software is very special, and version control is 
+ * crucial for tracing bugs. If in despite of this you distribute
+ * your modified version, please do not call it DensToolKit.
+ *
+ * If you find DensToolKit useful, we humbly ask that you cite
+ * the paper(s) on the package --- you can find them on the top
+ * README file.
+ *
+ */
+
+
+/*
+   basingrid3d.h
+
+   The class basinGrid3D partitions a uniform grid into the basins of the electron
+   density (QTAIM atomic basins), and integrates the density, and optionally other
+   fields, over every basin. The basins are assigned with an on-grid steepest ascent:
+   every point points to the neighbour (out of its 26 neighbours) towards which the
+   density grows the fastest. The ascent paths are followed by pointer jumping, i.e.,
+   every point caches the farthest point of its path that has been reached so far, so
+   that a few sweeps over the grid give the maximum (the root) of every path. The roots
+   are matched to the ACPs of a critPtNetWork, which label the basins. Since the on-grid
+   ascent is biased near the zero-flux surfaces, the points that have a neighbour lying
+   in another basin are reassigned afterwards by following the analytic gradient of the
+   density until an interior point is reached. Every stage is parallelised over the
+   slabs (planes of constant x) of the grid.
+ */
+
+#ifndef _BASINGRID3D_H_
+#define _BASINGRID3D_H_
+
+#ifndef _HAVE_DEF_SOLREAL_TYPE_
+#define _HAVE_DEF_SOLREAL_TYPE_
+typedef double solreal;
+#endif
+
+#include "gausswavefunction.h"
+#include "critptnetwork.h"
+#include "wfgrid3d.h"
+#include "fldtypesdef.h"
+#include <string>
+using std::string;
+#include <ostream>
+using std::ostream;
+
+/* The default spacing of the grid, and the default margin around the molecule.  */
+#ifndef BASINGRID_DEFAULTSPACING
+#define BASINGRID_DEFAULTSPACING (0.15e0)
+#endif
+#ifndef BASINGRID_DEFAULTMARGIN
+#define BASINGRID_DEFAULTMARGIN (4.0e0)
+#endif
+/* Points whose density is below this value are not assigned to any basin.  */
+#ifndef BASINGRID_MINRHO
+#define BASINGRID_MINRHO (1.0e-10)
+#endif
+/* The volumes of the basins are the volumes enclosed by this isosurface.  */
+#ifndef BASINGRID_VOLISOVAL
+#define BASINGRID_VOLISOVAL (1.0e-03)
+#endif
+/* The cusps of the density can not be integrated with the spacing of the grid: the
+   voxels where the density is larger than BASINGRID_SUBCELLRHO are split into
+   BASINGRID_NSUBCELLS^3 subcells, and the integrands are averaged over their centres.  */
+#ifndef BASINGRID_SUBCELLRHO
+#define BASINGRID_SUBCELLRHO (3.0e-01)
+#endif
+#ifndef BASINGRID_NSUBCELLS
+#define BASINGRID_NSUBCELLS (4)
+#endif
+/* Roots of the ascent paths lying farther than this from every ACP are reported.  */
+#ifndef BASINGRID_MAXROOTACPDIST
+#define BASINGRID_MAXROOTACPDIST (0.5e0)
+#endif
+/* An ACP closer than this to a nucleus is the ACP of that nucleus.  */
+#ifndef BASINGRID_MAXACPNUCDIST
+#define BASINGRID_MAXACPNUCDIST (0.3e0)
+#endif
+/* Boundary points whose density is below this value keep their on-grid basin (their
+   contribution to the populations is negligible).  */
+#ifndef BASINGRID_MINREFINERHO
+#define BASINGRID_MINREFINERHO (1.0e-04)
+#endif
+/* The step of the gradient paths of the boundary points, in units of the smallest
+   spacing of the grid, and the maximum number of steps.  */
+#ifndef BASINGRID_TRACESTEPFACTOR
+#define BASINGRID_TRACESTEPFACTOR (0.5e0)
+#endif
+#ifndef BASINGRID_MAXTRACESTEPS
+#define BASINGRID_MAXTRACESTEPS (400)
+#endif
+#ifndef BASINGRID_MINGRADMAG
+#define BASINGRID_MINGRADMAG (1.0e-08)
+#endif
+
+/* ************************************************************************************ */
+class basinGrid3D {
+/* ************************************************************************************ */
+public:
+/* ************************************************************************************ */
+   basinGrid3D();
+   ~basinGrid3D();
+/* ************************************************************************************ */
+   /** Takes the origin, the spacings and the number of points from grd, which must
+    * be already set up (with an orthogonal grid). Any previous partition is removed.  */
+   bool setUpFromGrid(waveFunctionGrid3D &grd);
+/* ************************************************************************************ */
+   /** If rb is false, the boundary points keep the basin of the on-grid ascent
+    * (the default is to refine them).  */
+   void setRefineBoundaries(bool rb) {refBnd=rb;}
+/* ************************************************************************************ */
+   /** Evaluates the density on the grid, assigns every point to the basin of one
+    * of the ACPs of cpn, and integrates the populations and volumes of the basins
+    * (the voxels around the nuclei are integrated over finer subcells, see
+    * BASINGRID_SUBCELLRHO).
+    * The ACPs of the density must have been already sought.  */
+   bool assignBasins(GaussWaveFunction &wf,critPtNetWork &cpn);
+/* ************************************************************************************ */
+   /** Integrates the nf fields ft[0],...,ft[nf-1] over every basin. The fields are
+    * evaluated in a single pass over the grid (see
+    * GaussWaveFunction::evalMultipleFields). assignBasins must be called first.  */
+   bool integrateFields(GaussWaveFunction &wf,const ScalarFieldType *ft,const int nf);
+/* ************************************************************************************ */
+   /** Writes the table of basins (populations, charges, volumes and integrated
+    * fields) to the stream os.  */
+   void printResults(ostream &os,GaussWaveFunction &wf,critPtNetWork &cpn);
+   /** Writes the table of basins into the file onam.  */
+   void writeResults(string &onam,string &wfnam,GaussWaveFunction &wf,critPtNetWork &cpn);
+/* ************************************************************************************ */
+   int getNofBasins(void) {return nBas;}
+   solreal getBasinPopulation(const int i) {return basPop[i];}
+   solreal getBasinVolume(const int i) {return basVol[i];}
+   /** The basin of the grid point (i,j,k) (-1 if the point is not in any basin).  */
+   int getBasinOfPoint(const int i,const int j,const int k) {return lbl[getIdx(i,j,k)];}
+/* ************************************************************************************ */
+protected:
+/* ************************************************************************************ */
+   int npts[3],nTot,nBas,nFld;
+   int nRoots,nFarRoots,nBndPts,nBndChanged;
+   solreal xin[3],hh[3],dV;
+   solreal *rho; /*!< The density at every point of the grid.  */
+   int *lbl; /*!< The basin (ACP index) of every point, -1 if none.  */
+   solreal *basPop,*basVol,*basFld,farRootPop;
+   ScalarFieldType *fldTyp;
+   bool imsetup,refBnd,iknowbasins;
+   int nbOff[26][3]; /*!< The offsets to the 26 neighbours of a point.  */
+   solreal nbOOD[26]; /*!< The inverse distances to the 26 neighbours.  */
+/* ************************************************************************************ */
+   inline int getIdx(const int i,const int j,const int k) {return (i*npts[1]+j)*npts[2]+k;}
+   inline void getPointCoords(const int m,solreal (&x)[3]) {
+      x[0]=xin[0]+solreal(m/(npts[1]*npts[2]))*hh[0];
+      x[1]=xin[1]+solreal((m/npts[2])%npts[1])*hh[1];
+      x[2]=xin[2]+solreal(m%npts[2])*hh[2];
+   }
+   void destroyArrays(void);
+   void evalRhoOnGrid(GaussWaveFunction &wf);
+   /** asc[m] is set to the neighbour of m towards which the density grows the fastest,
+    * to m if m is a local maximum, and to -1 if the density at m is negligible.  */
+   void setAscentNeighbours(int * (&asc));
+   /** Replaces asc[m] by the root of the ascent path of m (pointer jumping).  */
+   void followAscentPaths(int * (&asc));
+   /** Sets lbl from the roots of the ascent paths, matching every root with the
+    * closest ACP.  */
+   void labelFromRoots(int * (&asc),critPtNetWork &cpn);
+   int findClosestACP(critPtNetWork &cpn,solreal const (&x)[3],solreal &dd);
+   /** Reassigns the points that have a face neighbour in a different basin.  */
+   void refineBoundaryPoints(GaussWaveFunction &wf,critPtNetWork &cpn);
+   int traceBoundaryPoint(GaussWaveFunction &twf,critPtNetWork &cpn,bool * (&isbnd),\
+         const int m);
+   void integrateRho(GaussWaveFunction &wf);
+   /** Averages the nf fields ft (the density if nf is 0) over the subcells of the voxel
+    * of the point m (see BASINGRID_NSUBCELLS), and saves the averages into res.  */
+   void averageOverSubcells(GaussWaveFunction &twf,const int m,\
+         const ScalarFieldType *ft,const int nf,solreal *res);
+/* ************************************************************************************ */
+};
+/* ************************************************************************************ */
+
+#endif//_BASINGRID3D_H_
@@ -54,6 +54,8 @@
 #include "solpovtools.h"
 #include "iofuncts-wfn.h"
 #include "iofuncts-wfx.h"
+#include "solstringtools.h"
+#include "cellgrid3d.h"
 #include "atomradiicust.h"
 // The first 94 atomic radii are given,
 //  the rest are set to be 0.80e0
@@ -66,11 +68,12 @@ bondNetWork::bondNetWork()
 //**********************************************************************************************
 {
    R=NULL;
-   bondDist=NULL;
    nNuc=0;
    atNum=NULL;
    atLbl=NULL;
-   bNet=NULL;
+   bNetStart=NULL;
+   bNetList=NULL;
+   bNetDist=NULL;
    nBonds=0;
    nTit=0;
    title=NULL;
@@ -89,11 +92,12 @@ bondNetWork::~bondNetWork()
 //**********************************************************************************************
 {
    dealloc2DRealArray(R,nNuc);
-   dealloc2DIntArray(bNet,nNuc);
+   dealloc1DIntArray(bNetStart);
+   dealloc1DIntArray(bNetList);
    dealloc1DStringArray(atLbl);
    dealloc1DStringArray(title);
    dealloc1DIntArray(atNum);
-   dealloc2DRealArray(bondDist,nNuc);
+   dealloc1DRealArray(bNetDist);
    isSTP=false;
 }
 //**********************************************************************************************
@@ -104,45 +108,53 @@ bool bondNetWork::imstp()
 //**********************************************************************************************
 bool bondNetWork::readFromFileWFX(string inname)
 {
-   ifstream tif;
-   tif.open(inname.c_str(),ios::in);
-   if (!(tif.good())) {
+   wfxFileIndex wfx;
+   if ( !wfx.open(inname) ) {
       cout << "Error: File " << inname << "could not be opened...\n";
 #if DEBUG
       cout << __FILE__ << ", line: " << __LINE__ << endl;
 #endif
       return false;
    }
-   getTitleFromFileWFX(tif,nTit,title);
-   getNofNucleiFromFileWFX(tif,nNuc);
+   wfx.getLines(string("Title"),nTit,title);
+   for ( int i=0 ; i<nTit ; ++i ) {removeRedundantSpaces(title[i]);}
+   wfx.getInt(string("Number of Nuclei"),nNuc);
    alloc1DStringArray("atLbl",nNuc,atLbl);
    alloc2DRealArray(string("R"),nNuc,3,R);
    alloc1DIntArray(string("atNum"),nNuc,atNum);
-   getAtLabelsFromFileWFX(tif,nNuc,atLbl);
-   getNucCartCoordsFromFileWFX(tif,nNuc,R);
-   getAtNumbersFromFileWFX(tif,nNuc,atNum);
-   tif.close();
+   int nlbl=0;
+   string *lbl=NULL;
+   wfx.getLines(string("Nuclear Names"),nlbl,lbl);
+   for ( int i=0 ; (i<nNuc)&&(i<nlbl) ; ++i ) {atLbl[i]=lbl[i];}
+   if ( nlbl>0 ) {dealloc1DStringArray(lbl);}
+   solreal *rr=NULL;
+   alloc1DRealArray(string("rr"),3*nNuc,rr);
+   wfx.getReals(string("Nuclear Cartesian Coordinates"),3*nNuc,rr);
+   for ( int i=0 ; i<nNuc ; ++i ) {
+      for ( int k=0 ; k<3 ; ++k ) {R[i][k]=rr[3*i+k];}
+   }
+   dealloc1DRealArray(rr);
+   wfx.getInts(string("Atomic Numbers"),nNuc,atNum,0,-1);
+   wfx.close();
    return true;
 }
 //**********************************************************************************************
 bool bondNetWork::readFromFileWFN(string inname)
 {
-   ifstream tif;
+   wfnFileIndex wfn;
    string orDe;
    int nmo,npr;
-   tif.open(inname.c_str(),ios::in);
-   if (!(tif.good())) {
+   if ( !wfn.open(inname) ) {
       cout << "Error: File " << inname << "could not be opened...\n";
 #if DEBUG
       cout << __FILE__ << ", line: " << __LINE__ << endl;
 #endif
       return false;
    }
-   tif.seekg(tif.beg);
    nTit=1;
-   processFirstDataStringinWFNFile(tif,title,orDe,nmo,npr,nNuc);
+   if ( !wfn.getHeader(title,orDe,nmo,npr,nNuc) ) {return false;}
    solreal *atch,*tmprad;
-   processCentersWFN(tif,nNuc,atLbl,tmprad,atch);
+   if ( !wfn.getCenters(nNuc,atLbl,tmprad,atch) ) {return false;}
    alloc2DRealArray(string("R-readwfn-"),nNuc,3,R);
    alloc1DIntArray(string("atNum"),nNuc,atNum);
    for (int i=0; i<nNuc; i++) {
@@ -153,7 +165,30 @@ bool bondNetWork::readFromFileWFN(string inname)
    }
    dealloc1DRealArray(atch);
    dealloc1DRealArray(tmprad);
-   tif.close();
+   wfn.close();
+   return true;
+}
+//*************************************************************************************************
+bool bondNetWork::readFromWaveFunction(const GaussWaveFunction &wf)
+{
+   if ( !(wf.imldd&&(wf.atNum!=NULL)) ) {
+      cout << "Error: the wave function has not been loaded!" << endl;
+      return false;
+   }
+   nTit=wf.nTit;
+   alloc1DStringArray("title",nTit,title);
+   for (int i=0; i<nTit; i++) {title[i]=wf.title[i];}
+   nNuc=wf.nNuc;
+   alloc1DStringArray("atLbl",nNuc,atLbl);
+   alloc2DRealArray(string("R"),nNuc,3,R);
+   alloc1DIntArray(string("atNum"),nNuc,atNum);
+   for (int i=0; i<nNuc; i++) {
+      atLbl[i]=wf.atLbl[i];
+      atNum[i]=wf.atNum[i];
+      R[i][0]=wf.R[3*i];
+      R[i][1]=wf.R[3*i+1];
+      R[i][2]=wf.R[3*i+2];
+   }
    return true;
 }
 //*************************************************************************************************
@@ -197,22 +232,57 @@ bool bondNetWork::setUpBNW(void)
 //**********************************************************************************************
 bool bondNetWork::lookForBonds(void)
 {
-   if (!(alloc2DRealArray(string("bondDist"),nNuc,MAXBONDINGATOMS,bondDist))) {
+   dealloc1DIntArray(bNetStart);
+   dealloc1DIntArray(bNetList);
+   dealloc1DRealArray(bNetDist);
+   nBonds=0;
+   int capb=BNW_INITBONDCAPACITY;
+   if (!(alloc1DIntArray(string("bNetStart"),(nNuc+1),bNetStart,0))) {
+      cout << "Unknonw error from " << __FILE__ << ", line: " << __LINE__ << endl;
+      return false;
+   }
+   if (!(alloc1DIntArray(string("bNetList"),capb,bNetList,0))) {
       cout << "Unknonw error from " << __FILE__ << ", line: " << __LINE__ << endl;
       return false;
    }
-   if (!(alloc2DIntArray(string("bNet"),nNuc,MAXBONDINGATOMS,bNet))) {
+   if (!(alloc1DRealArray(string("bNetDist"),capb,bNetDist,0.0e0))) {
       cout << "Unknonw error from " << __FILE__ << ", line: " << __LINE__ << endl;
       return false;
    }
-   solreal d,vdwd,clsstatd=1.0e+50;
+   /* Two atoms are bonded if their distance is not larger than the sum of their
+      van der Waals radii, hence no bond is longer than twice the largest radius found
+      in the molecule. Using this cutoff as the cell size, the bonded partners of an atom
+      are in its own cell or in the adjacent ones.  */
+   solreal rcut=0.0e0;
+   for (int i=0; i<nNuc; i++) {
+      if ( getAtomicVDWRadius(atNum[i])>rcut ) {rcut=getAtomicVDWRadius(atNum[i]);}
+   }
+   rcut*=(2.0e0/BOHRTOANGSTROM);
+   cellGrid3D grd;
+   grd.setCellSize(((rcut>0.0e0)? rcut : AUTOMATICMAXBONDDIST));
+   for (int i=0; i<nNuc; i++) {grd.addPoint(R[i],i);}
+   int *cand=NULL,capcand=0,nc,j;
+   solreal d,dx,vdwd,clsstatd=1.0e+50;
    for (int i=0; i<nNuc; i++) {
-      for (int j=i+1; j<nNuc; j++) {
-         d=dist(i,j);
+      bNetStart[i]=nBonds;
+      nc=grd.getCandidatesAround(R[i],rcut,cand,capcand);
+      for (int c=0; c<nc; c++) {
+         j=cand[c];
+         if ( j<=i ) {continue;}
+         d=0.0e0;
+         for (int k=0; k<3; k++) {dx=R[i][k]-R[j][k]; d+=(dx*dx);}
+         if ( d>(rcut*rcut) ) {continue;}
+         d=sqrt(d);
          //vdwd=(atomicRadius[atNum[i]]+atomicRadius[atNum[j]])/BOHRTOANGSTROM;
          vdwd=(getAtomicVDWRadius(atNum[i])+getAtomicVDWRadius(atNum[j]))/BOHRTOANGSTROM;
          if (d<=vdwd) {
-            addBond(i,j,d);
+            if ( nBonds==capb ) {
+               resize1DIntArray(string("bNetList"),capb,2*capb,bNetList);
+               resize1DRealArray(string("bNetDist"),capb,2*capb,bNetDist);
+               capb*=2;
+            }
+            bNetList[nBonds]=j;
+            bNetDist[nBonds]=d;
             if (d>maxBondDist) {
                maxBondDist=d;
             }
@@ -221,24 +291,22 @@ bool bondNetWork::lookForBonds(void)
          if ( d<clsstatd ) {clsstatd=d;}
       }
    }
+   bNetStart[nNuc]=nBonds;
+   dealloc1DIntArray(cand);
    if (nNuc==1) {maxBondDist=AUTOMATICMAXBONDDIST;}
    if ((maxBondDist<0.0e0)&&(nNuc==2)) {maxBondDist=dist(0,1);}
-   if (maxBondDist<0.0e0) {maxBondDist=clsstatd;}
-   return true;
-}
-//**********************************************************************************************
-void bondNetWork::addBond(int m, int n,solreal dd)
-{
-   int k=0;
-   while (k<MAXBONDINGATOMS) {
-      if (bNet[m][k]>0) {
-         k++;
-      } else {
-         bNet[m][k]=n;
-         bondDist[m][k]=dd;
-         break;
+   if ((maxBondDist<0.0e0)&&(nNuc>2)) {
+      //No bonds at all; the closest pair may lie beyond the cutoff, so look for it.
+      clsstatd=1.0e+50;
+      for (int i=0; i<nNuc; i++) {
+         for (j=i+1; j<nNuc; j++) {
+            d=dist(i,j);
+            if ( d<clsstatd ) {clsstatd=d;}
+         }
       }
    }
+   if (maxBondDist<0.0e0) {maxBondDist=clsstatd;}
+   return true;
 }
 //**********************************************************************************************
 void bondNetWork::seekRMaxMin(void)
@@ -266,6 +334,8 @@ bool bondNetWork::makePOVFile(string pnam,povRayConfProp &pvp)
    //povRayConfProp pvp;
    if (!isSTP) {setUpBNW();}
    if (!ballAndStickMode) {drawAtSize*=AUTOMATICBALLANDSTICKRATIO;}
+   solreal trn[3];
+   for (int i=0; i<3; i++) {trn[i]=0.5e0*(rmax[i]+rmin[i]);}
    centerMolecule();
    calcViewRadius();
    cout << "rView: " << rView << endl;
@@ -292,6 +362,7 @@ bool bondNetWork::makePOVFile(string pnam,povRayConfProp &pvp)
    if (ballAndStickMode||wireMode) {
       putBonds(pof);
    }
+   pvp.writeIncludedObject(pof,trn);
    pof.close();
    return true;
 }
@@ -323,8 +394,8 @@ void bondNetWork::putBonds(ofstream &pof)
    int k=0,atni,atnk;
    solreal startpt[3],frak1;
    for (int i=0; i<nNuc; i++) {
-      for (int j=0; j<MAXBONDINGATOMS; j++) {
-         k=bNet[i][j];
+      for (int j=bNetStart[i]; j<bNetStart[i+1]; j++) {
+         k=bNetList[j];
          atni=atNum[i];
          atnk=atNum[k];
          //frak1=atomicRadius[atni]/(atomicRadius[atni]+atomicRadius[atnk]);
@@ -332,18 +403,16 @@ void bondNetWork::putBonds(ofstream &pof)
          for (int l=0; l<3; l++) {
             startpt[l]=R[i][l]*(1.0e0-frak1)+R[k][l]*frak1;
          }
-         if (k>0) {
-            writePOVCylinder(pof,1,
-                             R[i][0],R[i][1],R[i][2],
-                             startpt[0],startpt[1],startpt[2],drawStickSize,
-                             getAtomicRColorReal(atni),getAtomicGColorReal(atni),
-                             getAtomicBColorReal(atni));
-            writePOVCylinder(pof,1,
-                             startpt[0],startpt[1],startpt[2],
-                             R[k][0],R[k][1],R[k][2],drawStickSize,
-                             getAtomicRColorReal(atnk),getAtomicGColorReal(atnk),
-                             getAtomicBColorReal(atnk));
-         }
+         writePOVCylinder(pof,1,
+                          R[i][0],R[i][1],R[i][2],
+                          startpt[0],startpt[1],startpt[2],drawStickSize,
+                          getAtomicRColorReal(atni),getAtomicGColorReal(atni),
+                          getAtomicBColorReal(atni));
+         writePOVCylinder(pof,1,
+                          startpt[0],startpt[1],startpt[2],
+                          R[k][0],R[k][1],R[k][2],drawStickSize,
+                          getAtomicRColorReal(atnk),getAtomicGColorReal(atnk),
+                          getAtomicBColorReal(atnk));
       }
    }
    pof << "}" << endl;
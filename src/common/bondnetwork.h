@@ -80,7 +80,10 @@ using std::setprecision;
 #include "solscrutils.h"
 #include "solmemhand.h"
 #include "solpovtools.h"
-#define MAXBONDINGATOMS 8
+#include "gausswavefunction.h"
+#ifndef BNW_INITBONDCAPACITY
+#define BNW_INITBONDCAPACITY 64
+#endif
 
 //**********************************************************************************************
 //**********************************************************************************************
@@ -99,16 +102,23 @@ public:
    bool readFromFileWFX(string inname);
    bool readFromFileWFN(string inname);
    bool readFromFile(string inname);
+   /** Copies the title, labels, coordinates and atomic numbers from a loaded wave
+      function, so the wfn(wfx) file does not need to be parsed a second time.  */
+   bool readFromWaveFunction(const GaussWaveFunction &wf);
    //**********************************************************************************************
    solreal **R;         //Contains the atoms' radius-vectors.
-   solreal **bondDist;  //It contains the bond distances of the actual bonded atoms. It will
-                     //  not be allocated by its own, but rather one needs to call some setup
-                     //  function.
    int nNuc;         //The number of nuclei.
    int *atNum;       //The atomic number of each nuclei
    string *atLbl;    //The atom labels
-   int **bNet;       //The bonding network, contains the labels of the
-                     //   atoms that each atom is bonded to.
+   /* The bonding network is stored in compressed-sparse-row form: the atoms bonded to
+      the i-th atom (only those with a label larger than i, so each bond is stored once)
+      are bNetList[bNetStart[i]],...,bNetList[bNetStart[i+1]-1], in increasing order,
+      and bNetDist holds the corresponding bond distances. bNetStart has nNuc+1 entries.
+      These arrays are not allocated by their own; one needs to call lookForBonds (or
+      setUpBNW).  */
+   int *bNetStart;
+   int *bNetList;
+   solreal *bNetDist;
    int nBonds;
    int nTit;
    string *title;
@@ -124,8 +134,9 @@ public:
    bool lookForBonds(void);
    //**********************************************************************************************
    solreal dist(int i, int k);
-   //**********************************************************************************************
-   void addBond(int i,int j,solreal dd);
+   /** Returns the number of atoms bonded to the i-th atom and whose label is larger
+      than i.  */
+   inline int getNofBondsFrom(int i) {return bNetStart[i+1]-bNetStart[i];}
    //**********************************************************************************************
    bool makePOVFile(string pnam, povRayConfProp &pvp);
    //**********************************************************************************************
@@ -0,0 +1,199 @@
+/*
+ *                    This source code is part of
+ *
+ *                  D  E  N  S  T  O  O  L  K  I  T
+ *
+ *                         VERSION: 1.2.0
+ *
+ *             Contributors: Juan Manuel Solano-Altamirano
+ *                           Julio Manuel Hernandez-Perez
+ *        Copyright (c) 2013-2015, Juan Manuel Solano-Altamirano
+ *                                 <jmsolanoalt@gmail.com>
+ *
+ * -------------------------------------------------------------------
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * ---------------------------------------------------------------------
+ *
+ * If you want to redistribute modifications of the suite, please
+ * consider to include your modifications in our official release.
+ * We will be pleased to consider the inclusion of your code
+ * within the official distribution. Please keep in mind that
+ * scientific software is very special, and version control is 
+ * crucial for tracing bugs. If in despite of this you distribute
+ * your modified version, please do not call it DensToolKit.
+ *
+ * If you find DensToolKit useful, we humbly ask that you cite
+ * the paper(s) on the package --- you can find them on the top
+ * README file.
+ *
+ */
+
+
+#ifndef _CELLGRID3D_CPP_
+#define _CELLGRID3D_CPP_
+
+#include "cellgrid3d.h"
+#include "solmemhand.h"
+#include <iostream>
+using std::cout;
+using std::endl;
+
+/* ************************************************************************************ */
+cellGrid3D::cellGrid3D()
+{
+   h=ooh=1.0e0;
+   nPts=capPts=nBuck=0;
+   head=next=pid=cell=NULL;
+   xyz=NULL;
+}
+/* ************************************************************************************ */
+cellGrid3D::~cellGrid3D()
+{
+   dealloc1DIntArray(head);
+   dealloc1DIntArray(next);
+   dealloc1DIntArray(pid);
+   dealloc1DIntArray(cell);
+   dealloc1DRealArray(xyz);
+}
+/* ************************************************************************************ */
+void cellGrid3D::setCellSize(const solreal hh)
+{
+   h=((hh>0.0e0)? hh : 1.0e0);
+   ooh=1.0e0/h;
+   clear();
+}
+/* ************************************************************************************ */
+void cellGrid3D::clear(void)
+{
+   nPts=0;
+   for ( int i=0 ; i<nBuck ; i++ ) {head[i]=-1;}
+}
+/* ************************************************************************************ */
+bool cellGrid3D::growPointArrays(void)
+{
+   int newcap=((capPts>0)? (2*capPts) : CELLGRID3D_INITCAPACITY);
+   bool res=resize1DIntArray(string("next"),capPts,newcap,next,-1);
+   res=(res&&resize1DIntArray(string("pid"),capPts,newcap,pid));
+   res=(res&&resize1DIntArray(string("cell"),3*capPts,3*newcap,cell));
+   res=(res&&resize1DRealArray(string("xyz"),3*capPts,3*newcap,xyz));
+   if ( res ) {capPts=newcap;}
+   return res;
+}
+/* ************************************************************************************ */
+void cellGrid3D::rehash(const int newnbuck)
+{
+   dealloc1DIntArray(head);
+   nBuck=newnbuck;
+   alloc1DIntArray(string("head"),nBuck,head,-1);
+   int b;
+   for ( int p=0 ; p<nPts ; p++ ) {
+      b=getBucket(cell[3*p],cell[3*p+1],cell[3*p+2]);
+      next[p]=head[b];
+      head[b]=p;
+   }
+}
+/* ************************************************************************************ */
+bool cellGrid3D::addPoint(solreal const (&x)[3],const int id)
+{
+   return addPoint(&x[0],id);
+}
+/* ************************************************************************************ */
+bool cellGrid3D::addPoint(const solreal *x,const int id)
+{
+   if ( nPts==capPts && !growPointArrays() ) {
+      cout << "Error: the point could not be added to the cell grid!" << endl;
+      return false;
+   }
+   //Keeps (on average) less than two points per bucket.
+   if ( nPts>=(2*nBuck) ) {rehash((nBuck>0)? (2*nBuck) : CELLGRID3D_INITCAPACITY);}
+   int p=nPts;
+   for ( int k=0 ; k<3 ; k++ ) {
+      xyz[3*p+k]=x[k];
+      cell[3*p+k]=getCellIndex(x[k]);
+   }
+   pid[p]=id;
+   int b=getBucket(cell[3*p],cell[3*p+1],cell[3*p+2]);
+   next[p]=head[b];
+   head[b]=p;
+   ++nPts;
+   return true;
+}
+/* ************************************************************************************ */
+int cellGrid3D::findFirstWithin(solreal const (&x)[3],const solreal eps)
+{
+   if ( nPts==0 ) {return -1;}
+   int cmin[3],cmax[3],res=-1,p;
+   for ( int k=0 ; k<3 ; k++ ) {
+      cmin[k]=getCellIndex(x[k]-eps);
+      cmax[k]=getCellIndex(x[k]+eps);
+   }
+   for ( int i=cmin[0] ; i<=cmax[0] ; i++ ) {
+      for ( int j=cmin[1] ; j<=cmax[1] ; j++ ) {
+         for ( int k=cmin[2] ; k<=cmax[2] ; k++ ) {
+            p=head[getBucket(i,j,k)];
+            while ( p>=0 ) {
+               if ( (fabs(x[0]-xyz[3*p])<eps)&&(fabs(x[1]-xyz[3*p+1])<eps)\
+                     &&(fabs(x[2]-xyz[3*p+2])<eps) ) {
+                  if ( res<0 || pid[p]<res ) {res=pid[p];}
+               }
+               p=next[p];
+            }
+         }
+      }
+   }
+   return res;
+}
+/* ************************************************************************************ */
+int cellGrid3D::getCandidatesAround(const solreal *x,const solreal rad,int* &ids,int &capids)
+{
+   int cmin[3],cmax[3],n=0,p,q,tmp;
+   if ( nPts==0 ) {return 0;}
+   for ( int k=0 ; k<3 ; k++ ) {
+      cmin[k]=getCellIndex(x[k]-rad);
+      cmax[k]=getCellIndex(x[k]+rad);
+   }
+   for ( int i=cmin[0] ; i<=cmax[0] ; i++ ) {
+      for ( int j=cmin[1] ; j<=cmax[1] ; j++ ) {
+         for ( int k=cmin[2] ; k<=cmax[2] ; k++ ) {
+            p=head[getBucket(i,j,k)];
+            while ( p>=0 ) {
+               if ( cell[3*p]==i && cell[3*p+1]==j && cell[3*p+2]==k ) {
+                  if ( n==capids ) {
+                     resize1DIntArray(string("ids"),capids,\
+                           ((capids>0)? (2*capids) : CELLGRID3D_INITCAPACITY),ids);
+                     capids=((capids>0)? (2*capids) : CELLGRID3D_INITCAPACITY);
+                  }
+                  ids[n++]=pid[p];
+               }
+               p=next[p];
+            }
+         }
+      }
+   }
+   //Insertion sort; the lists are short.
+   for ( int i=1 ; i<n ; i++ ) {
+      tmp=ids[i];
+      q=i-1;
+      while ( q>=0 && ids[q]>tmp ) {
+         ids[q+1]=ids[q];
+         --q;
+      }
+      ids[q+1]=tmp;
+   }
+   return n;
+}
+/* ************************************************************************************ */
+#endif//_CELLGRID3D_CPP_
@@ -0,0 +1,125 @@
+/*
+ *                    This source code is part of
+ *
+ *                  D  E  N  S  T  O  O  L  K  I  T
+ *
+ *                         VERSION: 1.2.0
+ *
+ *             Contributors: Juan Manuel Solano-Altamirano
+ *                           Julio Manuel Hernandez-Perez
+ *        Copyright (c) 2013-2015, Juan Manuel Solano-Altamirano
+ *                                 <jmsolanoalt@gmail.com>
+ *
+ * -------------------------------------------------------------------
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * ---------------------------------------------------------------------
+ *
+ * If you want to redistribute modifications of the suite, please
+ * consider to include your modifications in our official release.
+ * We will be pleased to consider the inclusion of your code
+ * within the official distribution. Please keep in mind that
+ * scientific software is very special, and version control is 
+ * crucial for tracing bugs. If in despite of this you distribute
+ * your modified version, please do not call it DensToolKit.
+ *
+ * If you find DensToolKit useful, we humbly ask that you cite
+ * the paper(s) on the package --- you can find them on the top
+ * README file.
+ *
+ */
+
+
+/*
+   cellgrid3d.h
+
+   The class cellGrid3D is a uniform hash grid (a cell list) of points in space. Each
+   point is stored together with an integer identifier (usually the index of the point
+   in some external array), and the grid answers the two questions that, otherwise,
+   require scanning all the points: which is the (lowest identifier) point lying within
+   a small box around a given point, and which points are close to a given point.
+   The cells are cubes of side h; only the non-empty cells take memory, since the
+   cells are hashed into a table whose size grows with the number of points.
+ */
+
+#ifndef _CELLGRID3D_H_
+#define _CELLGRID3D_H_
+
+#ifndef _HAVE_DEF_SOLREAL_TYPE_
+#define _HAVE_DEF_SOLREAL_TYPE_
+typedef double solreal;
+#endif
+
+#include <cmath>
+
+#ifndef CELLGRID3D_INITCAPACITY
+#define CELLGRID3D_INITCAPACITY 64
+#endif
+
+/* ************************************************************************************ */
+class cellGrid3D {
+/* ************************************************************************************ */
+public:
+/* ************************************************************************************ */
+   cellGrid3D();
+   ~cellGrid3D();
+/* ************************************************************************************ */
+   /** Sets the side of the cells. This removes all the points in the grid.  */
+   void setCellSize(const solreal hh);
+/* ************************************************************************************ */
+   solreal getCellSize(void) {return h;}
+/* ************************************************************************************ */
+   /** Removes all the points (the memory is kept for further use).  */
+   void clear(void);
+/* ************************************************************************************ */
+   int getNofPoints(void) {return nPts;}
+/* ************************************************************************************ */
+   /** Adds the point x, whose identifier is id, to the grid.  */
+   bool addPoint(solreal const (&x)[3],const int id);
+   bool addPoint(const solreal *x,const int id);
+/* ************************************************************************************ */
+   /** Returns the lowest identifier of the points p such that |p[k]-x[k]|<eps for
+    * k=0,1,2, or -1 if there is no such point.  */
+   int findFirstWithin(solreal const (&x)[3],const solreal eps);
+/* ************************************************************************************ */
+   /** Collects into ids (in increasing order) the identifiers of all the points that
+    * lie in the cells overlapping the box [x-rad,x+rad]. This is a superset of the points
+    * whose distance to x is not larger than rad; the caller must do the actual
+    * distance test. The array ids is (re)allocated if capids is not large enough.
+    * Returns the number of identifiers stored in ids.  */
+   int getCandidatesAround(const solreal *x,const solreal rad,int* &ids,int &capids);
+/* ************************************************************************************ */
+protected:
+/* ************************************************************************************ */
+   solreal h,ooh;
+   int nPts,capPts,nBuck;
+   int *head; /*!< The first point of each bucket (-1 if the bucket is empty).  */
+   int *next; /*!< The next point in the same bucket (-1 at the end of the chain).  */
+   int *pid; /*!< The identifiers of the points.  */
+   int *cell; /*!< The three cell indices of each point.  */
+   solreal *xyz; /*!< The coordinates of the points.  */
+/* ************************************************************************************ */
+   inline int getCellIndex(const solreal xk) {return int(floor(xk*ooh));}
+   inline int getBucket(const int i,const int j,const int k) {
+      return int(((unsigned int)(i)*73856093u^(unsigned int)(j)*19349663u\
+               ^(unsigned int)(k)*83492791u)&(unsigned int)(nBuck-1));
+   }
+   bool growPointArrays(void);
+   void rehash(const int newnbuck);
+/* ************************************************************************************ */
+};
+/* ************************************************************************************ */
+
+#endif//_CELLGRID3D_H_
@@ -50,6 +50,8 @@
 using std::cout;
 using std::endl;
 #include <cstdlib>
+#include <iomanip>
+using std::setw;
 
 #include "solscrutils.h"
 #include "solfileutils.h"
@@ -76,6 +78,7 @@ using std::endl;
 #define CPNW_MINLOLSIGNIFICATIVEVAL (5.0e-04)
 #define CPNW_EXTENDEDBONDDISTFACTOR (3.5e0)
 #define CPNW_BONDISTEXTCCPSEARCHFACTOR (2.0e0)
+#define CPNW_DEDUPGRIDCELLSIZE (0.5e0)
 #define CPNW_ATOMCRITICALPOINTSIZEFACTOR (0.25e0)
 
 #ifndef CPNW_EPSEIGENVALUECPSEARCH
@@ -106,6 +109,18 @@ using std::endl;
 #define CPNW_DEFAULTGRADIENTPATHS 0.1
 #endif
 
+#ifndef CPNW_GRADPATHDP54TOL
+#define CPNW_GRADPATHDP54TOL (3.0e-07)
+#endif
+
+#ifndef CPNW_GRADPATHDP54MINSTEPFACTOR
+#define CPNW_GRADPATHDP54MINSTEPFACTOR (0.5e0)
+#endif
+
+#ifndef CPNW_GRADPATHDP54MAXSTEPFACTOR
+#define CPNW_GRADPATHDP54MAXSTEPFACTOR (10.0e0)
+#endif
+
 #ifndef CPNW_MAXITERATIONACPSEARCH
 #define CPNW_MAXITERATIONACPSEARCH 20
 #endif
@@ -122,6 +137,38 @@ using std::endl;
 #define CPNW_MAXITERATIONCCPSEARCH 120
 #endif
 
+#ifndef CPNW_TRUSTREGIONMAXRADIUSFACTOR
+#define CPNW_TRUSTREGIONMAXRADIUSFACTOR (2.0e0)
+#endif
+
+#ifndef CPNW_TRUSTREGIONHESSUPDATES
+#define CPNW_TRUSTREGIONHESSUPDATES (4)
+#endif
+
+#ifndef CPNW_TRUSTREGIONEPSMODEL
+#define CPNW_TRUSTREGIONEPSMODEL (1.0e-12)
+#endif
+
+#ifndef CPNW_GRIDSEARCHSPACING
+#define CPNW_GRIDSEARCHSPACING (0.4e0)
+#endif
+
+#ifndef CPNW_GRIDSEARCHMARGIN
+#define CPNW_GRIDSEARCHMARGIN (2.0e0)
+#endif
+
+#ifndef CPNW_GRIDSEARCHMAXLEVELS
+#define CPNW_GRIDSEARCHMAXLEVELS (3)
+#endif
+
+#ifndef CPNW_TRACKMAXCPSHIFT
+#define CPNW_TRACKMAXCPSHIFT (0.3e0)
+#endif
+
+#ifndef CPNW_LOLSEEDBLOCKSIZE
+#define CPNW_LOLSEEDBLOCKSIZE (8)
+#endif
+
 #ifndef CPNW_MAXITERATIONRINGPATHBISECT
 #define CPNW_MAXITERATIONRINGPATHBISECT 60
 #endif
@@ -167,9 +214,17 @@ void critPtNetWork::init()
    RBGP=NULL;
    RRGP=RCGP=NULL;
    lblACP=lblBCP=lblRCP=lblCCP=NULL;
+   RGP=NULL;
    for (int i=0; i<3; i++) {centMolecVec[i]=0.0e0;}
    //privates
    dACP=dBCP=dRCP=dCCP=0;
+   wConRCP=CPNW_INITBCPSCONNECTEDTORCP;
+   wConCCP=CPNW_INITRCPSCONNECTEDTOCCP;
+   maxPtsGP=CPNW_ARRAYSIZEGRADPATH;
+   arenaGP=NULL;
+   nArenaGP=dArenaGP=0;
+   gpMagG0=gpMagG1=gpS0=gpS=gpH=gpHNext=gpHMin=gpHMax=0.0e0;
+   gpDir=1.0e0;
    maxItACP=CPNW_MAXITERATIONACPSEARCH;
    maxItBCP=CPNW_MAXITERATIONBCPSEARCH;
    maxItRCP=CPNW_MAXITERATIONRCPSEARCH;
@@ -178,6 +233,8 @@ void critPtNetWork::init()
    stepSizeBCP=CPNW_MAXSTEPSIZEBCPSEARCH;
    stepSizeRCP=CPNW_MAXSTEPSIZERCPSEARCH;
    stepSizeCCP=CPNW_MAXSTEPSIZECCPSEARCH;
+   useTRCPSearch=useHessUpdCPSearch=false;
+   resetCPSearchStats();
    iknowacps=iknowbcps=iknowrcps=iknowccps=false;
    iknowallcps=false;
    iknowbgps=iknowrgps=iknowcgps=false;
@@ -188,8 +245,14 @@ void critPtNetWork::init()
    drawBnd=true;
    drawBGPs=drawRGPs=drawCGPs=false;
    tubeBGPStyle=false;
+   mkextsearch=mkgridsearch=false;
+   gridSearchH=CPNW_GRIDSEARCHSPACING;
    wf=NULL;
    bn=NULL;
+   gridACP.setCellSize(CPNW_DEDUPGRIDCELLSIZE);
+   gridBCP.setCellSize(CPNW_DEDUPGRIDCELLSIZE);
+   gridRCP.setCellSize(CPNW_DEDUPGRIDCELLSIZE);
+   gridCCP.setCellSize(CPNW_DEDUPGRIDCELLSIZE);
 }
 /* ************************************************************************************ */
 critPtNetWork::critPtNetWork(GaussWaveFunction &uwf,bondNetWork &ubn)
@@ -197,26 +260,18 @@ critPtNetWork::critPtNetWork(GaussWaveFunction &uwf,bondNetWork &ubn)
    init();
    wf=&uwf;
    bn=&ubn;
+   allocFlat2DRealArray(string("RGP"),maxPtsGP,3,RGP);
 }
 /* ************************************************************************************ */
 critPtNetWork::~critPtNetWork()
 {
-   dealloc4DRealArray(RCGP,dCCP,CPNW_MAXRCPSCONNECTEDTOCCP,\
-         CPNW_ARRAYSIZEGRADPATH);
-   dealloc4DRealArray(RRGP,dRCP,CPNW_MAXBCPSCONNECTEDTORCP,\
-         CPNW_ARRAYSIZEGRADPATH);
-   dealloc3DRealArray(RBGP,dBCP,CPNW_ARRAYSIZEGRADPATH);
-   dealloc2DRealArray(RACP,dACP);
-   dealloc1DStringArray(lblACP);
-   dealloc2DRealArray(RBCP,dBCP);
-   dealloc1DStringArray(lblBCP);
-   dealloc2DIntArray(conBCP,dBCP);
-   dealloc2DRealArray(RRCP,dRCP);
-   dealloc1DStringArray(lblRCP);
-   dealloc3DIntArray(conRCP,dRCP,2);
-   dealloc3DIntArray(conCCP,dCCP,2);
-   dealloc2DRealArray(RCCP,dCCP);
-   dealloc1DStringArray(lblCCP);
+   deallocGradPathViews();
+   deallocFlat2DRealArray(arenaGP);
+   deallocXCPArrays('a');
+   deallocXCPArrays('b');
+   deallocXCPArrays('r');
+   deallocXCPArrays('c');
+   deallocFlat2DRealArray(RGP);
    wf=NULL;
    bn=NULL;
 }
@@ -269,8 +324,7 @@ void critPtNetWork::setCriticalPoints(ScalarFieldType ft)
          exit(1);
          break;
    }
-   alloc2DRealArray(string("RACP"),dACP,3,RACP,1.0e+50);
-   alloc1DStringArray("lblACP",dACP,lblACP);
+   allocXCPArrays('a',dACP);
    cout << "Looking for Attractor Critical Points..." << endl;
    switch (ft) {
       case DENS:
@@ -285,11 +339,7 @@ void critPtNetWork::setCriticalPoints(ScalarFieldType ft)
          break;
    }
    if (iknowacps) {
-      dBCP=(nACP*(nACP-1))/2;
-      if ( dBCP<CPNW_MINARRAYSIZE ) {dBCP=CPNW_MINARRAYSIZE;}
-      alloc2DRealArray(string("RBCP"),dBCP,3,RBCP,1.0e+50);
-      alloc2DIntArray(string("conBCP"),dBCP,3,conBCP,-1);
-      alloc1DStringArray("lblBCP",dBCP,lblBCP);
+      allocXCPArrays('b',2*nACP);
    } else {
       displayErrorMessage("First look for ACPs...\n");
 #if DEBUG
@@ -313,13 +363,7 @@ void critPtNetWork::setCriticalPoints(ScalarFieldType ft)
 #if DEBUG
    cout << "nBCP: " << nBCP << ", dBCP: " << dBCP << endl;
 #endif
-   if (iknowbcps) {
-      dRCP=(nBCP*(nBCP-1))/2;
-      if ( dRCP<CPNW_MINARRAYSIZE ) {dRCP=CPNW_MINARRAYSIZE;}
-      alloc2DRealArray(string("RRCP"),dRCP,3,RRCP,1.0e+50);
-      alloc1DStringArray("lblRCP",dRCP,lblRCP);
-      alloc3DIntArray("conRCP",dRCP,2,CPNW_MAXBCPSCONNECTEDTORCP,conRCP,-1);
-   }
+   if (iknowbcps) {allocXCPArrays('r',nBCP);}
    cout << "Looking for Ring Critical Points..." << endl;
    switch (ft) {
       case DENS:
@@ -336,13 +380,7 @@ void critPtNetWork::setCriticalPoints(ScalarFieldType ft)
 #if DEBUG
    cout << "nRCP: " << nRCP << ", dRCP: " << dRCP << endl;
 #endif
-   if (iknowrcps) {
-      dCCP=(nRCP*(nRCP-1))/2;
-      if ( dCCP<CPNW_MINARRAYSIZE ) {dCCP=CPNW_MINARRAYSIZE;}
-      alloc2DRealArray(string("RCCP"),dCCP,3,RCCP,1.0e+50);
-      alloc1DStringArray("lblCCP",dCCP,lblCCP);
-      alloc3DIntArray("conCCP",dCCP,2,CPNW_MAXRCPSCONNECTEDTOCCP,conCCP,-1);
-   }
+   if (iknowrcps) {allocXCPArrays('c',nRCP);}
    cout << "Looking for Cage Critical Points..." << endl;
    switch (ft) {
       case DENS:
@@ -360,6 +398,13 @@ void critPtNetWork::setCriticalPoints(ScalarFieldType ft)
    cout << "nCCP: " << nCCP << ", dCCP: " << dCCP << endl;
 #endif
    if ( mkextsearch ) {extendedSearchCPs();}
+   if ( mkgridsearch ) {
+      if ( ft==DENS ) {
+         gridSearchRhoCPs();
+      } else {
+         displayWarningMessage("The grid search is only implemented for the density.");
+      }
+   }
    iknowallcps=(iknowacps&&iknowbcps&&iknowrcps&&iknowccps);
    if (iknowallcps) {
       printScrCharLine('*');
@@ -375,7 +420,8 @@ void critPtNetWork::setBondPaths()
       return;
    }
    int npts;
-   alloc3DRealArray(string("RBGP"),dBCP,CPNW_ARRAYSIZEGRADPATH,3,RBGP);
+   solreal **tgp;
+   allocFlat2DRealArray(string("tgp"),maxPtsGP,3,tgp);
    cout << "Calculating Bond Gradient Paths..." << endl;
    //cout << "nBCP: " << nBCP << endl;
 #if USEPROGRESSBAR
@@ -383,18 +429,16 @@ void critPtNetWork::setBondPaths()
 #endif
    solreal hstep,rseed[3];
    hstep=CPNW_DEFAULTGRADIENTPATHS;
-   int arrsize=CPNW_ARRAYSIZEGRADPATH;
+   int arrsize=maxPtsGP;
    int at1,at2;
    for (int i=0; i<nBCP; i++) {
       for (int k=0; k<3; k++) {rseed[k]=RBCP[i][k];}
       at1=conBCP[i][0];
       at2=conBCP[i][1];
-      npts=findSingleRhoBondGradientPathRK5(at1,at2,hstep,arrsize,RBGP[i],rseed);
+      npts=findSingleRhoBondGradientPathRK5(at1,at2,hstep,arrsize,tgp,rseed);
       conBCP[i][2]=npts;
+      conBCP[i][3]=appendGradPath(tgp,npts);
       if (npts>0) {nBGP++;}
-      //for (int j=0; j<npts; j++) {
-      //   for (int k=0; k<3; k++) {RBGP[i][j][k]=RGP[j][k];}
-      //}
 #if USEPROGRESSBAR
       printProgressBar(int(100.0e0*solreal(i)/\
                solreal((nBCP>1) ? (nBCP-1) : 1 )));
@@ -404,6 +448,8 @@ void critPtNetWork::setBondPaths()
    printProgressBar(100);
    cout << endl;
 #endif
+   deallocFlat2DRealArray(tgp);
+   rebuildGradPathViews();
    if (nBGP!=nBCP) {displayWarningMessage("For some unknown reason nBGP!=nBCP...");}
    iknowbgps=true;
    iknowallgps=(iknowbgps&&iknowrgps&&iknowcgps);
@@ -416,9 +462,25 @@ bool critPtNetWork::setRhoACPs()
    string lbl;
    int sig;
    bool tmpbool=false;
+   int nsd=bn->nNuc;
+   solreal **xx,*ff,**gg;
+   int *sg;
+   allocSeedArrays(nsd,xx,ff,gg,sg);
+   for (int i=0; i<nsd; i++) {
+      for ( int j=0 ; j<3 ; j++ ) {xx[i][j]=bn->R[i][j];}
+   }
+   /* The promolecular density has a cusp at every nucleus, which is its maximum
+      (the gradient does not vanish there, hence no search is done).  */
+   const bool promol=wf->usesProMolecularDensity();
+   if ( !promol ) {seekCPsFromSeeds(-3,false,nsd,xx,ff,gg,sg);}
    for (int i=0; i<(bn->nNuc); i++) {
-      for ( int j=0 ; j<3 ; j++ ) {x[j]=bn->R[i][j];}
-      seekRhoACP(x,rho,g,sig);
+      if ( promol ) {
+         for ( int j=0 ; j<3 ; j++ ) {x[j]=bn->R[i][j];}
+         lbl=bn->atLbl[i];
+         addRhoACP(x,-3,lbl);
+         continue;
+      }
+      getSeedResult(i,xx,ff,gg,sg,x,rho,g,sig);
       magg=computeMagnitudeV3(g);
       if ( (rho>CPNW_MINRHOSIGNIFICATIVEVAL)&&(magg<CPNW_EPSRHOACPGRADMAG) ) {
          lbl=bn->atLbl[i];
@@ -442,23 +504,45 @@ bool critPtNetWork::setRhoACPs()
 #if USEPROGRESSBAR
    printProgressBar(0);
 #endif
+   deallocSeedArrays(nsd,xx,ff,gg,sg);
+   /* Every pair of close nuclei contributes CPNW_NPAIRACPSEEDS seeds (around the midpoint),
+      which are searched all at once, and then merged pair by pair.  */
    solreal xs[3],rad;
-   for ( int i=0 ; i<(bn->nNuc) ; i++ ) {
-      for ( int j=(i+1) ; j<(bn->nNuc) ; j++ ) {
-         for ( int k=0 ; k<3 ; k++ ) {xs[k]=(bn->R[i][k]-bn->R[j][k]);}
-         rad=computeMagnitudeV3(xs);
-         if ( rad<=(bn->maxBondDist) ) {
-            for ( int k=0 ; k<3 ; k++ ) {xs[k]=0.5e0*(bn->R[i][k]+bn->R[j][k]);}
-            lbl="NNACP";
-            rad*=0.3e0;
-            seekRhoACPsAroundAPoint(xs,rad,lbl,8);
+   int *pra,*prb,i,j;
+   int npairs=getClosePairs(bn->nNuc,bn->R,-1.0e0,(bn->maxBondDist),pra,prb);
+   nsd=npairs*CPNW_NPAIRACPSEEDS;
+   allocSeedArrays(nsd,xx,ff,gg,sg);
+   nsd=0;
+   for ( int p=0 ; p<npairs ; p++ ) {
+      i=pra[p];
+      j=prb[p];
+      for ( int k=0 ; k<3 ; k++ ) {xs[k]=(bn->R[i][k]-bn->R[j][k]);}
+      rad=computeMagnitudeV3(xs);
+      for ( int k=0 ; k<3 ; k++ ) {xs[k]=0.5e0*(bn->R[i][k]+bn->R[j][k]);}
+      rad*=0.3e0;
+      for ( int v=0 ; v<CPNW_NPAIRACPSEEDS ; v++ ) {
+         for ( int k=0 ; k<3 ; k++ ) {xx[nsd][k]=xs[k]+IHV[v][k]*rad;}
+         ++nsd;
+      }
+   }
+   dealloc1DIntArray(pra);
+   dealloc1DIntArray(prb);
+   seekCPsFromSeeds(-3,false,nsd,xx,ff,gg,sg);
+   for ( int p=0 ; p<npairs ; p++ ) {
+      lbl="NNACP1";
+      for ( int v=0 ; v<CPNW_NPAIRACPSEEDS ; v++ ) {
+         getSeedResult(p*CPNW_NPAIRACPSEEDS+v,xx,ff,gg,sg,x,rho,g,sig);
+         magg=computeMagnitudeV3(g);
+         if ( (rho>CPNW_MINRHOSIGNIFICATIVEVAL)&&(magg<CPNW_EPSRHOACPGRADMAG) ) {
+            if (addRhoACP(x,sig,lbl)) {++lbl[(lbl.length()-1)];}
          }
       }
 #if USEPROGRESSBAR
-      printProgressBar(int(100.0e0*solreal(i)/\
-               solreal((bn->nNuc > 1)? (bn->nNuc-1) : 1)));
+      printProgressBar(int(100.0e0*solreal(p)/\
+               solreal((npairs > 1)? (npairs-1) : 1)));
 #endif
    }
+   deallocSeedArrays(nsd,xx,ff,gg,sg);
 #if USEPROGRESSBAR
    printProgressBar(100);
    cout << endl;
@@ -478,34 +562,35 @@ bool critPtNetWork::setRhoBCPs(void)
 #if USEPROGRESSBAR
    printProgressBar(0);
 #endif
-   int ata,atb,k,sig;
+   int ata,atb,sig;
    int mypos;
    solreal x[3],g[3],rho;
    string lbl;
-   for (int i=0; i<(bn->nNuc); i++) {
-      ata=i;
-      atb=bn->bNet[ata][0];
-      k=1;
-      while ((k<MAXBONDINGATOMS)&&(atb>0)) {
-         for (int j=0; j<3; j++) {x[j]=0.5e0*(bn->R[ata][j]+bn->R[atb][j]);}
-         seekRhoBCP(x,rho,g,sig);
-         if (ata<atb) {
-            lbl=bn->atLbl[ata]+string("-")+bn->atLbl[atb];
-         } else {
-            lbl=bn->atLbl[atb]+string("-")+bn->atLbl[ata];
-         }
-         if (rho>CPNW_MINRHOSIGNIFICATIVEVAL&&addRhoBCP(x,sig,lbl,mypos)&&mypos>=0) {
-            conBCP[mypos][0]=ata;
-            conBCP[mypos][1]=atb;
-         }
-         atb=bn->bNet[ata][k];
-         ++k;
+   solreal **xx,*ff,**gg;
+   int *sg,*sda,*sdb;
+   int nsd=getBondedPairSeeds(sda,sdb,xx,ff,gg,sg);
+   seekCPsFromSeeds(-1,false,nsd,xx,ff,gg,sg);
+   for (int i=0; i<nsd; i++) {
+      ata=sda[i];
+      atb=sdb[i];
+      getSeedResult(i,xx,ff,gg,sg,x,rho,g,sig);
+      if (ata<atb) {
+         lbl=bn->atLbl[ata]+string("-")+bn->atLbl[atb];
+      } else {
+         lbl=bn->atLbl[atb]+string("-")+bn->atLbl[ata];
+      }
+      if (rho>CPNW_MINRHOSIGNIFICATIVEVAL&&addRhoBCP(x,sig,lbl,mypos)&&mypos>=0) {
+         conBCP[mypos][0]=ata;
+         conBCP[mypos][1]=atb;
       }
 #if USEPROGRESSBAR
       printProgressBar(int(100.0e0*solreal(i)/\
-               solreal((nACP>1)? (nACP-1) : 1)));
+               solreal((nsd>1)? (nsd-1) : 1)));
 #endif
    }
+   deallocSeedArrays(nsd,xx,ff,gg,sg);
+   dealloc1DIntArray(sda);
+   dealloc1DIntArray(sdb);
    normalbcp=nBCP;
 #if USEPROGRESSBAR
    printProgressBar(100);
@@ -533,33 +618,41 @@ bool critPtNetWork::setRhoBCPs(void)
 #if USEPROGRESSBAR
    printProgressBar(0);
 #endif
-   solreal extbd=(bn->maxBondDist*CPNW_EXTENDEDBONDDISTFACTOR),dd=0.0e0;
-   for (int i=0; i<nACP; i++) {
-      for (int j=(i+1); j<nACP; j++) {
-         for (int k=0; k<3; k++) {x[k]=((RACP[i][k]-RACP[j][k]));}
-         dd=computeMagnitudeV3(x);
-         if ((dd>=(bn->maxBondDist*0.9e0))&&(dd<=extbd)) {
-            for (int k=0; k<3; k++) {x[k]=0.5e0*(RACP[i][k]+RACP[j][k]);}
-            if ((wf->evalDensity(x[0],x[1],x[2])>CPNW_MINRHOSIGNIFICATIVEVAL)) {
-               seekRhoBCP(x,rho,g,sig);
-               if (i<j) {ata=i; atb=j;} else {ata=j; atb=i;}
-               lbl=string("*")+lblACP[ata]+string("-")+lblACP[atb];
-               wf->evalRhoGradRho(x[0],x[1],x[2],rho,g);
-               if ((rho>CPNW_MINRHOSIGNIFICATIVEVAL)&&(computeMagnitudeV3(g)<CPNW_EPSRHOACPGRADMAG)) {
-                  addRhoBCP(x,sig,lbl,mypos);
-                  if ((mypos>=0)&&(mypos<dBCP)) {
-                     conBCP[mypos][0]=ata;
-                     conBCP[mypos][1]=atb;
-                  }
-               }
-            }
+   solreal extbd=(bn->maxBondDist*CPNW_EXTENDEDBONDDISTFACTOR);
+   int npairs=getClosePairs(nACP,RACP,(bn->maxBondDist*0.9e0),extbd,sda,sdb);
+   allocSeedArrays(npairs,xx,ff,gg,sg);
+   nsd=0;
+   for (int p=0; p<npairs; p++) {
+      for (int k=0; k<3; k++) {x[k]=0.5e0*(RACP[sda[p]][k]+RACP[sdb[p]][k]);}
+      if ((wf->evalDensity(x[0],x[1],x[2])>CPNW_MINRHOSIGNIFICATIVEVAL)) {
+         for (int k=0; k<3; k++) {xx[nsd][k]=x[k];}
+         sda[nsd]=sda[p];
+         sdb[nsd]=sdb[p];
+         ++nsd;
+      }
+   }
+   seekCPsFromSeeds(-1,false,nsd,xx,ff,gg,sg);
+   for (int i=0; i<nsd; i++) {
+      getSeedResult(i,xx,ff,gg,sg,x,rho,g,sig);
+      ata=sda[i];
+      atb=sdb[i];
+      lbl=string("*")+lblACP[ata]+string("-")+lblACP[atb];
+      wf->evalRhoGradRho(x[0],x[1],x[2],rho,g);
+      if ((rho>CPNW_MINRHOSIGNIFICATIVEVAL)&&(computeMagnitudeV3(g)<CPNW_EPSRHOACPGRADMAG)) {
+         addRhoBCP(x,sig,lbl,mypos);
+         if ((mypos>=0)&&(mypos<dBCP)) {
+            conBCP[mypos][0]=ata;
+            conBCP[mypos][1]=atb;
          }
       }
 #if USEPROGRESSBAR
       printProgressBar(int(100.0e0*solreal(i)/\
-               solreal((nACP>1)? (nACP-1) : 1)));
+               solreal((nsd>1)? (nsd-1) : 1)));
 #endif
    }
+   deallocSeedArrays(npairs,xx,ff,gg,sg);
+   dealloc1DIntArray(sda);
+   dealloc1DIntArray(sdb);
 #if USEPROGRESSBAR
    printProgressBar(100);
    cout << endl;
@@ -586,28 +679,32 @@ bool critPtNetWork::setRhoRCPs(void)
 {
    solreal x[3],rho,g[3];
    string lbl;
-   int sig,mypos;
-   for (int i=0; i<nBCP; i++) {
-      for (int j=(i+1); j<nBCP; j++) {
-         for (int k=0; k<3; k++) {x[k]=(RBCP[i][k]-RBCP[j][k]);}
-         if (computeMagnitudeV3(x)>(bn->maxBondDist*2.0e0)) {continue;}
-         for ( int k=0 ; k<3 ; k++ ) {x[k]=0.5e0*(RBCP[i][k]+RBCP[j][k]);}
-         seekRhoRCP(x,rho,g,sig);
-         lbl=(lblBCP[i]+string("-")+lblBCP[j]);
-         //wf->evalRhoGradRho(x[0],x[1],x[2],rho,g);
-         if ((rho>CPNW_MINRHOSIGNIFICATIVEVAL)&&(computeMagnitudeV3(g)<CPNW_EPSRHOACPGRADMAG)) {
-            addRhoRCP(x,sig,lbl,mypos);
-            if (mypos>=0) {
-               addBCP2ConRCP(mypos,i);
-               addBCP2ConRCP(mypos,j);
-            }  
-         }
+   int sig,mypos,ii,jj;
+   solreal **xx,*ff,**gg;
+   int *sg,*sda,*sdb;
+   int nsd=getCPPairSeeds(nBCP,RBCP,(bn->maxBondDist*2.0e0),sda,sdb,xx,ff,gg,sg);
+   seekCPsFromSeeds(1,false,nsd,xx,ff,gg,sg);
+   for (int i=0; i<nsd; i++) {
+      getSeedResult(i,xx,ff,gg,sg,x,rho,g,sig);
+      ii=sda[i];
+      jj=sdb[i];
+      lbl=(lblBCP[ii]+string("-")+lblBCP[jj]);
+      //wf->evalRhoGradRho(x[0],x[1],x[2],rho,g);
+      if ((rho>CPNW_MINRHOSIGNIFICATIVEVAL)&&(computeMagnitudeV3(g)<CPNW_EPSRHOACPGRADMAG)) {
+         addRhoRCP(x,sig,lbl,mypos);
+         if (mypos>=0) {
+            addBCP2ConRCP(mypos,ii);
+            addBCP2ConRCP(mypos,jj);
+         }  
       }
 #if USEPROGRESSBAR
       printProgressBar(int(100.0e0*solreal(i)/\
-               solreal((nBCP>1)? (nBCP-1) : 1)));
+               solreal((nsd>1)? (nsd-1) : 1)));
 #endif
    }
+   deallocSeedArrays(nsd,xx,ff,gg,sg);
+   dealloc1DIntArray(sda);
+   dealloc1DIntArray(sdb);
 #if USEPROGRESSBAR
    printProgressBar(100);
    cout << endl;
@@ -629,27 +726,33 @@ bool critPtNetWork::setRhoCCPs(void)
 #if USEPROGRESSBAR
    printProgressBar(0);
 #endif
-   for (int i=0; i<nRCP; i++) {
-      for (int j=(i+1); j<nRCP; j++) {
-         for (int k=0; k<3; k++) {x[k]=(RRCP[i][k]-RRCP[j][k]);}
-         if (computeMagnitudeV3(x)>(bn->maxBondDist*CPNW_BONDISTEXTCCPSEARCHFACTOR)) {continue;}
-         for (int k=0; k<3; k++) {x[k]=0.5e0*(RRCP[i][k]+RRCP[j][k]);}
-         seekRhoCCP(x,rho,g,sig);
-         lbl=(lblRCP[i]+string("-")+lblRCP[j]);
-         wf->evalRhoGradRho(x[0],x[1],x[2],rho,g);
-         if ((rho>CPNW_MINRHOSIGNIFICATIVEVAL)&&(computeMagnitudeV3(g)<CPNW_EPSRHOACPGRADMAG)) {
-            addRhoCCP(x,sig,lbl,mypos);
-            if (mypos>=0) {
-               addRCP2ConCCP(mypos,i);
-               addRCP2ConCCP(mypos,j);
-            } 
-         }
+   int ii,jj;
+   solreal **xx,*ff,**gg;
+   int *sg,*sda,*sdb;
+   int nsd=getCPPairSeeds(nRCP,RRCP,(bn->maxBondDist*CPNW_BONDISTEXTCCPSEARCHFACTOR),\
+         sda,sdb,xx,ff,gg,sg);
+   seekCPsFromSeeds(3,false,nsd,xx,ff,gg,sg);
+   for (int i=0; i<nsd; i++) {
+      getSeedResult(i,xx,ff,gg,sg,x,rho,g,sig);
+      ii=sda[i];
+      jj=sdb[i];
+      lbl=(lblRCP[ii]+string("-")+lblRCP[jj]);
+      wf->evalRhoGradRho(x[0],x[1],x[2],rho,g);
+      if ((rho>CPNW_MINRHOSIGNIFICATIVEVAL)&&(computeMagnitudeV3(g)<CPNW_EPSRHOACPGRADMAG)) {
+         addRhoCCP(x,sig,lbl,mypos);
+         if (mypos>=0) {
+            addRCP2ConCCP(mypos,ii);
+            addRCP2ConCCP(mypos,jj);
+         } 
       }
 #if USEPROGRESSBAR
       printProgressBar(int(100.0e0*solreal(i)/\
-               solreal((nRCP>0)? (nRCP) : 1)));
+               solreal((nsd>1)? (nsd-1) : 1)));
 #endif
    }
+   deallocSeedArrays(nsd,xx,ff,gg,sg);
+   dealloc1DIntArray(sda);
+   dealloc1DIntArray(sdb);
 #if USEPROGRESSBAR
    printProgressBar(100);
    cout << endl;
@@ -669,9 +772,16 @@ bool critPtNetWork::setLOLACPs()
    string lbl;
    int sig;
    bool tmpbool=false;
+   int nsd=bn->nNuc;
+   solreal **xx,*ff,**gg;
+   int *sg;
+   allocSeedArrays(nsd,xx,ff,gg,sg);
+   for (int i=0; i<nsd; i++) {
+      for ( int j=0 ; j<3 ; j++ ) {xx[i][j]=bn->R[i][j];}
+   }
+   seekCPsFromSeeds(-3,true,nsd,xx,ff,gg,sg);
    for (int i=0; i<(bn->nNuc); i++) {
-      for ( int j=0 ; j<3 ; j++ ) {x[j]=bn->R[i][j];}
-      seekLOLACP(x,rho,g,sig);
+      getSeedResult(i,xx,ff,gg,sg,x,rho,g,sig);
       magg=computeMagnitudeV3(g);
       if ( (rho>CPNW_MINRHOSIGNIFICATIVEVAL)&&(magg<CPNW_EPSLOLACPGRADMAG) ) {
          lbl=bn->atLbl[i];
@@ -684,6 +794,7 @@ bool critPtNetWork::setLOLACPs()
       }
 
    }
+   deallocSeedArrays(nsd,xx,ff,gg,sg);
    if ( tmpbool ) {
       displayWarningMessage("Some ACPs presented |nabla rho|!= 0... Look for '+' in labels.");
    }
@@ -696,18 +807,20 @@ bool critPtNetWork::setLOLACPs()
 #if USEPROGRESSBAR
    printProgressBar(0);
 #endif
-   solreal xs[3],rad;
+   solreal xs[3],**oo,*rad;
+   string *blbl;
+   alloc2DRealArray(string("oo"),(bn->nNuc),3,oo);
+   alloc1DRealArray(string("rad"),(bn->nNuc),rad);
+   alloc1DStringArray(string("blbl"),(bn->nNuc),blbl);
    for ( int i=0 ; i<(bn->nNuc) ; i++ ) {
-         for ( int k=0 ; k<3 ; k++ ) {xs[k]=(bn->R[i][k]);}
-         rad=computeMagnitudeV3(xs);
-         lbl="NNLOLACP"+getStringFromInt(i);
-         rad*=0.01e0;
-         seekLOLACPsAroundAPoint(xs,rad,lbl,-1);
-#if USEPROGRESSBAR
-         printProgressBar(int(100.0e0*solreal(i)/\
-                  solreal((bn->nNuc > 1)? (bn->nNuc-1) : 1)));
-#endif
-   }
+      for ( int k=0 ; k<3 ; k++ ) {oo[i][k]=xs[k]=(bn->R[i][k]);}
+      rad[i]=0.01e0*computeMagnitudeV3(xs);
+      blbl[i]="NNLOLACP"+getStringFromInt(i);
+   }
+   seekLOLACPsAroundPoints((bn->nNuc),oo,rad,blbl,-1);
+   dealloc2DRealArray(oo,(bn->nNuc));
+   dealloc1DRealArray(rad);
+   dealloc1DStringArray(blbl);
 #if USEPROGRESSBAR
    printProgressBar(100);
    cout << endl;
@@ -718,23 +831,27 @@ bool critPtNetWork::setLOLACPs()
 #if USEPROGRESSBAR
    printProgressBar(0);
 #endif
-   //solreal xs[3],rad;
-   for ( int i=0 ; i<(bn->nNuc) ; i++ ) {
-      for ( int j=(i+1) ; j<(bn->nNuc) ; j++ ) {
+   int *pra,*prb,i,j;
+   int npairs=getClosePairs(bn->nNuc,bn->R,-1.0e0,(2.0e0*bn->maxBondDist),pra,prb);
+   if ( npairs>0 ) {
+      alloc2DRealArray(string("oo"),npairs,3,oo);
+      alloc1DRealArray(string("rad"),npairs,rad);
+      alloc1DStringArray(string("blbl"),npairs,blbl);
+      for ( int p=0 ; p<npairs ; p++ ) {
+         i=pra[p];
+         j=prb[p];
          for ( int k=0 ; k<3 ; k++ ) {xs[k]=(bn->R[i][k]-bn->R[j][k]);}
-         rad=computeMagnitudeV3(xs);
-         if ( rad<=(2.0e0*bn->maxBondDist) ) {
-            for ( int k=0 ; k<3 ; k++ ) {xs[k]=0.5e0*(bn->R[i][k]+bn->R[j][k]);}
-            lbl="NNLOLACP"+getStringFromInt((i+1));
-            rad*=0.1e0;
-            seekLOLACPsAroundAPoint(xs,rad,lbl,-1);
-         }
+         rad[p]=0.1e0*computeMagnitudeV3(xs);
+         for ( int k=0 ; k<3 ; k++ ) {oo[p][k]=0.5e0*(bn->R[i][k]+bn->R[j][k]);}
+         blbl[p]="NNLOLACP"+getStringFromInt((i+1));
       }
-#if USEPROGRESSBAR
-      printProgressBar(int(100.0e0*solreal(i)/\
-               solreal((bn->nNuc > 1)? (bn->nNuc-1) : 1)));
-#endif
+      seekLOLACPsAroundPoints(npairs,oo,rad,blbl,-1);
+      dealloc2DRealArray(oo,npairs);
+      dealloc1DRealArray(rad);
+      dealloc1DStringArray(blbl);
    }
+   dealloc1DIntArray(pra);
+   dealloc1DIntArray(prb);
 #if USEPROGRESSBAR
    printProgressBar(100);
    cout << endl;
@@ -755,34 +872,35 @@ bool critPtNetWork::setLOLBCPs(void)
 #if USEPROGRESSBAR
    printProgressBar(0);
 #endif
-   int ata,atb,k,sig;
+   int ata,atb,sig;
    int mypos;
    solreal x[3],g[3],rho;
    string lbl;
-   for (int i=0; i<(bn->nNuc); i++) {
-      ata=i;
-      atb=bn->bNet[ata][0];
-      k=1;
-      while ((k<MAXBONDINGATOMS)&&(atb>0)) {
-         for (int j=0; j<3; j++) {x[j]=0.5e0*(bn->R[ata][j]+bn->R[atb][j]);}
-         seekLOLBCP(x,rho,g,sig);
-         if (ata<atb) {
-            lbl=bn->atLbl[ata]+string("-")+bn->atLbl[atb];
-         } else {
-            lbl=bn->atLbl[atb]+string("-")+bn->atLbl[ata];
-         }
-         if (addRhoBCP(x,sig,lbl,mypos)&&mypos>=0) {
-            conBCP[mypos][0]=ata;
-            conBCP[mypos][1]=atb;
-         }
-         atb=bn->bNet[ata][k];
-         ++k;
+   solreal **xx,*ff,**gg;
+   int *sg,*sda,*sdb;
+   int nsd=getBondedPairSeeds(sda,sdb,xx,ff,gg,sg);
+   seekCPsFromSeeds(-1,true,nsd,xx,ff,gg,sg);
+   for (int i=0; i<nsd; i++) {
+      ata=sda[i];
+      atb=sdb[i];
+      getSeedResult(i,xx,ff,gg,sg,x,rho,g,sig);
+      if (ata<atb) {
+         lbl=bn->atLbl[ata]+string("-")+bn->atLbl[atb];
+      } else {
+         lbl=bn->atLbl[atb]+string("-")+bn->atLbl[ata];
+      }
+      if (addRhoBCP(x,sig,lbl,mypos)&&mypos>=0) {
+         conBCP[mypos][0]=ata;
+         conBCP[mypos][1]=atb;
       }
 #if USEPROGRESSBAR
       printProgressBar(int(100.0e0*solreal(i)/\
-               solreal((nACP>1)? (nACP-1) : 1)));
+               solreal((nsd>1)? (nsd-1) : 1)));
 #endif
    }
+   deallocSeedArrays(nsd,xx,ff,gg,sg);
+   dealloc1DIntArray(sda);
+   dealloc1DIntArray(sdb);
    normalbcp=nBCP;
 #if USEPROGRESSBAR
    printProgressBar(100);
@@ -877,6 +995,7 @@ bool critPtNetWork::setLOLCCPs(void)
 bool critPtNetWork::addRhoACP(solreal (&x)[3],int sig,string &lbl)
 {
    if ( sig!=-3 ) {return false;}
+   if ( !reserveXCPArrays('a',nACP) ) {return false;}
    if (nACP==0) {
       for (int i=0; i<3; i++) {RACP[0][i]=x[i];}
       lblACP[0]=lbl;
@@ -888,7 +1007,7 @@ bool critPtNetWork::addRhoACP(solreal (&x)[3],int sig,string &lbl)
    //if ((x[1]<bn->bbmin[1])||(x[1]>bn->bbmax[1])) {cout << "Out of box (y)...\n"; return false;}
    //if ((x[2]<bn->bbmin[2])||(x[2]>bn->bbmax[2])) {cout << "Out of box (z)...\n"; return false;}
    size_t pos;
-   if (imNew(x,dACP,RACP,pos)) {
+   if (imNew(x,RACP,gridACP,nACP,pos)) {
       for (int i=0; i<3; i++) {RACP[pos][i]=x[i];}
       lblACP[pos]=lbl;
       //(lbl[lbl.length()-1])++;
@@ -904,6 +1023,10 @@ bool critPtNetWork::addRhoBCP(solreal (&x)[3],int sig,string &lbl,int &pos)
       pos=-1;
       return false;
    }
+   if ( !reserveXCPArrays('b',nBCP) ) {
+      pos=-1;
+      return false;
+   }
    if (nBCP==0) {
       for (int i=0; i<3; i++) {RBCP[0][i]=x[i];}
       lblBCP[0]=lbl;
@@ -916,7 +1039,7 @@ bool critPtNetWork::addRhoBCP(solreal (&x)[3],int sig,string &lbl,int &pos)
    //if ((x[1]<bn->bbmin[1])||(x[1]>bn->bbmax[1])) {cout << "Out of box (y)...\n"; return false;}
    //if ((x[2]<bn->bbmin[2])||(x[2]>bn->bbmax[2])) {cout << "Out of box (z)...\n"; return false;}
    size_t ttpos;
-   if (imNew(x,dBCP,RBCP,ttpos)) {
+   if (imNew(x,RBCP,gridBCP,nBCP,ttpos)) {
       for (int i=0; i<3; i++) {RBCP[ttpos][i]=x[i];}
       lblBCP[ttpos]=lbl;
       ++nBCP;
@@ -932,6 +1055,10 @@ bool critPtNetWork::addRhoRCP(solreal (&x)[3],int sig,string &lbl,int &pos)
       pos=-1;
       return false;
    }
+   if ( !reserveXCPArrays('r',nRCP) ) {
+      pos=-1;
+      return false;
+   }
    if (nRCP==0) {
       for (int i=0; i<3; i++) {RRCP[0][i]=x[i];}
       lblRCP[0]=lbl;
@@ -944,7 +1071,7 @@ bool critPtNetWork::addRhoRCP(solreal (&x)[3],int sig,string &lbl,int &pos)
    //if ((x[1]<bn->bbmin[1])||(x[1]>bn->bbmax[1])) {cout << "Out of box (y)...\n"; return false;}
    //if ((x[2]<bn->bbmin[2])||(x[2]>bn->bbmax[2])) {cout << "Out of box (z)...\n"; return false;}
    size_t ttpos;
-   if (imNew(x,dRCP,RRCP,ttpos)) {
+   if (imNew(x,RRCP,gridRCP,nRCP,ttpos)) {
       for (int i=0; i<3; i++) {RRCP[ttpos][i]=x[i];}
       lblRCP[ttpos]=lbl;
       ++nRCP;
@@ -965,6 +1092,10 @@ bool critPtNetWork::addRhoCCP(solreal (&x)[3],int sig,string &lbl,int &pos)
       pos=-1;
       return false;
    }
+   if ( !reserveXCPArrays('c',nCCP) ) {
+      pos=-1;
+      return false;
+   }
    if (nCCP==0) {
       for (int i=0; i<3; i++) {RCCP[0][i]=x[i];}
       lblCCP[0]=lbl;
@@ -977,7 +1108,7 @@ bool critPtNetWork::addRhoCCP(solreal (&x)[3],int sig,string &lbl,int &pos)
    //if ((x[1]<bn->bbmin[1])||(x[1]>bn->bbmax[1])) {cout << "Out of box (y)...\n"; return false;}
    //if ((x[2]<bn->bbmin[2])||(x[2]>bn->bbmax[2])) {cout << "Out of box (z)...\n"; return false;}
    size_t ttpos;
-   if (imNew(x,dCCP,RCCP,ttpos)) {
+   if (imNew(x,RCCP,gridCCP,nCCP,ttpos)) {
       for (int i=0; i<3; i++) {RCCP[ttpos][i]=x[i];}
       lblCCP[ttpos]=lbl;
       ++nCCP;
@@ -1102,52 +1233,96 @@ void critPtNetWork::seekRhoBCPWithExtraACP(int acppos,solreal maxrad)
 /* ************************************************************************************ */
 void critPtNetWork::seekLOLBCPWithExtraACP(int acppos,solreal maxrad)
 {
-   solreal xx[3],lol,g[3],hl[3][3];
+   solreal x[3],lol,g[3];
    int sig;
    string lbl="";
    int mypos=-1;
+   /* The midpoints between the ACP acppos and its neighbours are collected first,
+      and then all the searches are done at once.  */
+   solreal **xx,*ff,**gg;
+   int *sg,*nbr,nsd=0;
+   allocSeedArrays(nACP,xx,ff,gg,sg);
+   alloc1DIntArray(string("nbr"),nACP,nbr);
    for ( int i=0 ; i<nACP ; i++ ) {
       if ( i==acppos ) {continue;}
-      for ( int k=0 ; k<3 ; k++ ) {xx[k]=(RACP[acppos][k]-RACP[i][k]);}
-      if ( computeMagnitudeV3(xx)<=maxrad ) {
-         for (int k=0; k<3; k++) {xx[k]=0.5e0*(RACP[i][k]+RACP[acppos][k]);}
-         if ((wf->evalDensity(xx[0],xx[1],xx[2])>CPNW_MINRHOSIGNIFICATIVEVAL)) {
-            seekLOLBCP(xx,lol,g,sig);
-            if (i<acppos) {
-               lbl=string("*")+lblACP[i]+string("-")+lblACP[acppos];
-            } else {
-               lbl=string("*")+lblACP[acppos]+string("-")+lblACP[i];
-            }
-            wf->evalHessLOL(xx,lol,g,hl);
-            if (computeMagnitudeV3(g)<CPNW_EPSLOLACPGRADMAG) {
-               addRhoBCP(xx,sig,lbl,mypos);
-               if ((mypos>=0)&&(mypos<dBCP)) {
-                  conBCP[mypos][0]=i;
-                  conBCP[mypos][1]=acppos;
-               }
-            }
+      for ( int k=0 ; k<3 ; k++ ) {x[k]=(RACP[acppos][k]-RACP[i][k]);}
+      if ( computeMagnitudeV3(x)<=maxrad ) {
+         for (int k=0; k<3; k++) {x[k]=0.5e0*(RACP[i][k]+RACP[acppos][k]);}
+         if ((wf->evalDensity(x[0],x[1],x[2])>CPNW_MINRHOSIGNIFICATIVEVAL)) {
+            for ( int k=0 ; k<3 ; k++ ) {xx[nsd][k]=x[k];}
+            nbr[nsd++]=i;
+         }
+      }
+   }
+   seekCPsFromSeeds(-1,true,nsd,xx,ff,gg,sg);
+   int i;
+   for ( int s=0 ; s<nsd ; s++ ) {
+      i=nbr[s];
+      getSeedResult(s,xx,ff,gg,sg,x,lol,g,sig);
+      if (i<acppos) {
+         lbl=string("*")+lblACP[i]+string("-")+lblACP[acppos];
+      } else {
+         lbl=string("*")+lblACP[acppos]+string("-")+lblACP[i];
+      }
+      if (computeMagnitudeV3(g)<CPNW_EPSLOLACPGRADMAG) {
+         addRhoBCP(x,sig,lbl,mypos);
+         if ((mypos>=0)&&(mypos<dBCP)) {
+            conBCP[mypos][0]=i;
+            conBCP[mypos][1]=acppos;
          }
       }
    }
+   deallocSeedArrays(nACP,xx,ff,gg,sg);
+   dealloc1DIntArray(nbr);
 }
 /* ************************************************************************************ */
 void critPtNetWork::seekLOLACPsAroundAPoint(solreal const (&oo)[3],solreal const ddxx,\
       string const &blbl,int uunvrt)
 {
+   solreal **pp,*rr;
+   string *ll;
+   alloc2DRealArray(string("pp"),1,3,pp);
+   alloc1DRealArray(string("rr"),1,rr);
+   alloc1DStringArray(string("ll"),1,ll);
+   for ( int k=0 ; k<3 ; k++ ) {pp[0][k]=oo[k];}
+   rr[0]=ddxx;
+   ll[0]=blbl;
+   seekLOLACPsAroundPoints(1,pp,rr,ll,uunvrt);
+   dealloc2DRealArray(pp,1);
+   dealloc1DRealArray(rr);
+   dealloc1DStringArray(ll);
+}
+/* ************************************************************************************ */
+void critPtNetWork::seekLOLACPsAroundPoints(const int npt,solreal ** (&oo),\
+      solreal * (&ddxx),string * (&blbl),int uunvrt)
+{
+   if ( npt<1 ) {return;}
    int nvrt=uunvrt;
    if ( uunvrt>nIHV || uunvrt<1 ) {nvrt=nIHV;}
-   solreal xx[3],rho,gg[3],magg;
+   solreal x[3],lol,g[3],magg;
    int sig;
-   string lbl=blbl;
-   lbl.append("1");
-   for ( int i=0 ; i<nvrt ; i++ ) {
-      for ( int k=0 ; k<3 ; k++ ) {xx[k]=oo[k]+IHV[i][k]*ddxx;}
-      seekLOLACP(xx,rho,gg,sig);
-      magg=computeMagnitudeV3(gg);
-      if ( /*(rho>CPNW_MINLOLSIGNIFICATIVEVAL)&&*/(magg<CPNW_EPSLOLACPGRADMAG) ) {
-         if (addRhoACP(xx,sig,lbl)) {++lbl[(lbl.length()-1)];}
+   string lbl;
+   solreal **xx,*ff,**gg;
+   int *sg,nsd=npt*nvrt;
+   allocSeedArrays(nsd,xx,ff,gg,sg);
+   for ( int p=0 ; p<npt ; p++ ) {
+      for ( int i=0 ; i<nvrt ; i++ ) {
+         for ( int k=0 ; k<3 ; k++ ) {xx[p*nvrt+i][k]=oo[p][k]+IHV[i][k]*ddxx[p];}
       }
    }
+   seekCPsFromSeeds(-3,true,nsd,xx,ff,gg,sg);
+   for ( int p=0 ; p<npt ; p++ ) {
+      lbl=blbl[p];
+      lbl.append("1");
+      for ( int i=0 ; i<nvrt ; i++ ) {
+         getSeedResult(p*nvrt+i,xx,ff,gg,sg,x,lol,g,sig);
+         magg=computeMagnitudeV3(g);
+         if ( /*(lol>CPNW_MINLOLSIGNIFICATIVEVAL)&&*/(magg<CPNW_EPSLOLACPGRADMAG) ) {
+            if (addRhoACP(x,sig,lbl)) {++lbl[(lbl.length()-1)];}
+         }
+      }
+   }
+   deallocSeedArrays(nsd,xx,ff,gg,sg);
 }
 /* ************************************************************************************ */
 void critPtNetWork::seekLOLACPsOnASphere(int atIdx,int nDivR,int nDivT,int nDivP,\
@@ -1160,7 +1335,7 @@ void critPtNetWork::seekLOLACPsOnASphere(int atIdx,int nDivR,int nDivT,int nDivP
    }
    cout << "Looking for LOL ACPs around atom " << (atIdx+1) << "(" 
         << wf->atLbl[atIdx] << ")" << endl;
-   solreal xx[3],lol,gl[3];
+   solreal x[3],lol,gl[3];
    int sig,nseeds,count;
    string blbl="LOLACPSp"+getStringFromInt(atIdx+1)+"*",lbl;
    solreal cc[3],dr,dt,dp,currr,currt,currp;
@@ -1175,27 +1350,30 @@ void critPtNetWork::seekLOLACPsOnASphere(int atIdx,int nDivR,int nDivT,int nDivP
 #if USEPROGRESSBAR
    printProgressBar(0);
 #endif
+   solreal **xx,*ff,**gg;
+   int *sg;
+   allocSeedArrays(nseeds,xx,ff,gg,sg);
    for ( int ir=0 ; ir<nDivR ; ir++ ) {
       currr=radmin+solreal(ir)*dr;
       for ( int it=0 ; it<nDivT ; it++ ) {
          currt=(dt*solreal(it));
          for ( int ip=0 ; ip<nDivP ; ip++ ) {
             currp=dp*solreal(ip);
-            xx[0]=cc[0]+currr*sin(currt)*cos(currp);
-            xx[1]=cc[1]+currr*sin(currt)*sin(currp);
-            xx[2]=cc[2]+currr*cos(currt);
-            seekLOLACP(xx,lol,gl,sig);
-            if ( computeMagnitudeV3(gl)<CPNW_EPSLOLACPGRADMAG ) {
-               if (addRhoACP(xx,sig,lbl)){lbl=blbl+getStringFromInt(++idxLbl);}
-            }
+            xx[count][0]=cc[0]+currr*sin(currt)*cos(currp);
+            xx[count][1]=cc[1]+currr*sin(currt)*sin(currp);
+            xx[count][2]=cc[2]+currr*cos(currt);
             ++count;
          }
       }
-#if USEPROGRESSBAR
-      printProgressBar(int(100.0e0*solreal(count)/\
-               solreal((nseeds>1) ? (nseeds-1) : 1)));
-#endif
    }
+   seekCPsFromSeeds(-3,true,nseeds,xx,ff,gg,sg);
+   for ( int i=0 ; i<nseeds ; i++ ) {
+      getSeedResult(i,xx,ff,gg,sg,x,lol,gl,sig);
+      if ( computeMagnitudeV3(gl)<CPNW_EPSLOLACPGRADMAG ) {
+         if (addRhoACP(x,sig,lbl)){lbl=blbl+getStringFromInt(++idxLbl);}
+      }
+   }
+   deallocSeedArrays(nseeds,xx,ff,gg,sg);
 #if USEPROGRESSBAR
    printProgressBar(100);
    cout << endl;
@@ -1303,6 +1481,422 @@ void critPtNetWork::extendedSearchCPs(void)
    }
 }
 /* ************************************************************************************ */
+void critPtNetWork::gridSearchRhoCPs(void)
+{
+   if ( !iknowacps ) {
+      displayErrorMessage("Please look first for the ACPs...\nNothing to be done!");
+      return;
+   }
+   int initacp=nACP,initbcp=nBCP,initrcp=nRCP,initccp=nCCP;
+   /* addRhoRCP and addRhoCCP extend the labels of the CPs found again; the labels
+      of the CPs known before the grid search are restored at the end.  */
+   string *oldlblr=NULL,*oldlblc=NULL;
+   alloc1DStringArray(string("oldlblr"),((nRCP>0)? nRCP : 1),oldlblr);
+   alloc1DStringArray(string("oldlblc"),((nCCP>0)? nCCP : 1),oldlblc);
+   for ( int i=0 ; i<nRCP ; i++ ) {oldlblr[i]=lblRCP[i];}
+   for ( int i=0 ; i<nCCP ; i++ ) {oldlblc[i]=lblCCP[i];}
+   solreal **oo,**sd,**sus=NULL,*vals;
+   int nn[3],nb=1,nsd,nsus;
+   solreal hh=gridSearchH;
+   allocFlat2DRealArray(string("oo"),1,3,oo);
+   for ( int k=0 ; k<3 ; k++ ) {
+      solreal xmin=bn->R[0][k],xmax=bn->R[0][k];
+      for ( int i=1 ; i<(bn->nNuc) ; i++ ) {
+         if ( bn->R[i][k]<xmin ) {xmin=bn->R[i][k];}
+         if ( bn->R[i][k]>xmax ) {xmax=bn->R[i][k];}
+      }
+      oo[0][k]=xmin-CPNW_GRIDSEARCHMARGIN;
+      nn[k]=int(ceil((xmax-xmin+2.0e0*CPNW_GRIDSEARCHMARGIN)/hh))+1;
+   }
+   cout << "Grid search of CPs (" << nn[0] << "x" << nn[1] << "x" << nn[2]
+        << " points, spacing: " << hh << ")..." << endl;
+   int phsum=0;
+   for ( int lev=0 ; lev<=CPNW_GRIDSEARCHMAXLEVELS ; lev++ ) {
+      evalRhoGradOnGridBlocks(nb,oo,hh,nn,vals);
+      collectGridCells(nb,oo,hh,nn,vals,nsd,sd,nsus,sus);
+      dealloc1DRealArray(vals);
+      deallocFlat2DRealArray(oo);
+      seekRhoCPsFromGridSeeds(nsd,sd);
+      deallocFlat2DRealArray(sd);
+      phsum=nACP-nBCP+nRCP-nCCP;
+      cout << "  Level " << lev << ": " << nsd << " seeds, nACP-nBCP+nRCP-nCCP = "
+           << phsum << endl;
+      if ( phsum==1 || lev==CPNW_GRIDSEARCHMAXLEVELS || nsus==0 ) {break;}
+      /* The Poincare-Hopf relation fails: the cells that may hide a CP are
+         split into 2x2x2 cells, and searched again.  */
+      oo=sus;
+      sus=NULL;
+      nb=nsus;
+      hh*=0.5e0;
+      nn[0]=nn[1]=nn[2]=3;
+      cout << "  Refining " << nb << " cells (spacing: " << hh << ")..." << endl;
+   }
+   deallocFlat2DRealArray(sus);
+   if ( phsum!=1 ) {
+      displayWarningMessage("The Poincare-Hopf relation is not satisfied!");
+   }
+   solreal tbcp[3];
+   int ata,atb;
+   for ( int i=initbcp ; i<nBCP ; i++ ) {
+      for ( int k=0 ; k<3 ; k++ ) {tbcp[k]=RBCP[i][k];}
+      findTwoClosestACPs(tbcp,ata,atb);
+      conBCP[i][0]=ata;
+      conBCP[i][1]=atb;
+      lblBCP[i]="*"+lblACP[ata]+"-"+lblACP[atb];
+   }
+   for ( int i=0 ; i<initrcp ; i++ ) {lblRCP[i]=oldlblr[i];}
+   for ( int i=0 ; i<initccp ; i++ ) {lblCCP[i]=oldlblc[i];}
+   for ( int i=initrcp ; i<nRCP ; i++ ) {removeRedundInLabel(lblRCP[i]);}
+   for ( int i=initccp ; i<nCCP ; i++ ) {removeRedundInLabel(lblCCP[i]);}
+   dealloc1DStringArray(oldlblr);
+   dealloc1DStringArray(oldlblc);
+   if ( initacp<nACP ) {cout << "Found " << (nACP-initacp) << " new ACPs." << endl;}
+   if ( initbcp<nBCP ) {cout << "Found " << (nBCP-initbcp) << " new BCPs." << endl;}
+   if ( initrcp<nRCP ) {cout << "Found " << (nRCP-initrcp) << " new RCPs." << endl;}
+   if ( initccp<nCCP ) {cout << "Found " << (nCCP-initccp) << " new CCPs." << endl;}
+}
+/* ************************************************************************************ */
+void critPtNetWork::evalRhoGradOnGridBlocks(const int nb,solreal ** (&oo),\
+      const solreal hh,const int (&nn)[3],solreal * (&vals))
+{
+   const int ntot=nb*nn[0]*nn[1]*nn[2];
+   alloc1DRealArray(string("vals"),4*ntot,vals);
+#if PARALLELISEDTK
+#pragma omp parallel if(ntot>1)
+   {
+      GaussWaveFunction twf;
+      GaussWaveFunction *pwf=wf;
+      if ( omp_get_thread_num()>0 ) {
+         twf.shareDataFrom(*wf);
+         pwf=&twf;
+      }
+#pragma omp for schedule(dynamic,64)
+      for ( int n=0 ; n<ntot ; n++ ) {
+         evalRhoGradOnGridNode(*pwf,n,oo,hh,nn,vals);
+      }
+   }
+#else
+   for ( int n=0 ; n<ntot ; n++ ) {
+      evalRhoGradOnGridNode(*wf,n,oo,hh,nn,vals);
+   }
+#endif
+}
+/* ************************************************************************************ */
+void critPtNetWork::evalRhoGradOnGridNode(GaussWaveFunction &twf,const int n,\
+      solreal ** (&oo),const solreal hh,const int (&nn)[3],solreal * (&vals))
+{
+   const int npb=nn[0]*nn[1]*nn[2];
+   int b=n/npb,m=n%npb;
+   int i=m/(nn[1]*nn[2]),j=(m/nn[2])%nn[1],k=m%nn[2];
+   solreal g[3];
+   twf.evalRhoGradRho(oo[b][0]+solreal(i)*hh,oo[b][1]+solreal(j)*hh,\
+         oo[b][2]+solreal(k)*hh,vals[4*n],g);
+   for ( int l=0 ; l<3 ; l++ ) {vals[4*n+1+l]=g[l];}
+}
+/* ************************************************************************************ */
+int critPtNetWork::classifyGridCell(solreal * (&vals),const int (&cn)[8])
+{
+   solreal gmin[3],gmax[3],rmax=vals[4*cn[0]],gv;
+   for ( int k=0 ; k<3 ; k++ ) {gmin[k]=gmax[k]=vals[4*cn[0]+1+k];}
+   for ( int c=1 ; c<8 ; c++ ) {
+      if ( vals[4*cn[c]]>rmax ) {rmax=vals[4*cn[c]];}
+      for ( int k=0 ; k<3 ; k++ ) {
+         gv=vals[4*cn[c]+1+k];
+         if ( gv<gmin[k] ) {gmin[k]=gv;}
+         if ( gv>gmax[k] ) {gmax[k]=gv;}
+      }
+   }
+   if ( rmax<=CPNW_MINRHOSIGNIFICATIVEVAL ) {return 0;}
+   bool iscand=true,issusp=true;
+   for ( int k=0 ; k<3 ; k++ ) {
+      if ( gmin[k]>0.0e0 || gmax[k]<0.0e0 ) {
+         iscand=false;
+         gv=((gmin[k]>0.0e0)? gmin[k] : (-gmax[k]));
+         if ( gv>(gmax[k]-gmin[k]) ) {issusp=false;}
+      }
+   }
+   if ( iscand ) {return 1;}
+   if ( issusp ) {return 2;}
+   return 0;
+}
+/* ************************************************************************************ */
+void critPtNetWork::collectGridCells(const int nb,solreal ** (&oo),const solreal hh,\
+      const int (&nn)[3],solreal * (&vals),int &nsd,solreal ** (&sd),\
+      int &nsus,solreal ** (&sus))
+{
+   const int npb=nn[0]*nn[1]*nn[2];
+   int cn[8],typ,c;
+   nsd=nsus=0;
+   sd=sus=NULL;
+   /* The first pass counts the cells, the second one stores them.  */
+   for ( int pass=0 ; pass<2 ; pass++ ) {
+      if ( pass==1 ) {
+         allocFlat2DRealArray(string("sd"),((nsd>0)? nsd : 1),3,sd);
+         allocFlat2DRealArray(string("sus"),((nsus>0)? nsus : 1),3,sus);
+         nsd=nsus=0;
+      }
+      for ( int b=0 ; b<nb ; b++ ) {
+         for ( int i=0 ; i<(nn[0]-1) ; i++ ) {
+            for ( int j=0 ; j<(nn[1]-1) ; j++ ) {
+               for ( int k=0 ; k<(nn[2]-1) ; k++ ) {
+                  c=0;
+                  for ( int di=0 ; di<2 ; di++ ) {
+                     for ( int dj=0 ; dj<2 ; dj++ ) {
+                        for ( int dk=0 ; dk<2 ; dk++ ) {
+                           cn[c++]=b*npb+((i+di)*nn[1]+(j+dj))*nn[2]+(k+dk);
+                        }
+                     }
+                  }
+                  typ=classifyGridCell(vals,cn);
+                  if ( typ==1 ) {
+                     if ( pass==1 ) {
+                        sd[nsd][0]=oo[b][0]+(solreal(i)+0.5e0)*hh;
+                        sd[nsd][1]=oo[b][1]+(solreal(j)+0.5e0)*hh;
+                        sd[nsd][2]=oo[b][2]+(solreal(k)+0.5e0)*hh;
+                     }
+                     ++nsd;
+                  }
+                  if ( typ>0 ) {
+                     if ( pass==1 ) {
+                        sus[nsus][0]=oo[b][0]+solreal(i)*hh;
+                        sus[nsus][1]=oo[b][1]+solreal(j)*hh;
+                        sus[nsus][2]=oo[b][2]+solreal(k)*hh;
+                     }
+                     ++nsus;
+                  }
+               }
+            }
+         }
+      }
+   }
+}
+/* ************************************************************************************ */
+void critPtNetWork::seekRhoCPsFromGridSeeds(const int nsd,solreal ** (&sd))
+{
+   if ( nsd<1 ) {return;}
+   int *sgs;
+   alloc1DIntArray(string("sgs"),nsd,sgs);
+   solreal x[3],rho,g[3],hr[3][3];
+   for ( int i=0 ; i<nsd ; i++ ) {
+      wf->evalHessian(sd[i][0],sd[i][1],sd[i][2],rho,g,hr);
+      sgs[i]=computeSignature(hr);
+   }
+   const int cpsigs[4]={-3,-1,1,3};
+   string lbl[4]={"grdACP1","grdBCP1","grdRCP1","grdCCP1"};
+   solreal **xx,*ff,**gg;
+   int *sg,nsg,sig,pos;
+   bool isnew;
+   for ( int t=0 ; t<4 ; t++ ) {
+      nsg=0;
+      for ( int i=0 ; i<nsd ; i++ ) {if ( sgs[i]==cpsigs[t] ) {++nsg;}}
+      if ( nsg==0 ) {continue;}
+      allocSeedArrays(nsg,xx,ff,gg,sg);
+      nsg=0;
+      for ( int i=0 ; i<nsd ; i++ ) {
+         if ( sgs[i]!=cpsigs[t] ) {continue;}
+         for ( int k=0 ; k<3 ; k++ ) {xx[nsg][k]=sd[i][k];}
+         ++nsg;
+      }
+      seekCPsFromSeeds(cpsigs[t],false,nsg,xx,ff,gg,sg);
+      for ( int i=0 ; i<nsg ; i++ ) {
+         getSeedResult(i,xx,ff,gg,sg,x,rho,g,sig);
+         if ( (rho<=CPNW_MINRHOSIGNIFICATIVEVAL)||\
+               (computeMagnitudeV3(g)>=CPNW_EPSRHOACPGRADMAG) ) {continue;}
+         switch ( cpsigs[t] ) {
+            case -3 :
+               isnew=addRhoACP(x,sig,lbl[t]);
+               break;
+            case -1 :
+               isnew=addRhoBCP(x,sig,lbl[t],pos);
+               break;
+            case 1 :
+               isnew=addRhoRCP(x,sig,lbl[t],pos);
+               break;
+            default :
+               isnew=addRhoCCP(x,sig,lbl[t],pos);
+               break;
+         }
+         if ( isnew ) {++lbl[t][(lbl[t].length()-1)];}
+      }
+      deallocSeedArrays(nsg,xx,ff,gg,sg);
+   }
+   dealloc1DIntArray(sgs);
+}
+/* ************************************************************************************ */
+bool critPtNetWork::setRhoCPsFromPreviousFrame(critPtNetWork &prev)
+{
+   if ( (prev.mycptype!=DENS)||(!prev.iknowallcps)||(prev.bn->nNuc!=bn->nNuc) ) {
+      return false;
+   }
+   if (!bn->imstp()) {
+      displayErrorMessage("Trying to use a non set up bond network object!");
+      return false;
+   }
+   mycptype=DENS;
+   cout << "Tracking the Density Critical Points of the previous frame..." << endl;
+   allocXCPArrays('a',prev.nACP);
+   allocXCPArrays('b',prev.nBCP);
+   allocXCPArrays('r',prev.nRCP);
+   allocXCPArrays('c',prev.nCCP);
+   const int cpsigs[4]={-3,-1,1,3};
+   const int ncp[4]={prev.nACP,prev.nBCP,prev.nRCP,prev.nCCP};
+   solreal **rprv[4]={prev.RACP,prev.RBCP,prev.RRCP,prev.RCCP};
+   string *lprv[4]={prev.lblACP,prev.lblBCP,prev.lblRCP,prev.lblCCP};
+   solreal **xx,*ff,**gg,**sd,x[3],dx[3],rho,g[3],dd;
+   int *sg,sig,pos;
+   string lbl;
+   bool istracked=true;
+   for ( int t=0 ; (t<4)&&istracked ; t++ ) {
+      if ( ncp[t]==0 ) {continue;}
+      allocSeedArrays(ncp[t],xx,ff,gg,sg);
+      allocFlat2DRealArray(string("sd"),ncp[t],3,sd);
+      for ( int i=0 ; i<ncp[t] ; i++ ) {
+         for ( int k=0 ; k<3 ; k++ ) {x[k]=rprv[t][i][k];}
+         getFrameDisplacement(prev,x,dx);
+         for ( int k=0 ; k<3 ; k++ ) {sd[i][k]=xx[i][k]=x[k]+dx[k];}
+      }
+      seekCPsFromSeeds(cpsigs[t],false,ncp[t],xx,ff,gg,sg);
+      /* The i-th CP of the previous frame survives if its seed converges to a new CP
+         of the same type, close to the seed. Otherwise, two CPs merged (or one of
+         them vanished), and the topology is not the same.  */
+      for ( int i=0 ; (i<ncp[t])&&istracked ; i++ ) {
+         getSeedResult(i,xx,ff,gg,sg,x,rho,g,sig);
+         dd=0.0e0;
+         for ( int k=0 ; k<3 ; k++ ) {dd+=((x[k]-sd[i][k])*(x[k]-sd[i][k]));}
+         if ( (rho<=CPNW_MINRHOSIGNIFICATIVEVAL)||\
+               (computeMagnitudeV3(g)>=CPNW_EPSRHOACPGRADMAG)||\
+               (dd>(CPNW_TRACKMAXCPSHIFT*CPNW_TRACKMAXCPSHIFT)) ) {
+            istracked=false;
+            break;
+         }
+         lbl=lprv[t][i];
+         /* A nuclear ACP that did not converge in prev (label ending in '+') does now.  */
+         if ( (t==0)&&(i<bn->nNuc)&&(lbl==(bn->atLbl[i]+"+")) ) {lbl=bn->atLbl[i];}
+         switch ( cpsigs[t] ) {
+            case -3 :
+               istracked=addRhoACP(x,sig,lbl);
+               break;
+            case -1 :
+               istracked=addRhoBCP(x,sig,lbl,pos);
+               break;
+            case 1 :
+               istracked=addRhoRCP(x,sig,lbl,pos);
+               break;
+            default :
+               istracked=addRhoCCP(x,sig,lbl,pos);
+               break;
+         }
+      }
+      deallocFlat2DRealArray(sd);
+      deallocSeedArrays(ncp[t],xx,ff,gg,sg);
+   }
+   if ( !istracked ) {
+      cout << "The topology changed; the CPs could not be tracked." << endl;
+      return false;
+   }
+   /* The CPs keep their order, hence the connectivity is the one of the previous
+      frame (the gradient paths must be computed again).  */
+   for ( int i=0 ; i<nBCP ; i++ ) {
+      conBCP[i][0]=prev.conBCP[i][0];
+      conBCP[i][1]=prev.conBCP[i][1];
+   }
+   normalbcp=prev.normalbcp;
+   for ( int i=0 ; i<nRCP ; i++ ) {
+      for ( int j=0 ; (j<prev.wConRCP)&&(prev.conRCP[i][0][j]>=0) ; j++ ) {
+         addToConRCP(i,prev.conRCP[i][0][j]);
+      }
+   }
+   for ( int i=0 ; i<nCCP ; i++ ) {
+      for ( int j=0 ; (j<prev.wConCCP)&&(prev.conCCP[i][0][j]>=0) ; j++ ) {
+         addToConCCP(i,prev.conCCP[i][0][j]);
+      }
+   }
+   iknowacps=iknowbcps=iknowrcps=iknowccps=true;
+   iknowallcps=true;
+   printScrCharLine('*');
+   cout << "nACP-nBCP+nRCP-nCCP: " << (nACP-nBCP+nRCP-nCCP) << endl;
+   printScrCharLine('*');
+   return true;
+}
+/* ************************************************************************************ */
+void critPtNetWork::matchCPsToPreviousFrame(char cpt,critPtNetWork &prev,int * (&idx))
+{
+   int ncur,nprv;
+   solreal **rcur,**rprv;
+   switch ( cpt ) {
+      case 'a' :
+         ncur=nACP; rcur=RACP; nprv=prev.nACP; rprv=prev.RACP;
+         break;
+      case 'b' :
+         ncur=nBCP; rcur=RBCP; nprv=prev.nBCP; rprv=prev.RBCP;
+         break;
+      case 'r' :
+         ncur=nRCP; rcur=RRCP; nprv=prev.nRCP; rprv=prev.RRCP;
+         break;
+      case 'c' :
+         ncur=nCCP; rcur=RCCP; nprv=prev.nCCP; rprv=prev.RCCP;
+         break;
+      default:
+         displayErrorMessage(string("Unknown CP type: '")+cpt+string("'"));
+         return;
+   }
+   for ( int i=0 ; i<ncur ; i++ ) {idx[i]=-1;}
+   if ( (ncur==0)||(nprv==0)||(prev.bn->nNuc!=bn->nNuc) ) {return;}
+   solreal **rd,x[3],dx[3],dd,dmin;
+   int *nearcur,*nearprv;
+   allocFlat2DRealArray(string("rd"),nprv,3,rd);
+   alloc1DIntArray(string("nearcur"),nprv,nearcur,-1);
+   alloc1DIntArray(string("nearprv"),ncur,nearprv,-1);
+   for ( int j=0 ; j<nprv ; j++ ) {
+      for ( int k=0 ; k<3 ; k++ ) {x[k]=rprv[j][k];}
+      getFrameDisplacement(prev,x,dx);
+      for ( int k=0 ; k<3 ; k++ ) {rd[j][k]=x[k]+dx[k];}
+   }
+   const solreal maxd2=CPNW_TRACKMAXCPSHIFT*CPNW_TRACKMAXCPSHIFT;
+   for ( int j=0 ; j<nprv ; j++ ) {
+      dmin=maxd2;
+      for ( int i=0 ; i<ncur ; i++ ) {
+         dd=0.0e0;
+         for ( int k=0 ; k<3 ; k++ ) {dd+=((rcur[i][k]-rd[j][k])*(rcur[i][k]-rd[j][k]));}
+         if ( dd<dmin ) {dmin=dd; nearcur[j]=i;}
+      }
+   }
+   for ( int i=0 ; i<ncur ; i++ ) {
+      dmin=maxd2;
+      for ( int j=0 ; j<nprv ; j++ ) {
+         dd=0.0e0;
+         for ( int k=0 ; k<3 ; k++ ) {dd+=((rcur[i][k]-rd[j][k])*(rcur[i][k]-rd[j][k]));}
+         if ( dd<dmin ) {dmin=dd; nearprv[i]=j;}
+      }
+   }
+   //Only the mutually closest pairs are matched.
+   for ( int i=0 ; i<ncur ; i++ ) {
+      if ( (nearprv[i]>=0)&&(nearcur[nearprv[i]]==i) ) {idx[i]=nearprv[i];}
+   }
+   dealloc1DIntArray(nearprv);
+   dealloc1DIntArray(nearcur);
+   deallocFlat2DRealArray(rd);
+}
+/* ************************************************************************************ */
+void critPtNetWork::getFrameDisplacement(critPtNetWork &prev,solreal (&x)[3],\
+      solreal (&dx)[3])
+{
+   solreal w,sw=0.0e0,d2;
+   for ( int k=0 ; k<3 ; k++ ) {dx[k]=0.0e0;}
+   for ( int i=0 ; i<(bn->nNuc) ; i++ ) {
+      d2=0.0e0;
+      for ( int k=0 ; k<3 ; k++ ) {d2+=((x[k]-prev.bn->R[i][k])*(x[k]-prev.bn->R[i][k]));}
+      if ( d2<(CPNW_EPSFABSDIFFCOORD*CPNW_EPSFABSDIFFCOORD) ) {
+         for ( int k=0 ; k<3 ; k++ ) {dx[k]=bn->R[i][k]-prev.bn->R[i][k];}
+         return;
+      }
+      w=1.0e0/(d2*d2);
+      sw+=w;
+      for ( int k=0 ; k<3 ; k++ ) {dx[k]+=(w*(bn->R[i][k]-prev.bn->R[i][k]));}
+   }
+   for ( int k=0 ; k<3 ; k++ ) {dx[k]/=sw;}
+}
+/* ************************************************************************************ */
 /* ************************************************************************************ */
 /* ************************************************************************************ */
 /* ************************************************************************************ */
@@ -1387,7 +1981,8 @@ void critPtNetWork::writeAllFieldProperties(solreal x,solreal y,solreal z,ofstre
    wf->writeAllFieldProperties(x,y,z,ofil);
 }
 /* ************************************************************************************ */
-void critPtNetWork::getACPStep(solreal (&g)[3],solreal (&hess)[3][3],solreal (&hh)[3],int &sig)
+void critPtNetWork::getACPStep(solreal (&g)[3],solreal (&hess)[3][3],solreal (&hh)[3],int &sig,\
+      const bool capstep)
 {
    solreal eive[3][3],b[3],F[3];
    eigen_decomposition3(hess, eive, b);
@@ -1426,16 +2021,19 @@ void critPtNetWork::getACPStep(solreal (&g)[3],solreal (&hess)[3][3],solreal (&h
       hh[1]-=eive[1][j]*F[j]/(b[j]-lp+CPNW_EPSRHOACPGRADMAG);
       hh[2]-=eive[2][j]*F[j]/(b[j]-lp+CPNW_EPSRHOACPGRADMAG);
    }
-   for (int i=0; i<3; i++) {
-      if (fabs(hh[i])>stepSizeACP) {
-         hh[i]=SIGNF(hh[i])*stepSizeACP;
+   if ( capstep ) {
+      for (int i=0; i<3; i++) {
+         if (fabs(hh[i])>stepSizeACP) {
+            hh[i]=SIGNF(hh[i])*stepSizeACP;
+         }
       }
    }
    sig=computeSignature(b);
    return;
 }
 /* ************************************************************************************* */
-void critPtNetWork::getBCPStep(solreal (&g)[3],solreal (&hess)[3][3],solreal (&hh)[3],int &sig)
+void critPtNetWork::getBCPStep(solreal (&g)[3],solreal (&hess)[3][3],solreal (&hh)[3],int &sig,\
+      const bool capstep)
 {
    solreal eive[3][3],b[3];
    eigen_decomposition3(hess, eive, b);
@@ -1464,16 +2062,19 @@ void critPtNetWork::getBCPStep(solreal (&g)[3],solreal (&hess)[3][3],solreal (&h
       hh[1]-=eive[1][j]*F[j]/(b[j]-lp+CPNW_EPSRHOACPGRADMAG);
       hh[2]-=eive[2][j]*F[j]/(b[j]-ln+CPNW_EPSRHOACPGRADMAG);
    }
-   for (int i=0; i<3; i++) {
-      if (fabs(hh[i])>stepSizeBCP) {
-         hh[i]=SIGNF(hh[i])*stepSizeBCP;
+   if ( capstep ) {
+      for (int i=0; i<3; i++) {
+         if (fabs(hh[i])>stepSizeBCP) {
+            hh[i]=SIGNF(hh[i])*stepSizeBCP;
+         }
       }
    }
    sig=computeSignature(b);
    return;
 }
 /* ************************************************************************************* */
-void critPtNetWork::getRCPStep(solreal (&g)[3],solreal (&hess)[3][3],solreal (&hh)[3],int &sig)
+void critPtNetWork::getRCPStep(solreal (&g)[3],solreal (&hess)[3][3],solreal (&hh)[3],int &sig,\
+      const bool capstep)
 {
    solreal eive[3][3],b[3];
    eigen_decomposition3(hess, eive, b);
@@ -1502,16 +2103,19 @@ void critPtNetWork::getRCPStep(solreal (&g)[3],solreal (&hess)[3][3],solreal (&h
       hh[1]-=eive[1][j]*F[j]/(b[j]-ln+CPNW_EPSRHOACPGRADMAG);
       hh[2]-=eive[2][j]*F[j]/(b[j]-ln+CPNW_EPSRHOACPGRADMAG);
    }
-   for (int i=0; i<3; i++) {
-      if (fabs(hh[i])>stepSizeRCP) {
-         hh[i]=SIGNF(hh[i])*stepSizeRCP;
+   if ( capstep ) {
+      for (int i=0; i<3; i++) {
+         if (fabs(hh[i])>stepSizeRCP) {
+            hh[i]=SIGNF(hh[i])*stepSizeRCP;
+         }
       }
    }
    sig=computeSignature(b);
    return;
 }
 /* ************************************************************************************* */
-void critPtNetWork::getCCPStep(solreal (&g)[3],solreal (&hess)[3][3],solreal (&hh)[3],int &sig)
+void critPtNetWork::getCCPStep(solreal (&g)[3],solreal (&hess)[3][3],solreal (&hh)[3],int &sig,\
+      const bool capstep)
 {
    solreal eive[3][3],b[3];
    eigen_decomposition3(hess, eive, b);
@@ -1542,15 +2146,87 @@ void critPtNetWork::getCCPStep(solreal (&g)[3],solreal (&hess)[3][3],solreal (&h
       hh[1]-=eive[1][j]*F[j]/(b[j]-ln+CPNW_EPSRHOACPGRADMAG);
       hh[2]-=eive[2][j]*F[j]/(b[j]-ln+CPNW_EPSRHOACPGRADMAG);
    }
-   for (int i=0; i<3; i++) {
-      if (fabs(hh[i])>stepSizeCCP) {
-         hh[i]=SIGNF(hh[i])*stepSizeCCP;
+   if ( capstep ) {
+      for (int i=0; i<3; i++) {
+         if (fabs(hh[i])>stepSizeCCP) {
+            hh[i]=SIGNF(hh[i])*stepSizeCCP;
+         }
       }
    }
    sig=computeSignature(b);
    return;
 }
 /* ************************************************************************************ */
+void critPtNetWork::getXCPStep(const int cpsig,solreal (&g)[3],solreal (&hess)[3][3],\
+      solreal (&hh)[3],int &sig,const bool capstep)
+{
+   switch ( cpsig ) {
+      case -3 :
+         getACPStep(g,hess,hh,sig,capstep);
+         break;
+      case -1 :
+         getBCPStep(g,hess,hh,sig,capstep);
+         break;
+      case 1 :
+         getRCPStep(g,hess,hh,sig,capstep);
+         break;
+      case 3 :
+         getCCPStep(g,hess,hh,sig,capstep);
+         break;
+      default :
+         displayErrorMessage(string("Non valid CP signature: ")+getStringFromInt(cpsig));
+         hh[0]=hh[1]=hh[2]=0.0e0;
+         break;
+   }
+}
+/* ************************************************************************************ */
+void critPtNetWork::addCPSearchCounts(const int cpsig,const int nit,const int nhess,\
+      const int ngrad)
+{
+   int idx=(cpsig+3)/2;
+   if ( idx<0 || idx>3 ) {return;}
+#if PARALLELISEDTK
+#pragma omp atomic
+#endif
+   nCPSearches[idx]+=1;
+#if PARALLELISEDTK
+#pragma omp atomic
+#endif
+   nCPSearchIter[idx]+=nit;
+#if PARALLELISEDTK
+#pragma omp atomic
+#endif
+   nCPSearchHessEv[idx]+=nhess;
+#if PARALLELISEDTK
+#pragma omp atomic
+#endif
+   nCPSearchGradEv[idx]+=ngrad;
+}
+/* ************************************************************************************ */
+void critPtNetWork::resetCPSearchStats(void)
+{
+   for ( int i=0 ; i<4 ; i++ ) {
+      nCPSearches[i]=nCPSearchIter[i]=nCPSearchHessEv[i]=nCPSearchGradEv[i]=0;
+   }
+}
+/* ************************************************************************************ */
+void critPtNetWork::displayCPSearchStats(void)
+{
+   const char cpnam[4][4]={"ACP","BCP","RCP","CCP"};
+   printScrCharLine('-');
+   cout << "CP searches (" << (useTRCPSearch? "trust region" : "fixed step size");
+   if ( useTRCPSearch && useHessUpdCPSearch ) {cout << ", Hessian updates";}
+   cout << "):" << endl;
+   cout << "      Searches  Iterations  Hessian evals  Gradient evals" << endl;
+   for ( int i=0 ; i<4 ; i++ ) {
+      if ( nCPSearches[i]==0 ) {continue;}
+      cout << cpnam[i] << ": " << setw(9) << nCPSearches[i] << setw(12)
+           << nCPSearchIter[i] << setw(15) << nCPSearchHessEv[i]
+           << setw(16) << nCPSearchGradEv[i] << endl;
+   }
+   printScrCharLine('-');
+}
+/* ************************************************************************************ */
 int critPtNetWork::computeSignature(solreal (&ev)[3])
 {
    int res=0;
@@ -1570,13 +2246,23 @@ int critPtNetWork::computeSignature(solreal (&ev)[3])
 /* ************************************************************************************ */
 void critPtNetWork::seekRhoACP(solreal (&x)[3],solreal &rho2ret,solreal (&g)[3],int &sig)
 {
+   seekRhoACP(*wf,x,rho2ret,g,sig);
+}
+/* ************************************************************************************ */
+void critPtNetWork::seekRhoACP(GaussWaveFunction &twf,solreal (&x)[3],solreal &rho2ret,solreal (&g)[3],int &sig)
+{
+   if ( useTRCPSearch ) {
+      seekRhoCPTrustRegion(twf,-3,x,rho2ret,g,sig);
+      return;
+   }
    solreal rho,gr[3],hr[3][3],dx[3];
-   wf->evalHessian(x[0],x[1],x[2],rho,gr,hr);
+   twf.evalHessian(x[0],x[1],x[2],rho,gr,hr);
    sig=computeSignature(hr);
    solreal magd=computeMagnitudeV3(gr);
    if ( magd<CPNW_EPSRHOACPGRADMAG && sig==-3 ) {
       rho2ret=rho;
       for ( int i=0 ; i<3 ; i++ ) {g[i]=gr[i];}
+      addCPSearchCounts(-3,0,1,0);
       return;
    }
    solreal magh=magd;
@@ -1584,25 +2270,36 @@ void critPtNetWork::seekRhoACP(solreal (&x)[3],solreal &rho2ret,solreal (&g)[3],
    while (((magd>CPNW_EPSRHOACPGRADMAG)&&(magh>CPNW_EPSFABSDIFFCOORD))&&(count<maxItACP)) {
       getACPStep(gr,hr,dx,sig);
       for (int i=0; i<3; i++) {x[i]+=dx[i];}
-      wf->evalHessian(x[0],x[1],x[2],rho,gr,hr);
+      twf.evalHessian(x[0],x[1],x[2],rho,gr,hr);
       magd=sqrt(gr[0]*gr[0]+gr[1]*gr[1]+gr[2]*gr[2]);
       magh=sqrt(dx[0]*dx[0]+dx[1]*dx[1]+dx[2]*dx[2]);
       ++count;
    }
    for ( int k=0 ; k<3 ; k++ ) {g[k]=gr[k];}
    rho2ret=rho;
+   addCPSearchCounts(-3,count,count+1,0);
    return;
 }
 /* ************************************************************************************ */
 void critPtNetWork::seekRhoBCP(solreal (&x)[3],solreal &rho2ret,solreal (&g)[3],int &sig)
 {
+   seekRhoBCP(*wf,x,rho2ret,g,sig);
+}
+/* ************************************************************************************ */
+void critPtNetWork::seekRhoBCP(GaussWaveFunction &twf,solreal (&x)[3],solreal &rho2ret,solreal (&g)[3],int &sig)
+{
+   if ( useTRCPSearch ) {
+      seekRhoCPTrustRegion(twf,-1,x,rho2ret,g,sig);
+      return;
+   }
    solreal rho,gr[3],hr[3][3],dx[3];
-   wf->evalHessian(x[0],x[1],x[2],rho,gr,hr);
+   twf.evalHessian(x[0],x[1],x[2],rho,gr,hr);
    sig=computeSignature(hr);
    solreal magd=computeMagnitudeV3(gr);
    if ( magd<CPNW_EPSRHOACPGRADMAG && sig==-1 ) {
       rho2ret=rho;
       for ( int i=0 ; i<3 ; i++ ) {g[i]=gr[i];}
+      addCPSearchCounts(-1,0,1,0);
       return;
    }
    solreal magh=magd;
@@ -1610,25 +2307,36 @@ void critPtNetWork::seekRhoBCP(solreal (&x)[3],solreal &rho2ret,solreal (&g)[3],
    while (((magd>CPNW_EPSRHOACPGRADMAG)&&(magh>CPNW_EPSFABSDIFFCOORD))&&(count<maxItBCP)) {
       getBCPStep(gr,hr,dx,sig);
       for (int i=0; i<3; i++) {x[i]+=dx[i];}
-      wf->evalHessian(x[0],x[1],x[2],rho,gr,hr);
+      twf.evalHessian(x[0],x[1],x[2],rho,gr,hr);
       magd=sqrt(gr[0]*gr[0]+gr[1]*gr[1]+gr[2]*gr[2]);
       magh=sqrt(dx[0]*dx[0]+dx[1]*dx[1]+dx[2]*dx[2]);
       ++count;
    }
    for ( int k=0 ; k<3 ; k++ ) {g[k]=gr[k];}
    rho2ret=rho;
+   addCPSearchCounts(-1,count,count+1,0);
    return;
 }
 /* ************************************************************************************ */
 void critPtNetWork::seekRhoRCP(solreal (&x)[3],solreal &rho2ret,solreal (&g)[3],int &sig)
 {
+   seekRhoRCP(*wf,x,rho2ret,g,sig);
+}
+/* ************************************************************************************ */
+void critPtNetWork::seekRhoRCP(GaussWaveFunction &twf,solreal (&x)[3],solreal &rho2ret,solreal (&g)[3],int &sig)
+{
+   if ( useTRCPSearch ) {
+      seekRhoCPTrustRegion(twf,1,x,rho2ret,g,sig);
+      return;
+   }
    solreal rho,gr[3],hr[3][3],dx[3];
-   wf->evalHessian(x[0],x[1],x[2],rho,gr,hr);
+   twf.evalHessian(x[0],x[1],x[2],rho,gr,hr);
    sig=computeSignature(hr);
    solreal magd=computeMagnitudeV3(gr);
    if ( magd<=CPNW_EPSRHOACPGRADMAG && sig==1 ) {
       rho2ret=rho;
       for ( int i=0 ; i<3 ; i++ ) {g[i]=gr[i];}
+      addCPSearchCounts(1,0,1,0);
       return;
    }
    solreal magh=magd;
@@ -1636,25 +2344,36 @@ void critPtNetWork::seekRhoRCP(solreal (&x)[3],solreal &rho2ret,solreal (&g)[3],
    while (((magd>CPNW_EPSRHOACPGRADMAG)&&(magh>CPNW_EPSFABSDIFFCOORD))&&(count<maxItRCP)) {
       getRCPStep(gr,hr,dx,sig);
       for (int i=0; i<3; i++) {x[i]+=dx[i];}
-      wf->evalHessian(x[0],x[1],x[2],rho,gr,hr);
+      twf.evalHessian(x[0],x[1],x[2],rho,gr,hr);
       magd=sqrt(gr[0]*gr[0]+gr[1]*gr[1]+gr[2]*gr[2]);
       magh=sqrt(dx[0]*dx[0]+dx[1]*dx[1]+dx[2]*dx[2]);
       ++count;
    }
    for ( int k=0 ; k<3 ; k++ ) {g[k]=gr[k];}
    rho2ret=rho;
+   addCPSearchCounts(1,count,count+1,0);
    return;
 }
 /* ************************************************************************************ */
 void critPtNetWork::seekRhoCCP(solreal (&x)[3],solreal &rho2ret,solreal (&g)[3],int &sig)
 {
+   seekRhoCCP(*wf,x,rho2ret,g,sig);
+}
+/* ************************************************************************************ */
+void critPtNetWork::seekRhoCCP(GaussWaveFunction &twf,solreal (&x)[3],solreal &rho2ret,solreal (&g)[3],int &sig)
+{
+   if ( useTRCPSearch ) {
+      seekRhoCPTrustRegion(twf,3,x,rho2ret,g,sig);
+      return;
+   }
    solreal rho,gr[3],hr[3][3],dx[3];
-   wf->evalHessian(x[0],x[1],x[2],rho,gr,hr);
+   twf.evalHessian(x[0],x[1],x[2],rho,gr,hr);
    sig=computeSignature(hr);
    solreal magd=computeMagnitudeV3(gr);
    if ( magd<CPNW_EPSRHOACPGRADMAG && sig==3 ) {
       rho2ret=rho;
       for ( int i=0 ; i<3 ; i++ ) {g[i]=gr[i];}
+      addCPSearchCounts(3,0,1,0);
       return;
    }
    solreal magh=magd;
@@ -1662,118 +2381,527 @@ void critPtNetWork::seekRhoCCP(solreal (&x)[3],solreal &rho2ret,solreal (&g)[3],
    while (((magd>CPNW_EPSRHOACPGRADMAG)&&(magh>CPNW_EPSFABSDIFFCOORD))&&(count<maxItCCP)) {
       getCCPStep(gr,hr,dx,sig);
       for (int i=0; i<3; i++) {x[i]+=dx[i];}
-      wf->evalHessian(x[0],x[1],x[2],rho,gr,hr);
+      twf.evalHessian(x[0],x[1],x[2],rho,gr,hr);
       magd=sqrt(gr[0]*gr[0]+gr[1]*gr[1]+gr[2]*gr[2]);
       magh=sqrt(dx[0]*dx[0]+dx[1]*dx[1]+dx[2]*dx[2]);
       ++count;
    }
    for ( int k=0 ; k<3 ; k++ ) {g[k]=gr[k];}
    rho2ret=rho;
+   addCPSearchCounts(3,count,count+1,0);
+   return;
+}
+/* ************************************************************************************ */
+void critPtNetWork::seekLOLACP(solreal (&x)[3],solreal &ll,solreal (&g)[3],int &sig)
+{
+   seekLOLACP(*wf,x,ll,g,sig);
+}
+/* ************************************************************************************ */
+void critPtNetWork::seekLOLACP(GaussWaveFunction &twf,solreal (&x)[3],solreal &ll,solreal (&g)[3],int &sig)
+{
+   solreal lol,gl[3],hl[3][3],dx[3];
+   twf.evalHessLOL(x,lol,gl,hl);
+   sig=computeSignature(hl);
+   solreal magd=computeMagnitudeV3(gl);
+   if ( magd<CPNW_EPSRHOACPGRADMAG && sig==-3 ) {
+      ll=lol;
+      for ( int i=0 ; i<3 ; i++ ) {g[i]=gl[i];}
+      addCPSearchCounts(-3,0,1,0);
+      return;
+   }
+   solreal magh=magd;
+   int count=0;
+   while (((magd>CPNW_EPSRHOACPGRADMAG)&&(magh>CPNW_EPSFABSDIFFCOORD))&&(count<maxItACP)) {
+      getACPStep(gl,hl,dx,sig);
+      for (int i=0; i<3; i++) {x[i]+=(dx[i]/*MAXSTEPSIZEACPLOLSEARCH*/);}
+      twf.evalHessLOL(x,lol,gl,hl);
+      magd=sqrt(gl[0]*gl[0]+gl[1]*gl[1]+gl[2]*gl[2]);
+      magh=sqrt(dx[0]*dx[0]+dx[1]*dx[1]+dx[2]*dx[2]);
+      ++count;
+   }
+   for (int i=0; i<3; i++) {g[i]=gl[i];}
+   ll=lol;
+   addCPSearchCounts(-3,count,count+1,0);
+   return;
+}
+/* ************************************************************************************ */
+void critPtNetWork::seekLOLBCP(solreal (&x)[3],solreal &ll,solreal (&g)[3],int &sig)
+{
+   seekLOLBCP(*wf,x,ll,g,sig);
+}
+/* ************************************************************************************ */
+void critPtNetWork::seekLOLBCP(GaussWaveFunction &twf,solreal (&x)[3],solreal &ll,solreal (&g)[3],int &sig)
+{
+   solreal lol,gl[3],hl[3][3],dx[3];
+   twf.evalHessLOL(x,lol,gl,hl);
+   sig=computeSignature(hl);
+   solreal magd=computeMagnitudeV3(gl);
+   if ( magd<CPNW_EPSRHOACPGRADMAG && sig==-1 ) {
+      ll=lol;
+      for ( int i=0 ; i<3 ; i++ ) {g[i]=gl[i];}
+      addCPSearchCounts(-1,0,1,0);
+      return;
+   }
+   solreal magh=magd;
+   int count=0;
+   while (((magd>CPNW_EPSRHOACPGRADMAG)&&(magh>CPNW_EPSFABSDIFFCOORD))&&(count<maxItBCP)) {
+      getBCPStep(gl,hl,dx,sig);
+      for (int i=0; i<3; i++) {x[i]+=(dx[i]/*MAXSTEPSIZEACPLOLSEARCH*/);}
+      twf.evalHessLOL(x,lol,gl,hl);
+      magd=sqrt(gl[0]*gl[0]+gl[1]*gl[1]+gl[2]*gl[2]);
+      magh=sqrt(dx[0]*dx[0]+dx[1]*dx[1]+dx[2]*dx[2]);
+      ++count;
+   }
+   for (int i=0; i<3; i++) {g[i]=gl[i];}
+   ll=lol;
+   addCPSearchCounts(-1,count,count+1,0);
+   return;
+}
+/* ************************************************************************************ */
+void critPtNetWork::seekLOLRCP(solreal (&x)[3],solreal &ll,solreal (&g)[3],int &sig)
+{
+   seekLOLRCP(*wf,x,ll,g,sig);
+}
+/* ************************************************************************************ */
+void critPtNetWork::seekLOLRCP(GaussWaveFunction &twf,solreal (&x)[3],solreal &ll,solreal (&g)[3],int &sig)
+{
+   solreal lol,gl[3],hl[3][3],dx[3];
+   twf.evalHessLOL(x,lol,gl,hl);
+   sig=computeSignature(hl);
+   solreal magd=computeMagnitudeV3(gl);
+   if ( magd<CPNW_EPSRHOACPGRADMAG && sig==1 ) {
+      ll=lol;
+      for ( int i=0 ; i<3 ; i++ ) {g[i]=gl[i];}
+      addCPSearchCounts(1,0,1,0);
+      return;
+   }
+   solreal magh=magd;
+   int count=0;
+   while (((magd>CPNW_EPSRHOACPGRADMAG)&&(magh>CPNW_EPSFABSDIFFCOORD))&&(count<maxItRCP)) {
+      getRCPStep(gl,hl,dx,sig);
+      for (int i=0; i<3; i++) {x[i]+=(dx[i]/*MAXSTEPSIZEACPLOLSEARCH*/);}
+      twf.evalHessLOL(x,lol,gl,hl);
+      magd=sqrt(gl[0]*gl[0]+gl[1]*gl[1]+gl[2]*gl[2]);
+      magh=sqrt(dx[0]*dx[0]+dx[1]*dx[1]+dx[2]*dx[2]);
+      ++count;
+   }
+   for (int i=0; i<3; i++) {g[i]=gl[i];}
+   ll=lol;
+   addCPSearchCounts(1,count,count+1,0);
+   return;
+}
+/* ************************************************************************************ */
+void critPtNetWork::seekLOLCCP(solreal (&x)[3],solreal &ll,solreal (&g)[3],int &sig)
+{
+   seekLOLCCP(*wf,x,ll,g,sig);
+}
+/* ************************************************************************************ */
+void critPtNetWork::seekLOLCCP(GaussWaveFunction &twf,solreal (&x)[3],solreal &ll,solreal (&g)[3],int &sig)
+{
+   solreal lol,gl[3],hl[3][3],dx[3];
+   twf.evalHessLOL(x,lol,gl,hl);
+   sig=computeSignature(hl);
+   solreal magd=computeMagnitudeV3(gl);
+   if ( magd<CPNW_EPSRHOACPGRADMAG && sig==3 ) {
+      ll=lol;
+      for ( int i=0 ; i<3 ; i++ ) {g[i]=gl[i];}
+      addCPSearchCounts(3,0,1,0);
+      return;
+   }
+   solreal magh=magd;
+   int count=0;
+   while (((magd>CPNW_EPSRHOACPGRADMAG)&&(magh>CPNW_EPSFABSDIFFCOORD))&&(count<maxItRCP)) {
+      getCCPStep(gl,hl,dx,sig);
+      for (int i=0; i<3; i++) {x[i]+=(dx[i]/*MAXSTEPSIZEACPLOLSEARCH*/);}
+      twf.evalHessLOL(x,lol,gl,hl);
+      magd=sqrt(gl[0]*gl[0]+gl[1]*gl[1]+gl[2]*gl[2]);
+      magh=sqrt(dx[0]*dx[0]+dx[1]*dx[1]+dx[2]*dx[2]);
+      ++count;
+   }
+   for (int i=0; i<3; i++) {g[i]=gl[i];}
+   ll=lol;
+   addCPSearchCounts(3,count,count+1,0);
    return;
 }
 /* ************************************************************************************ */
-void critPtNetWork::seekLOLACP(solreal (&x)[3],solreal &ll,solreal (&g)[3],int &sig)
+void critPtNetWork::seekRhoCPTrustRegion(GaussWaveFunction &twf,const int cpsig,\
+      solreal (&x)[3],solreal &ff,solreal (&g)[3],int &sig)
+{
+   int maxit;
+   solreal rad;
+   switch ( cpsig ) {
+      case -3 :
+         maxit=maxItACP; rad=stepSizeACP;
+         break;
+      case -1 :
+         maxit=maxItBCP; rad=stepSizeBCP;
+         break;
+      case 1 :
+         maxit=maxItRCP; rad=stepSizeRCP;
+         break;
+      case 3 :
+         maxit=maxItCCP; rad=stepSizeCCP;
+         break;
+      default :
+         displayErrorMessage(string("Non valid CP signature: ")+getStringFromInt(cpsig));
+         return;
+   }
+   const solreal maxrad=CPNW_TRUSTREGIONMAXRADIUSFACTOR*rad;
+   solreal f,gr[3],hr[3][3],dx[3],xn[3],fn,gn[3],hn[3][3];
+   twf.evalHessian(x[0],x[1],x[2],f,gr,hr);
+   int nhess=1,ngrad=0,count=0,nupd=0;
+   sig=computeSignature(hr);
+   solreal magd=computeMagnitudeV3(gr);
+   if ( magd<CPNW_EPSRHOACPGRADMAG && sig==cpsig ) {
+      ff=f;
+      for ( int i=0 ; i<3 ; i++ ) {g[i]=gr[i];}
+      addCPSearchCounts(cpsig,0,nhess,ngrad);
+      return;
+   }
+   solreal magh=magd,pred,act,ratio;
+   bool fullh;
+   while (((magd>CPNW_EPSRHOACPGRADMAG)&&(magh>CPNW_EPSFABSDIFFCOORD))&&(count<maxit)) {
+      getXCPStep(cpsig,gr,hr,dx,sig,false);
+      magh=computeMagnitudeV3(dx);
+      if ( magh>rad ) {
+         for ( int i=0 ; i<3 ; i++ ) {dx[i]*=(rad/magh);}
+         magh=rad;
+      }
+      pred=0.0e0;
+      for ( int i=0 ; i<3 ; i++ ) {
+         pred+=gr[i]*dx[i];
+         for ( int j=0 ; j<3 ; j++ ) {pred+=(0.5e0*dx[i]*hr[i][j]*dx[j]);}
+         xn[i]=x[i]+dx[i];
+      }
+      fullh=((!useHessUpdCPSearch)||(nupd>=CPNW_TRUSTREGIONHESSUPDATES));
+      if ( fullh ) {
+         twf.evalHessian(xn[0],xn[1],xn[2],fn,gn,hn);
+         ++nhess;
+      } else {
+         twf.evalRhoGradRho(xn[0],xn[1],xn[2],fn,gn);
+         ++ngrad;
+      }
+      ++count;
+      act=fn-f;
+      ratio=((fabs(pred)>CPNW_TRUSTREGIONEPSMODEL)? (act/pred) : 1.0e0);
+      if ( ratio<0.0e0 && (cpsig==-3 || cpsig==3) ) {
+         /* The step of the extrema goes downhill (ACPs) or uphill (CCPs):
+            x stays, and the region is shrunk.  */
+         rad=0.25e0*magh;
+         magh=rad;
+         continue;
+      }
+      if ( ratio<0.25e0 || ratio>1.75e0 ) {
+         rad=0.5e0*magh;
+      } else if ( ratio>0.75e0 && ratio<1.25e0 && magh>(0.8e0*rad) ) {
+         rad=2.0e0*rad;
+         if ( rad>maxrad ) {rad=maxrad;}
+      }
+      if ( fullh ) {
+         for ( int i=0 ; i<3 ; i++ ) {
+            for ( int j=0 ; j<3 ; j++ ) {hr[i][j]=hn[i][j];}
+         }
+         nupd=0;
+      } else {
+         /* Bofill update: a mixture of the SR1 and PSB updates (BFGS assumes
+            a positive definite Hessian, which is not the case for BCPs and RCPs).  */
+         solreal xi[3],xs=0.0e0,xx=0.0e0,ss=0.0e0;
+         for ( int i=0 ; i<3 ; i++ ) {
+            xi[i]=gn[i]-gr[i];
+            for ( int j=0 ; j<3 ; j++ ) {xi[i]-=hr[i][j]*dx[j];}
+            xs+=xi[i]*dx[i];
+            xx+=xi[i]*xi[i];
+            ss+=dx[i]*dx[i];
+         }
+         if ( (xx*ss)>0.0e0 ) {
+            solreal phi=xs*xs/(xx*ss);
+            for ( int i=0 ; i<3 ; i++ ) {
+               for ( int j=0 ; j<3 ; j++ ) {
+                  hr[i][j]+=(phi*xs*xi[i]*xi[j]/(xx*ss)
+                        +(1.0e0-phi)*((xi[i]*dx[j]+dx[i]*xi[j])/ss
+                        -xs*dx[i]*dx[j]/(ss*ss)));
+               }
+            }
+         }
+         ++nupd;
+      }
+      for ( int i=0 ; i<3 ; i++ ) {
+         x[i]=xn[i];
+         gr[i]=gn[i];
+      }
+      f=fn;
+      magd=computeMagnitudeV3(gr);
+   }
+   if ( nupd>0 ) {
+      /* The signature is always computed from an actual Hessian.  */
+      twf.evalHessian(x[0],x[1],x[2],f,gr,hr);
+      ++nhess;
+   }
+   sig=computeSignature(hr);
+   for ( int k=0 ; k<3 ; k++ ) {g[k]=gr[k];}
+   ff=f;
+   addCPSearchCounts(cpsig,count,nhess,ngrad);
+   return;
+}
+/* ************************************************************************************ */
+void critPtNetWork::seekCPFromSeed(GaussWaveFunction &twf,const int cpsig,const bool uselol,\
+      solreal *xs,solreal &ff,solreal *gs,int &sg)
+{
+   solreal x[3],g[3];
+   for ( int k=0 ; k<3 ; k++ ) {x[k]=xs[k];}
+   switch ( cpsig ) {
+      case -3 :
+         if ( uselol ) {seekLOLACP(twf,x,ff,g,sg);} else {seekRhoACP(twf,x,ff,g,sg);}
+         break;
+      case -1 :
+         if ( uselol ) {seekLOLBCP(twf,x,ff,g,sg);} else {seekRhoBCP(twf,x,ff,g,sg);}
+         break;
+      case 1 :
+         if ( uselol ) {seekLOLRCP(twf,x,ff,g,sg);} else {seekRhoRCP(twf,x,ff,g,sg);}
+         break;
+      case 3 :
+         if ( uselol ) {seekLOLCCP(twf,x,ff,g,sg);} else {seekRhoCCP(twf,x,ff,g,sg);}
+         break;
+      default :
+         displayErrorMessage(string("Non valid CP signature: ")+getStringFromInt(cpsig));
+         break;
+   }
+   for ( int k=0 ; k<3 ; k++ ) {
+      xs[k]=x[k];
+      gs[k]=g[k];
+   }
+}
+/* ************************************************************************************ */
+void critPtNetWork::seekCPsFromSeeds(const int cpsig,const bool uselol,const int nsd,\
+      solreal ** (&xx),solreal * (&ff),solreal ** (&gg),int * (&sg))
+{
+   if ( nsd<1 ) {return;}
+   if ( uselol ) {
+      seekLOLCPsFromSeeds(cpsig,nsd,xx,ff,gg,sg);
+      return;
+   }
+#if PARALLELISEDTK
+   /* The master thread evaluates through wf; every other thread gets its own
+      workspace, which shares all the read-only arrays of *wf.  */
+#pragma omp parallel if(nsd>1)
+   {
+      GaussWaveFunction twf;
+      GaussWaveFunction *pwf=wf;
+      if ( omp_get_thread_num()>0 ) {
+         twf.shareDataFrom(*wf);
+         pwf=&twf;
+      }
+#pragma omp for schedule(dynamic)
+      for ( int i=0 ; i<nsd ; i++ ) {
+         seekCPFromSeed(*pwf,cpsig,uselol,xx[i],ff[i],gg[i],sg[i]);
+      }
+   }
+#else
+   for ( int i=0 ; i<nsd ; i++ ) {
+      seekCPFromSeed(*wf,cpsig,uselol,xx[i],ff[i],gg[i],sg[i]);
+   }
+#endif
+}
+/* ************************************************************************************ */
+void critPtNetWork::seekLOLCPsFromSeeds(const int cpsig,const int nsd,\
+      solreal ** (&xx),solreal * (&ff),solreal ** (&gg),int * (&sg))
+{
+   const int nblk=(nsd+CPNW_LOLSEEDBLOCKSIZE-1)/CPNW_LOLSEEDBLOCKSIZE;
+#if PARALLELISEDTK
+#pragma omp parallel if(nblk>1)
+   {
+      GaussWaveFunction twf;
+      GaussWaveFunction *pwf=wf;
+      if ( omp_get_thread_num()>0 ) {
+         twf.shareDataFrom(*wf);
+         pwf=&twf;
+      }
+#pragma omp for schedule(dynamic)
+      for ( int b=0 ; b<nblk ; b++ ) {
+         int i0=b*CPNW_LOLSEEDBLOCKSIZE;
+         int nb=((nsd-i0)<CPNW_LOLSEEDBLOCKSIZE)? (nsd-i0) : CPNW_LOLSEEDBLOCKSIZE;
+         seekLOLCPsFromSeedBlock(*pwf,cpsig,i0,nb,xx,ff,gg,sg);
+      }
+   }
+#else
+   int i0,nb;
+   for ( int b=0 ; b<nblk ; b++ ) {
+      i0=b*CPNW_LOLSEEDBLOCKSIZE;
+      nb=((nsd-i0)<CPNW_LOLSEEDBLOCKSIZE)? (nsd-i0) : CPNW_LOLSEEDBLOCKSIZE;
+      seekLOLCPsFromSeedBlock(*wf,cpsig,i0,nb,xx,ff,gg,sg);
+   }
+#endif
+}
+/* ************************************************************************************ */
+void critPtNetWork::seekLOLCPsFromSeedBlock(GaussWaveFunction &twf,const int cpsig,\
+      const int i0,const int nb,solreal ** (&xx),solreal * (&ff),solreal ** (&gg),\
+      int * (&sg))
+{
+   int maxit;
+   switch ( cpsig ) {
+      case -3 : maxit=maxItACP; break;
+      case -1 : maxit=maxItBCP; break;
+      case 1 : maxit=maxItRCP; break;
+      default : maxit=maxItCCP; break;
+   }
+   /* px, pl, pg and ph hold the points (and results) of the seeds that are still
+      being searched; act maps them back to the seeds of the block.  */
+   solreal **px,*pl,**pg,**ph,*magh;
+   int *act,*cnt;
+   alloc2DRealArray(string("px"),nb,3,px);
+   alloc1DRealArray(string("pl"),nb,pl);
+   alloc2DRealArray(string("pg"),nb,3,pg);
+   alloc2DRealArray(string("ph"),nb,9,ph);
+   alloc1DRealArray(string("magh"),nb,magh);
+   alloc1DIntArray(string("act"),nb,act);
+   alloc1DIntArray(string("cnt"),nb,cnt);
+   int na=nb,nna,s;
+   for ( int p=0 ; p<nb ; p++ ) {
+      act[p]=i0+p;
+      cnt[p]=0;
+      for ( int k=0 ; k<3 ; k++ ) {px[p][k]=xx[i0+p][k];}
+   }
+   solreal gl[3],hl[3][3],dx[3],magd;
+   bool first=true,goon;
+   while ( na>0 ) {
+      twf.evalHessLOL(na,px,pl,pg,ph);
+      nna=0;
+      for ( int p=0 ; p<na ; p++ ) {
+         s=act[p];
+         for ( int i=0 ; i<3 ; i++ ) {
+            gl[i]=pg[p][i];
+            for ( int j=0 ; j<3 ; j++ ) {hl[i][j]=ph[p][3*i+j];}
+         }
+         magd=computeMagnitudeV3(gl);
+         if ( first ) {
+            sg[s]=computeSignature(hl);
+            magh[p]=magd;
+            goon=!(magd<CPNW_EPSRHOACPGRADMAG && sg[s]==cpsig);
+         } else {
+            goon=true;
+         }
+         goon=(goon&&(magd>CPNW_EPSRHOACPGRADMAG)&&(magh[p]>CPNW_EPSFABSDIFFCOORD)\
+               &&(cnt[p]<maxit));
+         if ( !goon ) {
+            for ( int k=0 ; k<3 ; k++ ) {
+               xx[s][k]=px[p][k];
+               gg[s][k]=gl[k];
+            }
+            ff[s]=pl[p];
+            addCPSearchCounts(cpsig,cnt[p],cnt[p]+1,0);
+            continue;
+         }
+         getXCPStep(cpsig,gl,hl,dx,sg[s]);
+         act[nna]=s;
+         cnt[nna]=cnt[p]+1;
+         for ( int k=0 ; k<3 ; k++ ) {px[nna][k]=px[p][k]+dx[k];}
+         magh[nna]=computeMagnitudeV3(dx);
+         ++nna;
+      }
+      na=nna;
+      first=false;
+   }
+   dealloc2DRealArray(px,nb);
+   dealloc1DRealArray(pl);
+   dealloc2DRealArray(pg,nb);
+   dealloc2DRealArray(ph,nb);
+   dealloc1DRealArray(magh);
+   dealloc1DIntArray(act);
+   dealloc1DIntArray(cnt);
+}
+/* ************************************************************************************ */
+void critPtNetWork::getSeedResult(const int idx,solreal ** (&xx),solreal * (&ff),\
+      solreal ** (&gg),int * (&sg),solreal (&x)[3],solreal &ff2ret,solreal (&g)[3],int &sig)
 {
-   solreal lol,gl[3],hl[3][3],dx[3];
-   wf->evalHessLOL(x,lol,gl,hl);
-   sig=computeSignature(hl);
-   solreal magd=computeMagnitudeV3(gl);
-   if ( magd<CPNW_EPSRHOACPGRADMAG && sig==-3 ) {
-      ll=lol;
-      for ( int i=0 ; i<3 ; i++ ) {g[i]=gl[i];}
-      return;
-   }
-   solreal magh=magd;
-   int count=0;
-   while (((magd>CPNW_EPSRHOACPGRADMAG)&&(magh>CPNW_EPSFABSDIFFCOORD))&&(count<maxItACP)) {
-      getACPStep(gl,hl,dx,sig);
-      for (int i=0; i<3; i++) {x[i]+=(dx[i]/*MAXSTEPSIZEACPLOLSEARCH*/);}
-      wf->evalHessLOL(x,lol,gl,hl);
-      magd=sqrt(gl[0]*gl[0]+gl[1]*gl[1]+gl[2]*gl[2]);
-      magh=sqrt(dx[0]*dx[0]+dx[1]*dx[1]+dx[2]*dx[2]);
-      ++count;
+   for ( int k=0 ; k<3 ; k++ ) {
+      x[k]=xx[idx][k];
+      g[k]=gg[idx][k];
    }
-   for (int i=0; i<3; i++) {g[i]=gl[i];}
-   ll=lol;
-   return;
+   ff2ret=ff[idx];
+   sig=sg[idx];
 }
 /* ************************************************************************************ */
-void critPtNetWork::seekLOLBCP(solreal (&x)[3],solreal &ll,solreal (&g)[3],int &sig)
+bool critPtNetWork::allocSeedArrays(const int nsd,solreal ** (&xx),solreal * (&ff),\
+      solreal ** (&gg),int * (&sg))
 {
-   solreal lol,gl[3],hl[3][3],dx[3];
-   wf->evalHessLOL(x,lol,gl,hl);
-   sig=computeSignature(hl);
-   solreal magd=computeMagnitudeV3(gl);
-   if ( magd<CPNW_EPSRHOACPGRADMAG && sig==-1 ) {
-      ll=lol;
-      for ( int i=0 ; i<3 ; i++ ) {g[i]=gl[i];}
-      return;
-   }
-   solreal magh=magd;
-   int count=0;
-   while (((magd>CPNW_EPSRHOACPGRADMAG)&&(magh>CPNW_EPSFABSDIFFCOORD))&&(count<maxItBCP)) {
-      getBCPStep(gl,hl,dx,sig);
-      for (int i=0; i<3; i++) {x[i]+=(dx[i]/*MAXSTEPSIZEACPLOLSEARCH*/);}
-      wf->evalHessLOL(x,lol,gl,hl);
-      magd=sqrt(gl[0]*gl[0]+gl[1]*gl[1]+gl[2]*gl[2]);
-      magh=sqrt(dx[0]*dx[0]+dx[1]*dx[1]+dx[2]*dx[2]);
-      ++count;
-   }
-   for (int i=0; i<3; i++) {g[i]=gl[i];}
-   ll=lol;
-   return;
+   bool res=alloc2DRealArray(string("xx"),nsd,3,xx);
+   res=(res&&alloc1DRealArray(string("ff"),nsd,ff));
+   res=(res&&alloc2DRealArray(string("gg"),nsd,3,gg));
+   res=(res&&alloc1DIntArray(string("sg"),nsd,sg));
+   return res;
 }
 /* ************************************************************************************ */
-void critPtNetWork::seekLOLRCP(solreal (&x)[3],solreal &ll,solreal (&g)[3],int &sig)
+void critPtNetWork::deallocSeedArrays(const int nsd,solreal ** (&xx),solreal * (&ff),\
+      solreal ** (&gg),int * (&sg))
 {
-   solreal lol,gl[3],hl[3][3],dx[3];
-   wf->evalHessLOL(x,lol,gl,hl);
-   sig=computeSignature(hl);
-   solreal magd=computeMagnitudeV3(gl);
-   if ( magd<CPNW_EPSRHOACPGRADMAG && sig==1 ) {
-      ll=lol;
-      for ( int i=0 ; i<3 ; i++ ) {g[i]=gl[i];}
-      return;
+   dealloc2DRealArray(xx,nsd);
+   dealloc1DRealArray(ff);
+   dealloc2DRealArray(gg,nsd);
+   dealloc1DIntArray(sg);
+}
+/* ************************************************************************************ */
+int critPtNetWork::getBondedPairSeeds(int * (&sda),int * (&sdb),solreal ** (&xx),\
+      solreal * (&ff),solreal ** (&gg),int * (&sg))
+{
+   int nsd=bn->nBonds,atb;
+   allocSeedArrays(nsd,xx,ff,gg,sg);
+   alloc1DIntArray(string("sda"),nsd,sda);
+   alloc1DIntArray(string("sdb"),nsd,sdb);
+   for (int i=0; i<(bn->nNuc); i++) {
+      for (int k=bn->bNetStart[i]; k<bn->bNetStart[i+1]; k++) {
+         atb=bn->bNetList[k];
+         for (int j=0; j<3; j++) {xx[k][j]=0.5e0*(bn->R[i][j]+bn->R[atb][j]);}
+         sda[k]=i;
+         sdb[k]=atb;
+      }
    }
-   solreal magh=magd;
-   int count=0;
-   while (((magd>CPNW_EPSRHOACPGRADMAG)&&(magh>CPNW_EPSFABSDIFFCOORD))&&(count<maxItRCP)) {
-      getRCPStep(gl,hl,dx,sig);
-      for (int i=0; i<3; i++) {x[i]+=(dx[i]/*MAXSTEPSIZEACPLOLSEARCH*/);}
-      wf->evalHessLOL(x,lol,gl,hl);
-      magd=sqrt(gl[0]*gl[0]+gl[1]*gl[1]+gl[2]*gl[2]);
-      magh=sqrt(dx[0]*dx[0]+dx[1]*dx[1]+dx[2]*dx[2]);
-      ++count;
+   return nsd;
+}
+/* ************************************************************************************ */
+int critPtNetWork::getCPPairSeeds(const int ncp,solreal ** (&rcp),const solreal maxdd,\
+      int * (&sda),int * (&sdb),solreal ** (&xx),solreal * (&ff),solreal ** (&gg),int * (&sg))
+{
+   int nsd=getClosePairs(ncp,rcp,-1.0e0,maxdd,sda,sdb);
+   allocSeedArrays(nsd,xx,ff,gg,sg);
+   for (int i=0; i<nsd; i++) {
+      for (int k=0; k<3; k++) {xx[i][k]=0.5e0*(rcp[sda[i]][k]+rcp[sdb[i]][k]);}
    }
-   for (int i=0; i<3; i++) {g[i]=gl[i];}
-   ll=lol;
-   return;
+   return nsd;
 }
 /* ************************************************************************************ */
-void critPtNetWork::seekLOLCCP(solreal (&x)[3],solreal &ll,solreal (&g)[3],int &sig)
+int critPtNetWork::getClosePairs(const int npts,solreal ** (&rr),const solreal mindd,\
+      const solreal maxdd,int * (&pa),int * (&pb))
 {
-   solreal lol,gl[3],hl[3][3],dx[3];
-   wf->evalHessLOL(x,lol,gl,hl);
-   sig=computeSignature(hl);
-   solreal magd=computeMagnitudeV3(gl);
-   if ( magd<CPNW_EPSRHOACPGRADMAG && sig==3 ) {
-      ll=lol;
-      for ( int i=0 ; i<3 ; i++ ) {g[i]=gl[i];}
-      return;
+   int np=0,cap=0,nc,capc=0,*cand=NULL,j;
+   solreal x[3],dd;
+   pa=pb=NULL;
+   cellGrid3D grd;
+   grd.setCellSize(maxdd);
+   for (int i=0; i<npts; i++) {grd.addPoint(rr[i],i);}
+   for (int i=0; i<npts; i++) {
+      nc=grd.getCandidatesAround(rr[i],maxdd,cand,capc);
+      for (int c=0; c<nc; c++) {
+         j=cand[c];
+         if ( j<=i ) {continue;}
+         for (int k=0; k<3; k++) {x[k]=(rr[i][k]-rr[j][k]);}
+         dd=computeMagnitudeV3(x);
+         if ( (dd<mindd)||(dd>maxdd) ) {continue;}
+         if ( np==cap ) {
+            resize1DIntArray(string("pa"),cap,((cap>0)? (2*cap) : npts),pa);
+            resize1DIntArray(string("pb"),cap,((cap>0)? (2*cap) : npts),pb);
+            cap=((cap>0)? (2*cap) : npts);
+         }
+         pa[np]=i;
+         pb[np]=j;
+         ++np;
+      }
    }
-   solreal magh=magd;
-   int count=0;
-   while (((magd>CPNW_EPSRHOACPGRADMAG)&&(magh>CPNW_EPSFABSDIFFCOORD))&&(count<maxItRCP)) {
-      getCCPStep(gl,hl,dx,sig);
-      for (int i=0; i<3; i++) {x[i]+=(dx[i]/*MAXSTEPSIZEACPLOLSEARCH*/);}
-      wf->evalHessLOL(x,lol,gl,hl);
-      magd=sqrt(gl[0]*gl[0]+gl[1]*gl[1]+gl[2]*gl[2]);
-      magh=sqrt(dx[0]*dx[0]+dx[1]*dx[1]+dx[2]*dx[2]);
-      ++count;
+   dealloc1DIntArray(cand);
+   if ( pa==NULL ) {
+      alloc1DIntArray(string("pa"),1,pa);
+      alloc1DIntArray(string("pb"),1,pb);
    }
-   for (int i=0; i<3; i++) {g[i]=gl[i];}
-   ll=lol;
-   return;
+   return np;
 }
 /* ************************************************************************************ */
 int critPtNetWork::computeSignature(solreal (&hh)[3][3])
@@ -1783,35 +2911,29 @@ int critPtNetWork::computeSignature(solreal (&hh)[3][3])
    return computeSignature(b);
 }
 /* ************************************************************************************ */
-bool critPtNetWork::imNew(solreal (&x)[3],int dim,solreal ** (&arr),size_t &pos)
+bool critPtNetWork::imNew(solreal (&x)[3],solreal ** (&arr),cellGrid3D &grd,\
+      int ncp,size_t &pos)
 {
-   solreal ee;
-   int firstzeropos=0,k=1;
-   ee=arr[0][0]*arr[0][0]+arr[0][1]*arr[0][1]+arr[0][2]*arr[0][2];
-   while ((ee<1.0e49)&&(k<dim)) {
-      firstzeropos++;
-      ee=arr[k][0]*arr[k][0]+arr[k][1]*arr[k][1]+arr[k][2]*arr[k][2];
-      ++k;
-   }
-   if (k==dim) {
-      cout << "Warning: end of the array reached, perhaps you need a larger array...\n";
-      cout << "Returning false...\n";
+   //The grid is synchronised lazily with the first ncp points of arr.
+   if ( grd.getNofPoints()>ncp ) {grd.clear();}
+   for ( int i=grd.getNofPoints() ; i<ncp ; i++ ) {grd.addPoint(arr[i],i);}
+   int k=grd.findFirstWithin(x,CPNW_EPSFABSDIFFCOORD);
+   if ( k>=0 ) {
+      pos=k;
       return false;
    }
-   k=0;
-   while (k<firstzeropos) {
-      if ((fabs(x[0]-arr[k][0])<CPNW_EPSFABSDIFFCOORD)&&
-            (fabs(x[1]-arr[k][1])<CPNW_EPSFABSDIFFCOORD)&&
-            (fabs(x[2]-arr[k][2])<CPNW_EPSFABSDIFFCOORD)) {
-         pos=k;
-         return false;
-      }
-      ++k;
-   }
-   pos=firstzeropos;
+   pos=ncp;
    return true;
 }
 /* ************************************************************************************ */
+void critPtNetWork::clearCPGrids(void)
+{
+   gridACP.clear();
+   gridBCP.clear();
+   gridRCP.clear();
+   gridCCP.clear();
+}
+/* ************************************************************************************ */
 void critPtNetWork::displayXCPCoords(char cpt)
 {
    bool cpknow=false;
@@ -2478,6 +3600,7 @@ bool critPtNetWork::makePOVFile(string pnam,povRayConfProp &pvp,int campos)
       pof << "#end\n//end if DrawGradientPathSpheres" << endl;
  
    }
+   pvp.writeIncludedObject(pof,centMolecVec);
    pof.close();
    return true;
 }
@@ -2488,29 +3611,27 @@ void critPtNetWork::putBonds(ofstream &pof)
    int k=0,atni,atnk;
    solreal startpt[3],frak1;
    for (int i=0; i<bn->nNuc; i++) {
-      for (int j=0; j<MAXBONDINGATOMS; j++) {
-         k=bn->bNet[i][j];
-         atni=bn->atNum[i];
+      atni=bn->atNum[i];
+      for (int j=bn->bNetStart[i]; j<bn->bNetStart[i+1]; j++) {
+         k=bn->bNetList[j];
          atnk=bn->atNum[k];
          //frak1=atomicRadius[atni]/(atomicRadius[atni]+atomicRadius[atnk]);
          frak1=getAtomicVDWRadius(atni)/(getAtomicVDWRadius(atni)+getAtomicVDWRadius(atnk));
          for (int l=0; l<3; l++) {
             startpt[l]=bn->R[i][l]*(1.0e0-frak1)+bn->R[k][l]*frak1;
          }
-         if (k>0) {
-            writePOVCylinder(pof,1,
-                  bn->R[i][0],bn->R[i][1],bn->R[i][2],
-                  startpt[0],startpt[1],startpt[2],
-                  bn->drawStickSize*CPNW_ATOMCRITICALPOINTSIZEFACTOR,
-                  getAtomicRColorReal(atni),getAtomicGColorReal(atni),
-                  getAtomicBColorReal(atni));
-            writePOVCylinder(pof,1,
-                  startpt[0],startpt[1],startpt[2],
-                  bn->R[k][0],bn->R[k][1],bn->R[k][2],
-                  bn->drawStickSize*CPNW_ATOMCRITICALPOINTSIZEFACTOR,
-                  getAtomicRColorReal(atnk),getAtomicGColorReal(atnk),
-                  getAtomicBColorReal(atnk));
-         }
+         writePOVCylinder(pof,1,
+               bn->R[i][0],bn->R[i][1],bn->R[i][2],
+               startpt[0],startpt[1],startpt[2],
+               bn->drawStickSize*CPNW_ATOMCRITICALPOINTSIZEFACTOR,
+               getAtomicRColorReal(atni),getAtomicGColorReal(atni),
+               getAtomicBColorReal(atni));
+         writePOVCylinder(pof,1,
+               startpt[0],startpt[1],startpt[2],
+               bn->R[k][0],bn->R[k][1],bn->R[k][2],
+               bn->drawStickSize*CPNW_ATOMCRITICALPOINTSIZEFACTOR,
+               getAtomicRColorReal(atnk),getAtomicGColorReal(atnk),
+               getAtomicBColorReal(atnk));
       }
       writePOVSphere(pof,0,bn->R[i][0],bn->R[i][1],bn->R[i][2],
             bn->drawStickSize*CPNW_ATOMCRITICALPOINTSIZEFACTOR,
@@ -2541,6 +3662,7 @@ void critPtNetWork::centerMolecule(void)
    for (int i=0; i<3; i++) {
       trn[i]=0.5e0*(bn->rmax[i]+bn->rmin[i]);
    }
+   clearCPGrids();
    if (iknowacps) {
       for (int i=0; i<nACP; i++) {
          for (int j=0; j<3; j++) {
@@ -2569,26 +3691,9 @@ void critPtNetWork::centerMolecule(void)
          }
       }
    }
-   if (iknowbgps) {
-      for (int i=0; i<nBCP; i++) {
-         for (int j=0; j<conBCP[i][2]; j++) {
-            for (int k=0; k<3; k++) {
-               RBGP[i][j][k]-=trn[k];
-            }
-         }
-      }
-   }
-   if ( iknowrgps ) {
-      int kn,kp;
-      for ( int rcpIdx=0 ; rcpIdx<nRCP ; ++rcpIdx ) {
-         kn=getNofRingPathsOfRCP(rcpIdx);
-         for ( int j=0 ; j<kn ; ++j ) {
-            kp=conRCP[rcpIdx][1][j];
-            for ( int k=0 ; k<kp ; ++k ) {
-               for ( int l=0 ; l<3 ; ++l ) {RRGP[rcpIdx][j][k][l]-=trn[l];}
-            }
-         }
-      }
+   //All the gradient paths (bond, ring and cage paths) live in the arena.
+   for ( int i=0 ; i<nArenaGP ; ++i ) {
+      for ( int k=0 ; k<3 ; ++k ) {arenaGP[i][k]-=trn[k];}
    }
    bn->centerMolecule();
    for (int i=0; i<3; i++) {centMolecVec[i]=trn[i];}
@@ -2610,26 +3715,26 @@ bool critPtNetWork::readFromFile(string inname)
       return false;
    }
    cout << "Loading Critical Points information from file:\n   '" << inname << "'..." << endl;
+   clearCPGrids();
+   deallocGradPathViews();
+   deallocFlat2DRealArray(arenaGP);
+   nArenaGP=dArenaGP=0;
    mycptype=cpxGetCriticalPointFieldType(cfil);
    nACP=cpxGetNOfACPs(cfil);
    switch (mycptype) {
       case DENS:
-         dACP=nACP*CPNW_MAXRHOACPSPERATOM;
-         break;
       case LOLD:
-         dACP=nACP*CPNW_MAXLOLACPSPERATOM;
          break;
       default:
          displayWarningMessage("This field has not been implemented!");
          exit(1);
          break;
    }
-   if (dACP<0) {
+   if (nACP<0) {
       displayWarningMessage(string("ACPs are not given in file "+inname));
       iknowacps=false;
    } else {
-      alloc2DRealArray(string("RACP"),dACP,3,RACP,1.0e+50);
-      alloc1DStringArray("lblACP",dACP,lblACP);
+      allocXCPArrays('a',nACP+1);
       if (nACP>=0) {
          cpxGetACPCartCoordFromFile(cfil,nACP,RACP);
          cpxGetACPLabelsFromFile(cfil,nACP,lblACP);
@@ -2640,10 +3745,7 @@ bool critPtNetWork::readFromFile(string inname)
    }
    if (iknowacps) {
       nBCP=cpxGetNOfBCPs(cfil);
-      dBCP=(nACP*(nACP-1))/2;
-      alloc2DRealArray(string("RBCP"),dBCP,3,RBCP,1.0e+50);
-      alloc2DIntArray(string("conBCP"),dBCP,3,conBCP,-1);
-      alloc1DStringArray("lblBCP",dBCP,lblBCP);
+      allocXCPArrays('b',((nBCP>nACP)? nBCP : nACP)+1);
       if (nBCP>=0) {
          cpxGetBCPCartCoordFromFile(cfil,nBCP,RBCP);
          cpxGetBCPConnectivityFromFile(cfil,nBCP,conBCP);
@@ -2660,11 +3762,9 @@ bool critPtNetWork::readFromFile(string inname)
    }
    if (iknowbcps) {
       nRCP=cpxGetNOfRCPs(cfil);
-      dRCP=(nBCP*(nBCP-1))/2;
-      if ( dRCP<CPNW_MINARRAYSIZE ) {dRCP=CPNW_MINARRAYSIZE;}
-      alloc2DRealArray(string("RRCP"),dRCP,3,RRCP,1.0e+50);
-      alloc1DStringArray("lblRCP",dRCP,lblRCP);
-      alloc3DIntArray("conRCP",dRCP,2,CPNW_MAXBCPSCONNECTEDTORCP,conRCP,-1);
+      wConRCP=cpxGetMaxNOfBCPsConnectedToRCP(cfil,nRCP)+1;
+      if ( wConRCP<CPNW_INITBCPSCONNECTEDTORCP ) {wConRCP=CPNW_INITBCPSCONNECTEDTORCP;}
+      allocXCPArrays('r',nRCP+1);
       if (nRCP>=0) {
          cpxGetRCPCartCoordFromFile(cfil,nRCP,RRCP);
          cpxGetRCPLabelsFromFile(cfil,nRCP,lblRCP);
@@ -2676,11 +3776,9 @@ bool critPtNetWork::readFromFile(string inname)
    }
    if (iknowrcps) {
       nCCP=cpxGetNOfCCPs(cfil);
-      dCCP=(nRCP*(nRCP-1))/2;
-      if ( dCCP<CPNW_MINARRAYSIZE ) {dCCP=CPNW_MINARRAYSIZE;}
-      alloc2DRealArray(string("RCCP"),dCCP,3,RCCP,1.0e+50);
-      alloc1DStringArray("lblCCP",dCCP,lblCCP);
-      alloc3DIntArray("conCCP",dCCP,2,CPNW_MAXRCPSCONNECTEDTOCCP,conCCP,-1);
+      wConCCP=cpxGetMaxNOfRCPsConnectedToCCP(cfil,nCCP)+1;
+      if ( wConCCP<CPNW_INITRCPSCONNECTEDTOCCP ) {wConCCP=CPNW_INITRCPSCONNECTEDTOCCP;}
+      allocXCPArrays('c',nCCP+1);
       if (nCCP>=0) {
          cpxGetCCPCartCoordFromFile(cfil,nCCP,RCCP);
          cpxGetCCPLabelsFromFile(cfil,nCCP,lblCCP);
@@ -2691,33 +3789,38 @@ bool critPtNetWork::readFromFile(string inname)
       }
    }
    iknowallcps=(iknowacps&&iknowbcps&&iknowrcps&&iknowccps);
+   //The numbers of points of all the paths are read first, so that their places
+   //in the arena can be reserved before reading the coordinates.
    nBGP=cpxGetNOfBondPaths(cfil);
-   if (dBCP>0) {alloc3DRealArray(string("RBGP"),dBCP,CPNW_ARRAYSIZEGRADPATH,3,RBGP);}
-   if (nBGP>=0&&conBCP!=NULL) {
+   iknowbgps=(nBGP>=0&&conBCP!=NULL);
+   if (iknowbgps) {
       cpxGetNOfPtsPerBondPath(cfil,nBGP,conBCP);
-      cpxGetBondPathData(cfil,nBGP,conBCP,RBGP);
-      iknowbgps=true;
-   } else {iknowbgps=false;}
-   nRGP=cpxGetNOfRingPaths(cfil);
-   if (dRCP>0) {
-      alloc4DRealArray(string("RRGP"),dRCP,CPNW_MAXBCPSCONNECTEDTORCP,\
-            CPNW_ARRAYSIZEGRADPATH,3,RRGP);
+      for ( int i=0 ; i<nBGP ; ++i ) {conBCP[i][3]=reserveGradPath(conBCP[i][2]);}
    }
-   if ( nRGP>=0 && conRCP!=NULL ) {
+   nRGP=cpxGetNOfRingPaths(cfil);
+   iknowrgps=( nRGP>=0 && conRCP!=NULL );
+   if ( iknowrgps ) {
       cpxGetNOfPtsPerRingPath(cfil,nRCP,conRCP);
-      cpxGetRingPathData(cfil,nRCP,conRCP,RRGP);
-      iknowrgps=true;
-   } else { iknowrgps=false; }
-   nCGP=cpxGetNOfCagePaths(cfil);
-   if (dCCP>0) {
-      alloc4DRealArray(string("RCGP"),dCCP,CPNW_MAXRCPSCONNECTEDTOCCP,\
-            CPNW_ARRAYSIZEGRADPATH,3,RCGP);
+      for ( int i=0 ; i<nRCP ; ++i ) {
+         for ( int k=0 ; conRCP[i][0][k]>=0 ; ++k ) {
+            conRCP[i][2][k]=reserveGradPath(conRCP[i][1][k]);
+         }
+      }
    }
-   if ( nCGP>=0 && conCCP!=NULL ) {
+   nCGP=cpxGetNOfCagePaths(cfil);
+   iknowcgps=( nCGP>=0 && conCCP!=NULL );
+   if ( iknowcgps ) {
       cpxGetNOfPtsPerCagePath(cfil,nCCP,conCCP);
-      cpxGetCagePathData(cfil,nCCP,conCCP,RCGP);
-      iknowcgps=true;
-   } else { iknowcgps=false; }
+      for ( int i=0 ; i<nCCP ; ++i ) {
+         for ( int k=0 ; conCCP[i][0][k]>=0 ; ++k ) {
+            conCCP[i][2][k]=reserveGradPath(conCCP[i][1][k]);
+         }
+      }
+   }
+   rebuildGradPathViews();
+   if (iknowbgps) {cpxGetBondPathData(cfil,nBGP,conBCP,RBGP);}
+   if (iknowrgps) {cpxGetRingPathData(cfil,nRCP,conRCP,RRGP);}
+   if (iknowcgps) {cpxGetCagePathData(cfil,nCCP,conCCP,RCGP);}
    iknowallgps=iknowbgps&&iknowrgps&&iknowcgps;
    cout << "Critical Point State Loaded!" << endl;
    displayStatus(true);
@@ -2774,8 +3877,7 @@ int critPtNetWork::findSingleRhoBondGradientPathRK5(int at1,int at2,solreal hste
    maggrad=sqrt(maggrad);
    //hstep=DEFAULTHGRADIENTPATHS;
    for (int i=0; i<3; i++) {rn[i]=ro[i]+hstep*eive[i][2]/maggrad;}
-   wf->evalRhoGradRho(rn[0],rn[1],rn[2],rho,g);
-   maggrad=sqrt(g[0]*g[0]+g[1]*g[1]+g[2]*g[2]);
+   startGradientPathDP54(rn,hstep,true,maggrad);
    //cout << "maggrad: " << maggrad << endl;
    for (int i=0; i<3; i++) {
       arbgp[0][i]=ro[i];
@@ -2790,7 +3892,7 @@ int critPtNetWork::findSingleRhoBondGradientPathRK5(int at1,int at2,solreal hste
    iacp2=3*at2;
    solreal loopdist;
    while ((!iminacp)&&(count<maxit)&&(maggrad>EPSGRADMAG)) {
-      getNextPointInGradientPathRK5UpHill(rn,hstep,maggrad);
+      getNextPointInGradientPathDP54(rn,hstep,maggrad);
       for (int i=0; i<3; i++) {arbgp[count][i]=rn[i];}
       dist=0.0e0;
       for (int i=0; i<3; i++) {dist+=((rn[i]-wf->R[iacp1+i])*(rn[i]-wf->R[iacp1+i]));}
@@ -2830,8 +3932,7 @@ int critPtNetWork::findSingleRhoBondGradientPathRK5(int at1,int at2,solreal hste
    for (int i=0; i<3; i++) {maggrad+=(eive[i][2]*eive[i][2]);}
    maggrad=sqrt(maggrad);
    for (int i=0; i<3; i++) {rn[i]=ro[i]-hstep*eive[i][2]/maggrad;}
-   wf->evalRhoGradRho(rn[0],rn[1],rn[2],rho,g);
-   maggrad=sqrt(g[0]*g[0]+g[1]*g[1]+g[2]*g[2]);
+   startGradientPathDP54(rn,hstep,true,maggrad);
    //cout << "maggrad: " << maggrad << endl;
    for (int i=0; i<3; i++) {
       arbgp[count][i]=rn[i];
@@ -2841,7 +3942,7 @@ int critPtNetWork::findSingleRhoBondGradientPathRK5(int at1,int at2,solreal hste
    maxit+=count;
    iminacp=false;
    while ((!iminacp)&&(count<maxit)&&(maggrad>EPSGRADMAG)) {
-      getNextPointInGradientPathRK5UpHill(rn,hstep,maggrad);
+      getNextPointInGradientPathDP54(rn,hstep,maggrad);
       for (int i=0; i<3; i++) {arbgp[count][i]=rn[i];}
       dist=0.0e0;
       for (int i=0; i<3; i++) {dist+=((rn[i]-wf->R[iacp1+i])*(rn[i]-wf->R[iacp1+i]));}
@@ -2898,7 +3999,7 @@ int critPtNetWork::findSingleRhoRingGradientPathRK5(int rcpIdx,\
 {
    int bcpGlobIdx=conRCP[rcpIdx][0][bcpIdxInRRGP];
 #if DEBUG
-   if ( bcpIdxInRRGP>CPNW_MAXBCPSCONNECTEDTORCP || bcpIdxInRRGP < 0 ) {
+   if ( bcpIdxInRRGP>=wConRCP || bcpIdxInRRGP < 0 ) {
       displayErrorMessage("Out of conRCP bounds!");
       DISPLAYDEBUGINFOFILELINE;
    }
@@ -3028,7 +4129,7 @@ int critPtNetWork::findSingleRhoCageGradientPathRK5(int ccpIdx,\
 {
    int rcpGlobIdx=conCCP[ccpIdx][0][rcpIdxInRCGP];
 #if DEBUG
-   if ( rcpIdxInRCGP>CPNW_MAXRCPSCONNECTEDTOCCP || rcpIdxInRCGP < 0 ) {
+   if ( rcpIdxInRCGP>=wConCCP || rcpIdxInRCGP < 0 ) {
       displayErrorMessage("Out of conCCP bounds!");
       DISPLAYDEBUGINFOFILELINE;
    }
@@ -3095,15 +4196,12 @@ bool critPtNetWork::walkGradientPathRK5ToEndPoint(\
    solreal mxlen2=maxlen*maxlen,pathlength=magd;
    solreal epsd2=hstep*hstep;
    //solreal epsd2=CPNW_EPSFABSDIFFCOORD*CPNW_EPSFABSDIFFCOORD;
-   solreal maggrad=1.0e0;
+   solreal maggrad;
+   startGradientPathDP54(xn,hstep,uphilldir,maggrad);
    bool imatend=false;
    int count=2;
    while ((!imatend)&&(count<dima)&&(pathlength<mxlen2)) {
-      if ( uphilldir ) {
-         getNextPointInGradientPathRK5UpHill(xn,hstep,maggrad);
-      } else {
-         getNextPointInGradientPathRK5DownHill(xn,hstep,maggrad);
-      }
+      getNextPointInGradientPathDP54(xn,hstep,maggrad);
       magd=maggrad=0.0e0;
       for (int i=0; i<3; ++i) {
          magd+=((xn[i]-xe[i])*(xn[i]-xe[i]));
@@ -3123,8 +4221,8 @@ bool critPtNetWork::walkGradientPathRK5ToEndPoint(\
       }
       ++count;
    }
-   if ( count==CPNW_ARRAYSIZEGRADPATH ) {
-      displayWarningMessage("End or array reached, need larger array?");
+   if ( count==dima ) {
+      displayWarningMessage("Maximum number of points reached, need longer paths?");
 #if DEBUG
       DISPLAYDEBUGINFOFILELINE;
 #endif /* ( DEBUG ) */
@@ -3166,108 +4264,139 @@ bool critPtNetWork::seekSingleRhoBCP(int ata,int atb,solreal (&x)[3])
    return true;
 }
 /* ************************************************************************************ */
-void critPtNetWork::getNextPointInGradientPathRK5UpHill(solreal (&xn)[3],solreal &stepsize,\
+void critPtNetWork::startGradientPathDP54(solreal (&x0)[3],const solreal hstep,\
+      const bool uphill,solreal &mgg)
+{
+   gpDir=(uphill? 1.0e0 : -1.0e0);
+   for ( int i=0 ; i<3 ; ++i ) {gpX1[i]=x0[i];}
+   gpMagG1=evalGradientPathDirection(gpX1,gpF1);
+   gpS0=gpS=gpH=0.0e0;
+   gpHMin=CPNW_GRADPATHDP54MINSTEPFACTOR*hstep;
+   gpHMax=CPNW_GRADPATHDP54MAXSTEPFACTOR*hstep;
+   gpHNext=hstep;
+   mgg=gpMagG1;
+   return;
+}
+/* ************************************************************************************ */
+void critPtNetWork::getNextPointInGradientPathDP54(solreal (&xn)[3],const solreal ds,\
       solreal &mgg)
 {
-   /*
-   static const solreal b[15]={0.2e0, 3.0e0/40.0e0, 9.0e0/40.0e0, 0.3e0, -0.9e0, 1.2e0, \
-      -11.0e0/54.0e0, 2.5e0, -70.0e0/27.0e0, 35.0e0/27.0e0, 1631.0e0/55296.0e0, \
-         175.0e0/512.0e0, 575.0e0/13824.0e0, 44275.0e0/110592.0e0, 253.0e0/4096.0e0};
-   static const solreal c1=37.0e0/378.0e0;
-   static const solreal c3=250.0e0/621.0e0;
-   static const solreal c4=125.0e0/594.0e0;
-   static const solreal c6=512.0e0/1771.0e0;
-   solreal k[6][3],rho,g[3],xt[3],maggrad;
-   int offset;
-   for(int i=0; i<6; i++) {
-      offset=((i*(i-1))>>1);
-      for(int j=0; j<3; j++) {
-         xt[j] = xn[j];
-         for(int l=0; l<i; l++) {
-            xt[j] += b[l+offset]*k[l][j];
-         }
-      }
-      wf->evalRhoGradRho(xt[0],xt[1],xt[2],rho,g);
-      maggrad=sqrt(g[0]*g[0]+g[1]*g[1]+g[2]*g[2]);
-      for(int l=0; l<3; l++) {
-         k[i][l] = stepsize*g[l]/maggrad;
-      }
+   gpS+=ds;
+   while ( gpS>(gpS0+gpH) ) {stepGradientPathDP54();}
+   solreal th=(gpS-gpS0)/gpH,th1=1.0e0-th;
+   for ( int i=0 ; i<3 ; ++i ) {
+      xn[i]=gpCont[0][i]+th*(gpCont[1][i]+th1*(gpCont[2][i]\
+               +th*(gpCont[3][i]+th1*gpCont[4][i])));
    }
-   // */
-   static const solreal b[21]={1.0e0/5.0e0, \
+   mgg=th1*gpMagG0+th*gpMagG1;
+   return;
+}
+/* ************************************************************************************ */
+void critPtNetWork::stepGradientPathDP54(void)
+{
+   /* Dormand--Prince 5(4) coefficients (E. Hairer, S.P. Norsett, G. Wanner, Solving
+      Ordinary Differential Equations I, 2nd ed., Springer, 1993), with the 4th order
+      continuous extension used for the dense output. The last stage is evaluated at
+      the new point, so it is reused as the first stage of the next step.  */
+   static const solreal a[21]={1.0e0/5.0e0, \
       3.0e0/40.0e0, 9.0e0/40.0e0, \
       44.0e0/45.0e0, -56.0e0/15.0e0, 32.0e0/9.0e0, \
       19372.0e0/6561.0e0, -25360.0e0/2187.0e0, 64448.0e0/6561.0e0, -212.0e0/729.0e0,\
-      9017.0e0/3168.0e0, -355.0e0/33.0e0, 46732.0e0/5247.0e0, 49.0e0/176.0e0, -5103.0e0/18656.0e0,\
-      35.0e0/384.0e0, 0.0e0, 500.0e0/1113.0e0, 125.0e0/192.0e0, -2187.0e0/6784.0e0,11.0e0/84.0e0};
-   static const solreal c1=35.0e0/384.0e0;
-   static const solreal c3=500.0e0/1113.0e0;
-   static const solreal c4=125.0e0/192.0e0;
-   static const solreal c5=-2187.0e0/6784.0e0;
-   static const solreal c6=11.0e0/84.0e0;
-   solreal k[7][3],rho,g[3],xt[3],maggrad;
+      9017.0e0/3168.0e0, -355.0e0/33.0e0, 46732.0e0/5247.0e0, 49.0e0/176.0e0, \
+      -5103.0e0/18656.0e0,\
+      35.0e0/384.0e0, 0.0e0, 500.0e0/1113.0e0, 125.0e0/192.0e0, -2187.0e0/6784.0e0,\
+      11.0e0/84.0e0};
+   static const solreal e[7]={71.0e0/57600.0e0, 0.0e0, -71.0e0/16695.0e0, \
+      71.0e0/1920.0e0, -17253.0e0/339200.0e0, 22.0e0/525.0e0, -1.0e0/40.0e0};
+   static const solreal d[7]={-12715105075.0e0/11282082432.0e0, 0.0e0, \
+      87487479700.0e0/32700410799.0e0, -10690763975.0e0/1880347072.0e0, \
+      701980252875.0e0/199316789632.0e0, -1453857185.0e0/822651844.0e0, \
+      69997945.0e0/29380423.0e0};
+   solreal k[7][3],xt[3],err,fac,magg=0.0e0,h=gpHNext;
    int offset;
-   for(int i=0; i<7; i++) {
-      offset=((i*(i-1))>>1);
-      for(int j=0; j<3; j++) {
-         xt[j] = xn[j];
-         for(int l=0; l<i; l++) {
-            xt[j] += b[l+offset]*k[l][j];
+   for ( int i=0 ; i<3 ; ++i ) {k[0][i]=gpF1[i];}
+   bool accepted=false,rejected=false;
+   while ( !accepted ) {
+      for ( int s=1 ; s<7 ; ++s ) {
+         offset=((s*(s-1))>>1);
+         for ( int j=0 ; j<3 ; ++j ) {
+            xt[j]=0.0e0;
+            for ( int l=0 ; l<s ; ++l ) {xt[j]+=a[l+offset]*k[l][j];}
+            xt[j]=gpX1[j]+h*xt[j];
          }
+         magg=evalGradientPathDirection(xt,k[s]);
       }
-      wf->evalRhoGradRho(xt[0],xt[1],xt[2],rho,g);
-      maggrad=sqrt(g[0]*g[0]+g[1]*g[1]+g[2]*g[2]);
-      for(int l=0; l<3; l++) {
-         k[i][l] = stepsize*g[l]/maggrad;
+      err=0.0e0;
+      for ( int j=0 ; j<3 ; ++j ) {
+         fac=0.0e0;
+         for ( int l=0 ; l<7 ; ++l ) {fac+=e[l]*k[l][j];}
+         fac*=(h/CPNW_GRADPATHDP54TOL);
+         err+=(fac*fac);
+      }
+      err=sqrt(err/3.0e0);
+      if ( err>0.0e0 ) {
+         fac=0.9e0*pow(err,-0.2e0);
+         if ( fac<0.2e0 ) {fac=0.2e0;}
+         if ( fac>5.0e0 ) {fac=5.0e0;}
+      } else {
+         fac=5.0e0;
+      }
+      if ( err<=1.0e0 || h<=gpHMin ) {
+         accepted=true;
+      } else {
+         h*=fac;
+         if ( h<gpHMin ) {h=gpHMin;}
+         rejected=true;
       }
    }
-   for(int i=0; i<3; i++) {
-      xn[i]+=(c1*k[0][i]+c3*k[2][i]+c4*k[3][i]+c5*k[4][i]+c6*k[5][i]);
-   }
-   wf->evalRhoGradRho(xn[0],xn[1],xn[2],rho,g);
-   mgg=sqrt(g[0]*g[0]+g[1]*g[1]+g[2]*g[2]);
+   //Do not enlarge the step right after a rejection.
+   if ( rejected && fac>1.0e0 ) {fac=1.0e0;}
+   //The step is accepted; xt, k[6] and magg are the new point, direction and |grad|.
+   gpS0+=gpH;
+   gpH=h;
+   gpMagG0=gpMagG1;
+   gpMagG1=magg;
+   solreal dx,bspl;
+   for ( int j=0 ; j<3 ; ++j ) {
+      dx=xt[j]-gpX1[j];
+      bspl=h*k[0][j]-dx;
+      gpCont[0][j]=gpX1[j];
+      gpCont[1][j]=dx;
+      gpCont[2][j]=bspl;
+      gpCont[3][j]=dx-h*k[6][j]-bspl;
+      gpCont[4][j]=0.0e0;
+      for ( int l=0 ; l<7 ; ++l ) {gpCont[4][j]+=d[l]*k[l][j];}
+      gpCont[4][j]*=h;
+      gpX0[j]=gpX1[j];
+      gpF0[j]=gpF1[j];
+      gpX1[j]=xt[j];
+      gpF1[j]=k[6][j];
+   }
+   h*=fac;
+   /* If the gradient is vanishing along the path, a linear extrapolation of its
+      magnitude estimates how far the end point (a maximum or a minimum of rho) is;
+      larger steps would overshoot it and be rejected.  */
+   if ( gpMagG1<gpMagG0 ) {
+      fac=gpH*gpMagG1/(gpMagG0-gpMagG1);
+      if ( h>fac ) {h=fac;}
+   }
+   if ( h>gpHMax ) {h=gpHMax;}
+   if ( h<gpHMin ) {h=gpHMin;}
+   gpHNext=h;
    return;
 }
 /* ************************************************************************************ */
-void critPtNetWork::getNextPointInGradientPathRK5DownHill(solreal (&xn)[3],\
-      solreal &stepsize,solreal &mgg)
+solreal critPtNetWork::evalGradientPathDirection(const solreal (&x)[3],solreal (&f)[3])
 {
-   static const solreal b[21]={1.0e0/5.0e0, \
-      3.0e0/40.0e0, 9.0e0/40.0e0, \
-         44.0e0/45.0e0, -56.0e0/15.0e0, 32.0e0/9.0e0, \
-         19372.0e0/6561.0e0, -25360.0e0/2187.0e0, \
-         64448.0e0/6561.0e0, -212.0e0/729.0e0,\
-         9017.0e0/3168.0e0, -355.0e0/33.0e0, 46732.0e0/5247.0e0, \
-         49.0e0/176.0e0, -5103.0e0/18656.0e0,\
-         35.0e0/384.0e0, 0.0e0, 500.0e0/1113.0e0, 125.0e0/192.0e0, \
-         -2187.0e0/6784.0e0,11.0e0/84.0e0};
-   static const solreal c1=35.0e0/384.0e0;
-   static const solreal c3=500.0e0/1113.0e0;
-   static const solreal c4=125.0e0/192.0e0;
-   static const solreal c5=-2187.0e0/6784.0e0;
-   static const solreal c6=11.0e0/84.0e0;
-   solreal k[7][3],rho,g[3],xt[3],maggrad;
-   int offset;
-   for(int i=0; i<7; i++) {
-      offset=((i*(i-1))>>1);
-      for(int j=0; j<3; j++) {
-         xt[j] = xn[j];
-         for(int l=0; l<i; l++) {
-            xt[j] += b[l+offset]*k[l][j];
-         }
-      }
-      wf->evalRhoGradRho(xt[0],xt[1],xt[2],rho,g);
-      maggrad=sqrt(g[0]*g[0]+g[1]*g[1]+g[2]*g[2]);
-      for(int l=0; l<3; l++) {
-         k[i][l] = -stepsize*g[l]/maggrad;
-      }
-   }
-   for(int i=0; i<3; i++) {
-      xn[i]+=(c1*k[0][i]+c3*k[2][i]+c4*k[3][i]+c5*k[4][i]+c6*k[5][i]);
+   solreal rho,g[3];
+   wf->evalRhoGradRho(x[0],x[1],x[2],rho,g);
+   solreal maggrad=sqrt(g[0]*g[0]+g[1]*g[1]+g[2]*g[2]);
+   if ( maggrad>0.0e0 ) {
+      for ( int i=0 ; i<3 ; ++i ) {f[i]=gpDir*g[i]/maggrad;}
+   } else {
+      for ( int i=0 ; i<3 ; ++i ) {f[i]=0.0e0;}
    }
-   wf->evalRhoGradRho(xn[0],xn[1],xn[2],rho,g);
-   mgg=sqrt(g[0]*g[0]+g[1]*g[1]+g[2]*g[2]);
-   return;
+   return maggrad;
 }
 /* ************************************************************************************ */
 void critPtNetWork::findMaxBondDist()
@@ -3310,17 +4439,7 @@ void critPtNetWork::addBCP2ConRCP(const int rcpIdx,const int bcpIdx)
       DISPLAYDEBUGINFOFILELINE;
    }
 #endif /* ( DEBUG ) */
-   int k=0;
-   while ( k<CPNW_MAXBCPSCONNECTEDTORCP && conRCP[rcpIdx][0][k]!=bcpIdx ) {
-      if ( conRCP[rcpIdx][0][k]<0 ) {conRCP[rcpIdx][0][k]=bcpIdx; return;}
-      ++k;
-   }
-   if ( k==CPNW_MAXBCPSCONNECTEDTORCP ) {
-      displayWarningMessage("Perhaps you need a larger array for conRCP!");
-#if DEBUG
-         DISPLAYDEBUGINFOFILELINE;
-#endif /* ( DEBUG ) */
-   }
+   addToConRCP(rcpIdx,bcpIdx);
 }
 /* ************************************************************************************ */
 void critPtNetWork::addRCP2ConCCP(const int ccpIdx,const int rcpIdx)
@@ -3331,17 +4450,7 @@ void critPtNetWork::addRCP2ConCCP(const int ccpIdx,const int rcpIdx)
       DISPLAYDEBUGINFOFILELINE;
    }
 #endif /* ( DEBUG ) */
-   int k=0;
-   while ( k<CPNW_MAXRCPSCONNECTEDTOCCP && conCCP[ccpIdx][0][k]!=rcpIdx ) {
-      if ( conCCP[ccpIdx][0][k]<0 ) {conCCP[ccpIdx][0][k]=rcpIdx; return;}
-      ++k;
-   }
-   if ( k==CPNW_MAXRCPSCONNECTEDTOCCP ) {
-      displayWarningMessage("Perhaps you need a larger array for conCCP!");
-#if DEBUG
-         DISPLAYDEBUGINFOFILELINE;
-#endif /* ( DEBUG ) */
-   }
+   addToConCCP(ccpIdx,rcpIdx);
 }
 /* ************************************************************************************ */
 void critPtNetWork::correctRCPConnectivity(void)
@@ -3354,7 +4463,7 @@ void critPtNetWork::correctRCPConnectivity(void)
    int j,bcpIdx;
    for ( int i=0 ; i<nRCP ; ++i ) {
       j=0;
-      while ( j<CPNW_MAXBCPSCONNECTEDTORCP && conRCP[i][0][j]>=0 ) {
+      while ( conRCP[i][0][j]>=0 ) {
          bcpIdx=conRCP[i][0][j];
          dd=0.0e0;
          for ( int k=0; k<3 ; ++k ) {
@@ -3384,14 +4493,13 @@ void critPtNetWork::removeFromConRCP(const int rcpIdx,const int pos2rem)
    while ( conRCP[rcpIdx][0][total]>=0 ) {++total;}
    --total;
    if ( pos2rem==total ) {
-      conRCP[rcpIdx][0][total]=conRCP[rcpIdx][1][total]=-1;
+      for ( int j=0 ; j<3 ; ++j ) {conRCP[rcpIdx][j][total]=-1;}
       return;
    }
-   int tmp=conRCP[rcpIdx][0][total];
-   conRCP[rcpIdx][0][pos2rem]=tmp;
-   tmp=conRCP[rcpIdx][1][total];
-   conRCP[rcpIdx][1][pos2rem]=tmp;
-   conRCP[rcpIdx][0][total]=conRCP[rcpIdx][1][total]=-1;
+   for ( int j=0 ; j<3 ; ++j ) {
+      conRCP[rcpIdx][j][pos2rem]=conRCP[rcpIdx][j][total];
+      conRCP[rcpIdx][j][total]=-1;
+   }
    /*
    int total=0;
    while ( conRCP[rcpIdx][0][total]>=0 ) {++total;}
@@ -3416,14 +4524,9 @@ void critPtNetWork::addToConRCP(const int rcpIdx,const int bcpIdx)
    while (conRCP[rcpIdx][0][mypos]>=0) {
       if ( conRCP[rcpIdx][0][mypos]==bcpIdx ) {return;}
       ++mypos;
-      if ( mypos==CPNW_MAXBCPSCONNECTEDTORCP ) {
-         displayWarningMessage("End of array reached, need bigger array!");
-#if DEBUG
-         DISPLAYDEBUGINFOFILELINE;
-#endif /* ( DEBUG ) */
-         return;
-      }
    }
+   //The list must keep its terminating (negative) entry.
+   if ( (mypos+1)>=wConRCP ) {widenConXCP('r');}
    conRCP[rcpIdx][0][mypos]=bcpIdx;
 }
 /* ************************************************************************************ */
@@ -3433,14 +4536,8 @@ void critPtNetWork::addToConCCP(const int ccpIdx,const int rcpIdx)
    while (conCCP[ccpIdx][0][mypos]>=0) {
       if ( conCCP[ccpIdx][0][mypos]==rcpIdx ) {return;}
       ++mypos;
-      if ( mypos==CPNW_MAXRCPSCONNECTEDTOCCP ) {
-         displayWarningMessage("End of array reached, need bigger array!");
-#if DEBUG
-         DISPLAYDEBUGINFOFILELINE;
-#endif /* ( DEBUG ) */
-         return;
-      }
    }
+   if ( (mypos+1)>=wConCCP ) {widenConXCP('c');}
    conCCP[ccpIdx][0][mypos]=rcpIdx;
 }
 /* ************************************************************************************ */
@@ -3450,9 +4547,9 @@ void critPtNetWork::setRingPaths()
       displayErrorMessage("Please look first for the RCPs...\nNothing to be done!");
       return;
    }
-   alloc4DRealArray(string("RRGP"),dRCP,CPNW_MAXBCPSCONNECTEDTORCP,\
-         CPNW_ARRAYSIZEGRADPATH,3,RRGP);
    correctRCPConnectivity();
+   solreal **tgp;
+   allocFlat2DRealArray(string("tgp"),maxPtsGP,3,tgp);
    cout << "Calculating Ring Gradient Paths..." << endl;
 #if DEBUG
    cout << "nRCP: " << nRCP << endl;
@@ -3462,7 +4559,7 @@ void critPtNetWork::setRingPaths()
 #endif
    solreal hstep; //,rseed[3];
    hstep=CPNW_DEFAULTGRADIENTPATHS;
-   int arrsize=CPNW_ARRAYSIZEGRADPATH;
+   int arrsize=maxPtsGP;
    int currBcpPos,npts;
 #if DEBUG
    int bcpIdx;
@@ -3479,7 +4576,7 @@ void critPtNetWork::setRingPaths()
 #endif
          //for (int k=0; k<3; k++) {rseed[k]=RBCP[bcpIdx][k];}
          npts=findSingleRhoRingGradientPathRK5(rcpIdx,\
-               currBcpPos,hstep,arrsize,RRGP[rcpIdx][currBcpPos]);
+               currBcpPos,hstep,arrsize,tgp);
 #if DEBUG
          if ( npts<0 ) {
             displayWarningMessage("Catched -1");
@@ -3487,6 +4584,7 @@ void critPtNetWork::setRingPaths()
          }
 #endif /* ( DEBUG ) */
          conRCP[rcpIdx][1][currBcpPos]=npts;
+         conRCP[rcpIdx][2][currBcpPos]=appendGradPath(tgp,npts);
          ++currBcpPos;
       }
 #if USEPROGRESSBAR
@@ -3498,6 +4596,8 @@ void critPtNetWork::setRingPaths()
    printProgressBar(100);
    cout << endl;
 #endif
+   deallocFlat2DRealArray(tgp);
+   rebuildGradPathViews();
    iknowrgps=true;
    iknowallgps=(iknowbgps&&iknowrgps&&iknowcgps);
 }
@@ -3508,8 +4608,8 @@ void critPtNetWork::setCagePaths(void)
       displayErrorMessage("Please look first for the CCPs...\nNothing to be done!");
       return;
    }
-   alloc4DRealArray(string("RCGP"),dCCP,CPNW_MAXRCPSCONNECTEDTOCCP,\
-         CPNW_ARRAYSIZEGRADPATH,3,RCGP);
+   solreal **tgp;
+   allocFlat2DRealArray(string("tgp"),maxPtsGP,3,tgp);
    cout << "Calculating Cage Gradient Paths..." << endl;
 #if DEBUG
    cout << "nCCP: " << nCCP << endl;
@@ -3520,7 +4620,7 @@ void critPtNetWork::setCagePaths(void)
 #endif
    solreal hstep; //,rseed[3];
    hstep=CPNW_DEFAULTGRADIENTPATHS;
-   int arrsize=CPNW_ARRAYSIZEGRADPATH;
+   int arrsize=maxPtsGP;
    //int rcpIdx;
    int currRcpPos,npts;
    for (int ccpIdx=0; ccpIdx<nCCP; ccpIdx++) {
@@ -3535,7 +4635,7 @@ void critPtNetWork::setCagePaths(void)
 #endif
          //for (int k=0; k<3; k++) {rseed[k]=RCCP[ccpIdx][k];}
          npts=findSingleRhoCageGradientPathRK5(ccpIdx,\
-               currRcpPos,hstep,arrsize,RCGP[ccpIdx][currRcpPos]);
+               currRcpPos,hstep,arrsize,tgp);
 #if DEBUG
          if ( npts<0 ) {
             displayWarningMessage("Catched -1");
@@ -3543,6 +4643,7 @@ void critPtNetWork::setCagePaths(void)
          }
 #endif /* ( DEBUG ) */
          conCCP[ccpIdx][1][currRcpPos]=npts;
+         conCCP[ccpIdx][2][currRcpPos]=appendGradPath(tgp,npts);
          ++currRcpPos;
       }
 #if USEPROGRESSBAR
@@ -3554,6 +4655,8 @@ void critPtNetWork::setCagePaths(void)
    printProgressBar(100);
    cout << endl;
 #endif
+   deallocFlat2DRealArray(tgp);
+   rebuildGradPathViews();
    iknowcgps=true;
    iknowallgps=(iknowbgps&&iknowrgps&&iknowcgps);
 }
@@ -3612,6 +4715,232 @@ int critPtNetWork::getTotalNofCagePaths(void)
    return res;
 }
 /* ************************************************************************************ */
+void critPtNetWork::setMaxPointsPerGradPath(int nn)
+{
+   if ( nn<4 ) {
+      displayWarningMessage("Gradient paths need at least 4 points! Nothing done.");
+      return;
+   }
+   deallocFlat2DRealArray(RGP);
+   maxPtsGP=nn;
+   allocFlat2DRealArray(string("RGP"),maxPtsGP,3,RGP);
+}
+/* ************************************************************************************ */
+void critPtNetWork::allocXCPArrays(char cpt,int dim)
+{
+   deallocXCPArrays(cpt);
+   if ( dim<CPNW_MINARRAYSIZE ) {dim=CPNW_MINARRAYSIZE;}
+   switch ( cpt ) {
+      case 'a':
+         dACP=dim;
+         allocFlat2DRealArray(string("RACP"),dACP,3,RACP,1.0e+50);
+         alloc1DStringArray("lblACP",dACP,lblACP);
+         break;
+      case 'b':
+         dBCP=dim;
+         allocFlat2DRealArray(string("RBCP"),dBCP,3,RBCP,1.0e+50);
+         allocFlat2DIntArray(string("conBCP"),dBCP,4,conBCP,-1);
+         alloc1DStringArray("lblBCP",dBCP,lblBCP);
+         break;
+      case 'r':
+         dRCP=dim;
+         allocFlat2DRealArray(string("RRCP"),dRCP,3,RRCP,1.0e+50);
+         allocFlat3DIntArray(string("conRCP"),dRCP,3,wConRCP,conRCP,-1);
+         alloc1DStringArray("lblRCP",dRCP,lblRCP);
+         break;
+      case 'c':
+         dCCP=dim;
+         allocFlat2DRealArray(string("RCCP"),dCCP,3,RCCP,1.0e+50);
+         allocFlat3DIntArray(string("conCCP"),dCCP,3,wConCCP,conCCP,-1);
+         alloc1DStringArray("lblCCP",dCCP,lblCCP);
+         break;
+      default:
+         displayErrorMessage(string("Unknown CP type: '")+cpt+string("'"));
+         break;
+   }
+}
+/* ************************************************************************************ */
+bool critPtNetWork::reserveXCPArrays(char cpt,int ncp)
+{
+   int *dd;
+   switch ( cpt ) {
+      case 'a': dd=&dACP; break;
+      case 'b': dd=&dBCP; break;
+      case 'r': dd=&dRCP; break;
+      case 'c': dd=&dCCP; break;
+      default:
+         displayErrorMessage(string("Unknown CP type: '")+cpt+string("'"));
+         return false;
+   }
+   if ( ncp<(*dd) ) {return true;}
+   int newd=2*(*dd);
+   if ( newd<=ncp ) {newd=ncp+1;}
+   if ( newd<CPNW_MINARRAYSIZE ) {newd=CPNW_MINARRAYSIZE;}
+   bool res=true;
+   switch ( cpt ) {
+      case 'a':
+         res=res&&resizeFlat2DRealArray(string("RACP"),dACP,newd,3,RACP,1.0e+50);
+         res=res&&resize1DStringArray(string("lblACP"),dACP,newd,lblACP);
+         break;
+      case 'b':
+         res=res&&resizeFlat2DRealArray(string("RBCP"),dBCP,newd,3,RBCP,1.0e+50);
+         res=res&&resizeFlat2DIntArray(string("conBCP"),dBCP,newd,4,conBCP,-1);
+         res=res&&resize1DStringArray(string("lblBCP"),dBCP,newd,lblBCP);
+         break;
+      case 'r':
+         res=res&&resizeFlat2DRealArray(string("RRCP"),dRCP,newd,3,RRCP,1.0e+50);
+         res=res&&resizeFlat3DIntArray(string("conRCP"),dRCP,3,wConRCP,\
+               newd,wConRCP,conRCP,-1);
+         res=res&&resize1DStringArray(string("lblRCP"),dRCP,newd,lblRCP);
+         break;
+      case 'c':
+         res=res&&resizeFlat2DRealArray(string("RCCP"),dCCP,newd,3,RCCP,1.0e+50);
+         res=res&&resizeFlat3DIntArray(string("conCCP"),dCCP,3,wConCCP,\
+               newd,wConCCP,conCCP,-1);
+         res=res&&resize1DStringArray(string("lblCCP"),dCCP,newd,lblCCP);
+         break;
+   }
+   if ( !res ) {
+      displayErrorMessage("Could not grow the arrays of CPs!");
+      return false;
+   }
+   (*dd)=newd;
+   if ( arenaGP!=NULL ) {rebuildGradPathViews();}
+   return true;
+}
+/* ************************************************************************************ */
+void critPtNetWork::deallocXCPArrays(char cpt)
+{
+   switch ( cpt ) {
+      case 'a':
+         deallocFlat2DRealArray(RACP);
+         dealloc1DStringArray(lblACP);
+         dACP=0;
+         break;
+      case 'b':
+         deallocFlat2DRealArray(RBCP);
+         deallocFlat2DIntArray(conBCP);
+         dealloc1DStringArray(lblBCP);
+         dBCP=0;
+         break;
+      case 'r':
+         deallocFlat2DRealArray(RRCP);
+         deallocFlat3DIntArray(conRCP);
+         dealloc1DStringArray(lblRCP);
+         dRCP=0;
+         break;
+      case 'c':
+         deallocFlat2DRealArray(RCCP);
+         deallocFlat3DIntArray(conCCP);
+         dealloc1DStringArray(lblCCP);
+         dCCP=0;
+         break;
+      default:
+         break;
+   }
+}
+/* ************************************************************************************ */
+void critPtNetWork::widenConXCP(char cpt)
+{
+   switch ( cpt ) {
+      case 'r':
+         resizeFlat3DIntArray(string("conRCP"),dRCP,3,wConRCP,dRCP,2*wConRCP,conRCP,-1);
+         wConRCP*=2;
+         break;
+      case 'c':
+         resizeFlat3DIntArray(string("conCCP"),dCCP,3,wConCCP,dCCP,2*wConCCP,conCCP,-1);
+         wConCCP*=2;
+         break;
+      default:
+         displayErrorMessage(string("Unknown CP type: '")+cpt+string("'"));
+         return;
+   }
+   if ( arenaGP!=NULL ) {rebuildGradPathViews();}
+}
+/* ************************************************************************************ */
+int critPtNetWork::reserveGradPath(const int npts)
+{
+   if ( npts<=0 ) {return -1;}
+   if ( (nArenaGP+npts)>dArenaGP ) {
+      int newd=2*dArenaGP;
+      if ( newd<(CPNW_MINARRAYSIZE*maxPtsGP) ) {newd=CPNW_MINARRAYSIZE*maxPtsGP;}
+      if ( newd<(nArenaGP+npts) ) {newd=nArenaGP+npts;}
+      if ( !resizeFlat2DRealArray(string("arenaGP"),nArenaGP,newd,3,arenaGP) ) {
+         displayErrorMessage("Could not grow the arena of gradient paths!");
+         return -1;
+      }
+      dArenaGP=newd;
+   }
+   int res=nArenaGP;
+   nArenaGP+=npts;
+   return res;
+}
+/* ************************************************************************************ */
+int critPtNetWork::appendGradPath(solreal** (&pts),const int npts)
+{
+   int res=reserveGradPath(npts);
+   if ( res<0 ) {return res;}
+   for ( int i=0 ; i<npts ; ++i ) {
+      for ( int k=0 ; k<3 ; ++k ) {arenaGP[res+i][k]=pts[i][k];}
+   }
+   return res;
+}
+/* ************************************************************************************ */
+void critPtNetWork::rebuildGradPathViews(void)
+{
+   deallocGradPathViews();
+   if ( arenaGP==NULL ) {return;}
+   int off;
+   if ( conBCP!=NULL ) {
+      RBGP=new solreal**[dBCP];
+      for ( int i=0 ; i<dBCP ; ++i ) {
+         off=conBCP[i][3];
+         RBGP[i]=((off>=0)? (arenaGP+off) : NULL);
+      }
+   }
+   if ( conRCP!=NULL ) {
+      //RRGP[0] points to the whole table of views.
+      RRGP=new solreal***[dRCP];
+      RRGP[0]=new solreal**[dRCP*wConRCP];
+      for ( int i=0 ; i<dRCP ; ++i ) {
+         RRGP[i]=RRGP[0]+(i*wConRCP);
+         for ( int k=0 ; k<wConRCP ; ++k ) {
+            off=conRCP[i][2][k];
+            RRGP[i][k]=((off>=0)? (arenaGP+off) : NULL);
+         }
+      }
+   }
+   if ( conCCP!=NULL ) {
+      RCGP=new solreal***[dCCP];
+      RCGP[0]=new solreal**[dCCP*wConCCP];
+      for ( int i=0 ; i<dCCP ; ++i ) {
+         RCGP[i]=RCGP[0]+(i*wConCCP);
+         for ( int k=0 ; k<wConCCP ; ++k ) {
+            off=conCCP[i][2][k];
+            RCGP[i][k]=((off>=0)? (arenaGP+off) : NULL);
+         }
+      }
+   }
+}
+/* ************************************************************************************ */
+void critPtNetWork::deallocGradPathViews(void)
+{
+   if ( RBGP!=NULL ) {
+      delete[] RBGP;
+      RBGP=NULL;
+   }
+   if ( RRGP!=NULL ) {
+      delete[] RRGP[0];
+      delete[] RRGP;
+      RRGP=NULL;
+   }
+   if ( RCGP!=NULL ) {
+      delete[] RCGP[0];
+      delete[] RCGP;
+      RCGP=NULL;
+   }
+}
+/* ************************************************************************************ */
 void critPtNetWork::copyRGP2Array(solreal** (&thearr),int nn)
 {
    for ( int i=0 ; i<nn ; ++i ) {
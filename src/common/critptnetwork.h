@@ -52,18 +52,28 @@ using std::ofstream;
 #include <cmath>
 
 #include "fldtypesdef.h"
+#include "cellgrid3d.h"
 
+/* Default maximum number of points of a single gradient path
+   (see critPtNetWork::setMaxPointsPerGradPath).  */
 #ifndef CPNW_ARRAYSIZEGRADPATH
 #define CPNW_ARRAYSIZEGRADPATH 100
 #endif
 
+/* Initial number of slots of the connectivity lists of RCPs and CCPs (conRCP and conCCP).
+   The lists grow when needed.  */
+#ifndef CPNW_INITBCPSCONNECTEDTORCP
+#define CPNW_INITBCPSCONNECTEDTORCP (18)
+#endif
 
-#ifndef CPNW_MAXBCPSCONNECTEDTORCP
-#define CPNW_MAXBCPSCONNECTEDTORCP (18)
+#ifndef CPNW_INITRCPSCONNECTEDTOCCP
+#define CPNW_INITRCPSCONNECTEDTOCCP (32)
 #endif
 
-#ifndef CPNW_MAXRCPSCONNECTEDTOCCP
-#define CPNW_MAXRCPSCONNECTEDTOCCP (32)
+/* Number of seeds (vertices of the icosahedron, see IHV) used around the midpoint
+   of each pair of close nuclei, when looking for non-nuclear ACPs.  */
+#ifndef CPNW_NPAIRACPSEEDS
+#define CPNW_NPAIRACPSEEDS 8
 #endif
 
 /* ************************************************************************************ */
@@ -84,7 +94,9 @@ public:
     * In conBCP[i][j], i refers to the i-th BCP in the list.
     * j=0 (j=1) contains the first (second) ACP connected to the BCP.
     * j=2 is reserved to store the number of points for the gradient path
-    * (associated also to the BCP) if the bond gradient paths are requested.
+    * (associated also to the BCP) if the bond gradient paths are requested,
+    * and j=3 the position of its first point in the arena of gradient paths
+    * (-1 if there is no such path).
     * In the old version, conBCP only included atoms which were part of the wf.
     * In contrast, in this version conBCP contains indices to actual ACPs. This is
     * needed in order to correctly search BCPs and Bond paths between atoms and 
@@ -96,6 +108,10 @@ public:
     * [j=0][k] contains the list of kth-bcps possibly connected to the rcp.
     * [j=1][k] contains the list of the number of points in the Ring Path
     * that connects the i-th rcp with the k-th bcp.
+    * [j=2][k] contains the position of the first point of such Ring Path in the
+    * arena of gradient paths (-1 if there is no such path).
+    * The lists are terminated by a negative index; their size
+    * (see getMaxBCPsPerRCP) grows as needed.
     * Here Ring Path is equivalent to Ring Grad Path, and are the Gradient
     * paths that connects RCPs with BCPs (BGP connects BCPs with ACPs).
     */
@@ -105,12 +121,19 @@ public:
     * [j=0][k] contains the list of kth-rcps possibly connected to the ccp.
     * [j=1][k] contains the list of the number of points in the Cage Path
     * that connects the i-th ccp with the k-th rcp.
+    * [j=2][k] contains the position of the first point of such Cage Path in the
+    * arena of gradient paths (-1 if there is no such path).
+    * The lists are terminated by a negative index; their size
+    * (see getMaxRCPsPerCCP) grows as needed.
     * Here Cage Path is equivalent to Cage Grad Path [CGP], and are the Gradient
     * paths that connects CCPs with RCPs (BGP connects BCPs with ACPs).
     */
    int ***conCCP;
    /** This array contains the coordinates of ACPs. in RACP[i][j], the j-th cartesian
-    * coordinates of the i-th ACP are stored.  */
+    * coordinates of the i-th ACP are stored. The coordinates of all the CPs of
+    * a given type are stored contiguously (RACP[0] points to the whole block), and the
+    * arrays (RACP, RBCP, RRCP, RCCP, the labels and conBCP, conRCP, conCCP) grow as
+    * new CPs are found.  */
    solreal **RACP;
    /** This array contains the coordinates of BCPs. in RBCP[i][j], the j-th cartesian
     * coordinates of the i-th ACP are stored.  */
@@ -128,7 +151,12 @@ public:
     * In RGBP[i][n][j], the first index indicates the index of the 
     * i-th BCP, the second indicates
     * the n-th point in the bond path, and the third index is the cartesian
-    * coordinate of the n-th point.  */
+    * coordinate of the n-th point.
+    * The points of all the gradient paths (bond, ring and cage paths) are
+    * stored in a single arena (see arenaGP); RBGP, RRGP and RCGP are only views
+    * of the arena, built from the offsets stored in conBCP, conRCP and conCCP.
+    * They are rebuilt whenever the arena is reallocated, hence pointers to
+    * paths should not be kept across calls that add paths or CPs.  */
    solreal ***RBGP;
    /** RRGP contains the coordinates of the <b>R</b>ing <b>G</b>radient
     * <b>P</b>aths. In this implementation the ring path consists of a set
@@ -161,8 +189,9 @@ public:
     * wavefunction.</b>  */
    solreal centMolecVec[3];
    /** The array RGP is an auxiliary array, used for manipulating the order
-    * of the points in a bond path searching procedure.  */
-   solreal RGP[CPNW_ARRAYSIZEGRADPATH][3];
+    * of the points in a bond path searching procedure. Its size is the maximum
+    * number of points per gradient path (see setMaxPointsPerGradPath).  */
+   solreal **RGP;
    string *lblACP, /*!< An array to store the labels of the ACPs.  */\
       *lblBCP, /*!< An array to store the labels of the BCPs. */\
       *lblRCP, /*!< An array to store the labels of the RCPs.  */\
@@ -184,6 +213,24 @@ public:
    void setMaxIterationsRCP(int ii) {maxItRCP=ii;}
    /** Self descriptive.  */
    void setMaxIterationsCCP(int ii) {maxItCCP=ii;}
+   /** Sets the maximum number of points of a single gradient path (the default
+    * value is CPNW_ARRAYSIZEGRADPATH). It only bounds the length of new paths; the
+    * paths are stored using only the points they actually have.  */
+   void setMaxPointsPerGradPath(int nn);
+   int getMaxPointsPerGradPath(void) {return maxPtsGP;}
+   /** If tr is true, the searches of the CPs of the density use a trust region Newton
+    * method (see seekRhoCPTrustRegion) instead of the eigenvector following steps with
+    * a fixed maximum step size. The searches of LOL CPs are not affected.  */
+   void setTrustRegionCPSearch(bool tr) {useTRCPSearch=tr;}
+   /** If hu is true (and the trust region search is on), the trust region searches
+    * evaluate the Hessian only every CPNW_TRUSTREGIONHESSUPDATES steps; in between,
+    * the Hessian is updated from the gradients of rho (Bofill update).  */
+   void setHessianUpdateCPSearch(bool hu) {useHessUpdCPSearch=hu;}
+   /** Sets to zero the counters of iterations and evaluations of the CP searches.  */
+   void resetCPSearchStats(void);
+   /** Displays the number of searches, iterations, Hessian and gradient evaluations
+    * used so far by the CP searches of each type.  */
+   void displayCPSearchStats(void);
 /* ************************************************************************************ */
    /** The main public function for searching all critical points.
     * Configuration, such as requesting extended search should be
@@ -255,6 +302,13 @@ public:
    /** Same functionality as critPtNetWork::seekRhoACPsAroundAPoint, but for LOL ACPs.  */
    void seekLOLACPsAroundAPoint(solreal const (&oo)[3],solreal const ddxx,\
          string const &blbl,int nvrt=-1);
+/* ************************************************************************************ */
+   /** Same as seekLOLACPsAroundAPoint, for the npt centres oo[p] (with radii ddxx[p]
+    * and base labels blbl[p]). All the searches are done at once (see
+    * seekCPsFromSeeds), and the ACPs are added in the same order as in npt
+    * consecutive calls to seekLOLACPsAroundAPoint.  */
+   void seekLOLACPsAroundPoints(const int npt,solreal ** (&oo),solreal * (&ddxx),\
+         string * (&blbl),int nvrt=-1);
 /* ************************************************************************************ */
    void seekLOLACPsOnASphere(int atIdx,int nDivR,int nDivT,int nDivP,solreal radmin,\
          solreal radmax);
@@ -262,6 +316,35 @@ public:
    void seekLOLBCPWithExtraACP(int acppos,solreal maxrad);
 /* ************************************************************************************ */
    void extendedSearchCPs();
+/* ************************************************************************************ */
+   /** Grid based search of the CPs of rho. The density and its gradient are evaluated
+    * on a regular grid (spacing gridSearchH) that contains all the nuclei plus a margin of
+    * CPNW_GRIDSEARCHMARGIN. Every cell where the three components of the gradient change
+    * their sign is used as a seed, and the type of CP looked for is the signature of the
+    * Hessian at the seed. Afterwards, the Poincare-Hopf relation (nACP-nBCP+nRCP-nCCP=1) is
+    * checked; if it does not hold, the cells where the gradient changes (or nearly
+    * changes) its sign are split in eight, and the process is repeated (up to
+    * CPNW_GRIDSEARCHMAXLEVELS times).  */
+   void gridSearchRhoCPs(void);
+/* ************************************************************************************ */
+   /** Sets the CPs of rho by following the CPs of prev, which is the network of the
+    * previous frame of a trajectory (same nuclei, in the same order). Each CP of prev is
+    * displaced as the nuclei around it (see getFrameDisplacement), and used as the seed
+    * of a search of the same type of CP. If every CP is found again, at no more than
+    * CPNW_TRACKMAXCPSHIFT from its seed, the i-th CP of each type is the continuation of
+    * the i-th CP of prev (and keeps its label and connectivity), and the function returns
+    * true. Otherwise, the topology has changed and false is returned; in this case, the
+    * object must be discarded, and a full search (setCriticalPoints) must be done with a
+    * new one.  */
+   bool setRhoCPsFromPreviousFrame(critPtNetWork &prev);
+/* ************************************************************************************ */
+   /** For every CP of type cpt ('a', 'b', 'r' or 'c') of this network, sets idx[i] to
+    * the index of the same CP in prev (the network of the previous frame of a
+    * trajectory), or to -1 if there is no such CP. Two CPs are the same if each one is the
+    * closest to the other (the CPs of prev being displaced with the nuclei), and their
+    * distance is less than CPNW_TRACKMAXCPSHIFT. idx must have (at least) as many
+    * entries as CPs of type cpt.  */
+   void matchCPsToPreviousFrame(char cpt,critPtNetWork &prev,int * (&idx));
 /* ************************************************************************************ */
    bool readFromFile(string inname);
 /* ************************************************************************************ */
@@ -331,6 +414,13 @@ public:
    void tubeStyleBGP(bool stl) {tubeBGPStyle=stl;}
 /* ************************************************************************************ */
    void setExtendedSearch(bool ss) {mkextsearch=ss;}
+/* ************************************************************************************ */
+   /** If gs is true, setCriticalPoints completes the search of the CPs of rho with
+    * gridSearchRhoCPs.  */
+   void setGridSearch(bool gs) {mkgridsearch=gs;}
+/* ************************************************************************************ */
+   /** Sets the spacing of the (coarsest) grid used by gridSearchRhoCPs.  */
+   void setGridSearchSpacing(solreal hh) {gridSearchH=hh;}
 /* ************************************************************************************ */
    void writeCPProps(string &ofnam,string &wfnam);
 /* ************************************************************************************ */
@@ -365,26 +455,60 @@ public:
    int getTotalNofRingPaths(void);
 /* ************************************************************************************ */
    int getTotalNofCagePaths(void);
+/* ************************************************************************************ */
+   /** Returns the current size of the connectivity lists conRCP[i][j]. At most
+    * getMaxBCPsPerRCP()-1 entries are used (the list is terminated by a negative
+    * index).  */
+   int getMaxBCPsPerRCP(void) {return wConRCP;}
+/* ************************************************************************************ */
+   /** Same as getMaxBCPsPerRCP, but for conCCP.  */
+   int getMaxRCPsPerCCP(void) {return wConCCP;}
+/* ************************************************************************************ */
+   /** Returns the number of points stored in the arena of gradient paths.  */
+   int getNofGradPathPoints(void) {return nArenaGP;}
 /* ************************************************************************************ */
 protected:
 /* ************************************************************************************ */
    class GaussWaveFunction *wf;
    class bondNetWork *bn;
    int dACP,dBCP,dRCP,dCCP;
+   int wConRCP,wConCCP; /*!< Current sizes of the lists conRCP[i][j] and conCCP[i][j].  */
+   int maxPtsGP; /*!< The maximum number of points of a single gradient path.  */
+   /** The arena of gradient paths. The points of every bond, ring and cage path are stored
+    * consecutively in arenaGP[n][k] (a single contiguous block); a path is identified by
+    * the position of its first point (see conBCP, conRCP and conCCP) and its number of
+    * points. nArenaGP is the number of points in use, and dArenaGP the capacity.  */
+   solreal **arenaGP;
+   int nArenaGP,dArenaGP;
+   /** State of the adaptive gradient path integrator (see startGradientPathDP54).
+    * The last accepted step goes from gpX0 (arc length gpS0) to gpX1 (arc length
+    * gpS0+gpH); gpF0 and gpF1 are the (normalised) directions of the path at both ends,
+    * gpMagG0 and gpMagG1 the magnitudes of the gradient, and gpCont the coefficients of
+    * the dense output within the step. gpS is the arc length of the last point handed
+    * out by getNextPointInGradientPathDP54.  */
+   solreal gpX0[3],gpX1[3],gpF0[3],gpF1[3],gpCont[5][3];
+   solreal gpMagG0,gpMagG1,gpS0,gpS,gpH,gpHNext,gpHMin,gpHMax,gpDir;
    int maxItACP,maxItBCP,maxItRCP,maxItCCP;
    int normalbcp;
    bool iknowacps,iknowbcps,iknowrcps,iknowccps, iknowallcps;
    bool iknowbgps,iknowrgps,iknowcgps,iknowallgps;
    bool drawNuc,drawBnd,drawBGPs,drawRGPs,drawCGPs;
    bool tubeBGPStyle;
-   bool mkextsearch;
+   bool mkextsearch,mkgridsearch;
+   solreal gridSearchH;
    solreal stepSizeACP,stepSizeBCP,stepSizeRCP,stepSizeCCP;
+   bool useTRCPSearch,useHessUpdCPSearch;
+   /** Counters of the CP searches (index 0, 1, 2 and 3 for ACPs, BCPs, RCPs and CCPs):
+    * number of searches, iterations, Hessian evaluations and gradient-only evaluations.  */
+   int nCPSearches[4],nCPSearchIter[4],nCPSearchHessEv[4],nCPSearchGradEv[4];
    ScalarFieldType mycptype;
    solreal maxBondDist; /*!< The maximum distance between two ACPs related by a BCP  */
    solreal maxBCPACPDist; /*!< The maximum distance between a BCP and associated ACPs  */
    static const int nIHV=16; //It is actually the vertices of an icosahedron plus the origin
    // (0,0,0)
    static solreal V0,V5,V8,IHV[nIHV][3];
+   /** Hash grids of the found CPs, used for discarding repeated CPs.  */
+   cellGrid3D gridACP,gridBCP,gridRCP,gridCCP;
 /* ************************************************************************************ */
    void init();
    /** The constructor without arguments is not public. This will enforce the use
@@ -399,35 +523,170 @@ protected:
    inline solreal computeMagnitudeV3(solreal (&v)[3])
           {return sqrt(v[0]*v[0]+v[1]*v[1]+v[2]*v[2]);}
 /* ************************************************************************************ */
-   bool imNew(solreal (&x)[3],int dim,solreal ** (&arr),size_t &pos);
+   /** Returns true if no one of the first ncp points of arr lies within
+    * a box of half side CPNW_EPSFABSDIFFCOORD around x; then pos is the place for x (ncp),
+    * and the caller must have reserved room for it (see reserveXCPArrays).
+    * Otherwise pos is the (lowest) index of the point found. The search uses the grid grd,
+    * which indexes the points of arr.  */
+   bool imNew(solreal (&x)[3],solreal ** (&arr),class cellGrid3D &grd,\
+         int ncp,size_t &pos);
+/* ************************************************************************************ */
+   /** Allocates the arrays (coordinates, labels and connectivity) of the CPs of type cpt
+    * ('a', 'b', 'r' or 'c') with room for dim CPs.  */
+   void allocXCPArrays(char cpt,int dim);
+/* ************************************************************************************ */
+   /** Makes sure there is room for, at least, ncp+1 CPs of type cpt, growing the arrays
+    * (and the views of the gradient paths) if necessary.  */
+   bool reserveXCPArrays(char cpt,int ncp);
 /* ************************************************************************************ */
-   void getACPStep(solreal (&g)[3],solreal (&hess)[3][3],solreal (&hh)[3],int &sig);
+   void deallocXCPArrays(char cpt);
 /* ************************************************************************************ */
-   void getBCPStep(solreal (&g)[3],solreal (&hess)[3][3],solreal (&hh)[3],int &sig);
+   /** Doubles the size of the lists conRCP[i][j] (cpt='r') or conCCP[i][j] (cpt='c').  */
+   void widenConXCP(char cpt);
 /* ************************************************************************************ */
-   void getRCPStep(solreal (&g)[3],solreal (&hess)[3][3],solreal (&hh)[3],int &sig);
+   /** Reserves npts points at the end of the arena of gradient paths and returns the
+    * position of the first one (-1 if npts<=0). The views RBGP, RRGP and RCGP are not
+    * updated here (see rebuildGradPathViews).  */
+   int reserveGradPath(const int npts);
 /* ************************************************************************************ */
-   void getCCPStep(solreal (&g)[3],solreal (&hess)[3][3],solreal (&hh)[3],int &sig);
+   /** Copies the first npts points of pts into the arena, returning its position.  */
+   int appendGradPath(solreal** (&pts),const int npts);
+/* ************************************************************************************ */
+   /** Sets RBGP, RRGP and RCGP, using the offsets stored in conBCP, conRCP and conCCP.  */
+   void rebuildGradPathViews(void);
+/* ************************************************************************************ */
+   void deallocGradPathViews(void);
+/* ************************************************************************************ */
+   /** Empties the grids of found CPs (they will be rebuilt from RACP, RBCP, etc.). This must
+    * be called whenever the coordinates of the CPs are changed.  */
+   void clearCPGrids(void);
+/* ************************************************************************************ */
+   /** Looks for all the pairs (i<j) of the npts points rr whose distance d satisfies
+    * mindd<=d<=maxdd. The pairs are returned in pa and pb (which are allocated here),
+    * in the same order as the double loop over i and j>i. Returns the number of pairs.  */
+   int getClosePairs(const int npts,solreal ** (&rr),const solreal mindd,\
+         const solreal maxdd,int * (&pa),int * (&pb));
+/* ************************************************************************************ */
+   void getACPStep(solreal (&g)[3],solreal (&hess)[3][3],solreal (&hh)[3],int &sig,\
+         const bool capstep=true);
+/* ************************************************************************************ */
+   void getBCPStep(solreal (&g)[3],solreal (&hess)[3][3],solreal (&hh)[3],int &sig,\
+         const bool capstep=true);
+/* ************************************************************************************ */
+   void getRCPStep(solreal (&g)[3],solreal (&hess)[3][3],solreal (&hh)[3],int &sig,\
+         const bool capstep=true);
+/* ************************************************************************************ */
+   void getCCPStep(solreal (&g)[3],solreal (&hess)[3][3],solreal (&hh)[3],int &sig,\
+         const bool capstep=true);
+/* ************************************************************************************ */
+   /** Calls getACPStep, getBCPStep, getRCPStep or getCCPStep, according to cpsig.  */
+   void getXCPStep(const int cpsig,solreal (&g)[3],solreal (&hess)[3][3],\
+         solreal (&hh)[3],int &sig,const bool capstep=true);
+/* ************************************************************************************ */
+   /** Adds the counts of a single CP search to the counters (see displayCPSearchStats).  */
+   void addCPSearchCounts(const int cpsig,const int nit,const int nhess,const int ngrad);
 /* ************************************************************************************ */
    int computeSignature(solreal (&ev)[3]);
 /* ************************************************************************************ */
    int computeSignature(solreal (&hh)[3][3]);
 /* ************************************************************************************ */
    void seekRhoACP(solreal (&x)[3],solreal &rho2ret,solreal (&g)[3],int &sig);
+   void seekRhoACP(class GaussWaveFunction &twf,solreal (&x)[3],solreal &rho2ret,
+         solreal (&g)[3],int &sig);
 /* ************************************************************************************ */
    void seekRhoBCP(solreal (&x)[3],solreal &rho2ret,solreal (&g)[3],int &sig);
+   void seekRhoBCP(class GaussWaveFunction &twf,solreal (&x)[3],solreal &rho2ret,
+         solreal (&g)[3],int &sig);
 /* ************************************************************************************ */
    void seekRhoRCP(solreal (&x)[3],solreal &rho2ret,solreal (&g)[3],int &sig);
+   void seekRhoRCP(class GaussWaveFunction &twf,solreal (&x)[3],solreal &rho2ret,
+         solreal (&g)[3],int &sig);
 /* ************************************************************************************ */
    void seekRhoCCP(solreal (&x)[3],solreal &rho2ret,solreal (&g)[3],int &sig);
+   void seekRhoCCP(class GaussWaveFunction &twf,solreal (&x)[3],solreal &rho2ret,
+         solreal (&g)[3],int &sig);
 /* ************************************************************************************ */
    void seekLOLACP(solreal (&x)[3],solreal &ll,solreal (&g)[3],int &sig);
+   void seekLOLACP(class GaussWaveFunction &twf,solreal (&x)[3],solreal &ll,
+         solreal (&g)[3],int &sig);
 /* ************************************************************************************ */
    void seekLOLBCP(solreal (&x)[3],solreal &ll,solreal (&g)[3],int &sig);
+   void seekLOLBCP(class GaussWaveFunction &twf,solreal (&x)[3],solreal &ll,
+         solreal (&g)[3],int &sig);
 /* ************************************************************************************ */
    void seekLOLRCP(solreal (&x)[3],solreal &ll,solreal (&g)[3],int &sig);
+   void seekLOLRCP(class GaussWaveFunction &twf,solreal (&x)[3],solreal &ll,
+         solreal (&g)[3],int &sig);
 /* ************************************************************************************ */
    void seekLOLCCP(solreal (&x)[3],solreal &ll,solreal (&g)[3],int &sig);
+   void seekLOLCCP(class GaussWaveFunction &twf,solreal (&x)[3],solreal &ll,
+         solreal (&g)[3],int &sig);
+/* ************************************************************************************ */
+   /** Trust region version of the Newton searches of the CPs of rho (seekRhoACP,
+    * seekRhoBCP, etc.). The steps are the (uncapped) eigenvector following steps, scaled
+    * down to the radius of the trust region. The radius starts at the maximum step size
+    * of the CP type, and it is adapted using the ratio between the actual change of rho
+    * and the change predicted by the quadratic model. For ACPs and CCPs, the steps that
+    * move rho in the wrong direction are rejected. If useHessUpdCPSearch is true, the
+    * Hessian is updated between evaluations (see setHessianUpdateCPSearch).  */
+   void seekRhoCPTrustRegion(class GaussWaveFunction &twf,const int cpsig,\
+         solreal (&x)[3],solreal &ff,solreal (&g)[3],int &sig);
+/* ************************************************************************************ */
+   /** Performs the Newton search of the CP of signature cpsig (-3 for ACPs, -1 for BCPs,
+    * 1 for RCPs and 3 for CCPs) of either rho or LOL (if uselol is true), starting
+    * at xs, and using twf for evaluating the field. On return, xs, ff, gs and sg
+    * contain the final position, field value, gradient and signature.  */
+   void seekCPFromSeed(class GaussWaveFunction &twf,const int cpsig,const bool uselol,\
+         solreal *xs,solreal &ff,solreal *gs,int &sg);
+/* ************************************************************************************ */
+   /** Calls seekCPFromSeed for each one of the nsd seeds xx[i], storing the results
+    * in xx[i], ff[i], gg[i] and sg[i]. The searches are independent of each other;
+    * if PARALLELISEDTK is on, they are distributed among threads, each thread having
+    * its own GaussWaveFunction workspace (see GaussWaveFunction::shareDataFrom).
+    * Nothing is added to the CP lists here: the caller merges the results
+    * sequentially, in seed order, so that the labels and the order of the
+    * CPs do not depend on the number of threads.  */
+   void seekCPsFromSeeds(const int cpsig,const bool uselol,const int nsd,\
+         solreal ** (&xx),solreal * (&ff),solreal ** (&gg),int * (&sg));
+/* ************************************************************************************ */
+   /** LOL version of seekCPsFromSeeds. The seeds are split into blocks of
+    * CPNW_LOLSEEDBLOCKSIZE seeds (see seekLOLCPsFromSeedBlock); if PARALLELISEDTK is
+    * on, the blocks are distributed among threads, each one with its own
+    * GaussWaveFunction workspace.  */
+   void seekLOLCPsFromSeeds(const int cpsig,const int nsd,solreal ** (&xx),\
+         solreal * (&ff),solreal ** (&gg),int * (&sg));
+/* ************************************************************************************ */
+   /** Performs the Newton searches of the LOL CPs (signature cpsig) starting at the nb
+    * seeds xx[i0],...,xx[i0+nb-1]. The searches advance in lockstep, so that LOL and
+    * its derivatives are evaluated for all the unconverged seeds of the block in a
+    * single call to the batched GaussWaveFunction::evalHessLOL. Each search follows
+    * exactly the same steps as seekLOLACP (seekLOLBCP, etc.).  */
+   void seekLOLCPsFromSeedBlock(class GaussWaveFunction &twf,const int cpsig,\
+         const int i0,const int nb,solreal ** (&xx),solreal * (&ff),solreal ** (&gg),\
+         int * (&sg));
+/* ************************************************************************************ */
+   void getSeedResult(const int idx,solreal ** (&xx),solreal * (&ff),solreal ** (&gg),\
+         int * (&sg),solreal (&x)[3],solreal &ff2ret,solreal (&g)[3],int &sig);
+/* ************************************************************************************ */
+   bool allocSeedArrays(const int nsd,solreal ** (&xx),solreal * (&ff),\
+         solreal ** (&gg),int * (&sg));
+/* ************************************************************************************ */
+   void deallocSeedArrays(const int nsd,solreal ** (&xx),solreal * (&ff),\
+         solreal ** (&gg),int * (&sg));
+/* ************************************************************************************ */
+   /** Allocates the seed arrays and sets one seed at the midpoint of every bonded
+    * pair of nuclei (as given by bn->bNetStart and bn->bNetList). The nuclei of the
+    * i-th seed are returned in sda[i] and sdb[i]. Returns the number of seeds.  */
+   int getBondedPairSeeds(int * (&sda),int * (&sdb),solreal ** (&xx),\
+         solreal * (&ff),solreal ** (&gg),int * (&sg));
+/* ************************************************************************************ */
+   /** Allocates the seed arrays and sets one seed at the midpoint of every pair (i<j)
+    * of the ncp points rcp whose distance is not larger than maxdd. The indices of
+    * the i-th seed's points are returned in sda[i] and sdb[i]. Returns the number
+    * of seeds.  */
+   int getCPPairSeeds(const int ncp,solreal ** (&rcp),const solreal maxdd,\
+         int * (&sda),int * (&sdb),solreal ** (&xx),solreal * (&ff),solreal ** (&gg),\
+         int * (&sg));
 /* ************************************************************************************ */
    bool setRhoACPs(void);
 /* ************************************************************************************ */
@@ -456,6 +715,39 @@ protected:
    void findTwoClosestAtoms(solreal (&xo)[3],int &idx1st,int &idx2nd);
 /* ************************************************************************************ */
    void findTwoClosestACPs(solreal (&xo)[3],int &idx1st,int &idx2nd);
+/* ************************************************************************************ */
+   /** Returns in dx the displacement, from the previous frame (prev) to this one, of
+    * the point x (of the previous frame). dx is the average of the displacements of the
+    * nuclei, weighted by the inverse of the fourth power of their distance to x.  */
+   void getFrameDisplacement(critPtNetWork &prev,solreal (&x)[3],solreal (&dx)[3]);
+/* ************************************************************************************ */
+   /** Evaluates rho and its gradient at the nodes of nb blocks of nn[0]xnn[1]xnn[2] points
+    * (spacing hh); oo[b] is the first node of the b-th block. vals is allocated here, and
+    * contains rho, and the gradient, of the node (i,j,k) of the block b at
+    * vals[4*(b*nn[0]*nn[1]*nn[2]+(i*nn[1]+j)*nn[2]+k)].  */
+   void evalRhoGradOnGridBlocks(const int nb,solreal ** (&oo),const solreal hh,\
+         const int (&nn)[3],solreal * (&vals));
+/* ************************************************************************************ */
+   void evalRhoGradOnGridNode(class GaussWaveFunction &twf,const int n,solreal ** (&oo),\
+         const solreal hh,const int (&nn)[3],solreal * (&vals));
+/* ************************************************************************************ */
+   /** Returns 1 if the three components of the gradient change their sign among the
+    * corners cn[0..7] of a cell, 2 if they do not but every component is closer to zero
+    * than its variation within the cell, and 0 otherwise (and also if rho is not larger
+    * than CPNW_MINRHOSIGNIFICATIVEVAL at any corner).  */
+   int classifyGridCell(solreal * (&vals),const int (&cn)[8]);
+/* ************************************************************************************ */
+   /** Classifies the cells of the blocks evaluated by evalRhoGradOnGridBlocks. The centres
+    * of the cells of type 1 are returned in sd (nsd seeds), and the first corners of the
+    * cells of types 1 and 2 in sus (nsus cells, the ones to be refined if needed).
+    * Both arrays are allocated here.  */
+   void collectGridCells(const int nb,solreal ** (&oo),const solreal hh,\
+         const int (&nn)[3],solreal * (&vals),int &nsd,solreal ** (&sd),\
+         int &nsus,solreal ** (&sus));
+/* ************************************************************************************ */
+   /** Looks for CPs of rho starting at the nsd seeds sd, using the signature of the
+    * Hessian at each seed to choose the type of CP, and adds the CPs found.  */
+   void seekRhoCPsFromGridSeeds(const int nsd,solreal ** (&sd));
 /* ************************************************************************************ */
    void addBCP2ConRCP(const int rcpIdx,const int bcpIdx);
 /* ************************************************************************************ */
@@ -465,11 +757,28 @@ protected:
 /* ************************************************************************************ */
    void invertOrderBGPPoints(int dim,solreal** (&arr));
 /* ************************************************************************************ */
-   void getNextPointInGradientPathRK5UpHill(solreal (&xn)[3],\
-         solreal &stepsize,solreal &mgg);
-/* ************************************************************************************ */
-   void getNextPointInGradientPathRK5DownHill(solreal (&xn)[3],\
-         solreal &stepsize,solreal &mgg);
+   /** Starts a new gradient path at x0 (uphill if uphill is true, downhill otherwise).
+    * The path is integrated with an embedded Dormand--Prince 5(4) scheme whose step is
+    * controlled by the local error; hstep is the spacing of the points that will be
+    * requested (see getNextPointInGradientPathDP54), which also scales the bounds of the
+    * integration step. mgg returns the magnitude of the gradient at x0.  */
+   void startGradientPathDP54(solreal (&x0)[3],const solreal hstep,const bool uphill,\
+         solreal &mgg);
+/* ************************************************************************************ */
+   /** Returns in xn the point of the current path lying an arc length ds after the last
+    * point returned (after x0 for the first call). The point is taken from the dense
+    * output of the integrator, hence new integration steps are only taken when the
+    * current one has been used up. mgg returns an estimate (linear interpolation within
+    * the step) of the magnitude of the gradient at xn.  */
+   void getNextPointInGradientPathDP54(solreal (&xn)[3],const solreal ds,solreal &mgg);
+/* ************************************************************************************ */
+   /** Takes a single (accepted) adaptive step of the current path; used by
+    * getNextPointInGradientPathDP54.  */
+   void stepGradientPathDP54(void);
+/* ************************************************************************************ */
+   /** Evaluates the direction field of the current path, i.e. gpDir*grad(rho)/|grad(rho)|,
+    * at x. Returns the magnitude of the gradient.  */
+   solreal evalGradientPathDirection(const solreal (&x)[3],solreal (&f)[3]);
 /* ************************************************************************************ */
    void centerMolecule(void);
 /* ************************************************************************************ */
@@ -792,6 +792,41 @@ void eigen_decomposition2(solreal A[N2][N2], solreal V[N2][N2], solreal d[N2]) {
    tql22(V, d, e);
 }
 //*************************************************************************************************
+inline void eigen_values3_sym(const solreal a00, const solreal a11, const solreal a22,
+      const solreal a01, const solreal a02, const solreal a12, solreal d[3]) {
+   const solreal p1 = a01*a01 + a02*a02 + a12*a12;
+   const solreal q = (a00 + a11 + a22)/3.0e0;
+   const solreal b00 = a00 - q, b11 = a11 - q, b22 = a22 - q;
+   const solreal p2 = b00*b00 + b11*b11 + b22*b22 + 2.0e0*p1;
+   if (p2 <= 0.0e0) {
+      d[0] = d[1] = d[2] = q;
+      return;
+   }
+   const solreal p = sqrt(p2/6.0e0);
+   /* r = det((A-qI)/p)/2, which lies within [-1,1] (up to rounding errors). */
+   solreal r = b00*(b11*b22 - a12*a12) - a01*(a01*b22 - a12*a02) + a02*(a01*a12 - b11*a02);
+   r /= (2.0e0*p*p*p);
+   if (r <= -1.0e0) {
+      r = -1.0e0;
+   } else if (r >= 1.0e0) {
+      r = 1.0e0;
+   }
+   const solreal phi = acos(r)/3.0e0;
+   d[2] = q + 2.0e0*p*cos(phi);
+   d[0] = q + 2.0e0*p*cos(phi + 2.09439510239319549230842892219e0); /* phi+2pi/3 */
+   d[1] = 3.0e0*q - d[0] - d[2];
+}
+//*************************************************************************************************
+void eigen_values3(solreal A[3][3], solreal d[3]) {
+   eigen_values3_sym(A[0][0], A[1][1], A[2][2], A[0][1], A[0][2], A[1][2], d);
+}
+//*************************************************************************************************
+void eigen_values3_packed(const int n, const solreal *h, solreal *d) {
+   for (int i = 0; i < n; i++) {
+      eigen_values3_sym(h[6*i], h[6*i+1], h[6*i+2], h[6*i+3], h[6*i+4], h[6*i+5], &d[3*i]);
+   }
+}
+//*************************************************************************************************
 //*************************************************************************************************
 #endif//_EIG2_4_CPP_
 
@@ -32,5 +32,15 @@ void eigen_decomposition3(solreal A[3][3], solreal V[3][3], solreal d[3]);
 
 void eigen_decomposition2(solreal A[2][2], solreal V[2][2], solreal d[2]);
 
+/* Eigenvalues (only) of the symmetric matrix A, in ascending order (d[0]<=d[1]<=d[2]).
+ They are computed in closed form (trigonometric solution of the characteristic
+ polynomial), which is much faster than eigen_decomposition3 when the eigenvectors
+ are not needed. */
+void eigen_values3(solreal A[3][3], solreal d[3]);
+
+/* Same as eigen_values3, for the n matrices packed in h: the i-th matrix is given by
+ h[6i..6i+5]=(a00,a11,a22,a01,a02,a12), and its eigenvalues are saved in d[3i..3i+2]. */
+void eigen_values3_packed(const int n, const solreal *h, solreal *d);
+
 #endif//_EIG2_4_H_
 
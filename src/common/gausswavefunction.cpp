@@ -87,14 +87,16 @@
 #include "iofuncts-wfx.h"
 #include "eig2-4.h"
 #include "solmath.h"
+#include "promoldensity.h"
 
 #ifndef DEBUG
 #define DEBUG 0
 #endif
 
-#if DEBUG
 #include "solstringtools.h"
-#endif
+#include "solfileutils.h"
+#include <cstring>
+#include <cstdio>
 
 #ifndef EPSFORELFVALUE
 #define EPSFORELFVALUE (2.871e-05)
@@ -130,6 +132,7 @@ GaussWaveFunction::GaussWaveFunction()
    primType=NULL;
    primCent=NULL;
    myPN=NULL;
+   atNum=NULL;
    R=NULL;
    atCharge=NULL;
    primExp=NULL;
@@ -146,6 +149,9 @@ GaussWaveFunction::GaussWaveFunction()
    virial=0.0e0;
    imldd=ihaveEDF=false;
    usescustfld=usevcustfld=false;
+   imshrd=false;
+   proMol=NULL;
+   usepromol=imownpromol=false;
 }
 /* ************************************************************************************** */
 int GaussWaveFunction::prTy[]={
@@ -166,12 +172,20 @@ int GaussWaveFunction::prTy[]={
 GaussWaveFunction::~GaussWaveFunction()
 /* ************************************************************************************** */
 {
+   if ( imshrd ) {
+      title=atLbl=NULL;
+      primType=primCent=myPN=atNum=NULL;
+      R=atCharge=primExp=MOCoeff=occN=MOEner=EDFCoeff=cab=NULL;
+      ihaveEDF=false;
+   }
    dealloc1DStringArray(title);
    dealloc1DRealArray(R);
    dealloc1DStringArray(atLbl);
    dealloc1DRealArray(atCharge);
    dealloc1DIntArray(primCent);
    dealloc1DIntArray(primType);
+   dealloc1DIntArray(myPN);
+   dealloc1DIntArray(atNum);
    dealloc1DRealArray(primExp);
    dealloc1DRealArray(chi);
    dealloc1DRealArray(cab);
@@ -190,6 +204,9 @@ GaussWaveFunction::~GaussWaveFunction()
    if ( ihaveEDF ) {
       dealloc1DRealArray(EDFCoeff);
    }
+   if ( imownpromol ) {delete proMol;}
+   proMol=NULL;
+   usepromol=imownpromol=false;
    imldd=false;
 }
 /* ************************************************************************************** */
@@ -236,39 +253,33 @@ bool GaussWaveFunction::sameMolOrbOccNums()
 bool GaussWaveFunction::readFromFileWFN(string inname)
 /* ************************************************************************************** */
 {
-   ifstream tif;
-   tif.open(inname.c_str(),ios::in);
-   if (!(tif.good())) {
+   wfnFileIndex wfn;
+   if ( !wfn.open(inname) ) {
       cout << "Error: File " << inname << "could not be opened...\n";
 #if DEBUG
       cout << __FILE__ << ", line: " << __LINE__ << endl;
 #endif
       return false;
    }
-   tif.seekg(tif.beg);
    nTit=1;
-   processFirstDataStringinWFNFile(tif,title,orbDesc,nMOr,nPri,nNuc);
+   if ( !wfn.getHeader(title,orbDesc,nMOr,nPri,nNuc) ) {return false;}
    totPri=nPri;
-   processCentersWFN(tif,nNuc,atLbl,R,atCharge);
-   processPrimitivesWFN(tif,nPri,primCent,primType,primExp);
-   processMolecularOrbitalPropsAndCoefs(tif,nMOr,nPri,occN,MOEner,MOCoeff);
-   string liend;
-   getline(tif,liend);
-   //cout << "nPri%5: " << (nPri%5) << " len: " << liend.length() << endl;
-   if (((nPri%5)==0)&&(liend.length()==0)) {
-      getline(tif,liend);
-      cout << liend << endl;
-   }
-   if (liend.substr(0,8)!="END DATA") {
-      cout << "Error, expecting \"END DATA\" in file " << inname << endl;
-      cout << "Line: " << liend << endl;
+   if ( !(wfn.getCenters(nNuc,atLbl,R,atCharge)&&\
+            wfn.getPrimitives(nPri,primCent,primType,primExp)&&\
+            wfn.getMolecularOrbitals(nMOr,nPri,occN,MOEner,MOCoeff)) ) {
+      cout << "Error: the file " << inname << " seems to be corrupted!" << endl;
       return false;
    }
-   getEnergyAndVirial(tif,totener,virial);
+   if ( !wfn.getEnergyAndVirial(totener,virial) ) {
+      cout << "Warning: the energy and virial ratio could not be read from "
+           << inname << endl;
+   }
+   wfn.close();
+   alloc1DIntArray("atNum",nNuc,atNum);
+   for ( int i=0 ; i<nNuc ; ++i ) {atNum[i]=int(floor(atCharge[i]))-1;}
    allocAuxArrays();
    countPrimsPerCenter();
    calcCab();
-   tif.close();
    imldd=testSupport();
    return true;
 }
@@ -276,38 +287,38 @@ bool GaussWaveFunction::readFromFileWFN(string inname)
 bool GaussWaveFunction::readFromFileWFX(string inname)
 /* ************************************************************************************** */
 {
-   ifstream tif;
-   tif.open(inname.c_str(),ios::in);
-   if (!(tif.good())) {
+   wfxFileIndex wfx;
+   if ( !wfx.open(inname) ) {
       cout << "Error: File " << inname << "could not be opened...\n";
 #if DEBUG
       cout << __FILE__ << ", line: " << __LINE__ << endl;
 #endif
       return false;
    }
-   getTitleFromFileWFX(tif,nTit,title);
-   getKeyWordsFromFileWFX(tif,orbDesc);
+   wfx.getLines(string("Title"),nTit,title);
+   for ( int i=0 ; i<nTit ; ++i ) {removeRedundantSpaces(title[i]);}
+   int nkw=0;
+   string *kwl=NULL;
+   wfx.getLines(string("Keywords"),nkw,kwl);
+   orbDesc="";
+   for ( int i=0 ; i<nkw ; ++i ) {orbDesc+=kwl[i]; orbDesc+=" ";}
+   if ( nkw>0 ) {dealloc1DStringArray(kwl);}
    if (orbDesc.substr(0,3)!="GTO") {
       cout << "Error: not supported wave function. Keyword: " << orbDesc << endl;
    }
-   getNofNucleiFromFileWFX(tif,nNuc);
-   getNofMolOrbFromFileWFX(tif,nMOr);
-   getNofPrimFromFileWFX(tif,nPri);
+   wfx.getInt(string("Number of Nuclei"),nNuc);
+   wfx.getInt(string("Number of Occupied Molecular Orbitals"),nMOr);
+   wfx.getInt(string("Number of Primitives"),nPri);
    totPri=nPri;
-   getEDFExistenceFromFileWFX(tif,ihaveEDF);
+   ihaveEDF=(wfx.findKey(string("Number of EDF Primitives"))>=0);
    if ( ihaveEDF ) {
-      int kk;
-      countEDFCentersFromFileWFX(tif,kk);
-      if ( kk>0 ) {
+      if ( wfx.countKey(string("EDF Name"))>0 ) {
          cerr << "Error: In this version"
             <<" only combined EDF wave functions are supported!"
             << endl;
          return false;
       }
-      getNofEDFPrimFromFileWFX(tif,1,EDFPri); //1: number of times to seek for
-                     //EDF primitives. 1 is used for combined edfs, otherwise,
-                     //it should be the number obtained wiht 
-                     //countEDFCentersFromFileWFX.
+      EDFPri=wfx.sumIntsOfKey(string("Number of EDF Primitives"));
       totPri+=EDFPri;
       alloc1DRealArray("EDFCoeff",EDFPri,EDFCoeff);
    }
@@ -322,27 +333,39 @@ bool GaussWaveFunction::readFromFileWFX(string inname)
                     //number of core electrons when EDF information is present
    alloc1DRealArray("MOEner",nMOr,MOEner);
    allocAuxArrays();
-   getAtLabelsFromFileWFX(tif,nNuc,atLbl);
-   getNucCartCoordsFromFileWFX(tif,nNuc,R);
-   getAtChargesFromFileWFX(tif,nNuc,atCharge);
-   getPrimCentersFromFileWFX(tif,nPri,primCent);
-   getPrimTypesFromFileWFX(tif,nPri,primType);
-   getPrimExponentsFromFileWFX(tif,nPri,primExp);
-   getMolecOrbOccNumsFromFileWFX(tif,nMOr,occN);
-   getMolecOrbEnergiesFromFileWFX(tif,nMOr,MOEner);
-   getMolecOrbCoefficientsFromFileWFX(tif,nMOr,nPri,MOCoeff);
-   getTotEnerAndVirialFromFileWFX(tif,totener,virial);
+   int nlbl=0;
+   string *lbl=NULL;
+   wfx.getLines(string("Nuclear Names"),nlbl,lbl);
+   for ( int i=0 ; (i<nNuc)&&(i<nlbl) ; ++i ) {atLbl[i]=lbl[i];}
+   if ( nlbl>0 ) {dealloc1DStringArray(lbl);}
+   bool res=true;
+   res=res&&wfx.getReals(string("Nuclear Cartesian Coordinates"),3*nNuc,R);
+   res=res&&wfx.getReals(string("Nuclear Charges"),nNuc,atCharge);
+   alloc1DIntArray("atNum",nNuc,atNum);
+   res=res&&wfx.getInts(string("Atomic Numbers"),nNuc,atNum,0,-1);
+   res=res&&wfx.getInts(string("Primitive Centers"),nPri,primCent,0,-1);
+   res=res&&wfx.getInts(string("Primitive Types"),nPri,primType,0,-1);
+   res=res&&wfx.getReals(string("Primitive Exponents"),nPri,primExp);
+   res=res&&wfx.getReals(string("Molecular Orbital Occupation Numbers"),nMOr,occN);
+   res=res&&wfx.getReals(string("Molecular Orbital Energies"),nMOr,MOEner);
+   res=res&&wfx.getMOCoefficients(nMOr,nPri,MOCoeff);
+   wfx.getReal(string("Energy = T + Vne + Vee + Vnn"),totener);
+   wfx.getReal(string("Virial Ratio (-V/T)"),virial);
    if ( ihaveEDF ) {
-      getEDFPrimCentersFromFileWFX(tif,nPri,totPri,primCent);
-      getEDFPrimTypesFromFileWFX(tif,nPri,totPri,primType);
-      getEDFPrimExponentsFromFileWFX(tif,nPri,totPri,primExp);
-      getNofCoreElectronsFromFileWFX(tif,coreElec);
+      res=res&&wfx.getInts(string("EDF Primitive Centers"),EDFPri,primCent,nPri,-1);
+      res=res&&wfx.getInts(string("EDF Primitive Types"),EDFPri,primType,nPri,-1);
+      res=res&&wfx.getReals(string("EDF Primitive Exponents"),EDFPri,primExp,nPri);
+      wfx.getInt(string("Number of Core Electrons"),coreElec);
       occN[nMOr]=1.0e0;
-      getEDFPrimCoefficientsFromFileWFX(tif,EDFPri,EDFCoeff);
+      res=res&&wfx.getReals(string("EDF Primitive Coefficients"),EDFPri,EDFCoeff);
+   }
+   wfx.close();
+   if ( !res ) {
+      cout << "Error: the file " << inname << " seems to be corrupted!" << endl;
+      return false;
    }
    countPrimsPerCenter();
    calcCab();
-   tif.close();
    imldd=testSupport();
    return true;
 }
@@ -352,6 +375,20 @@ bool GaussWaveFunction::readFromFile(string inname)
    string extension;
    extension=inname.substr(inname.length()-3,3);
    bool res;
+   if ( (inname.length()>5)&&(inname.substr(inname.length()-5,5)==".dtkb") ) {
+      res=readFromFileDTKB(inname,0,0,false);
+      if ( !res ) { return res; }
+      return sanityChecks();
+   }
+#if USEDTKBINARYCACHE
+   unsigned long long srcsum=0;
+   size_t srclen=0;
+   string cachnam=inname+string(".dtkb");
+   bool havesum=getFileChecksum(inname,srcsum,srclen);
+   if ( havesum&&readFromFileDTKB(cachnam,srcsum,srclen,true) ) {
+      return sanityChecks();
+   }
+#endif
    if ((extension=="wfn")||(extension=="WFN")) {
       res=readFromFileWFN(inname);
    } else if ((extension=="wfx")||(extension=="WFX")) {
@@ -362,6 +399,9 @@ bool GaussWaveFunction::readFromFile(string inname)
       return false;
    }
    if ( !res ) { return res; }
+#if USEDTKBINARYCACHE
+   if ( havesum ) {writeToFileDTKB(cachnam,srcsum,srclen);}
+#endif
    res=(res&&sanityChecks());
    return res;
 }
@@ -391,6 +431,193 @@ void GaussWaveFunction::countPrimsPerCenter(void)
    return;
 }
 /* ************************************************************************************** */
+/* Layout of the *.dtkb files: a dtkbFileHeader followed by blocks. Every block is
+   a 64-bit byte count, the data, and zero padding up to a multiple of 8 bytes.
+   Blocks: title[nTit], orbDesc, atLbl[nNuc] (strings), primType, primCent, myPN, atNum,
+   R, atCharge, primExp, MOCoeff, occN, MOEner, EDFCoeff and cab.  */
+struct dtkbFileHeader {
+   char magic[8];
+   unsigned int version,realsize;
+   unsigned long long srclen,srcsum,totlen;
+   int nTit,nNuc,nMOr,nPri,EDFPri,totPri,coreElec,haveEDF;
+   solreal totener,virial;
+};
+static const char dtkbMagic[8]={'D','T','K','B','W','F','N','\0'};
+/* ************************************************************************************** */
+static void writeDTKBBlock(ofstream &ofil,const void* data,const size_t nb)
+{
+   static const char zeros[8]={0,0,0,0,0,0,0,0};
+   unsigned long long nbl=(unsigned long long)nb;
+   ofil.write(reinterpret_cast<const char*>(&nbl),sizeof(nbl));
+   if ( nb>0 ) {ofil.write(static_cast<const char*>(data),nb);}
+   if ( (nb%8)!=0 ) {ofil.write(zeros,8-(nb%8));}
+}
+/* ************************************************************************************** */
+static const char* getDTKBBlock(const char* &p,const char* end,size_t &nb)
+{
+   unsigned long long nbl;
+   if ( (p+sizeof(nbl))>end ) {nb=0; return NULL;}
+   memcpy(&nbl,p,sizeof(nbl));
+   p+=sizeof(nbl);
+   nb=size_t(nbl);
+   size_t padded=nb+((nb%8)? (8-(nb%8)) : 0);
+   if ( size_t(end-p)<padded ) {nb=0; return NULL;}
+   const char *data=p;
+   p+=padded;
+   return data;
+}
+/* ************************************************************************************** */
+static bool copyDTKBRealBlock(const char* &p,const char* end,const size_t n,solreal* &arr)
+{
+   size_t nb;
+   const char *data=getDTKBBlock(p,end,nb);
+   if ( (data==NULL)||(nb!=n*sizeof(solreal)) ) {return false;}
+   if ( n==0 ) {return true;}
+   alloc1DRealArray(string("dtkbreal"),int(n),arr);
+   memcpy(arr,data,nb);
+   return true;
+}
+/* ************************************************************************************** */
+static bool copyDTKBIntBlock(const char* &p,const char* end,const size_t n,int* &arr)
+{
+   size_t nb;
+   const char *data=getDTKBBlock(p,end,nb);
+   if ( (data==NULL)||(nb!=n*sizeof(int)) ) {return false;}
+   if ( n==0 ) {return true;}
+   alloc1DIntArray(string("dtkbint"),int(n),arr);
+   memcpy(arr,data,nb);
+   return true;
+}
+/* ************************************************************************************** */
+static bool copyDTKBStringBlock(const char* &p,const char* end,string &str)
+{
+   size_t nb;
+   const char *data=getDTKBBlock(p,end,nb);
+   if ( data==NULL ) {return false;}
+   str.assign(data,nb);
+   return true;
+}
+/* ************************************************************************************** */
+bool GaussWaveFunction::writeToFileDTKB(string outname,unsigned long long srcsum,size_t srclen)
+{
+   if ( (nPri<=0)||(cab==NULL)||(myPN==NULL)||(atNum==NULL) ) {return false;}
+   string tmpnam=outname+string(".tmp")+genStrRandSeq(6);
+   ofstream ofil(tmpnam.c_str(),ios::out|ios::binary);
+   if ( !ofil.good() ) {return false;} //Read-only directories are silently skipped.
+   dtkbFileHeader hd;
+   memset(&hd,0,sizeof(hd));
+   memcpy(hd.magic,dtkbMagic,8);
+   hd.version=DTKBINARYCACHEVERSION;
+   hd.realsize=sizeof(solreal);
+   hd.srclen=(unsigned long long)srclen;
+   hd.srcsum=srcsum;
+   hd.nTit=nTit; hd.nNuc=nNuc; hd.nMOr=nMOr; hd.nPri=nPri;
+   hd.EDFPri=(ihaveEDF? EDFPri : 0); hd.totPri=totPri;
+   hd.coreElec=coreElec; hd.haveEDF=(ihaveEDF? 1 : 0);
+   hd.totener=totener; hd.virial=virial;
+   ofil.write(reinterpret_cast<const char*>(&hd),sizeof(hd));
+   for ( int i=0 ; i<nTit ; ++i ) {writeDTKBBlock(ofil,title[i].c_str(),title[i].length());}
+   writeDTKBBlock(ofil,orbDesc.c_str(),orbDesc.length());
+   for ( int i=0 ; i<nNuc ; ++i ) {writeDTKBBlock(ofil,atLbl[i].c_str(),atLbl[i].length());}
+   writeDTKBBlock(ofil,primType,totPri*sizeof(int));
+   writeDTKBBlock(ofil,primCent,totPri*sizeof(int));
+   writeDTKBBlock(ofil,myPN,nNuc*sizeof(int));
+   writeDTKBBlock(ofil,atNum,nNuc*sizeof(int));
+   writeDTKBBlock(ofil,R,3*nNuc*sizeof(solreal));
+   writeDTKBBlock(ofil,atCharge,nNuc*sizeof(solreal));
+   writeDTKBBlock(ofil,primExp,totPri*sizeof(solreal));
+   writeDTKBBlock(ofil,MOCoeff,size_t(nMOr)*size_t(nPri)*sizeof(solreal));
+   writeDTKBBlock(ofil,occN,(ihaveEDF? nMOr+1 : nMOr)*sizeof(solreal));
+   writeDTKBBlock(ofil,MOEner,nMOr*sizeof(solreal));
+   writeDTKBBlock(ofil,EDFCoeff,(ihaveEDF? EDFPri : 0)*sizeof(solreal));
+   writeDTKBBlock(ofil,cab,size_t(nPri)*size_t(nPri)*sizeof(solreal));
+   hd.totlen=(unsigned long long)ofil.tellp();
+   ofil.seekp(0,ios::beg);
+   ofil.write(reinterpret_cast<const char*>(&hd),sizeof(hd));
+   bool res=ofil.good();
+   ofil.close();
+   //The cache only becomes visible once complete.
+   if ( res ) {res=(rename(tmpnam.c_str(),outname.c_str())==0);}
+   if ( !res ) {remove(tmpnam.c_str());}
+   return res;
+}
+/* ************************************************************************************** */
+bool GaussWaveFunction::readFromFileDTKB(string inname,unsigned long long srcsum,\
+      size_t srclen,bool validate)
+{
+   char *buf;
+   size_t len;
+   bool ismapped;
+   if ( !mapFileToMemory(inname,buf,len,ismapped) ) {
+      if ( !validate ) {cout << "Error: File " << inname << " could not be opened...\n";}
+      return false;
+   }
+   dtkbFileHeader hd;
+   bool res=(len>=sizeof(hd));
+   if ( res ) {
+      memcpy(&hd,buf,sizeof(hd));
+      res=(memcmp(hd.magic,dtkbMagic,8)==0)&&(hd.version==DTKBINARYCACHEVERSION)\
+          &&(hd.realsize==sizeof(solreal))&&(hd.totlen==(unsigned long long)len);
+   }
+   if ( res&&validate ) {
+      res=(hd.srcsum==srcsum)&&(hd.srclen==(unsigned long long)srclen);
+   }
+   if ( !res ) {
+      if ( !validate ) {cout << "Error: " << inname << " is not a valid dtkb file!" << endl;}
+      unmapFileFromMemory(buf,len,ismapped);
+      return false;
+   }
+   nTit=hd.nTit; nNuc=hd.nNuc; nMOr=hd.nMOr; nPri=hd.nPri;
+   EDFPri=hd.EDFPri; totPri=hd.totPri; coreElec=hd.coreElec;
+   ihaveEDF=(hd.haveEDF!=0);
+   totener=hd.totener; virial=hd.virial;
+   const char *p=buf+sizeof(hd),*end=buf+len;
+   alloc1DStringArray("title",nTit,title);
+   for ( int i=0 ; res&&(i<nTit) ; ++i ) {res=copyDTKBStringBlock(p,end,title[i]);}
+   res=res&&copyDTKBStringBlock(p,end,orbDesc);
+   alloc1DStringArray("atLbl",nNuc,atLbl);
+   for ( int i=0 ; res&&(i<nNuc) ; ++i ) {res=copyDTKBStringBlock(p,end,atLbl[i]);}
+   res=res&&copyDTKBIntBlock(p,end,totPri,primType);
+   res=res&&copyDTKBIntBlock(p,end,totPri,primCent);
+   res=res&&copyDTKBIntBlock(p,end,nNuc,myPN);
+   res=res&&copyDTKBIntBlock(p,end,nNuc,atNum);
+   res=res&&copyDTKBRealBlock(p,end,3*nNuc,R);
+   res=res&&copyDTKBRealBlock(p,end,nNuc,atCharge);
+   res=res&&copyDTKBRealBlock(p,end,totPri,primExp);
+   res=res&&copyDTKBRealBlock(p,end,size_t(nMOr)*size_t(nPri),MOCoeff);
+   res=res&&copyDTKBRealBlock(p,end,(ihaveEDF? nMOr+1 : nMOr),occN);
+   res=res&&copyDTKBRealBlock(p,end,nMOr,MOEner);
+   res=res&&copyDTKBRealBlock(p,end,(ihaveEDF? EDFPri : 0),EDFCoeff);
+   res=res&&copyDTKBRealBlock(p,end,size_t(nPri)*size_t(nPri),cab);
+   unmapFileFromMemory(buf,len,ismapped);
+   if ( !res ) {
+      cout << "Error: the file " << inname << " seems to be corrupted!" << endl;
+      /* The arrays read so far are freed, so that the source can be parsed into an
+         empty object.  */
+      dealloc1DStringArray(title);
+      dealloc1DStringArray(atLbl);
+      dealloc1DIntArray(primType);
+      dealloc1DIntArray(primCent);
+      dealloc1DIntArray(myPN);
+      dealloc1DIntArray(atNum);
+      dealloc1DRealArray(R);
+      dealloc1DRealArray(atCharge);
+      dealloc1DRealArray(primExp);
+      dealloc1DRealArray(MOCoeff);
+      dealloc1DRealArray(occN);
+      dealloc1DRealArray(MOEner);
+      dealloc1DRealArray(EDFCoeff);
+      dealloc1DRealArray(cab);
+      orbDesc.clear();
+      nTit=nNuc=nMOr=nPri=EDFPri=totPri=coreElec=0;
+      ihaveEDF=false;
+      return false;
+   }
+   allocAuxArrays();
+   imldd=testSupport();
+   return true;
+}
+/* ************************************************************************************** */
 bool GaussWaveFunction::writeToFileWFX(string outname)
 /* ************************************************************************************** */
 {
@@ -451,8 +678,8 @@ solreal GaussWaveFunction::evalDensityArray(solreal x,solreal y, solreal z)
 /* ************************************************************************************** */
 void GaussWaveFunction::displayAllFieldProperties(solreal x,solreal y,solreal z)
 {
-   static solreal rho,lol,xx[3],g[3],hess[3][3];
-   static solreal eivec[3][3],eival[3];
+   solreal rho,lol,xx[3],g[3],hess[3][3];
+   solreal eivec[3][3],eival[3];
    xx[0]=x;
    xx[1]=y;
    xx[2]=z;
@@ -521,8 +748,8 @@ void GaussWaveFunction::displayAllFieldProperties(solreal x,solreal y,solreal z)
 /* ************************************************************************************** */
 void GaussWaveFunction::writeAllFieldProperties(solreal x,solreal y,solreal z,ofstream &ofil)
 {
-   static solreal rho,lol,xx[3],g[3],hess[3][3];
-   static solreal eivec[3][3],eival[3];
+   solreal rho,lol,xx[3],g[3],hess[3][3];
+   solreal eivec[3][3],eival[3];
    xx[0]=x;
    xx[1]=y;
    xx[2]=z;
@@ -828,6 +1055,7 @@ void GaussWaveFunction::calcCab(void)
 #if PARALLELISEDTK
 solreal GaussWaveFunction::evalDensity(solreal x,solreal y,solreal z)
 {
+   if ( usepromol ) {return proMol->evalDensity(x,y,z);}
    int indr,indp;
    solreal xmr,ymr,zmr,rho,chib;
    rho=0.000000e0;
@@ -865,6 +1093,7 @@ firstprivate(j) lastprivate(i) reduction(+: rho)
 #else
 solreal GaussWaveFunction::evalDensity(solreal x,solreal y,solreal z)
 {
+   if ( usepromol ) {return proMol->evalDensity(x,y,z);}
    int indr,indp;
    solreal xmr,ymr,zmr,rho,chib;
    rho=0.000000e0;
@@ -1007,6 +1236,12 @@ solreal GaussWaveFunction::evalOptimizedScalar(solreal px,solreal py,solreal pz)
 #if PARALLELISEDTK
 void GaussWaveFunction::evalRhoGradRho(solreal x, solreal y, solreal z,solreal &rho, solreal &dx, solreal &dy, solreal &dz)
 {
+   if ( usepromol ) {
+      solreal g[3];
+      proMol->evalRhoGradRho(x,y,z,rho,g);
+      dx=g[0]; dy=g[1]; dz=g[2];
+      return;
+   }
    solreal nabx,naby,nabz,xmr,ymr,zmr,trho,cc,rr,alp,chib;
    int indp,indr,ppt;
    indp=0;
@@ -1057,6 +1292,12 @@ firstprivate(j) lastprivate(i) reduction(+: trho,nabx,naby,nabz)
 /* ************************************************************************************** */
 void GaussWaveFunction::evalRhoGradRho(solreal x, solreal y, solreal z,solreal &rho, solreal &dx, solreal &dy, solreal &dz)
 {
+   if ( usepromol ) {
+      solreal g[3];
+      proMol->evalRhoGradRho(x,y,z,rho,g);
+      dx=g[0]; dy=g[1]; dz=g[2];
+      return;
+   }
    solreal nabx,naby,nabz,xmr,ymr,zmr,trho,cc,rr,alp,chib;
    int indp,indr,ppt;
    indp=0;
@@ -1308,6 +1549,273 @@ bool GaussWaveFunction::allocAuxArrays(void)
    return allgood;
 }
 /* ************************************************************************************** */
+bool GaussWaveFunction::shareDataFrom(const GaussWaveFunction &src)
+{
+   if ( imldd || !src.imldd ) {
+      displayWarningMessage("Cannot share the data of an unloaded wave function, or share\n"
+            "into an already loaded one!");
+      return false;
+   }
+   title=src.title;
+   orbDesc=src.orbDesc;
+   nTit=src.nTit;
+   nNuc=src.nNuc;
+   nMOr=src.nMOr;
+   nPri=src.nPri;
+   EDFPri=src.EDFPri;
+   totPri=src.totPri;
+   coreElec=src.coreElec;
+   atLbl=src.atLbl;
+   primType=src.primType;
+   primCent=src.primCent;
+   myPN=src.myPN;
+   atNum=src.atNum;
+   R=src.R;
+   atCharge=src.atCharge;
+   primExp=src.primExp;
+   MOCoeff=src.MOCoeff;
+   EDFCoeff=src.EDFCoeff;
+   occN=src.occN;
+   MOEner=src.MOEner;
+   cab=src.cab;
+   totener=src.totener;
+   virial=src.virial;
+   ihaveEDF=src.ihaveEDF;
+   usescustfld=src.usescustfld;
+   usevcustfld=src.usevcustfld;
+   maxPrimType=src.maxPrimType;
+   proMol=src.proMol;
+   usepromol=src.usepromol;
+   imownpromol=false;
+   imshrd=true;
+   imldd=allocAuxArrays();
+   return imldd;
+}
+/* ************************************************************************************** */
+bool GaussWaveFunction::setUpProMolecularDensity(void)
+{
+   if ( !imldd ) {
+      displayErrorMessage("The wave function must be loaded before setting up its\n"
+            "promolecular density!");
+      return false;
+   }
+   if ( proMol!=NULL ) {return true;}
+   int *zz;
+   alloc1DIntArray(string("zz"),nNuc,zz);
+   for ( int i=0 ; i<nNuc ; i++ ) {zz[i]=atNum[i]+1;}
+   proMol=new proMolDensity();
+   imownpromol=true;
+   bool res=proMol->setUp(nNuc,R,zz);
+   dealloc1DIntArray(zz);
+   if ( !res ) {
+      delete proMol;
+      proMol=NULL;
+      imownpromol=false;
+   }
+   return res;
+}
+/* ************************************************************************************** */
+bool GaussWaveFunction::useProMolecularDensity(bool upm)
+{
+   if ( upm && !setUpProMolecularDensity() ) {return false;}
+   usepromol=upm;
+   return true;
+}
+/* ************************************************************************************** */
+bool GaussWaveFunction::getDensityBoundingBox(const solreal rhocut,\
+      solreal (&bbmin)[3],solreal (&bbmax)[3])
+{
+   /* The term cab_ij chi_i chi_j of the density is a Gaussian of exponent g=a_i+a_j,
+      centered at P=(a_i A+a_j B)/g, times exp(-a_i a_j |A-B|^2/g) and a polynomial of
+      degrees l_i and l_j in r-A and r-B. Its decay radius s around P is the outer root of
+      ln(c)+l_i ln(s+|P-A|)+l_j ln(s+|P-B|)-g s^2=ln(rhocut), found as the fixed
+      point of s=sqrt((...)/g).  */
+   bool found=false;
+   int ci,cj,li,lj;
+   solreal g,pp[3],da,db,ab2,lnc,s,sn,cc;
+   for ( int i=0 ; i<nPri ; ++i ) {
+      ci=3*primCent[i];
+      li=prTy[3*primType[i]]+prTy[3*primType[i]+1]+prTy[3*primType[i]+2];
+      for ( int j=i ; j<nPri ; ++j ) {
+         cc=fabs(cab[i*nPri+j]);
+         if ( j!=i ) {cc*=2.0e0;}
+         if ( cc==0.0e0 ) {continue;}
+         cj=3*primCent[j];
+         lj=prTy[3*primType[j]]+prTy[3*primType[j]+1]+prTy[3*primType[j]+2];
+         g=primExp[i]+primExp[j];
+         ab2=0.0e0;
+         for ( int k=0 ; k<3 ; ++k ) {
+            pp[k]=(primExp[i]*R[ci+k]+primExp[j]*R[cj+k])/g;
+            ab2+=(R[ci+k]-R[cj+k])*(R[ci+k]-R[cj+k]);
+         }
+         da=primExp[j]*sqrt(ab2)/g;
+         db=primExp[i]*sqrt(ab2)/g;
+         lnc=log(cc/rhocut)-primExp[i]*primExp[j]*ab2/g;
+         if ( (li+lj)==0 && lnc<=0.0e0 ) {continue;}
+         s=sqrt(0.5e0*solreal(li+lj)/g);
+         if ( lnc>0.0e0 && sqrt(lnc/g)>s ) {s=sqrt(lnc/g);}
+         for ( int it=0 ; it<50 ; ++it ) {
+            sn=lnc;
+            if ( li>0 ) {sn+=solreal(li)*log(s+da);}
+            if ( lj>0 ) {sn+=solreal(lj)*log(s+db);}
+            sn=((sn>0.0e0)? sqrt(sn/g) : 0.0e0);
+            if ( fabs(sn-s)<=(1.0e-6*s) ) {s=sn; break;}
+            s=sn;
+         }
+         if ( s<=0.0e0 ) {continue;}
+         for ( int k=0 ; k<3 ; ++k ) {
+            if ( (!found)||((pp[k]-s)<bbmin[k]) ) {bbmin[k]=pp[k]-s;}
+            if ( (!found)||((pp[k]+s)>bbmax[k]) ) {bbmax[k]=pp[k]+s;}
+         }
+         found=true;
+      }
+   }
+   if ( !found ) {return false;}
+   solreal xk;
+   for ( int k=0 ; k<3 ; ++k ) {
+      for ( int side=0 ; side<2 ; ++side ) {
+         solreal &face=((side==0)? bbmin[k] : bbmax[k]);
+         solreal out=((side==0)? -GWF_BOXFACESTEP : GWF_BOXFACESTEP);
+         if ( evalMaxDensityOnBoxFace(k,face,bbmin,bbmax)>rhocut ) {
+            for ( int it=0 ; it<1000 ; ++it ) {
+               face+=out;
+               if ( evalMaxDensityOnBoxFace(k,face,bbmin,bbmax)<=rhocut ) {break;}
+            }
+         } else {
+            while ( (bbmax[k]-bbmin[k])>GWF_BOXFACESTEP ) {
+               xk=face-out;
+               if ( evalMaxDensityOnBoxFace(k,xk,bbmin,bbmax)>rhocut ) {break;}
+               face=xk;
+            }
+         }
+      }
+   }
+   return true;
+}
+/* ************************************************************************************** */
+void GaussWaveFunction::getPrimitiveDecayRadii(const solreal cut,solreal *rr)
+{
+   solreal *cmx,dd,lnd,r,rn;
+   int ll;
+   alloc1DRealArray(string("cmx"),totPri,cmx);
+   /* max|x^a y^b z^c exp(-alpha r^2)| = max r^l exp(-alpha r^2), at r^2=l/(2 alpha)  */
+   for ( int i=0 ; i<totPri ; ++i ) {
+      ll=prTy[3*primType[i]]+prTy[3*primType[i]+1]+prTy[3*primType[i]+2];
+      cmx[i]=1.0e0;
+      if ( ll>0 ) {cmx[i]=pow(0.5e0*solreal(ll)/(primExp[i]*exp(1.0e0)),0.5e0*solreal(ll));}
+   }
+   for ( int i=0 ; i<totPri ; ++i ) {
+      if ( i<nPri ) {
+         dd=0.0e0;
+         for ( int j=0 ; j<nPri ; ++j ) {dd+=fabs(cab[i*nPri+j])*cmx[j];}
+         dd*=2.0e0;
+      } else {
+         dd=fabs(EDFCoeff[i-nPri]);
+      }
+      rr[i]=0.0e0;
+      if ( (dd*cmx[i])<=cut ) {continue;}
+      /* Outer root of ln(D)+l ln(r)-alpha r^2=ln(cut), starting beyond the maximum.  */
+      ll=prTy[3*primType[i]]+prTy[3*primType[i]+1]+prTy[3*primType[i]+2];
+      lnd=log(dd/cut);
+      r=sqrt(lnd/primExp[i]);
+      if ( ll>0 ) {
+         rn=sqrt(0.5e0*solreal(ll)/primExp[i]);
+         if ( rn>r ) {r=rn;}
+         for ( int it=0 ; it<50 ; ++it ) {
+            rn=sqrt((lnd+solreal(ll)*log(r))/primExp[i]);
+            if ( fabs(rn-r)<=(1.0e-6*r) ) {r=rn; break;}
+            r=rn;
+         }
+      }
+      rr[i]=r;
+   }
+   dealloc1DRealArray(cmx);
+}
+/* ************************************************************************************** */
+int GaussWaveFunction::evalDensityOnTile(const int np,const solreal *xx,\
+      solreal (&bbmin)[3],solreal (&bbmax)[3],const solreal *rr,solreal *rho)
+{
+   if ( usepromol ) {
+      for ( int p=0 ; p<np ; ++p ) {rho[p]=proMol->evalDensity(xx[3*p],xx[3*p+1],xx[3*p+2]);}
+      return 0;
+   }
+   /* The primitives whose sphere of radius rr[i] intersects the tile.  */
+   int *loc,nloc=0,nedf=0,c;
+   alloc1DIntArray(string("loc"),totPri,loc);
+   solreal d2,dk;
+   for ( int i=0 ; i<totPri ; ++i ) {
+      if ( rr[i]<=0.0e0 ) {continue;}
+      c=3*primCent[i];
+      d2=0.0e0;
+      for ( int k=0 ; k<3 ; ++k ) {
+         dk=0.0e0;
+         if ( R[c+k]<bbmin[k] ) {dk=bbmin[k]-R[c+k];}
+         if ( R[c+k]>bbmax[k] ) {dk=R[c+k]-bbmax[k];}
+         d2+=dk*dk;
+      }
+      if ( d2>(rr[i]*rr[i]) ) {continue;}
+      loc[nloc++]=i;
+      if ( i>=nPri ) {++nedf;}
+   }
+   const int m=nloc-nedf;
+   if ( nloc==0 ) {
+      for ( int p=0 ; p<np ; ++p ) {rho[p]=0.0e0;}
+      dealloc1DIntArray(loc);
+      return 0;
+   }
+   /* The sub-block of cab (upper triangle, diagonal halved), and the EDF coefficients.  */
+   solreal *cabl,*chil;
+   alloc1DRealArray(string("cabl"),((m>0)? m*m : 1),cabl);
+   alloc1DRealArray(string("chil"),nloc,chil);
+   for ( int a=0 ; a<m ; ++a ) {
+      cabl[a*m+a]=0.5e0*cab[loc[a]*nPri+loc[a]];
+      for ( int b=a+1 ; b<m ; ++b ) {cabl[a*m+b]=cab[loc[a]*nPri+loc[b]];}
+   }
+   solreal xmr,ymr,zmr,chib,rh;
+   for ( int p=0 ; p<np ; ++p ) {
+      for ( int a=0 ; a<nloc ; ++a ) {
+         c=3*primCent[loc[a]];
+         xmr=xx[3*p]-R[c];
+         ymr=xx[3*p+1]-R[c+1];
+         zmr=xx[3*p+2]-R[c+2];
+         chil[a]=evalAngACases(primType[loc[a]],xmr,ymr,zmr);
+         chil[a]*=exp(-primExp[loc[a]]*((xmr*xmr)+(ymr*ymr)+(zmr*zmr)));
+      }
+      rh=0.0e0;
+      for ( int a=0 ; a<m ; ++a ) {
+         chib=0.0e0;
+         for ( int b=a ; b<m ; ++b ) {chib+=(cabl[a*m+b]*chil[b]);}
+         rh+=chib*chil[a];
+      }
+      rh*=2.0e0;
+      for ( int a=m ; a<nloc ; ++a ) {rh+=(EDFCoeff[loc[a]-nPri]*chil[a]);}
+      rho[p]=rh;
+   }
+   dealloc1DRealArray(chil);
+   dealloc1DRealArray(cabl);
+   dealloc1DIntArray(loc);
+   return m;
+}
+/* ************************************************************************************** */
+solreal GaussWaveFunction::evalMaxDensityOnBoxFace(const int k,const solreal xk,\
+      solreal (&bbmin)[3],solreal (&bbmax)[3])
+{
+   const int k1=(k+1)%3,k2=(k+2)%3;
+   const int n1=int(ceil((bbmax[k1]-bbmin[k1])/GWF_BOXFACESPACING))+1;
+   const int n2=int(ceil((bbmax[k2]-bbmin[k2])/GWF_BOXFACESPACING))+1;
+   solreal xx[3],rho,rhomax=0.0e0;
+   xx[k]=xk;
+   for ( int i=0 ; i<n1 ; ++i ) {
+      xx[k1]=bbmin[k1]+(bbmax[k1]-bbmin[k1])*solreal(i)/solreal(n1-1);
+      for ( int j=0 ; j<n2 ; ++j ) {
+         xx[k2]=bbmin[k2]+(bbmax[k2]-bbmin[k2])*solreal(j)/solreal(n2-1);
+         rho=evalDensity(xx[0],xx[1],xx[2]);
+         if ( rho>rhomax ) {rhomax=rho;}
+      }
+   }
+   return rhomax;
+}
+/* ************************************************************************************** */
 /* ************************************************************************************** */
 void GaussWaveFunction::evalDkAngCases(int &pty,solreal alp,solreal x, solreal y, solreal z, solreal &anx, solreal &any, solreal &anz)
 {
@@ -1666,6 +2174,13 @@ void GaussWaveFunction::evalHessian(solreal x, solreal y, solreal z,
                                 solreal &dxx, solreal &dyy, solreal &dzz,
                                 solreal &dxy, solreal &dxz, solreal &dyz)
 {
+   if ( usepromol ) {
+      solreal rho,g[3],h[3][3];
+      proMol->evalHessian(x,y,z,rho,g,h);
+      dxx=h[0][0]; dyy=h[1][1]; dzz=h[2][2];
+      dxy=h[0][1]; dxz=h[0][2]; dyz=h[1][2];
+      return;
+   }
    solreal nabxx,nabyy,nabzz,nabxy,nabxz,nabyz,xmr,ymr,zmr,cc,rr,alp,chii,gxi,gyi,gzi;
    solreal sxx,syy,szz,sxy,sxz,syz,gxs,gys,gzs;
    int indp,indr,ppt;
@@ -1741,6 +2256,13 @@ void GaussWaveFunction::evalHessian(solreal x, solreal y, solreal z,
                                 solreal &dxx, solreal &dyy, solreal &dzz,
                                 solreal &dxy, solreal &dxz, solreal &dyz)
 {
+   if ( usepromol ) {
+      solreal rho,g[3],h[3][3];
+      proMol->evalHessian(x,y,z,rho,g,h);
+      dxx=h[0][0]; dyy=h[1][1]; dzz=h[2][2];
+      dxy=h[0][1]; dxz=h[0][2]; dyz=h[1][2];
+      return;
+   }
    solreal nabxx,nabyy,nabzz,nabxy,nabxz,nabyz,xmr,ymr,zmr,cc,rr,alp,chii,gxi,gyi,gzi;
    solreal sxx,syy,szz,sxy,sxz,syz,gxs,gys,gzs;
    int indp,indr,ppt;
@@ -1942,6 +2464,7 @@ solreal GaussWaveFunction::evalLapAngCases(int &pty,solreal alp,solreal x,solrea
 /* ************************************************************************************** */
 solreal GaussWaveFunction::evalLapRho(solreal x, solreal y, solreal z)
 {
+   if ( usepromol ) {return proMol->evalLapRho(x,y,z);}
    solreal lap,xmr,ymr,zmr,cc,rr,alp;
    solreal sxx,gxs,gys,gzs;
    int indp,indr,ppt;
@@ -2002,6 +2525,7 @@ firstprivate(k) lastprivate(i) reduction(+: lap)
 /* ************************************************************************************** */
 solreal GaussWaveFunction::evalLapRho(solreal x, solreal y, solreal z)
 {
+   if ( usepromol ) {return proMol->evalLapRho(x,y,z);}
    solreal lap,xmr,ymr,zmr,cc,rr,alp;
    solreal sxx,gxs,gys,gzs;
    int indp,indr,ppt;
@@ -2130,6 +2654,10 @@ void GaussWaveFunction::evalHessian(solreal x, solreal y, solreal z,solreal (&h)
 /* ************************************************************************************** */
 void GaussWaveFunction::evalHessian(solreal x, solreal y, solreal z,solreal &dens,solreal (&g)[3],solreal (&h)[3][3])
 {
+   if ( usepromol ) {
+      proMol->evalHessian(x,y,z,dens,g,h);
+      return;
+   }
    solreal nabxx,nabyy,nabzz,nabxy,nabxz,nabyz,xmr,ymr,zmr,cc,rr,alp,
    chii,gxi,gyi,gzi,rho,delx,dely,delz;
    solreal sxx,syy,szz,sxy,sxz,syz,gxs,gys,gzs;
@@ -3732,10 +4260,10 @@ solreal GaussWaveFunction::evalLapRhoUsingd2(solreal x, solreal y, solreal z)
 void GaussWaveFunction::evalDiDjDkChi(int &pty,solreal &alp,solreal x,solreal y,solreal z,
                                   solreal (&dlm)[3][3],solreal (&dijk)[3][3][3])
 {
-   static int aa[3];
+   int aa[3];
    int ppt=3*pty;
    for (int m=0; m<3; m++) {aa[m]=prTy[ppt++];}
-   static solreal X[3],X2[3],D0[3],D1[3],D2[3],D3[3];
+   solreal X[3],X2[3],D0[3],D1[3],D2[3],D3[3];
    X[0]=x;
    X[1]=y;
    X[2]=z;
@@ -3839,7 +4367,7 @@ void GaussWaveFunction::evalHessLOL(solreal x, solreal y, solreal z, solreal &de
          indp++;
       }
    }
-   static solreal dG[3],dR[3],ds[3],ddG[3][3],ddR[3][3],dds[3][3],ddC[3][3],dddC[3][3][3];
+   solreal dG[3],dR[3],ds[3],ddG[3][3],ddR[3][3],dds[3][3],ddC[3][3],dddC[3][3][3];
    for (int i=0; i<3; i++) {
       dR[i]=0.0e0;
       ds[i]=0.0e0;
@@ -4048,7 +4576,7 @@ void GaussWaveFunction::evalHessLOL(solreal x, solreal y, solreal z, solreal &de
          indp++;
       }
    }
-   static solreal dG[3],dR[3],ds[3],ddG[3][3],ddR[3][3],dds[3][3],ddC[3][3],dddC[3][3][3];
+   solreal dG[3],dR[3],ds[3],ddG[3][3],ddR[3][3],dds[3][3],ddC[3][3],dddC[3][3][3];
    for (int i=0; i<3; i++) {
       dG[i]=0.0e0;
       dR[i]=0.0e0;
@@ -4187,7 +4715,7 @@ void GaussWaveFunction::evalHessLOL(solreal x, solreal y, solreal z, solreal &de
 /* *************************************************************************************** */
 void GaussWaveFunction::evalHessLOL(solreal (&x)[3],solreal &lol,solreal (&glol)[3],solreal (&hlol)[3][3])
 {
-   static solreal rho,ke;
+   solreal rho,ke;
    evalHessLOL(x[0],x[1],x[2],rho,ke,lol,glol[0],glol[1],glol[2],
                hlol[0][0],hlol[1][1],hlol[2][2],hlol[0][1],hlol[0][2],hlol[1][2]);
    hlol[1][0]=hlol[0][1];
@@ -4196,6 +4724,180 @@ void GaussWaveFunction::evalHessLOL(solreal (&x)[3],solreal &lol,solreal (&glol)
    return;
 }
 /* *************************************************************************************** */
+void GaussWaveFunction::evalHessLOL(const int npts,solreal ** (&xx),solreal * (&lol),\
+      solreal ** (&glol),solreal ** (&hlol))
+{
+   if ( npts<1 ) {return;}
+   /* dd holds, for every primitive j and every point p, the value of the primitive
+      (q=0), its gradient (q=1..3), its Hessian (q=4..9: xx,yy,zz,xy,xz,yz) and its
+      third derivatives (q=10..19: xxx,xxy,xxz,xyy,xyz,xzz,yyy,yyz,yzz,zzz), at
+      dd[(j*npts+p)*nq+q]. Each primitive needs a single exponential per point.  */
+   const int nq=20,ns=10;
+   solreal *dd,*acc;
+   alloc1DRealArray(string("dd"),nq*nPri*npts,dd);
+   alloc1DRealArray(string("acc"),nq*npts,acc);
+   int aa[3],ppt,indr;
+   solreal X[3],X2[3],D0[3],D1[3],D2[3],D3[3],alp,ee,*dj;
+   for ( int j=0 ; j<nPri ; j++ ) {
+      ppt=3*primType[j];
+      for ( int m=0 ; m<3 ; m++ ) {aa[m]=prTy[ppt++];}
+      alp=primExp[j];
+      indr=3*primCent[j];
+      for ( int p=0 ; p<npts ; p++ ) {
+         for ( int m=0 ; m<3 ; m++ ) {
+            X[m]=xx[p][m]-R[indr+m];
+            X2[m]=X[m]*X[m];
+         }
+         evald3Ang(aa,alp,X,X2,D0,D1,D2,D3);
+         ee=exp(-alp*(X2[0]+X2[1]+X2[2]));
+         dj=&dd[(j*npts+p)*nq];
+         dj[0]=ee*D0[0]*D0[1]*D0[2];
+         dj[1]=ee*D1[0]*D0[1]*D0[2];
+         dj[2]=ee*D0[0]*D1[1]*D0[2];
+         dj[3]=ee*D0[0]*D0[1]*D1[2];
+         dj[4]=ee*D2[0]*D0[1]*D0[2];
+         dj[5]=ee*D0[0]*D2[1]*D0[2];
+         dj[6]=ee*D0[0]*D0[1]*D2[2];
+         dj[7]=ee*D1[0]*D1[1]*D0[2];
+         dj[8]=ee*D1[0]*D0[1]*D1[2];
+         dj[9]=ee*D0[0]*D1[1]*D1[2];
+         dj[10]=ee*D3[0]*D0[1]*D0[2];
+         dj[11]=ee*D2[0]*D1[1]*D0[2];
+         dj[12]=ee*D2[0]*D0[1]*D1[2];
+         dj[13]=ee*D1[0]*D2[1]*D0[2];
+         dj[14]=ee*D1[0]*D1[1]*D1[2];
+         dj[15]=ee*D1[0]*D0[1]*D2[2];
+         dj[16]=ee*D0[0]*D3[1]*D0[2];
+         dj[17]=ee*D0[0]*D2[1]*D1[2];
+         dj[18]=ee*D0[0]*D1[1]*D2[2];
+         dj[19]=ee*D0[0]*D0[1]*D3[2];
+      }
+   }
+   /* acc[q*npts+p] accumulates, for point p: rho, nabla rho/2 (1..3), the Hessian of
+      rho/2 (4..9), G (10), nabla G/2 (11..13) and the Hessian of G/2 (14..19:
+      xx,xy,xz,yy,yz,zz). The points are contracted with cab in pairs, so that
+      every element of cab is loaded once for two points, and the partial sums
+      (sa and sb) can be kept in registers.  */
+   for ( int k=0 ; k<(nq*npts) ; k++ ) {acc[k]=0.0e0;}
+   solreal cc,sa[ns],sb[ns],ss[2][ns],*ci,*di;
+   solreal chij,gxs,gys,gzs,sxx,syy,szz,sxy,sxz,syz;
+   solreal chii,gxi,gyi,gzi,hxxi,hyyi,hzzi,hxyi,hxzi,hyzi;
+   int np2;
+   for ( int i=0 ; i<nPri ; i++ ) {
+      ci=&cab[i*nPri];
+      for ( int p0=0 ; p0<npts ; p0+=2 ) {
+         np2=((p0+1)<npts)? 2 : 1;
+         for ( int q=0 ; q<ns ; q++ ) {sa[q]=sb[q]=0.0e0;}
+         if ( np2==2 ) {
+            for ( int j=0 ; j<nPri ; j++ ) {
+               cc=ci[j];
+               dj=&dd[(j*npts+p0)*nq];
+               for ( int q=0 ; q<ns ; q++ ) {
+                  sa[q]+=cc*dj[q];
+                  sb[q]+=cc*dj[nq+q];
+               }
+            }
+         } else {
+            for ( int j=0 ; j<nPri ; j++ ) {
+               cc=ci[j];
+               dj=&dd[(j*npts+p0)*nq];
+               for ( int q=0 ; q<ns ; q++ ) {sa[q]+=cc*dj[q];}
+            }
+         }
+         for ( int q=0 ; q<ns ; q++ ) {
+            ss[0][q]=sa[q];
+            ss[1][q]=sb[q];
+         }
+         for ( int p=p0 ; p<(p0+np2) ; p++ ) {
+            chij=ss[p-p0][0];
+            gxs=ss[p-p0][1]; gys=ss[p-p0][2]; gzs=ss[p-p0][3];
+            sxx=ss[p-p0][4]; syy=ss[p-p0][5]; szz=ss[p-p0][6];
+            sxy=ss[p-p0][7]; sxz=ss[p-p0][8]; syz=ss[p-p0][9];
+            di=&dd[(i*npts+p)*nq];
+            chii=di[0];
+            gxi=di[1]; gyi=di[2]; gzi=di[3];
+            hxxi=di[4]; hyyi=di[5]; hzzi=di[6];
+            hxyi=di[7]; hxzi=di[8]; hyzi=di[9];
+            acc[p]+=chij*chii;
+            acc[npts+p]+=chij*gxi;
+            acc[2*npts+p]+=chij*gyi;
+            acc[3*npts+p]+=chij*gzi;
+            acc[4*npts+p]+=chij*hxxi+gxi*gxs;
+            acc[5*npts+p]+=chij*hyyi+gyi*gys;
+            acc[6*npts+p]+=chij*hzzi+gzi*gzs;
+            acc[7*npts+p]+=chij*hxyi+gxi*gys;
+            acc[8*npts+p]+=chij*hxzi+gxi*gzs;
+            acc[9*npts+p]+=chij*hyzi+gyi*gzs;
+            acc[10*npts+p]+=(gxs*gxi+gys*gyi+gzs*gzi);
+            acc[11*npts+p]+=(gxs*hxxi+gys*hxyi+gzs*hxzi);
+            acc[12*npts+p]+=(gxs*hxyi+gys*hyyi+gzs*hyzi);
+            acc[13*npts+p]+=(gxs*hxzi+gys*hyzi+gzs*hzzi);
+            acc[14*npts+p]+=(hxxi*sxx+hxyi*sxy+hxzi*sxz)
+                           +(di[10]*gxs+di[11]*gys+di[12]*gzs);
+            acc[15*npts+p]+=(hxxi*sxy+hxyi*syy+hxzi*syz)
+                           +(di[11]*gxs+di[13]*gys+di[14]*gzs);
+            acc[16*npts+p]+=(hxxi*sxz+hxyi*syz+hxzi*szz)
+                           +(di[12]*gxs+di[14]*gys+di[15]*gzs);
+            acc[17*npts+p]+=(hxyi*sxy+hyyi*syy+hyzi*syz)
+                           +(di[13]*gxs+di[16]*gys+di[17]*gzs);
+            acc[18*npts+p]+=(hxyi*sxz+hyyi*syz+hyzi*szz)
+                           +(di[14]*gxs+di[17]*gys+di[18]*gzs);
+            acc[19*npts+p]+=(hxzi*sxz+hyzi*syz+hzzi*szz)
+                           +(di[15]*gxs+di[18]*gys+di[19]*gzs);
+         }
+      }
+   }
+   /* From here on, every point is finished as in the single point version.  */
+   static const int hidx[6][2]={{0,0},{1,1},{2,2},{0,1},{0,2},{1,2}};
+   static const int gidx[6][2]={{0,0},{0,1},{0,2},{1,1},{1,2},{2,2}};
+   solreal oo2ferm=0.17414115323489e0,fo3=5.0e0/3.0e0;
+   solreal rho,G,s,dR[3],dG[3],ds[3],ddR[3][3],ddG[3][3],dds[3][3];
+   solreal rhoto5o3,oorho,gam2,gam3;
+   for ( int p=0 ; p<npts ; p++ ) {
+      rho=acc[p];
+      G=acc[10*npts+p];
+      for ( int k=0 ; k<3 ; k++ ) {
+         dR[k]=2.0e0*acc[(1+k)*npts+p];
+         dG[k]=2.0e0*acc[(11+k)*npts+p];
+         dG[k]+=(SIGNF(dG[k])*EPSFORLOLVALUE*0.01);
+      }
+      for ( int k=0 ; k<6 ; k++ ) {
+         ddR[hidx[k][0]][hidx[k][1]]=2.0e0*acc[(4+k)*npts+p];
+         ddR[hidx[k][1]][hidx[k][0]]=ddR[hidx[k][0]][hidx[k][1]];
+         ddG[gidx[k][0]][gidx[k][1]]=2.0e0*acc[(14+k)*npts+p];
+         ddG[gidx[k][1]][gidx[k][0]]=ddG[gidx[k][0]][gidx[k][1]];
+      }
+      rho+=EPSFORLOLVALUE;
+      G+=EPSFORLOLVALUE;
+      rhoto5o3=pow(rho,fo3);
+      oorho=1.0e0/(rho);
+      s=oo2ferm*(G)/rhoto5o3;
+      for ( int i=0 ; i<3 ; i++ ) {
+         ds[i]=oo2ferm*(dG[i]-fo3*oorho*G*dR[i])/rhoto5o3;
+         for ( int j=0 ; j<3 ; j++ ) {
+            dds[i][j]=oo2ferm*(ddG[i][j]
+                               -fo3*oorho*(dG[i]*dR[j]+dG[j]*dR[i]+G*ddR[i][j])
+                               +(40.0e0*G*oorho*oorho/9.0e0)*dR[i]*dR[j])/rhoto5o3;
+         }
+      }
+      lol[p]=1.0e0/(1.0e0+s);
+      gam2=lol[p]*lol[p];
+      gam3=lol[p]*gam2;
+      for ( int i=0 ; i<3 ; i++ ) {
+         glol[p][i]=(-ds[i]*gam2);
+         for ( int j=0 ; j<3 ; j++ ) {
+            hlol[p][3*i+j]=2.0e0*gam3*ds[i]*ds[j]-gam2*dds[i][j];
+         }
+      }
+   }
+   dealloc1DRealArray(dd);
+   dealloc1DRealArray(acc);
+   if ( ihaveEDF ) {
+      cout << "Warning: HessLOL does not include EDF contributions!" << endl;
+   }
+   return;
+}
+/* *************************************************************************************** */
 void GaussWaveFunction::evalFTASingCartA(int &ang,solreal &a,solreal &ooa,solreal &osra,
                                      solreal &px,solreal &px2,solreal &Rx,
                                      solreal &RePhi,solreal &ImPhi)
@@ -4254,7 +4956,7 @@ void GaussWaveFunction::evalFTChi(int &pty,solreal &alp,solreal (&Rx)[3],
                               solreal px,solreal py,solreal pz,
                               complex<solreal> &phi)
 {
-   static int aa[3];
+   int aa[3];
    int ppt=3*pty;
    for (int m=0; m<3; m++) {aa[m]=prTy[ppt++];}
    solreal P[3],P2[3],ooalp;
@@ -5197,6 +5899,251 @@ solreal GaussWaveFunction::evalRoSE(solreal x,solreal y,solreal z)
    return ((tau0-tau)/(tau0+tau));
 }
 /* *************************************************************************************** */
+void GaussWaveFunction::evalSharedFieldTerms(solreal x,solreal y,solreal z,bool wantlap,\
+      solreal &rho,solreal (&g)[3],solreal &twoG,solreal &lap,solreal &kinK)
+{
+   if ( usepromol ) {
+      /* The promolecular density has no orbitals: only rho, its gradient and its
+         Laplacian are meaningful.  */
+      proMol->evalRhoGradRho(x,y,z,rho,g);
+      lap=(wantlap? proMol->evalLapRho(x,y,z) : 0.0e0);
+      twoG=kinK=0.0e0;
+      return;
+   }
+   solreal xmr,ymr,zmr,cc,rr,alp,chib,gxj,gyj,gzj,lapj,lapt,kej,nabx,naby,nabz,trho;
+   int indp,indr,ppt;
+   indp=0;
+   indr=0;
+   for (int i=0; i<nNuc; i++) {
+      xmr=x-R[indr++];
+      ymr=y-R[indr++];
+      zmr=z-R[indr++];
+      rr=((xmr*xmr)+(ymr*ymr)+(zmr*zmr));
+      for (int j=0; j<myPN[i]; j++) {
+         ppt=primType[indp];
+         alp=primExp[indp];
+         cc=exp(-alp*rr);
+         chi[indp]=evalAngACases(ppt,xmr,ymr,zmr);
+         chi[indp]*=cc;
+         evalDkAngCases(ppt,alp,xmr,ymr,zmr,gx[indp],gy[indp],gz[indp]);
+         gx[indp]*=cc;
+         gy[indp]*=cc;
+         gz[indp]*=cc;
+         if ( wantlap ) {
+            hxx[indp]=evalLapAngCases(ppt,alp,xmr,ymr,zmr,rr);
+            hxx[indp]*=cc;
+         }
+         ++indp;
+      }
+   }
+   trho=kej=lapt=nabx=naby=nabz=0.0e0;
+   indp=0;
+   for (int i=0; i<nPri; i++) {
+      chib=gxj=gyj=gzj=lapj=0.0e0;
+      if ( wantlap ) {
+         for (int j=0; j<nPri; j++) {
+            cc=cab[indp++];
+            chib+=(cc*chi[j]);
+            gxj+=(cc*gx[j]);
+            gyj+=(cc*gy[j]);
+            gzj+=(cc*gz[j]);
+            lapj+=(cc*hxx[j]);
+         }
+      } else {
+         for (int j=0; j<nPri; j++) {
+            cc=cab[indp++];
+            chib+=(cc*chi[j]);
+            gxj+=(cc*gx[j]);
+            gyj+=(cc*gy[j]);
+            gzj+=(cc*gz[j]);
+         }
+      }
+      trho+=(chib*chi[i]);
+      nabx+=(chib*gx[i]);
+      naby+=(chib*gy[i]);
+      nabz+=(chib*gz[i]);
+      kej+=(gxj*gx[i]+gyj*gy[i]+gzj*gz[i]);
+      lapt+=(lapj*chi[i]);
+   }
+   rho=trho;
+   g[0]=2.0e0*nabx;
+   g[1]=2.0e0*naby;
+   g[2]=2.0e0*nabz;
+   twoG=kej;
+   if ( wantlap ) {
+      lap=2.0e0*(lapt+kej);
+      kinK=-0.5e0*lapt;
+   } else {
+      lap=kinK=0.0e0;
+   }
+   if ( ihaveEDF ) {
+      /* EDF contributions are added following evalRhoGradRho, evalLOL and evalLapRho.  */
+      for ( int i=nPri ; i<totPri ; ++i ) {
+         indr=3*(primCent[i]);
+         xmr=x-R[indr];
+         ymr=y-R[indr+1];
+         zmr=z-R[indr+2];
+         rr=((xmr*xmr)+(ymr*ymr)+(zmr*zmr));
+         ppt=primType[i];
+         alp=primExp[i];
+         cc=exp(-alp*rr);
+         chi[i]=evalAngACases(ppt,xmr,ymr,zmr);
+         chi[i]*=cc;
+         evalDkAngCases(ppt,alp,xmr,ymr,zmr,gx[i],gy[i],gz[i]);
+         gx[i]*=cc;
+         gy[i]*=cc;
+         gz[i]*=cc;
+         if ( wantlap ) {
+            hxx[i]=evalLapAngCases(ppt,alp,xmr,ymr,zmr,rr);
+            hxx[i]*=cc;
+         }
+      }
+      chib=gxj=gyj=gzj=lapj=0.0e0;
+      for (int i=nPri; i<totPri; ++i) {
+         cc=EDFCoeff[i-nPri];
+         chib+=(cc*chi[i]);
+         gxj+=(cc*gx[i]);
+         gyj+=(cc*gy[i]);
+         gzj+=(cc*gz[i]);
+         if ( wantlap ) { lapj+=(cc*hxx[i]); }
+      }
+      rho+=chib;
+      g[0]+=gxj;
+      g[1]+=gyj;
+      g[2]+=gzj;
+      twoG+=(gxj+gyj+gzj);
+      if ( wantlap ) {
+         lap+=lapj;
+         kinK-=(0.5e0*lapj);
+      }
+   }
+   return;
+}
+/* *************************************************************************************** */
+bool GaussWaveFunction::isSharedTermsField(ScalarFieldType ft)
+{
+   switch ( ft ) {
+      case DENS :
+      case MGRD :
+      case LAPD :
+      case LOLD :
+      case ELFD :
+      case SENT :
+      case KEDK :
+      case KEDG :
+      case MLED :
+      case REDG :
+      case ROSE :
+         return true;
+         break;
+      default :
+         break;
+   }
+   return false;
+}
+/* *************************************************************************************** */
+bool GaussWaveFunction::isProMolecularField(ScalarFieldType ft)
+{
+   switch ( ft ) {
+      case DENS :
+      case MGRD :
+      case LAPD :
+      case REDG :
+      case SENT :
+      case MLED :
+         return true;
+         break;
+      default :
+         break;
+   }
+   return false;
+}
+/* *************************************************************************************** */
+bool GaussWaveFunction::sharedTermsFieldNeedsLap(ScalarFieldType ft)
+{
+   return ((ft==LAPD)||(ft==KEDK));
+}
+/* *************************************************************************************** */
+void GaussWaveFunction::evalMultipleFields(solreal x,solreal y,solreal z,\
+      const ScalarFieldType *ft,const int nf,solreal *res)
+{
+   static const solreal mto3=-10.0e0/3.0e0;
+   static const solreal ooferm2=0.121300564999911e0;
+   static const solreal tferm=5.742468000376382e0;
+   static const solreal rdgcc=0.161620459673995481331661e0; /* $(2(3\pi^2)^{1/3})^{-1}$  */
+   static const solreal rosecc=2.87123400018819181594250e0; /* (3/10)(3\pi^2)^{2/3}  */
+   static const solreal fouo3=4.0e0/3.0e0;
+   static const solreal fivo3=5.0e0/3.0e0;
+   bool needshared=false,needlap=false;
+   for ( int i=0 ; i<nf ; ++i ) {
+      if ( isSharedTermsField(ft[i]) ) {
+         needshared=true;
+         if ( sharedTermsFieldNeedsLap(ft[i]) ) { needlap=true; }
+      }
+   }
+   solreal rho=0.0e0,g[3]={0.0e0,0.0e0,0.0e0},twoG=0.0e0,lap=0.0e0,kinK=0.0e0;
+   if ( needshared ) { evalSharedFieldTerms(x,y,z,needlap,rho,g,twoG,lap,kinK); }
+   solreal mg2=g[0]*g[0]+g[1]*g[1]+g[2]*g[2];
+   solreal tmp,tau;
+   for ( int i=0 ; i<nf ; ++i ) {
+      switch ( ft[i] ) {
+         case DENS :
+            res[i]=rho;
+            break;
+         case MGRD :
+            res[i]=sqrt(mg2);
+            break;
+         case LAPD :
+            res[i]=lap;
+            break;
+         case ELFD :
+            tmp=0.5e0*twoG-0.125e0*mg2/rho+EPSFORELFVALUE;
+            tmp=ooferm2*tmp*tmp*pow(rho,mto3);
+            res[i]=1.0e0/(1.0e0+tmp);
+            break;
+         case LOLD :
+            tau=tferm*pow(rho,fivo3)/(twoG+EPSFORLOLVALUE);
+            res[i]=tau/(1.0e0+tau);
+            break;
+         case SENT :
+            res[i]=-rho*log(rho);
+            break;
+         case KEDK :
+            res[i]=kinK;
+            break;
+         case KEDG :
+            res[i]=0.5e0*twoG;
+            break;
+         case MLED :
+            tmp=(rho<1.0e-12 ? 1.0e-12 : rho);
+            res[i]=0.5e0*sqrt(mg2)/tmp;
+            break;
+         case REDG :
+            tmp=(rho<1.0e-10 ? 1.0e-10 : rho);
+            res[i]=rdgcc*sqrt(mg2)/pow(tmp,fouo3);
+            break;
+         case ROSE :
+            tau=0.5e0*twoG;
+            tmp=rosecc*pow(rho,fivo3);
+            res[i]=(tmp-tau)/(tmp+tau);
+            break;
+         case MEPD :
+            res[i]=evalMolElecPot(x,y,z);
+            break;
+         case MGLD :
+            res[i]=evalMagGradLOL(x,y,z);
+            break;
+         case SCFD :
+            res[i]=evalCustomScalarField(x,y,z);
+            break;
+         default :
+            res[i]=0.0e0;
+            break;
+      }
+   }
+   return;
+}
+/* *************************************************************************************** */
 /* *************************************************************************************** */
 /* *************************************************************************************** */
 /* *************************************************************************************** */
@@ -65,6 +65,8 @@
       int *primType     --> The primitive type (Type Assignments) 
       int *primCent     --> The primitive center (Centre assignments)
       int *myPN         --> The number of primitives associated with each nuclear center.
+      int *atNum        --> The atomic number of each nucleus, minus one (as in bondNetWork).
+                            In wfn files it is taken from the nuclear charge.
       solreal *R           --> The coordinates of the nuclei. It is a 1-dimensional array. It is 
                                this way to facilitate
                                the implementation of cuda code. Later, a function getR(i,j) will be 
@@ -150,6 +152,22 @@ typedef double solreal;
 #define MAXITERATIONCCPSEARCH 240
 #define MAXNUMBEROFPRIMITIVESFORMEMALLOC 10000
 
+/* If USEDTKBINARYCACHE is not zero, readFromFile looks for a binary cache (inname.dtkb)
+   matching the checksum of inname, and writes it after the first successful parse.  */
+#ifndef USEDTKBINARYCACHE
+#define USEDTKBINARYCACHE 1
+#endif
+#define DTKBINARYCACHEVERSION 2
+
+/* getDensityBoundingBox samples the density on the faces of the box with the spacing
+   GWF_BOXFACESPACING, and moves the faces in steps of GWF_BOXFACESTEP (bohr).  */
+#ifndef GWF_BOXFACESPACING
+#define GWF_BOXFACESPACING (0.5e0)
+#endif
+#ifndef GWF_BOXFACESTEP
+#define GWF_BOXFACESTEP (0.2e0)
+#endif
+
 #ifndef SIGNF
 #define SIGNF(a) ((a)>=0?(1):(-1))
 #endif
@@ -175,6 +193,9 @@ using std::complex;
 #if PARALLELISEDTK
 #include <omp.h>
 #endif
+#include "fldtypesdef.h"
+
+class proMolDensity;
 
 class GaussWaveFunction {
 public:
@@ -185,7 +206,7 @@ public:
    string *title,orbDesc; /* title */
    int nTit,nNuc,nMOr,nPri,EDFPri,totPri,coreElec;
    string *atLbl;
-   int *primType, *primCent,*myPN;
+   int *primType, *primCent,*myPN,*atNum;
    solreal *R, *atCharge, *primExp, *MOCoeff, *occN, *MOEner,*EDFCoeff;
    solreal *cab,*chi,*gx,*gy,*gz,*hxx,*hyy,*hzz,*hxy,*hxz,*hyz;
    solreal totener,virial;
@@ -288,6 +309,61 @@ public:
     */
    bool allocAuxArrays(void);
    /* *********************************************************************************** */
+   /** This function turns the object into a workspace of the (already loaded) wave function
+      src: all the read-only arrays (coordinates, primitives, cab, MO coefficients, etc.)
+      are shared with src (they are not copied, and the destructor of this object will not
+      free them), while the auxiliar arrays (chi, gx, ..., hyz) are allocated for this object
+      alone. Thus several threads can evaluate the fields of the same wave function
+      concurrently, each one through its own workspace. The workspace must not outlive src.
+    */
+   bool shareDataFrom(const GaussWaveFunction &src);
+   /* *********************************************************************************** */
+   /** This function builds the promolecular density of this molecule (see
+      promoldensity.h). The promolecular density is shared with the workspaces created
+      with shareDataFrom.
+    */
+   bool setUpProMolecularDensity(void);
+   /** If upm is true, the density, its gradient, its Hessian and its Laplacian (and hence
+      the fields derived only from them, e.g. the magnitude of the gradient and the
+      reduced density gradient) are evaluated from the promolecular density instead of
+      the wave function. The fields that need the orbitals are not affected, and
+      evalSharedFieldTerms returns zero for twoG and kinK. The workspaces created after
+      this call with shareDataFrom inherit the mode.
+    */
+   bool useProMolecularDensity(bool upm);
+   bool usesProMolecularDensity(void) {return usepromol;}
+   proMolDensity *getProMolecularDensity(void) {return proMol;}
+   /** Returns true if the field ft can be evaluated from the promolecular density.  */
+   static bool isProMolecularField(ScalarFieldType ft);
+   /* *********************************************************************************** */
+   /** This function sets bbmin and bbmax to the corners of the (tight) box outside of
+      which the density is smaller than rhocut. The box is first estimated from the decay
+      radii of the terms cab_ij chi_i chi_j of the density, which follow from the
+      exponents and angular momenta of the two primitives (Gaussian product theorem).
+      Since several terms add up, each face is then moved (outwards or inwards) until the
+      largest value of the density on it, sampled on a mesh of spacing
+      GWF_BOXFACESPACING, is just below rhocut. Returns false if no term reaches rhocut.
+    */
+   bool getDensityBoundingBox(const solreal rhocut,solreal (&bbmin)[3],solreal (&bbmax)[3]);
+   /** This function computes the decay radius of each primitive: rr[i] is the distance
+      from the center of the i-th primitive beyond which all the terms of the density
+      that contain it add up to less than cut. These terms are bounded by
+      D_i r^l exp(-alpha_i r^2), where l is the angular momentum of the primitive and
+      D_i=sum_j |cab_ij| max|chi_j| (|EDFCoeff| for the EDF primitives). If D_i max|chi_i|
+      is already smaller than cut, rr[i] is zero. The array rr must have totPri entries.
+    */
+   void getPrimitiveDecayRadii(const solreal cut,solreal *rr);
+   /** This function evaluates the density at the np points xx[3p], xx[3p+1], xx[3p+2],
+      which must lie within the box bbmin-bbmax (a tile of a grid). Only the primitives
+      whose decay radius rr[i] (see getPrimitiveDecayRadii) reaches the box are used, and
+      the density is contracted with the sub-block of cab of these primitives, hence the
+      cost depends on the basis functions near the tile, not on the size of the molecule.
+      This function does not use the auxiliar arrays (chi, gx, etc.), so it can be
+      called concurrently on the same object. Returns the number of primitives used.
+    */
+   int evalDensityOnTile(const int np,const solreal *xx,solreal (&bbmin)[3],\
+         solreal (&bbmax)[3],const solreal *rr,solreal *rho);
+   /* *********************************************************************************** */
    /** This function counts the number of primitives associated with each one
       of the nuclear centers.
     */
@@ -301,6 +377,24 @@ public:
    /** This function will write the wave function into a wfx file which name is outname. */
    bool writeToFileWFX(string outname);
    /* *********************************************************************************** */
+   /** Writes the loaded wave function into the binary cache file outname (*.dtkb). Besides
+      the parsed arrays, the file contains the derived data (cab and the number of primitives
+      per centre), so that reading it back requires neither parsing nor calcCab. The bonds
+      (bondNetWork, built with a cell list) and the decay radii of the primitives (which
+      depend on the tolerance, see getPrimitiveDecayRadii) are cheap to recompute, and are
+      not stored. srcsum and srclen are the checksum and size of the source file (see
+      getFileChecksum). All blocks are 8-byte aligned and stored in native byte order. */
+   bool writeToFileDTKB(string outname,unsigned long long srcsum,size_t srclen);
+   /* *********************************************************************************** */
+   /** Loads a wave function from a binary cache file. The file is memory-mapped, and
+      every block is copied into the arrays of the object (which own their memory, as
+      after parsing), so the mapping is released before returning. If validate is true,
+      the function returns false, before allocating anything, whenever the cache was not
+      produced from a source file with checksum srcsum and size srclen, or if the version
+      of the format or the size of solreal differ from the current ones. If a block is
+      corrupted, the arrays already read are freed before returning false.  */
+   bool readFromFileDTKB(string inname,unsigned long long srcsum,size_t srclen,bool validate);
+   /* *********************************************************************************** */
    /** This function returns true if the *.wfn or *.wfx is supported. At the current version,
       only gaussian wave functions are handled.
     */
@@ -536,6 +630,14 @@ public:
    /* *********************************************************************************** */
    /** Evaluates the Hessian of LOL. It is an overloaded function.  */
    void evalHessLOL(solreal (&x)[3],solreal &lol,solreal (&glol)[3],solreal (&hlol)[3][3]);
+   /* *********************************************************************************** */
+   /** Evaluates LOL (lol[p]), its gradient (glol[p][0..2]) and its Hessian
+    * (hlol[p][3*i+j]) at the npts points xx[p]. The primitives and their derivatives
+    * (up to third order) are evaluated once per point, and each element of the
+    * coefficient matrix is used for all the points of the batch, which makes this
+    * version considerably cheaper than npts calls to the single point version.  */
+   void evalHessLOL(const int npts,solreal ** (&xx),solreal * (&lol),\
+         solreal ** (&glol),solreal ** (&hlol));
    /* ************************************************************************************ */
    /**
      This function evaluates the "angular" part of the Fourier transform of every primitive.
@@ -618,6 +720,29 @@ public:
     * (x,y,z).  */
    solreal evalRoSE(solreal x,solreal y,solreal z);
    /* ************************************************************************************ */
+   /** This function evaluates, in a single pass over the primitives, the quantities
+    * that are shared by most of the scalar fields: \f$\rho\f$, \f$\nabla\rho\f$,
+    * twoG (\f$\sum_{\dot{A}\dot{B}}C_{\dot{A}\dot{B}}\nabla\phi_{\dot{A}}\cdot\nabla\phi_{\dot{B}}\f$),
+    * and, if wantlap is true, the Laplacian of \f$\rho\f$ (lap) and the kinetic
+    * energy density K (kinK). If wantlap is false, lap and kinK are set to zero.  */
+   void evalSharedFieldTerms(solreal x,solreal y,solreal z,bool wantlap,\
+         solreal &rho,solreal (&g)[3],solreal &twoG,solreal &lap,solreal &kinK);
+   /* ************************************************************************************ */
+   /** Returns true if the field ft can be obtained from the terms computed by
+    * evalSharedFieldTerms. For the remaining fields (MEP, MagGradLOL, custom
+    * fields) an independent evaluation is needed.  */
+   bool isSharedTermsField(ScalarFieldType ft);
+   /* ************************************************************************************ */
+   /** Returns true if the field ft needs the Laplacian terms of evalSharedFieldTerms.  */
+   bool sharedTermsFieldNeedsLap(ScalarFieldType ft);
+   /* ************************************************************************************ */
+   /** This function evaluates the nf fields contained in ft at the point (x,y,z),
+    * and saves the values in res (res[i] is the value of ft[i]). The primitives
+    * and their derivatives are evaluated only once, and all the fields that
+    * can be derived from them (see evalSharedFieldTerms) share that computation.  */
+   void evalMultipleFields(solreal x,solreal y,solreal z,\
+         const ScalarFieldType *ft,const int nf,solreal *res);
+   /* ************************************************************************************ */
    /** This function is left to the final user for implementing its own custom 
     * scalar field.  */
    solreal evalCustomScalarField(solreal x,solreal y,solreal z);
@@ -634,7 +759,15 @@ protected:
    static int prTy[MAXPRIMTYPEDEFINED*3];
    /* ************************************************************************************ */
    bool usescustfld,usevcustfld;
+   bool imshrd;
    int maxPrimType;
+   proMolDensity *proMol;
+   bool usepromol,imownpromol;
+   /* ************************************************************************************ */
+   /** Returns the largest value of the density on the face x_k=xk of the box bbmin-bbmax,
+      sampled on a mesh of spacing GWF_BOXFACESPACING.  */
+   solreal evalMaxDensityOnBoxFace(const int k,const solreal xk,solreal (&bbmin)[3],\
+         solreal (&bbmax)[3]);
    /* ************************************************************************************ */
    /* ************************************************************************************ */
    /* ************************************************************************************ */
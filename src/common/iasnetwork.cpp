@@ -0,0 +1,325 @@
+/*
+ *                    This source code is part of
+ *
+ *                  D  E  N  S  T  O  O  L  K  I  T
+ *
+ *                         VERSION: 1.2.0
+ *
+ *             Contributors: Juan Manuel Solano-Altamirano
+ *                           Julio Manuel Hernandez-Perez
+ *        Copyright (c) 2013-2015, Juan Manuel Solano-Altamirano
+ *                                 <jmsolanoalt@gmail.com>
+ *
+ * -------------------------------------------------------------------
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * ---------------------------------------------------------------------
+ *
+ * If you want to redistribute modifications of the suite, please
+ * consider to include your modifications in our official release.
+ * We will be pleased to consider the inclusion of your code
+ * within the official distribution. Please keep in mind that
+ * scientific software is very special, and version control is 
+ * crucial for tracing bugs. If in despite of this you distribute
+ * your modified version, please do not call it DensToolKit.
+ *
+ * If you find DensToolKit useful, we humbly ask that you cite
+ * the paper(s) on the package --- you can find them on the top
+ * README file.
+ *
+ */
+
+
+#ifndef _IASNETWORK_CPP_
+#define _IASNETWORK_CPP_
+
+#include "iasnetwork.h"
+#include "solmemhand.h"
+#include "solscrutils.h"
+#include "eig2-4.h"
+#include <iostream>
+using std::cout;
+using std::endl;
+#include <fstream>
+using std::ofstream;
+#include <iomanip>
+using std::setw;
+using std::setprecision;
+#include <cmath>
+
+/* ************************************************************************************ */
+iaSurfaceNetWork::iaSurfaceNetWork()
+{
+   nIAS=nVert=nTri=0;
+   vert=NULL;
+   tri=NULL;
+   firstVert=nVertIAS=firstTri=nTriIAS=NULL;
+   areaIAS=NULL;
+   nRays=IASNW_DEFAULTNRAYS;
+   maxPtsRay=0;
+   arcStep=IASNW_DEFAULTARCSTEP;
+   maxArcLen=IASNW_DEFAULTMAXARCLENGTH;
+   minRho=IASNW_DEFAULTMINRHO;
+}
+/* ************************************************************************************ */
+iaSurfaceNetWork::~iaSurfaceNetWork()
+{
+   destroyArrays();
+}
+/* ************************************************************************************ */
+void iaSurfaceNetWork::destroyArrays(void)
+{
+   deallocFlat2DRealArray(vert);
+   deallocFlat2DIntArray(tri);
+   dealloc1DIntArray(firstVert);
+   dealloc1DIntArray(nVertIAS);
+   dealloc1DIntArray(firstTri);
+   dealloc1DIntArray(nTriIAS);
+   dealloc1DRealArray(areaIAS);
+   nIAS=nVert=nTri=0;
+}
+/* ************************************************************************************ */
+bool iaSurfaceNetWork::buildSurfaces(GaussWaveFunction &wf,critPtNetWork &cpn)
+{
+   destroyArrays();
+   if ( cpn.nBCP<1 ) {
+      displayWarningMessage("There are no BCPs, hence there are no interatomic surfaces.");
+      return false;
+   }
+   nIAS=cpn.nBCP;
+   maxPtsRay=int(maxArcLen/arcStep)+1;
+   const int nrt=nIAS*nRays;
+   cout << "Building " << nIAS << " interatomic surfaces (" << nRays
+        << " rays per surface)..." << endl;
+   /* The planes of the BCPs.  */
+   solreal **pln,x[3],e1[3],e2[3];
+   allocFlat2DRealArray(string("pln"),nIAS,6,pln);
+   for ( int s=0 ; s<nIAS ; s++ ) {
+      for ( int k=0 ; k<3 ; k++ ) {x[k]=cpn.RBCP[s][k];}
+      getBCPPlane(wf,x,e1,e2);
+      for ( int k=0 ; k<3 ; k++ ) {
+         pln[s][k]=e1[k];
+         pln[s][3+k]=e2[k];
+      }
+   }
+   /* The rays. Every ray has its own block of maxPtsRay points in rays.  */
+   solreal **rays;
+   int *npr;
+   allocFlat2DRealArray(string("rays"),nrt*maxPtsRay,3,rays);
+   alloc1DIntArray(string("npr"),nrt,npr,0);
+   const solreal dth=2.0e0*M_PI/solreal(nRays);
+#if PARALLELISEDTK
+#pragma omp parallel
+   {
+      GaussWaveFunction twf;
+      GaussWaveFunction *pwf=&wf;
+      if ( omp_get_thread_num()>0 ) {
+         twf.shareDataFrom(wf);
+         pwf=&twf;
+      }
+      solreal x0[3],cc,ss;
+      int s;
+#pragma omp for schedule(dynamic,1)
+      for ( int r=0 ; r<nrt ; r++ ) {
+         s=r/nRays;
+         cc=IASNW_STARTRADIUS*cos(dth*solreal(r%nRays));
+         ss=IASNW_STARTRADIUS*sin(dth*solreal(r%nRays));
+         for ( int k=0 ; k<3 ; k++ ) {x0[k]=cpn.RBCP[s][k]+cc*pln[s][k]+ss*pln[s][3+k];}
+         npr[r]=traceRay(*pwf,x0,rays,r*maxPtsRay);
+      }
+   }
+#else
+   solreal x0[3],cc,ss;
+   int s;
+   for ( int r=0 ; r<nrt ; r++ ) {
+      s=r/nRays;
+      cc=IASNW_STARTRADIUS*cos(dth*solreal(r%nRays));
+      ss=IASNW_STARTRADIUS*sin(dth*solreal(r%nRays));
+      for ( int k=0 ; k<3 ; k++ ) {x0[k]=cpn.RBCP[s][k]+cc*pln[s][k]+ss*pln[s][3+k];}
+      npr[r]=traceRay(wf,x0,rays,r*maxPtsRay);
+   }
+#endif
+   deallocFlat2DRealArray(pln);
+   /* The sizes of the meshes: the BCP plus the points of the rays, and the triangles
+      between every pair of consecutive rays of a and b points are a+b-1.  */
+   alloc1DIntArray(string("firstVert"),nIAS,firstVert);
+   alloc1DIntArray(string("nVertIAS"),nIAS,nVertIAS);
+   alloc1DIntArray(string("firstTri"),nIAS,firstTri);
+   alloc1DIntArray(string("nTriIAS"),nIAS,nTriIAS);
+   alloc1DRealArray(string("areaIAS"),nIAS,areaIAS,0.0e0);
+   int npts;
+   nVert=nTri=0;
+   for ( int s=0 ; s<nIAS ; s++ ) {
+      npts=0;
+      for ( int j=0 ; j<nRays ; j++ ) {npts+=npr[s*nRays+j];}
+      firstVert[s]=nVert;
+      nVertIAS[s]=1+npts;
+      firstTri[s]=nTri;
+      nTriIAS[s]=2*npts-nRays;
+      nVert+=nVertIAS[s];
+      nTri+=nTriIAS[s];
+   }
+   allocFlat2DRealArray(string("vert"),nVert,3,vert);
+   allocFlat2DIntArray(string("tri"),nTri,3,tri);
+   for ( int s=0 ; s<nIAS ; s++ ) {
+      for ( int k=0 ; k<3 ; k++ ) {vert[firstVert[s]][k]=cpn.RBCP[s][k];}
+      triangulateSurface(s,npr,rays);
+   }
+   dealloc1DIntArray(npr);
+   deallocFlat2DRealArray(rays);
+   return true;
+}
+/* ************************************************************************************ */
+void iaSurfaceNetWork::getBCPPlane(GaussWaveFunction &wf,solreal const (&x)[3],\
+      solreal (&e1)[3],solreal (&e2)[3])
+{
+   solreal rr,g[3],hh[3][3],eive[3][3],eiva[3];
+   wf.evalHessian(x[0],x[1],x[2],rr,g,hh);
+   eigen_decomposition3(hh,eive,eiva);
+   /* The eigenvalues are sorted in increasing order.  */
+   for ( int k=0 ; k<3 ; k++ ) {
+      e1[k]=eive[k][0];
+      e2[k]=eive[k][1];
+   }
+}
+/* ************************************************************************************ */
+solreal iaSurfaceNetWork::evalDownhillDirection(GaussWaveFunction &twf,\
+      solreal const (&x)[3],solreal (&f)[3],solreal &rr)
+{
+   solreal g[3];
+   twf.evalRhoGradRho(x[0],x[1],x[2],rr,g);
+   solreal mg=sqrt(g[0]*g[0]+g[1]*g[1]+g[2]*g[2]);
+   solreal oomg=((mg>0.0e0)? (-1.0e0/mg) : 0.0e0);
+   for ( int k=0 ; k<3 ; k++ ) {f[k]=oomg*g[k];}
+   return mg;
+}
+/* ************************************************************************************ */
+int iaSurfaceNetWork::traceRay(GaussWaveFunction &twf,solreal const (&x0)[3],\
+      solreal ** (&pts),const int p0)
+{
+   solreal x[3],xt[3],k1[3],k2[3],k3[3],k4[3],rr,rn,mg;
+   const solreal h=arcStep;
+   for ( int k=0 ; k<3 ; k++ ) {x[k]=pts[p0][k]=x0[k];}
+   int n=1;
+   mg=evalDownhillDirection(twf,x,k1,rr);
+   if ( rr<minRho || mg<IASNW_MINGRADMAG ) {return n;}
+   while ( n<maxPtsRay ) {
+      for ( int k=0 ; k<3 ; k++ ) {xt[k]=x[k]+0.5e0*h*k1[k];}
+      evalDownhillDirection(twf,xt,k2,rn);
+      for ( int k=0 ; k<3 ; k++ ) {xt[k]=x[k]+0.5e0*h*k2[k];}
+      evalDownhillDirection(twf,xt,k3,rn);
+      for ( int k=0 ; k<3 ; k++ ) {xt[k]=x[k]+h*k3[k];}
+      evalDownhillDirection(twf,xt,k4,rn);
+      for ( int k=0 ; k<3 ; k++ ) {
+         xt[k]=x[k]+(h/6.0e0)*(k1[k]+2.0e0*(k2[k]+k3[k])+k4[k]);
+      }
+      mg=evalDownhillDirection(twf,xt,k1,rn);
+      /* If the density does not decrease, the path has passed over a minimum of the
+         surface (an RCP).  */
+      if ( rn>=rr ) {break;}
+      for ( int k=0 ; k<3 ; k++ ) {x[k]=pts[p0+n][k]=xt[k];}
+      rr=rn;
+      ++n;
+      if ( rr<minRho || mg<IASNW_MINGRADMAG ) {break;}
+   }
+   return n;
+}
+/* ************************************************************************************ */
+void iaSurfaceNetWork::triangulateSurface(const int s,int * (&npr),solreal ** (&rays))
+{
+   const int v0=firstVert[s];
+   int *off;
+   alloc1DIntArray(string("off"),nRays,off);
+   int v=v0+1,r;
+   for ( int j=0 ; j<nRays ; j++ ) {
+      off[j]=v;
+      r=(s*nRays+j)*maxPtsRay;
+      for ( int k=0 ; k<npr[s*nRays+j] ; k++ ) {
+         for ( int l=0 ; l<3 ; l++ ) {vert[v][l]=rays[r+k][l];}
+         ++v;
+      }
+   }
+   int t=firstTri[s],a,b,m,pa,pb,jn;
+   for ( int j=0 ; j<nRays ; j++ ) {
+      jn=((j+1)%nRays);
+      a=npr[s*nRays+j];
+      b=npr[s*nRays+jn];
+      pa=off[j];
+      pb=off[jn];
+      m=((a<b)? a : b);
+      tri[t][0]=v0; tri[t][1]=pa; tri[t][2]=pb; ++t;
+      for ( int k=0 ; k<(m-1) ; k++ ) {
+         tri[t][0]=pa+k; tri[t][1]=pa+k+1; tri[t][2]=pb+k+1; ++t;
+         tri[t][0]=pa+k; tri[t][1]=pb+k+1; tri[t][2]=pb+k; ++t;
+      }
+      for ( int k=(m-1) ; k<(a-1) ; k++ ) {
+         tri[t][0]=pa+k; tri[t][1]=pa+k+1; tri[t][2]=pb+m-1; ++t;
+      }
+      for ( int k=(m-1) ; k<(b-1) ; k++ ) {
+         tri[t][0]=pa+m-1; tri[t][1]=pb+k+1; tri[t][2]=pb+k; ++t;
+      }
+   }
+   dealloc1DIntArray(off);
+   solreal u[3],w[3],c[3];
+   areaIAS[s]=0.0e0;
+   for ( t=firstTri[s] ; t<(firstTri[s]+nTriIAS[s]) ; t++ ) {
+      for ( int k=0 ; k<3 ; k++ ) {
+         u[k]=vert[tri[t][1]][k]-vert[tri[t][0]][k];
+         w[k]=vert[tri[t][2]][k]-vert[tri[t][0]][k];
+      }
+      c[0]=u[1]*w[2]-u[2]*w[1];
+      c[1]=u[2]*w[0]-u[0]*w[2];
+      c[2]=u[0]*w[1]-u[1]*w[0];
+      areaIAS[s]+=0.5e0*sqrt(c[0]*c[0]+c[1]*c[1]+c[2]*c[2]);
+   }
+}
+/* ************************************************************************************ */
+void iaSurfaceNetWork::printSummary(ostream &os,critPtNetWork &cpn)
+{
+   os << "#Interatomic surfaces (rays: " << nRays << ", arc step: " << arcStep
+      << ", minimum Rho: " << minRho << ")" << endl;
+   os << "#       BCP        Atoms   nVert    nTri        Area" << endl;
+   for ( int s=0 ; s<nIAS ; s++ ) {
+      os << setw(11) << cpn.lblBCP[s] << " "
+         << setw(12) << (cpn.lblACP[cpn.conBCP[s][0]]+string("-")+cpn.lblACP[cpn.conBCP[s][1]])
+         << " " << setw(7) << nVertIAS[s] << " " << setw(7) << nTriIAS[s] << " "
+         << std::fixed << setprecision(5) << setw(11) << areaIAS[s] << endl;
+      os.unsetf(std::ios::fixed);
+   }
+   os << setprecision(6);
+}
+/* ************************************************************************************ */
+void iaSurfaceNetWork::writeOBJFile(string &onam,critPtNetWork &cpn)
+{
+   ofstream ofil(onam.c_str());
+   if ( !ofil.good() ) {
+      displayErrorMessage(string("The file ")+onam+string(" could not be opened!"));
+      return;
+   }
+   ofil << "# Interatomic surfaces (one object per BCP)" << endl;
+   ofil << std::scientific << setprecision(10);
+   for ( int s=0 ; s<nIAS ; s++ ) {
+      ofil << "o " << cpn.lblBCP[s] << endl;
+      for ( int v=firstVert[s] ; v<(firstVert[s]+nVertIAS[s]) ; v++ ) {
+         ofil << "v " << vert[v][0] << " " << vert[v][1] << " " << vert[v][2] << endl;
+      }
+      for ( int t=firstTri[s] ; t<(firstTri[s]+nTriIAS[s]) ; t++ ) {
+         ofil << "f " << (tri[t][0]+1) << " " << (tri[t][1]+1) << " " << (tri[t][2]+1) << endl;
+      }
+   }
+   ofil.close();
+}
+/* ************************************************************************************ */
+#endif//_IASNETWORK_CPP_
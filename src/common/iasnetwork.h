@@ -0,0 +1,161 @@
+/*
+ *                    This source code is part of
+ *
+ *                  D  E  N  S  T  O  O  L  K  I  T
+ *
+ *                         VERSION: 1.2.0
+ *
+ *             Contributors: Juan Manuel Solano-Altamirano
+ *                           Julio Manuel Hernandez-Perez
+ *        Copyright (c) 2013-2015, Juan Manuel Solano-Altamirano
+ *                                 <jmsolanoalt@gmail.com>
+ *
+ * -------------------------------------------------------------------
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * ---------------------------------------------------------------------
+ *
+ * If you want to redistribute modifications of the suite, please
+ * consider to include your modifications in our official release.
+ * We will be pleased to consider the inclusion of your code
+ * within the official distribution. Please keep in mind that
+ * scientific software is very special, and version control is 
+ * crucial for tracing bugs. If in despite of this you distribute
+ * your modified version, please do not call it DensToolKit.
+ *
+ * If you find DensToolKit useful, we humbly ask that you cite
+ * the paper(s) on the package --- you can find them on the top
+ * README file.
+ *
+ */
+
+
+/*
+   iasnetwork.h
+
+   The class iaSurfaceNetWork builds the interatomic surfaces (IAS), i.e. the zero-flux
+   surfaces of the density that separate two bonded atoms. The surface of the atoms
+   joined by a BCP is made of the gradient paths that end at that BCP; these paths
+   leave the BCP within the plane spanned by the two eigenvectors of the Hessian that
+   have negative eigenvalues. Hence, every surface is built by tracing (downhill)
+   a fan of paths (rays) that start on a small circle around the BCP, within that
+   plane, and the points of consecutive rays are joined into triangles. The rays of
+   all the BCPs are independent from each other, and they are traced in parallel.
+ */
+
+#ifndef _IASNETWORK_H_
+#define _IASNETWORK_H_
+
+#ifndef _HAVE_DEF_SOLREAL_TYPE_
+#define _HAVE_DEF_SOLREAL_TYPE_
+typedef double solreal;
+#endif
+
+#include "gausswavefunction.h"
+#include "critptnetwork.h"
+#include <string>
+using std::string;
+#include <ostream>
+using std::ostream;
+
+/* The number of rays of every surface.  */
+#ifndef IASNW_DEFAULTNRAYS
+#define IASNW_DEFAULTNRAYS (72)
+#endif
+/* The arc length between consecutive points of a ray.  */
+#ifndef IASNW_DEFAULTARCSTEP
+#define IASNW_DEFAULTARCSTEP (0.1e0)
+#endif
+/* The rays stop when they are longer than this, or when the density is lower than
+   IASNW_DEFAULTMINRHO.  */
+#ifndef IASNW_DEFAULTMAXARCLENGTH
+#define IASNW_DEFAULTMAXARCLENGTH (8.0e0)
+#endif
+#ifndef IASNW_DEFAULTMINRHO
+#define IASNW_DEFAULTMINRHO (1.0e-03)
+#endif
+/* The radius of the circle (around the BCP) where the rays start.  */
+#ifndef IASNW_STARTRADIUS
+#define IASNW_STARTRADIUS (5.0e-02)
+#endif
+/* The rays also stop at the points where the gradient vanishes (RCPs).  */
+#ifndef IASNW_MINGRADMAG
+#define IASNW_MINGRADMAG (1.0e-06)
+#endif
+
+/* ************************************************************************************ */
+class iaSurfaceNetWork {
+/* ************************************************************************************ */
+public:
+/* ************************************************************************************ */
+   iaSurfaceNetWork();
+   ~iaSurfaceNetWork();
+/* ************************************************************************************ */
+   int nIAS; /*!< The number of surfaces (one per BCP).  */
+   int nVert; /*!< The total number of vertices.  */
+   int nTri; /*!< The total number of triangles.  */
+   /** The vertices of all the surfaces. The vertices of the surface i are
+    * vert[firstVert[i]],...,vert[firstVert[i]+nVertIAS[i]-1]; the first of them is
+    * the BCP.  */
+   solreal **vert;
+   /** The triangles of all the surfaces (indices to vert). The triangles of the surface i
+    * are tri[firstTri[i]],...,tri[firstTri[i]+nTriIAS[i]-1].  */
+   int **tri;
+   int *firstVert,*nVertIAS,*firstTri,*nTriIAS;
+   solreal *areaIAS; /*!< The area of every surface.  */
+/* ************************************************************************************ */
+   /** Self descriptive (the default is IASNW_DEFAULTNRAYS).  */
+   void setNofRays(const int nr) {nRays=((nr>=3)? nr : 3);}
+   /** Self descriptive (the default is IASNW_DEFAULTARCSTEP).  */
+   void setArcStep(const solreal ds) {arcStep=((ds>0.0e0)? ds : IASNW_DEFAULTARCSTEP);}
+   /** Self descriptive (the default is IASNW_DEFAULTMAXARCLENGTH).  */
+   void setMaxArcLength(const solreal ll) {maxArcLen=ll;}
+   /** The rays stop where the density is lower than rr (the default is
+    * IASNW_DEFAULTMINRHO).  */
+   void setMinRho(const solreal rr) {minRho=rr;}
+/* ************************************************************************************ */
+   /** Builds the surfaces of all the BCPs of cpn, which must be already known.  */
+   bool buildSurfaces(GaussWaveFunction &wf,critPtNetWork &cpn);
+/* ************************************************************************************ */
+   /** Writes the areas and sizes of the surfaces to the stream os.  */
+   void printSummary(ostream &os,critPtNetWork &cpn);
+   /** Writes all the surfaces into the Wavefront obj file onam (one object per surface,
+    * named after its BCP).  */
+   void writeOBJFile(string &onam,critPtNetWork &cpn);
+/* ************************************************************************************ */
+protected:
+/* ************************************************************************************ */
+   int nRays,maxPtsRay;
+   solreal arcStep,maxArcLen,minRho;
+/* ************************************************************************************ */
+   void destroyArrays(void);
+   /** Computes the two directions (in the plane of the negative eigenvalues of the
+    * Hessian) of the BCP x, saved into e1 and e2.  */
+   void getBCPPlane(GaussWaveFunction &wf,solreal const (&x)[3],solreal (&e1)[3],\
+         solreal (&e2)[3]);
+   /** Traces (downhill) the ray that starts at x0, saving its points (separated by the
+    * arc length arcStep) into pts. Returns the number of points.  */
+   int traceRay(GaussWaveFunction &twf,solreal const (&x0)[3],solreal ** (&pts),\
+         const int p0);
+   /** Evaluates -grad(rho)/|grad(rho)| at x. Returns |grad(rho)|, and the density in rr.  */
+   solreal evalDownhillDirection(GaussWaveFunction &twf,solreal const (&x)[3],\
+         solreal (&f)[3],solreal &rr);
+   /** Joins the rays of the surface s into triangles, and computes its area.  */
+   void triangulateSurface(const int s,int * (&npr),solreal ** (&rays));
+/* ************************************************************************************ */
+};
+/* ************************************************************************************ */
+
+#endif//_IASNETWORK_H_
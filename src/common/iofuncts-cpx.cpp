@@ -907,6 +907,19 @@ void cpxGetRCPConnectivityFromFile(ifstream &ifil,const int nn,int*** (&cc))
    }
 }
 /* ************************************************************************** */
+int cpxGetMaxNOfBCPsConnectedToRCP(ifstream &ifil,const int nn)
+{
+   if ( nn<=0 ) {return 0;}
+   cpxSetPosOfFileAfterOpenningKey(ifil,"RCPConnectivity",true);
+   int idx,ncon,res=0;
+   for (int i=0; i<nn; i++) {
+      ifil >> idx >> ncon;
+      if ( ncon>res ) {res=ncon;}
+      for ( int j=0 ; j<ncon ; ++j ) {ifil >> idx;}
+   }
+   return res;
+}
+/* ************************************************************************** */
 int cpxGetNOfRingPaths(ifstream &ifil)
 {
    int res;
@@ -966,6 +979,19 @@ void cpxGetCCPConnectivityFromFile(ifstream &ifil,const int nn,int*** (&cc))
    }
 }
 /* ************************************************************************** */
+int cpxGetMaxNOfRCPsConnectedToCCP(ifstream &ifil,const int nn)
+{
+   if ( nn<=0 ) {return 0;}
+   cpxSetPosOfFileAfterOpenningKey(ifil,"CCPConnectivity",true);
+   int idx,ncon,res=0;
+   for (int i=0; i<nn; i++) {
+      ifil >> idx >> ncon;
+      if ( ncon>res ) {res=ncon;}
+      for ( int j=0 ; j<ncon ; ++j ) {ifil >> idx;}
+   }
+   return res;
+}
+/* ************************************************************************** */
 int cpxGetNOfCagePaths(ifstream &ifil)
 {
    int res;
@@ -156,6 +156,10 @@ void cpxGetBondPathData(ifstream &ifil,const int nn,int** (&ii),solreal*** (&rrr
 /* ************************************************************************** */
 void cpxGetRCPConnectivityFromFile(ifstream &ifil,const int nn,int*** (&cc));
 /* ************************************************************************** */
+/** Returns the largest number of BCPs connected to a single RCP (out of the nn RCPs
+ * of the file).  */
+int cpxGetMaxNOfBCPsConnectedToRCP(ifstream &ifil,const int nn);
+/* ************************************************************************** */
 int cpxGetNOfRingPaths(ifstream &ifil);
 /* ************************************************************************** */
 void cpxGetNOfPtsPerRingPath(ifstream &ifil,const int nn,int*** (&ii));
@@ -164,6 +168,10 @@ void cpxGetRingPathData(ifstream &ifil,const int nn,int*** (&ii),solreal**** (&r
 /* ************************************************************************** */
 void cpxGetCCPConnectivityFromFile(ifstream &ifil,const int nn,int*** (&cc));
 /* ************************************************************************** */
+/** Returns the largest number of RCPs connected to a single CCP (out of the nn CCPs
+ * of the file).  */
+int cpxGetMaxNOfRCPsConnectedToCCP(ifstream &ifil,const int nn);
+/* ************************************************************************** */
 int cpxGetNOfCagePaths(ifstream &ifil);
 /* ************************************************************************** */
 void cpxGetNOfPtsPerCagePath(ifstream &ifil,const int nn,int*** (&ii));
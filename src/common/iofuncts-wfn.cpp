@@ -53,7 +53,10 @@ using std::atof;
 using std::cout;
 using std::endl;
 #include "solmemhand.h"
+#include "solfileutils.h"
+#include "solstringtools.h"
 #include <cmath>
+#include <cstring>
 /* ********************************************************************************************* */
 /* ********************************************************************************************* */
 string getTitleFromFileWFN(ifstream &ifil)
@@ -275,6 +278,299 @@ void getEnergyAndVirial(ifstream &ifil,solreal &theener,solreal &thevir)
 }
 /* ********************************************************************************************* */
 /* ********************************************************************************************* */
+#define WFNASSIGNHEADLEN 20
+#define WFNEXPONENTSHEADLEN 10
+#define WFNASSIGNWIDTH 3
+#define WFNASSIGNPERLINE 20
+#define WFNEXPONENTWIDTH 14
+#define WFNMOCOEFWIDTH 16
+#define WFNREALSPERLINE 5
+#define WFNCOORDSHEADLEN 24
+#define WFNCOORDWIDTH 12
+/* ********************************************************************************************* */
+wfnFileIndex::wfnFileIndex()
+{
+   buf=NULL;
+   len=0;
+   ismapped=false;
+   posCent=posType=posExpo=posEnd=0;
+   nMOLines=capMOLines=0;
+   posMO=NULL;
+}
+/* ********************************************************************************************* */
+wfnFileIndex::~wfnFileIndex()
+{
+   close();
+}
+/* ********************************************************************************************* */
+void wfnFileIndex::close(void)
+{
+   unmapFileFromMemory(buf,len,ismapped);
+   ismapped=false;
+   if ( posMO!=NULL ) {delete[] posMO;}
+   posMO=NULL;
+   nMOLines=capMOLines=0;
+   posCent=posType=posExpo=posEnd=0;
+}
+/* ********************************************************************************************* */
+bool wfnFileIndex::open(const string &fnam)
+{
+   close();
+   if ( !mapFileToMemory(fnam,buf,len,ismapped) ) {
+      cout << "Error: File " << fnam << " could not be opened...\n";
+      return false;
+   }
+   return buildIndex();
+}
+/* ********************************************************************************************* */
+size_t wfnFileIndex::lineEnd(const size_t pos) const
+{
+   if ( pos>=len ) {return len;}
+   const char *nl=static_cast<const char*>(memchr(buf+pos,'\n',len-pos));
+   size_t eol=((nl!=NULL)? size_t(nl-buf) : len);
+   if ( (eol>pos)&&(buf[eol-1]=='\r') ) {--eol;}
+   return eol;
+}
+/* ********************************************************************************************* */
+size_t wfnFileIndex::nextLine(const size_t pos) const
+{
+   if ( pos>=len ) {return len;}
+   const char *nl=static_cast<const char*>(memchr(buf+pos,'\n',len-pos));
+   return ((nl!=NULL)? size_t(nl-buf)+1 : len);
+}
+/* ********************************************************************************************* */
+bool wfnFileIndex::startsWith(const size_t pos,const char* key) const
+{
+   size_t kl=strlen(key);
+   return ( ((pos+kl)<=len)&&(memcmp(buf+pos,key,kl)==0) );
+}
+/* ********************************************************************************************* */
+bool wfnFileIndex::buildIndex(void)
+{
+   size_t pos=0,eol;
+   const char *nl;
+   bool havecent=false,havetype=false,haveexpo=false;
+   while ( pos<len ) {
+      nl=static_cast<const char*>(memchr(buf+pos,'\n',len-pos));
+      eol=((nl!=NULL)? size_t(nl-buf) : len);
+      if ( (!havecent)&&startsWith(pos,"CENTRE ASSIGNMENTS") ) {
+         posCent=pos; havecent=true;
+      } else if ( (!havetype)&&startsWith(pos,"TYPE ASSIGNMENTS") ) {
+         posType=pos; havetype=true;
+      } else if ( (!haveexpo)&&startsWith(pos,"EXPONENTS") ) {
+         posExpo=pos; haveexpo=true;
+      } else if ( startsWith(pos,"MO ") ) {
+         if ( nMOLines==capMOLines ) {
+            int ncap=((capMOLines>0)? 2*capMOLines : 64);
+            size_t *tmp=new size_t[ncap];
+            for ( int i=0 ; i<nMOLines ; ++i ) {tmp[i]=posMO[i];}
+            if ( posMO!=NULL ) {delete[] posMO;}
+            posMO=tmp;
+            capMOLines=ncap;
+         }
+         posMO[nMOLines++]=pos;
+      } else if ( startsWith(pos,"END DATA") ) {
+         posEnd=pos;
+         break;
+      }
+      pos=eol+1;
+   }
+   if ( !(havecent&&havetype&&haveexpo&&(posEnd>0)) ) {
+      cout << "Error: the wfn file seems to be incomplete!" << endl;
+      return false;
+   }
+   return true;
+}
+/* ********************************************************************************************* */
+bool wfnFileIndex::getHeader(string* &tit,string &orbdesc,int &nmo,int &npr,int &nnu) const
+{
+   size_t eol=lineEnd(0);
+   alloc1DStringArray(string("tit"),1,tit);
+   tit[0].assign(buf,eol);
+   const char *p=buf+nextLine(0),*pe=buf+lineEnd(nextLine(0));
+   while ( (p<pe)&&(*p==' ') ) {++p;}
+   const char *w=p;
+   while ( (p<pe)&&(*p!=' ') ) {++p;}
+   orbdesc.assign(w,size_t(p-w));
+   if ( orbdesc!="GAUSSIAN" ) {
+      cout << "Error: only gaussian orbitals are implemented in this version...\n";
+      return false;
+   }
+   //Line: GAUSSIAN  nmo MOL ORBITALS  npr PRIMITIVES  nnu NUCLEI
+   const char *tk[3]={"MOL ORBITALS","PRIMITIVES","NUCLEI"};
+   int *val[3]={&nmo,&npr,&nnu};
+   for ( int i=0 ; i<3 ; ++i ) {
+      if ( !getIntFromBuffer(p,pe,*val[i]) ) {
+         cout << "Error: Expecting a number before \"" << tk[i] << "\" in file...\n";
+         return false;
+      }
+      while ( (p<pe)&&(*p==' ') ) {++p;}
+      size_t kl=strlen(tk[i]);
+      if ( (size_t(pe-p)<kl)||(memcmp(p,tk[i],kl)!=0) ) {
+         cout << "Error: Expecting \"" << tk[i] << "\" in file...\n";
+         return false;
+      }
+      p+=kl;
+   }
+   return true;
+}
+/* ********************************************************************************************* */
+bool wfnFileIndex::getCenters(const int nnu,string* &atlbl,solreal* &rr,solreal* &atch) const
+{
+   alloc1DStringArray("atlbl",nnu,atlbl);
+   alloc1DRealArray("rr",3*nnu,rr);
+   alloc1DRealArray("atch",nnu,atch);
+   size_t pos=nextLine(nextLine(0)),eol,fb,fe;
+   const char *p,*pe;
+   for ( int i=0 ; i<nnu ; ++i ) {
+      eol=lineEnd(pos);
+      //Label: columns 1-12, without spaces.
+      atlbl[i].clear();
+      for ( size_t k=pos ; (k<(pos+12))&&(k<eol) ; ++k ) {
+         if ( buf[k]!=' ' ) {atlbl[i]+=buf[k];}
+      }
+      //Coordinates: 3F12.8 after "(CENTRE nn)"; fields may touch (e.g. 0.00000000-12.63381616).
+      fb=pos+WFNCOORDSHEADLEN;
+      for ( int j=0 ; j<3 ; ++j ) {
+         fe=fb+WFNCOORDWIDTH;
+         if ( fe>eol ) {fe=eol;}
+         p=buf+fb;
+         if ( (fb>=eol)||(!getRealFromBuffer(p,buf+fe,rr[3*i+j])) ) {
+            cout << "Error: corrupted centre line (" << i+1 << ")!" << endl;
+            return false;
+         }
+         fb=fe;
+      }
+      p=buf+fb; pe=buf+eol;
+      p=static_cast<const char*>(memchr(p,'=',size_t(pe-p)));
+      if ( (p==NULL)||(!getRealFromBuffer(++p,pe,atch[i])) ) {
+         cout << "Error: missing charge in centre line (" << i+1 << ")!" << endl;
+         return false;
+      }
+      pos=nextLine(pos);
+   }
+   return true;
+}
+/* ********************************************************************************************* */
+bool wfnFileIndex::getFixedInts(size_t pos,const char* key,const int n,int* v) const
+{
+   size_t eol,fb;
+   const char *p;
+   int count=0;
+   while ( (count<n)&&(pos<len) ) {
+      eol=lineEnd(pos);
+      if ( !startsWith(pos,key) ) {break;}
+      fb=pos+WFNASSIGNHEADLEN;
+      for ( int j=0 ; (j<WFNASSIGNPERLINE)&&(count<n)&&(fb<eol) ; ++j ) {
+         p=buf+fb;
+         if ( !getIntFromBuffer(p,buf+((fb+WFNASSIGNWIDTH<eol)? fb+WFNASSIGNWIDTH : eol),v[count]) ) {
+            break;
+         }
+         v[count]--;
+         ++count;
+         fb+=WFNASSIGNWIDTH;
+      }
+      pos=nextLine(pos);
+      while ( (pos<len)&&((buf[pos]=='\n')||(buf[pos]=='\r')) ) {++pos;}
+   }
+   if ( count<n ) {
+      cout << "Error: only " << count << " entries found for \"" << key << "\"" << endl;
+      return false;
+   }
+   return true;
+}
+/* ********************************************************************************************* */
+bool wfnFileIndex::getPrimitives(const int npr,int* &pricen,int* &primty,solreal* &prexp) const
+{
+   alloc1DIntArray("pricen",npr,pricen);
+   alloc1DIntArray("primty",npr,primty);
+   alloc1DRealArray("prexp",npr,prexp);
+   if ( !getFixedInts(posCent,"CENTRE ASSIGNMENTS",npr,pricen) ) {return false;}
+   if ( !getFixedInts(posType,"TYPE ASSIGNMENTS",npr,primty) ) {return false;}
+   size_t pos=posExpo,eol,fb,fe;
+   const char *p;
+   int count=0;
+   while ( (count<npr)&&(pos<len) ) {
+      eol=lineEnd(pos);
+      fb=pos+WFNEXPONENTSHEADLEN;
+      for ( int j=0 ; (j<WFNREALSPERLINE)&&(count<npr)&&(fb<eol) ; ++j ) {
+         fe=fb+WFNEXPONENTWIDTH;
+         if ( fe>eol ) {fe=eol;}
+         p=buf+fb;
+         if ( !getFortranRealFromField(p,buf+fe,prexp[count]) ) {break;}
+         ++count;
+         fb=fe;
+      }
+      pos=nextLine(pos);
+      while ( (pos<len)&&((buf[pos]=='\n')||(buf[pos]=='\r')) ) {++pos;}
+   }
+   if ( count<npr ) {
+      cout << "Error: only " << count << " exponents were found!" << endl;
+      return false;
+   }
+   return true;
+}
+/* ********************************************************************************************* */
+bool wfnFileIndex::getMolecularOrbitals(const int norb,const int npr,\
+      solreal* &ocn,solreal* &moe,solreal* &moc) const
+{
+   alloc1DRealArray("moc",(norb*npr),moc);
+   alloc1DRealArray("ocn",norb,ocn);
+   alloc1DRealArray("moe",norb,moe);
+   if ( nMOLines<norb ) {
+      cout << "Error: only " << nMOLines << " molecular orbitals were found!" << endl;
+      return false;
+   }
+   bool res=true;
+#if PARALLELISEDTK
+#pragma omp parallel for reduction(&&:res)
+#endif
+   for ( int k=0 ; k<norb ; ++k ) {
+      size_t pos=posMO[k],eol=lineEnd(pos),fb,fe;
+      //MO header: ... OCC NO = occ  ORB. ENERGY = ene
+      const char *p=buf+pos,*pe=buf+eol;
+      p=static_cast<const char*>(memchr(p,'=',size_t(pe-p)));
+      bool ok=(p!=NULL)&&getRealFromBuffer(++p,pe,ocn[k]);
+      if ( ok ) {
+         p=static_cast<const char*>(memchr(p,'=',size_t(pe-p)));
+         ok=(p!=NULL)&&getRealFromBuffer(++p,pe,moe[k]);
+      }
+      solreal *cf=moc+(size_t(k)*size_t(npr));
+      int count=0;
+      pos=nextLine(pos);
+      while ( ok&&(count<npr)&&(pos<len) ) {
+         eol=lineEnd(pos);
+         fb=pos;
+         for ( int j=0 ; (j<WFNREALSPERLINE)&&(count<npr)&&(fb<eol) ; ++j ) {
+            fe=fb+WFNMOCOEFWIDTH;
+            if ( fe>eol ) {fe=eol;}
+            p=buf+fb;
+            if ( !getFortranRealFromField(p,buf+fe,cf[count]) ) {break;}
+            ++count;
+            fb=fe;
+         }
+         pos=nextLine(pos);
+         while ( (pos<len)&&((buf[pos]=='\n')||(buf[pos]=='\r')) ) {++pos;}
+      }
+      if ( !(ok&&(count==npr)) ) {res=false;}
+   }
+   if ( !res ) {cout << "Error: incomplete molecular orbital data!" << endl;}
+   return res;
+}
+/* ********************************************************************************************* */
+bool wfnFileIndex::getEnergyAndVirial(solreal &theener,solreal &thevir) const
+{
+   size_t pos=nextLine(posEnd);
+   if ( pos>=len ) {return false;}
+   const char *p=buf+pos,*pe=buf+lineEnd(pos);
+   p=static_cast<const char*>(memchr(p,'=',size_t(pe-p)));
+   if ( (p==NULL)||(!getRealFromBuffer(++p,pe,theener)) ) {return false;}
+   p=static_cast<const char*>(memchr(p,'=',size_t(pe-p)));
+   if ( (p==NULL)||(!getRealFromBuffer(++p,pe,thevir)) ) {return false;}
+   return true;
+}
+/* ********************************************************************************************* */
+/* ********************************************************************************************* */
 /* ********************************************************************************************* */
 #endif//_IOFUNCTS_WFN_CPP_
 
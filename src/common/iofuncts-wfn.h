@@ -68,5 +68,44 @@ void processPrimitivesWFN(ifstream &ifil,const int npr,int* &pricen,int* &primty
 void processMolecularOrbitalPropsAndCoefs(ifstream &ifil,const int norb,const int npr
                                  ,solreal* &ocn,solreal* &moe,solreal* &moc);
 void getEnergyAndVirial(ifstream &ifil,solreal &theener,solreal &thevir);
+
+/* ********************************************************************************************* */
+/** wfnFileIndex maps a wfn file into memory and records, in a single pass, the offsets of
+ the lines that start every section (centres, CENTRE ASSIGNMENTS, TYPE ASSIGNMENTS,
+ EXPONENTS, each MO block, END DATA). The fixed-column Fortran records are then parsed
+ directly from the buffer into the final arrays (D exponents included), without
+ building intermediate strings. Once the MO offsets are known, the MO blocks are parsed
+ in parallel if PARALLELISEDTK is enabled. The arrays are allocated as in the
+ ifstream-based functions above.  */
+class wfnFileIndex {
+/* ********************************************************************************************* */
+public:
+   wfnFileIndex();
+   ~wfnFileIndex();
+   bool open(const string &fnam);
+   void close(void);
+   bool isOpen(void) const {return (buf!=NULL);}
+   bool getHeader(string* &tit,string &orbdesc,int &nmo,int &npr,int &nnu) const;
+   bool getCenters(const int nnu,string* &atlbl,solreal* &rr,solreal* &atch) const;
+   bool getPrimitives(const int npr,int* &pricen,int* &primty,solreal* &prexp) const;
+   bool getMolecularOrbitals(const int norb,const int npr,\
+         solreal* &ocn,solreal* &moe,solreal* &moc) const;
+   bool getEnergyAndVirial(solreal &theener,solreal &thevir) const;
+/* ********************************************************************************************* */
+protected:
+   char *buf;
+   size_t len;
+   bool ismapped;
+   size_t posCent,posType,posExpo,posEnd;
+   int nMOLines,capMOLines;
+   size_t *posMO;
+   size_t lineEnd(const size_t pos) const;
+   size_t nextLine(const size_t pos) const;
+   bool startsWith(const size_t pos,const char* key) const;
+   bool buildIndex(void);
+   bool getFixedInts(size_t pos,const char* key,const int n,int* v) const;
+/* ********************************************************************************************* */
+};
+/* ********************************************************************************************* */
 #endif//_IOFUNCTS_WFN_H_
 
@@ -52,6 +52,8 @@ using std::cout;
 using std::endl;
 #include "solmemhand.h"
 #include "solstringtools.h"
+#include "solfileutils.h"
+#include <cstring>
 
 #define MAXWFXKEYSDEF 36
 static const string wfxKeysTab[MAXWFXKEYSDEF]=
@@ -524,5 +526,255 @@ void getEDFExistenceFromFileWFX(ifstream &ifil,bool &ihaveEDF)
 }
 /* ************************************************************************** */
 /* ************************************************************************** */
+wfxFileIndex::wfxFileIndex()
+{
+   buf=NULL;
+   len=0;
+   ismapped=false;
+   nTags=capTags=0;
+   tagName=tagCBeg=tagCEnd=tagAEnd=NULL;
+   tagNameLen=NULL;
+}
+/* ************************************************************************** */
+wfxFileIndex::~wfxFileIndex()
+{
+   close();
+}
+/* ************************************************************************** */
+void wfxFileIndex::close(void)
+{
+   unmapFileFromMemory(buf,len,ismapped);
+   ismapped=false;
+   if ( capTags>0 ) {
+      delete[] tagName;
+      delete[] tagCBeg;
+      delete[] tagCEnd;
+      delete[] tagAEnd;
+      delete[] tagNameLen;
+   }
+   tagName=tagCBeg=tagCEnd=tagAEnd=NULL;
+   tagNameLen=NULL;
+   nTags=capTags=0;
+}
+/* ************************************************************************** */
+bool wfxFileIndex::open(const string &fnam)
+{
+   close();
+   if ( !mapFileToMemory(fnam,buf,len,ismapped) ) {
+      cout << "Error: File " << fnam << " could not be opened...\n";
+      return false;
+   }
+   return buildIndex();
+}
+/* ************************************************************************** */
+void wfxFileIndex::growTagArrays(void)
+{
+   int ncap=((capTags>0)? 2*capTags : 64);
+   size_t *nna=new size_t[ncap];
+   size_t *ncb=new size_t[ncap];
+   size_t *nce=new size_t[ncap];
+   size_t *nae=new size_t[ncap];
+   int *nnl=new int[ncap];
+   for ( int i=0 ; i<nTags ; ++i ) {
+      nna[i]=tagName[i];
+      ncb[i]=tagCBeg[i];
+      nce[i]=tagCEnd[i];
+      nae[i]=tagAEnd[i];
+      nnl[i]=tagNameLen[i];
+   }
+   if ( capTags>0 ) {
+      delete[] tagName;
+      delete[] tagCBeg;
+      delete[] tagCEnd;
+      delete[] tagAEnd;
+      delete[] tagNameLen;
+   }
+   tagName=nna; tagCBeg=ncb; tagCEnd=nce; tagAEnd=nae; tagNameLen=nnl;
+   capTags=ncap;
+}
+/* ************************************************************************** */
+bool wfxFileIndex::buildIndex(void)
+{
+   //A tag is a line whose first and last non-blank characters are '<' and '>'
+   int nopen=0,capopen=16;
+   int *openTag=new int[capopen];
+   size_t pos=0,lb,le,eol;
+   const char *nl;
+   while ( pos<len ) {
+      nl=static_cast<const char*>(memchr(buf+pos,'\n',len-pos));
+      eol=((nl!=NULL)? size_t(nl-buf) : len);
+      lb=pos; le=eol;
+      while ( (lb<le)&&((buf[lb]==' ')||(buf[lb]=='\t')) ) {++lb;}
+      while ( (le>lb)&&((buf[le-1]==' ')||(buf[le-1]=='\t')||(buf[le-1]=='\r')) ) {--le;}
+      if ( ((le-lb)>2)&&(buf[lb]=='<')&&(buf[le-1]=='>') ) {
+         if ( buf[lb+1]=='/' ) {
+            size_t nb=lb+2;
+            int nlen=int(le-1-nb);
+            for ( int k=nopen-1 ; k>=0 ; --k ) {
+               int t=openTag[k];
+               if ( (tagNameLen[t]==nlen)&&(memcmp(buf+tagName[t],buf+nb,nlen)==0) ) {
+                  tagCEnd[t]=pos;
+                  tagAEnd[t]=((eol<len)? eol+1 : len);
+                  nopen=k;
+                  break;
+               }
+            }
+         } else {
+            if ( nTags==capTags ) {growTagArrays();}
+            tagName[nTags]=lb+1;
+            tagNameLen[nTags]=int(le-lb-2);
+            tagCBeg[nTags]=((eol<len)? eol+1 : len);
+            tagCEnd[nTags]=tagAEnd[nTags]=len;
+            if ( nopen==capopen ) {
+               int *tmp=new int[2*capopen];
+               for ( int k=0 ; k<nopen ; ++k ) {tmp[k]=openTag[k];}
+               delete[] openTag;
+               openTag=tmp;
+               capopen*=2;
+            }
+            openTag[nopen++]=nTags;
+            ++nTags;
+         }
+      }
+      pos=eol+1;
+   }
+   delete[] openTag;
+   return (nTags>0);
+}
+/* ************************************************************************** */
+bool wfxFileIndex::tagIs(const int i,const string &key) const
+{
+   return ( (size_t(tagNameLen[i])==key.length())&&\
+         (memcmp(buf+tagName[i],key.c_str(),key.length())==0) );
+}
+/* ************************************************************************** */
+int wfxFileIndex::findKey(const string &key,const int from) const
+{
+   for ( int i=from ; i<nTags ; ++i ) {if ( tagIs(i,key) ) {return i;}}
+   return -1;
+}
+/* ************************************************************************** */
+int wfxFileIndex::countKey(const string &key) const
+{
+   int nk=0;
+   for ( int i=0 ; i<nTags ; ++i ) {if ( tagIs(i,key) ) {++nk;}}
+   return nk;
+}
+/* ************************************************************************** */
+bool wfxFileIndex::getKeyRange(const string &key,size_t &beg,size_t &end) const
+{
+   int i=findKey(key);
+   if ( i<0 ) {return false;}
+   beg=tagCBeg[i];
+   end=tagCEnd[i];
+   return true;
+}
+/* ************************************************************************** */
+bool wfxFileIndex::getInt(const string &key,int &val) const
+{
+   return getInts(key,1,&val);
+}
+/* ************************************************************************** */
+bool wfxFileIndex::getReal(const string &key,solreal &val) const
+{
+   return getReals(key,1,&val);
+}
+/* ************************************************************************** */
+bool wfxFileIndex::getInts(const string &key,const int n,int* v,\
+      const int off,const int shift) const
+{
+   size_t b,e;
+   if ( !getKeyRange(key,b,e) ) {return false;}
+   const char *p=buf+b,*pe=buf+e;
+   for ( int i=off ; i<(off+n) ; ++i ) {
+      if ( !getIntFromBuffer(p,pe,v[i]) ) {
+         cout << "Error: not enough data within the key <" << key << ">" << endl;
+         return false;
+      }
+      v[i]+=shift;
+   }
+   return true;
+}
+/* ************************************************************************** */
+bool wfxFileIndex::getReals(const string &key,const int n,solreal* v,\
+      const int off) const
+{
+   size_t b,e;
+   if ( !getKeyRange(key,b,e) ) {return false;}
+   const char *p=buf+b,*pe=buf+e;
+   for ( int i=off ; i<(off+n) ; ++i ) {
+      if ( !getRealFromBuffer(p,pe,v[i]) ) {
+         cout << "Error: not enough data within the key <" << key << ">" << endl;
+         return false;
+      }
+   }
+   return true;
+}
+/* ************************************************************************** */
+int wfxFileIndex::sumIntsOfKey(const string &key) const
+{
+   int tot=0,tmp;
+   const char *p;
+   for ( int i=0 ; i<nTags ; ++i ) {
+      if ( !tagIs(i,key) ) {continue;}
+      p=buf+tagCBeg[i];
+      if ( getIntFromBuffer(p,buf+tagCEnd[i],tmp) ) {tot+=tmp;}
+   }
+   return tot;
+}
+/* ************************************************************************** */
+bool wfxFileIndex::getLines(const string &key,int &nl,string* &lines) const
+{
+   size_t b,e,pos;
+   nl=0;
+   if ( !getKeyRange(key,b,e) ) {return false;}
+   for ( pos=b ; pos<e ; ++pos ) {if ( buf[pos]=='\n' ) {++nl;}}
+   if ( (e>b)&&(buf[e-1]!='\n') ) {++nl;}
+   if ( nl==0 ) {return true;}
+   alloc1DStringArray("lines",nl,lines);
+   const char *nlp;
+   size_t eol;
+   pos=b;
+   for ( int i=0 ; i<nl ; ++i ) {
+      nlp=static_cast<const char*>(memchr(buf+pos,'\n',e-pos));
+      eol=((nlp!=NULL)? size_t(nlp-buf) : e);
+      lines[i].assign(buf+pos,eol-pos);
+      removeSpacesLeftAndRight(lines[i]);
+      pos=eol+1;
+   }
+   return true;
+}
+/* ************************************************************************** */
+bool wfxFileIndex::getMOCoefficients(const int nmo,const int npr,solreal* cf) const
+{
+   int *moTag=new int[nmo];
+   int t=-1;
+   bool res=true;
+   for ( int i=0 ; i<nmo ; ++i ) {
+      t=findKey(string("MO Number"),t+1);
+      if ( t<0 ) {
+         cout << "Error: only " << i << " <MO Number> keys were found!" << endl;
+         delete[] moTag;
+         return false;
+      }
+      moTag[i]=t;
+   }
+#if PARALLELISEDTK
+#pragma omp parallel for reduction(&&:res)
+#endif
+   for ( int i=0 ; i<nmo ; ++i ) {
+      //The coefficients start right after </MO Number> and end at the next tag
+      const char *p=buf+tagAEnd[moTag[i]];
+      const char *pe=((moTag[i]+1)<nTags)? buf+tagName[moTag[i]+1] : buf+len;
+      for ( int j=0 ; j<npr ; ++j ) {
+         if ( !getRealFromBuffer(p,pe,cf[npr*i+j]) ) {res=false; break;}
+      }
+   }
+   delete[] moTag;
+   if ( !res ) {cout << "Error: incomplete molecular orbital coefficients!" << endl;}
+   return res;
+}
+/* ************************************************************************** */
+/* ************************************************************************** */
 #endif//_IOFUNCTS_WFX_CPP_
 
@@ -97,5 +97,58 @@ void getEDFExistenceFromFileWFX(ifstream &ifil,bool &ihaveEDF);
 void getEDFPrimCoefficientsFromFileWFX(ifstream &ifil,\
       const int nedfp,solreal* &edfc);
 
+/* ************************************************************************** */
+/** wfxFileIndex maps a wfx file into memory and, in a single pass over the
+ buffer, records every tag (<key> ... </key>) together with the 64-bit offsets
+ of its content. Subsequent queries only parse the requested range, instead of
+ rescanning the file from the beginning for every key (as the ifstream-based
+ functions above do). Repeated tags (e.g. "MO Number") are indexed in the order
+ they appear in the file.  */
+class wfxFileIndex {
+/* ************************************************************************** */
+public:
+   wfxFileIndex();
+   ~wfxFileIndex();
+   /** Maps the file and builds the tag index. Returns false on failure.  */
+   bool open(const string &fnam);
+   void close(void);
+   bool isOpen(void) const {return (buf!=NULL);}
+   /** Returns the index of the first tag named key whose position is at or
+    after from, or -1 if there is no such tag.  */
+   int findKey(const string &key,const int from=0) const;
+   int countKey(const string &key) const;
+   /** Content range [beg,end) of the first tag named key.  */
+   bool getKeyRange(const string &key,size_t &beg,size_t &end) const;
+   bool getInt(const string &key,int &val) const;
+   bool getReal(const string &key,solreal &val) const;
+   /** Reads n integers from the first tag named key into v[off..off+n-1],
+    adding shift to every value (shift=-1 converts Fortran indices).  */
+   bool getInts(const string &key,const int n,int* v,const int off=0,\
+         const int shift=0) const;
+   bool getReals(const string &key,const int n,solreal* v,const int off=0) const;
+   /** Sum of the integers stored in every tag named key.  */
+   int sumIntsOfKey(const string &key) const;
+   /** Returns the (trimmed) lines of the first tag named key; lines is
+    allocated here.  */
+   bool getLines(const string &key,int &nl,string* &lines) const;
+   /** Reads the nmo x npr coefficient matrix; each block is located through
+    its "MO Number" tag. The blocks are parsed in parallel if PARALLELISEDTK
+    is enabled.  */
+   bool getMOCoefficients(const int nmo,const int npr,solreal* cf) const;
+/* ************************************************************************** */
+protected:
+   char *buf;
+   size_t len;
+   bool ismapped;
+   int nTags,capTags;
+   size_t *tagName,*tagCBeg,*tagCEnd,*tagAEnd;
+   int *tagNameLen;
+   void growTagArrays(void);
+   bool buildIndex(void);
+   bool tagIs(const int i,const string &key) const;
+/* ************************************************************************** */
+};
+/* ************************************************************************** */
+
 #endif//_IOFUNCTS_WFX_H_
 
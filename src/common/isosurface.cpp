@@ -0,0 +1,804 @@
+/*
+ *                    This source code is part of
+ *
+ *                  D  E  N  S  T  O  O  L  K  I  T
+ *
+ *                         VERSION: 1.2.0
+ *
+ *             Contributors: Juan Manuel Solano-Altamirano
+ *                           Julio Manuel Hernandez-Perez
+ *        Copyright (c) 2013-2015, Juan Manuel Solano-Altamirano
+ *                                 <jmsolanoalt@gmail.com>
+ *
+ * -------------------------------------------------------------------
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * ---------------------------------------------------------------------
+ *
+ * If you want to redistribute modifications of the suite, please
+ * consider to include your modifications in our official release.
+ * We will be pleased to consider the inclusion of your code
+ * within the official distribution. Please keep in mind that
+ * scientific software is very special, and version control is 
+ * crucial for tracing bugs. If in despite of this you distribute
+ * your modified version, please do not call it DensToolKit.
+ *
+ * If you find DensToolKit useful, we humbly ask that you cite
+ * the paper(s) on the package --- you can find them on the top
+ * README file.
+ *
+ */
+
+
+#ifndef _ISOSURFACE_CPP_
+#define _ISOSURFACE_CPP_
+
+#include "isosurface.h"
+#include "solmemhand.h"
+#include "solscrutils.h"
+#include "solcubetools.h"
+#include <iostream>
+using std::cout;
+using std::endl;
+#include <fstream>
+using std::ifstream;
+using std::ofstream;
+#include <iomanip>
+using std::setprecision;
+using std::setw;
+using std::scientific;
+using std::fixed;
+#include <cmath>
+
+/* ************************************************************************************ */
+isoSurface::isoSurface()
+{
+   nVert=nTri=0;
+   capVert=capTri=0;
+   vert=norm=NULL;
+   tri=NULL;
+   vProp=NULL;
+   vPropType=NONE;
+   isoVal=colRange=0.0e0;
+   for ( int k=0 ; k<3 ; k++ ) {
+      npts[k]=0;
+      xin[k]=0.0e0;
+      dx[k]=1.0e0;
+   }
+   nPlanes=0;
+   valA=valB=NULL;
+   inA=inB=crs=NULL;
+}
+/* ************************************************************************************ */
+isoSurface::~isoSurface()
+{
+   destroyPlanes();
+   deallocFlat2DRealArray(vert);
+   deallocFlat2DRealArray(norm);
+   deallocFlat2DIntArray(tri);
+   dealloc1DRealArray(vProp);
+}
+/* ************************************************************************************ */
+void isoSurface::destroyPlanes(void)
+{
+   dealloc1DRealArray(valA);
+   dealloc1DRealArray(valB);
+   dealloc1DIntArray(inA);
+   dealloc1DIntArray(inB);
+   dealloc1DIntArray(crs);
+   nPlanes=0;
+}
+/* ************************************************************************************ */
+bool isoSurface::startExtraction(const solreal isov,const int (&nn)[3],\
+      solreal const (&x0)[3],solreal const (&hh)[3])
+{
+   destroyPlanes();
+   deallocFlat2DRealArray(vert);
+   deallocFlat2DRealArray(norm);
+   deallocFlat2DIntArray(tri);
+   dealloc1DRealArray(vProp);
+   vPropType=NONE;
+   nVert=nTri=0;
+   for ( int k=0 ; k<3 ; k++ ) {
+      if ( nn[k]<2 || hh[k]<=0.0e0 ) {
+         displayErrorMessage("The grid for the isosurface is not set up!");
+         return false;
+      }
+      npts[k]=nn[k];
+      xin[k]=x0[k];
+      dx[k]=hh[k];
+   }
+   isoVal=isov;
+   capVert=capTri=ISOSURF_INITCAPACITY;
+   allocFlat2DRealArray(string("vert"),capVert,3,vert);
+   allocFlat2DRealArray(string("norm"),capVert,3,norm);
+   allocFlat2DIntArray(string("tri"),capTri,3,tri);
+   const int nsl=npts[1]*npts[2];
+   alloc1DRealArray(string("valA"),nsl,valA);
+   alloc1DRealArray(string("valB"),nsl,valB);
+   alloc1DIntArray(string("inA"),3*nsl,inA,-1);
+   alloc1DIntArray(string("inB"),3*nsl,inB,-1);
+   alloc1DIntArray(string("crs"),4*nsl,crs,-1);
+   return true;
+}
+/* ************************************************************************************ */
+void isoSurface::addPlane(const solreal *pv)
+{
+   if ( valA==NULL || nPlanes>=npts[0] ) {return;}
+   const int nsl=npts[1]*npts[2];
+   solreal *tv=((nPlanes==0)? valA : valB);
+   for ( int m=0 ; m<nsl ; m++ ) {tv[m]=pv[m];}
+   ++nPlanes;
+   if ( nPlanes<2 ) {return;}
+   polygonizeSlab();
+   /* The upper plane is the lower plane of the next slab.  */
+   tv=valA; valA=valB; valB=tv;
+   int *ti=inA; inA=inB; inB=ti;
+   for ( int m=0 ; m<3*nsl ; m++ ) {inB[m]=-1;}
+}
+/* ************************************************************************************ */
+void isoSurface::endExtraction(void)
+{
+   destroyPlanes();
+}
+/* ************************************************************************************ */
+void isoSurface::polygonizeSlab(void)
+{
+   const int nsl=npts[1]*npts[2];
+   for ( int m=0 ; m<4*nsl ; m++ ) {crs[m]=-1;}
+   /* The six tetrahedra of every cube share the main diagonal (corners 0 and 7); the
+      corners are numbered with the bits x=4, y=2 and z=1, so that the corners of every
+      tetrahedron, 0 < a < a|b < 7, are nested, and all the cubes are split alike.  */
+   static const int tets[6][4]={{0,4,6,7},{0,4,5,7},{0,2,6,7},\
+                                {0,2,3,7},{0,1,5,7},{0,1,3,7}};
+   solreal val[8];
+   int m;
+   bool allin,allout;
+   for ( int j=0 ; j<(npts[1]-1) ; j++ ) {
+      for ( int k=0 ; k<(npts[2]-1) ; k++ ) {
+         allin=allout=true;
+         for ( int c=0 ; c<8 ; c++ ) {
+            m=(j+((c>>1)&1))*npts[2]+(k+(c&1));
+            val[c]=((c&4)? valB[m] : valA[m]);
+            if ( val[c]>=isoVal ) {allout=false;} else {allin=false;}
+         }
+         if ( allin || allout ) {continue;}
+         for ( int t=0 ; t<6 ; t++ ) {polygonizeTet(j,k,tets[t],val);}
+      }
+   }
+}
+/* ************************************************************************************ */
+void isoSurface::polygonizeTet(const int j,const int k,const int (&c)[4],\
+      solreal const (&val)[8])
+{
+   int ins[4],out[4],ni=0,no=0;
+   for ( int p=0 ; p<4 ; p++ ) {
+      if ( val[c[p]]>=isoVal ) {ins[ni++]=p;} else {out[no++]=p;}
+   }
+   if ( ni==0 || no==0 ) {return;}
+   /* The triangles are oriented along dir, from the inner corners to the outer ones.  */
+   solreal dir[3]={0.0e0,0.0e0,0.0e0},x[3];
+   for ( int p=0 ; p<ni ; p++ ) {
+      getCornerCoords(j,k,c[ins[p]],x);
+      for ( int l=0 ; l<3 ; l++ ) {dir[l]-=x[l]/solreal(ni);}
+   }
+   for ( int p=0 ; p<no ; p++ ) {
+      getCornerCoords(j,k,c[out[p]],x);
+      for ( int l=0 ; l<3 ; l++ ) {dir[l]+=x[l]/solreal(no);}
+   }
+   int v[4];
+   if ( ni==1 || no==1 ) {
+      int s=((ni==1)? ins[0] : out[0]),n=0;
+      for ( int p=0 ; p<4 ; p++ ) {
+         if ( p==s ) {continue;}
+         v[n++]=getEdgeVertex(j,k,c[((p<s)? p : s)],c[((p<s)? s : p)],val);
+      }
+      addTriangle(v[0],v[1],v[2],dir);
+   } else {
+      int a=ins[0],b=ins[1],cc=out[0],d=out[1];
+      v[0]=getEdgeVertex(j,k,c[((a<cc)? a : cc)],c[((a<cc)? cc : a)],val);
+      v[1]=getEdgeVertex(j,k,c[((a<d)? a : d)],c[((a<d)? d : a)],val);
+      v[2]=getEdgeVertex(j,k,c[((b<d)? b : d)],c[((b<d)? d : b)],val);
+      v[3]=getEdgeVertex(j,k,c[((b<cc)? b : cc)],c[((b<cc)? cc : b)],val);
+      addTriangle(v[0],v[1],v[2],dir);
+      addTriangle(v[0],v[2],v[3],dir);
+   }
+}
+/* ************************************************************************************ */
+int isoSurface::getEdgeVertex(const int j,const int k,const int cu,const int cv,\
+      solreal const (&val)[8])
+{
+   /* cu is a subset of cv, hence the edge is identified by the point of cu and the
+      direction d.  */
+   const int d=cu^cv;
+   const int pt=(j+((cu>>1)&1))*npts[2]+(k+(cu&1));
+   int *slot;
+   if ( d&4 ) {
+      slot=&crs[4*pt+(d&3)];
+   } else {
+      slot=&(((cu&4)? inB : inA)[3*pt+(d-1)]);
+   }
+   if ( (*slot)>=0 ) {return (*slot);}
+   solreal xu[3],xv[3],x[3];
+   getCornerCoords(j,k,cu,xu);
+   getCornerCoords(j,k,cv,xv);
+   solreal t=(isoVal-val[cu])/(val[cv]-val[cu]);
+   for ( int l=0 ; l<3 ; l++ ) {x[l]=xu[l]+t*(xv[l]-xu[l]);}
+   (*slot)=addVertex(x);
+   return (*slot);
+}
+/* ************************************************************************************ */
+void isoSurface::getCornerCoords(const int j,const int k,const int c,solreal (&x)[3])
+{
+   x[0]=xin[0]+solreal(nPlanes-2+((c>>2)&1))*dx[0];
+   x[1]=xin[1]+solreal(j+((c>>1)&1))*dx[1];
+   x[2]=xin[2]+solreal(k+(c&1))*dx[2];
+}
+/* ************************************************************************************ */
+int isoSurface::addVertex(solreal const (&x)[3])
+{
+   if ( nVert>=capVert ) {
+      resizeFlat2DRealArray(string("vert"),capVert,2*capVert,3,vert);
+      resizeFlat2DRealArray(string("norm"),capVert,2*capVert,3,norm);
+      capVert*=2;
+   }
+   for ( int l=0 ; l<3 ; l++ ) {
+      vert[nVert][l]=x[l];
+      norm[nVert][l]=0.0e0;
+   }
+   return (nVert++);
+}
+/* ************************************************************************************ */
+void isoSurface::addTriangle(const int a,const int b,const int c,solreal const (&dir)[3])
+{
+   if ( a==b || b==c || c==a ) {return;}
+   if ( nTri>=capTri ) {
+      resizeFlat2DIntArray(string("tri"),capTri,2*capTri,3,tri);
+      capTri*=2;
+   }
+   solreal u[3],v[3],n[3];
+   for ( int l=0 ; l<3 ; l++ ) {
+      u[l]=vert[b][l]-vert[a][l];
+      v[l]=vert[c][l]-vert[a][l];
+   }
+   n[0]=u[1]*v[2]-u[2]*v[1];
+   n[1]=u[2]*v[0]-u[0]*v[2];
+   n[2]=u[0]*v[1]-u[1]*v[0];
+   tri[nTri][0]=a;
+   if ( (n[0]*dir[0]+n[1]*dir[1]+n[2]*dir[2])>=0.0e0 ) {
+      tri[nTri][1]=b;
+      tri[nTri][2]=c;
+   } else {
+      tri[nTri][1]=c;
+      tri[nTri][2]=b;
+   }
+   ++nTri;
+}
+/* ************************************************************************************ */
+solreal isoSurface::evalField(GaussWaveFunction &wf,const ScalarFieldType ft,\
+      const solreal x,const solreal y,const solreal z)
+{
+   if ( ft==DENS ) {return wf.evalDensity(x,y,z);}
+   solreal val;
+   wf.evalMultipleFields(x,y,z,&ft,1,&val);
+   return val;
+}
+/* ************************************************************************************ */
+bool isoSurface::extractFromWaveFunction(waveFunctionGrid3D &grd,GaussWaveFunction &wf,\
+      const ScalarFieldType ft,const solreal isov,string *cubnam)
+{
+   int nn[3];
+   solreal x0[3],hh[3];
+   for ( int k=0 ; k<3 ; k++ ) {
+      nn[k]=grd.getNPts(k);
+      x0[k]=grd.xin[k];
+      hh[k]=grd.dx[k][k];
+      for ( int l=0 ; l<3 ; l++ ) {
+         if ( l!=k && grd.dx[k][l]!=0.0e0 ) {
+            displayErrorMessage("The grid for the isosurface must be orthogonal!");
+            return false;
+         }
+      }
+   }
+   if ( !startExtraction(isov,nn,x0,hh) ) {return false;}
+   ofstream ofil;
+   if ( cubnam!=NULL ) {
+      string comm=grd.comments+string("Property: ");
+      comm+=getFieldTypeKeyLong(convertScalarFieldType2Char(ft));
+      ofil.open(cubnam->c_str());
+      writeCubeHeader(ofil,wf.title[0],comm,nn,grd.xin,grd.dx,wf.nNuc,wf.atCharge,wf.R);
+   }
+   const int nsl=nn[1]*nn[2];
+   solreal *pv,*row;
+   alloc1DRealArray(string("pv"),nsl,pv);
+#if USEPROGRESSBAR
+   printProgressBar(0);
+#endif
+   for ( int i=0 ; i<nn[0] ; i++ ) {
+      solreal xx=x0[0]+solreal(i)*hh[0];
+#if PARALLELISEDTK
+#pragma omp parallel
+      {
+         GaussWaveFunction twf;
+         GaussWaveFunction *pwf=&wf;
+         if ( omp_get_thread_num()>0 ) {
+            twf.shareDataFrom(wf);
+            pwf=&twf;
+         }
+#pragma omp for schedule(dynamic,1)
+         for ( int j=0 ; j<nn[1] ; j++ ) {
+            solreal yy=x0[1]+solreal(j)*hh[1];
+            for ( int k=0 ; k<nn[2] ; k++ ) {
+               pv[j*nn[2]+k]=evalField(*pwf,ft,xx,yy,x0[2]+solreal(k)*hh[2]);
+            }
+         }
+      }
+#else
+      for ( int j=0 ; j<nn[1] ; j++ ) {
+         solreal yy=x0[1]+solreal(j)*hh[1];
+         for ( int k=0 ; k<nn[2] ; k++ ) {
+            pv[j*nn[2]+k]=evalField(wf,ft,xx,yy,x0[2]+solreal(k)*hh[2]);
+         }
+      }
+#endif
+      if ( cubnam!=NULL ) {
+         for ( int j=0 ; j<nn[1] ; j++ ) {
+            row=&pv[j*nn[2]];
+            writeCubeProp(ofil,nn[2],row);
+         }
+      }
+      addPlane(pv);
+#if USEPROGRESSBAR
+      printProgressBar(int(100.0e0*solreal(i)/solreal((nn[0]-1))));
+#endif
+   }
+#if USEPROGRESSBAR
+   printProgressBar(100);
+   cout << endl;
+#endif
+   if ( cubnam!=NULL ) {ofil.close();}
+   dealloc1DRealArray(pv);
+   endExtraction();
+   computeNormals(wf,ft);
+   return true;
+}
+/* ************************************************************************************ */
+bool isoSurface::extractFromCubeFile(string &cubnam,const solreal isov)
+{
+   ifstream ifil(cubnam.c_str());
+   if ( !ifil.good() ) {
+      displayErrorMessage(string("The file ")+cubnam+string(" could not be opened!"));
+      return false;
+   }
+   string line;
+   getline(ifil,line);
+   getline(ifil,line);
+   int nat,nn[3],nv=1;
+   solreal x0[3],hh[3],ax[3];
+   ifil >> nat >> x0[0] >> x0[1] >> x0[2];
+   getline(ifil,line);
+   bool isang=false;
+   for ( int k=0 ; k<3 ; k++ ) {
+      ifil >> nn[k] >> ax[0] >> ax[1] >> ax[2];
+      if ( nn[k]<0 ) {
+         nn[k]=-nn[k];
+         isang=true;
+      }
+      hh[k]=ax[k];
+      for ( int l=0 ; l<3 ; l++ ) {
+         if ( l!=k && ax[l]!=0.0e0 ) {
+            displayErrorMessage("Only cube files with orthogonal axes are supported!");
+            return false;
+         }
+      }
+   }
+   getline(ifil,line);
+   /* Cube files given in angstroms are converted into bohrs.  */
+   if ( isang ) {
+      for ( int k=0 ; k<3 ; k++ ) {
+         x0[k]/=0.52917720859e0;
+         hh[k]/=0.52917720859e0;
+      }
+   }
+   for ( int i=0 ; i<(nat<0? -nat : nat) ; i++ ) {getline(ifil,line);}
+   /* A negative number of atoms means that the next line lists the orbitals, and that
+      the file holds the values of every orbital at each point (the first one is used). */
+   if ( nat<0 ) {
+      ifil >> nv;
+      getline(ifil,line);
+      if ( nv<1 ) {nv=1;}
+   }
+   if ( !ifil.good() || !startExtraction(isov,nn,x0,hh) ) {
+      displayErrorMessage(string("Could not read the header of ")+cubnam);
+      return false;
+   }
+   const int nsl=nn[1]*nn[2];
+   solreal *pv,tv;
+   alloc1DRealArray(string("pv"),nsl,pv);
+   bool allread=true;
+   for ( int i=0 ; i<nn[0] && allread ; i++ ) {
+      for ( int m=0 ; m<nsl ; m++ ) {
+         ifil >> pv[m];
+         for ( int v=1 ; v<nv ; v++ ) {ifil >> tv;}
+      }
+      if ( ifil.fail() ) {
+         allread=false;
+         break;
+      }
+      addPlane(pv);
+   }
+   ifil.close();
+   dealloc1DRealArray(pv);
+   endExtraction();
+   if ( !allread ) {
+      displayWarningMessage(string("The cube file ")+cubnam+string(" is incomplete!"));
+   }
+   computeNormalsFromFaces();
+   return allread;
+}
+/* ************************************************************************************ */
+void isoSurface::computeNormals(GaussWaveFunction &wf,const ScalarFieldType ft)
+{
+#if PARALLELISEDTK
+#pragma omp parallel
+   {
+      GaussWaveFunction twf;
+      GaussWaveFunction *pwf=&wf;
+      if ( omp_get_thread_num()>0 ) {
+         twf.shareDataFrom(wf);
+         pwf=&twf;
+      }
+#else
+   {
+      GaussWaveFunction *pwf=&wf;
+#endif
+      solreal g[3],rho,fp,fm,xp[3],xm[3],gm;
+#if PARALLELISEDTK
+#pragma omp for schedule(dynamic,64)
+#endif
+      for ( int i=0 ; i<nVert ; i++ ) {
+         if ( ft==DENS ) {
+            pwf->evalRhoGradRho(vert[i][0],vert[i][1],vert[i][2],rho,g);
+         } else {
+            for ( int l=0 ; l<3 ; l++ ) {
+               for ( int m=0 ; m<3 ; m++ ) {xp[m]=xm[m]=vert[i][m];}
+               xp[l]+=ISOSURF_FDSTEP;
+               xm[l]-=ISOSURF_FDSTEP;
+               fp=evalField(*pwf,ft,xp[0],xp[1],xp[2]);
+               fm=evalField(*pwf,ft,xm[0],xm[1],xm[2]);
+               g[l]=(fp-fm)/(2.0e0*ISOSURF_FDSTEP);
+            }
+         }
+         gm=sqrt(g[0]*g[0]+g[1]*g[1]+g[2]*g[2]);
+         if ( gm>0.0e0 ) {
+            for ( int l=0 ; l<3 ; l++ ) {norm[i][l]=-g[l]/gm;}
+         } else {
+            for ( int l=0 ; l<3 ; l++ ) {norm[i][l]=0.0e0;}
+         }
+      }
+   }
+   /* The gradient may vanish at some vertices; they take the normals of the faces.  */
+   int nzero=0;
+   for ( int i=0 ; i<nVert ; i++ ) {
+      if ( norm[i][0]==0.0e0 && norm[i][1]==0.0e0 && norm[i][2]==0.0e0 ) {++nzero;}
+   }
+   if ( nzero>0 ) {computeNormalsFromFaces();}
+}
+/* ************************************************************************************ */
+void isoSurface::computeNormalsFromFaces(void)
+{
+   solreal **fn;
+   allocFlat2DRealArray(string("fn"),nVert,3,fn,0.0e0);
+   solreal u[3],v[3],n[3],nm;
+   int a,b,c;
+   for ( int t=0 ; t<nTri ; t++ ) {
+      a=tri[t][0];
+      b=tri[t][1];
+      c=tri[t][2];
+      for ( int l=0 ; l<3 ; l++ ) {
+         u[l]=vert[b][l]-vert[a][l];
+         v[l]=vert[c][l]-vert[a][l];
+      }
+      /* The cross product is twice the area times the unit normal.  */
+      n[0]=u[1]*v[2]-u[2]*v[1];
+      n[1]=u[2]*v[0]-u[0]*v[2];
+      n[2]=u[0]*v[1]-u[1]*v[0];
+      for ( int l=0 ; l<3 ; l++ ) {
+         fn[a][l]+=n[l];
+         fn[b][l]+=n[l];
+         fn[c][l]+=n[l];
+      }
+   }
+   for ( int i=0 ; i<nVert ; i++ ) {
+      if ( norm[i][0]!=0.0e0 || norm[i][1]!=0.0e0 || norm[i][2]!=0.0e0 ) {continue;}
+      nm=sqrt(fn[i][0]*fn[i][0]+fn[i][1]*fn[i][1]+fn[i][2]*fn[i][2]);
+      if ( nm>0.0e0 ) {
+         for ( int l=0 ; l<3 ; l++ ) {norm[i][l]=fn[i][l]/nm;}
+      }
+   }
+   deallocFlat2DRealArray(fn);
+}
+/* ************************************************************************************ */
+solreal isoSurface::getTriangleArea(const int t)
+{
+   solreal u[3],v[3],n[3];
+   const int a=tri[t][0],b=tri[t][1],c=tri[t][2];
+   for ( int l=0 ; l<3 ; l++ ) {
+      u[l]=vert[b][l]-vert[a][l];
+      v[l]=vert[c][l]-vert[a][l];
+   }
+   n[0]=u[1]*v[2]-u[2]*v[1];
+   n[1]=u[2]*v[0]-u[0]*v[2];
+   n[2]=u[0]*v[1]-u[1]*v[0];
+   return 0.5e0*sqrt(n[0]*n[0]+n[1]*n[1]+n[2]*n[2]);
+}
+/* ************************************************************************************ */
+solreal isoSurface::getArea(void)
+{
+   solreal area=0.0e0;
+   for ( int t=0 ; t<nTri ; t++ ) {area+=getTriangleArea(t);}
+   return area;
+}
+/* ************************************************************************************ */
+void isoSurface::evalFieldOnVertices(GaussWaveFunction &wf,const ScalarFieldType ft)
+{
+   dealloc1DRealArray(vProp);
+   alloc1DRealArray(string("vProp"),(nVert>0? nVert : 1),vProp);
+   vPropType=ft;
+#if PARALLELISEDTK
+#pragma omp parallel
+   {
+      GaussWaveFunction twf;
+      GaussWaveFunction *pwf=&wf;
+      if ( omp_get_thread_num()>0 ) {
+         twf.shareDataFrom(wf);
+         pwf=&twf;
+      }
+#pragma omp for schedule(dynamic,64)
+      for ( int i=0 ; i<nVert ; i++ ) {
+         vProp[i]=evalField(*pwf,ft,vert[i][0],vert[i][1],vert[i][2]);
+      }
+   }
+#else
+   for ( int i=0 ; i<nVert ; i++ ) {
+      vProp[i]=evalField(wf,ft,vert[i][0],vert[i][1],vert[i][2]);
+   }
+#endif
+}
+/* ************************************************************************************ */
+solreal isoSurface::getColorRange(void)
+{
+   if ( colRange>0.0e0 ) {return colRange;}
+   solreal rng=0.0e0;
+   for ( int i=0 ; i<nVert ; i++ ) {
+      if ( fabs(vProp[i])>rng ) {rng=fabs(vProp[i]);}
+   }
+   return ((rng>0.0e0)? rng : 1.0e0);
+}
+/* ************************************************************************************ */
+void isoSurface::getVertexColor(const int i,const solreal rng,solreal (&rgb)[3])
+{
+   solreal t=vProp[i]/rng;
+   if ( t>1.0e0 ) {t=1.0e0;}
+   if ( t<-1.0e0 ) {t=-1.0e0;}
+   if ( t<0.0e0 ) {
+      rgb[0]=1.0e0;
+      rgb[1]=rgb[2]=1.0e0+t;
+   } else {
+      rgb[0]=rgb[1]=1.0e0-t;
+      rgb[2]=1.0e0;
+   }
+}
+/* ************************************************************************************ */
+void isoSurface::printVertexPropStats(ostream &os)
+{
+   if ( vProp==NULL || nTri<1 ) {
+      displayWarningMessage("There is no field evaluated on the surface!");
+      return;
+   }
+   int imin=0,imax=0;
+   for ( int i=1 ; i<nVert ; i++ ) {
+      if ( vProp[i]<vProp[imin] ) {imin=i;}
+      if ( vProp[i]>vProp[imax] ) {imax=i;}
+   }
+   /* Every triangle takes the average of the field at its vertices.  */
+   solreal at,vt,atot=0.0e0,apos=0.0e0,aneg=0.0e0,vavg=0.0e0,vpos=0.0e0,vneg=0.0e0;
+   for ( int t=0 ; t<nTri ; t++ ) {
+      at=getTriangleArea(t);
+      vt=(vProp[tri[t][0]]+vProp[tri[t][1]]+vProp[tri[t][2]])/3.0e0;
+      atot+=at;
+      vavg+=at*vt;
+      if ( vt>0.0e0 ) {
+         apos+=at;
+         vpos+=at*vt;
+      } else if ( vt<0.0e0 ) {
+         aneg+=at;
+         vneg+=at*vt;
+      }
+   }
+   vavg/=atot;
+   if ( apos>0.0e0 ) {vpos/=apos;}
+   if ( aneg>0.0e0 ) {vneg/=aneg;}
+   solreal s2pos=0.0e0,s2neg=0.0e0,pidev=0.0e0;
+   for ( int t=0 ; t<nTri ; t++ ) {
+      at=getTriangleArea(t);
+      vt=(vProp[tri[t][0]]+vProp[tri[t][1]]+vProp[tri[t][2]])/3.0e0;
+      pidev+=at*fabs(vt-vavg);
+      if ( vt>0.0e0 ) {
+         s2pos+=at*(vt-vpos)*(vt-vpos);
+      } else if ( vt<0.0e0 ) {
+         s2neg+=at*(vt-vneg)*(vt-vneg);
+      }
+   }
+   if ( apos>0.0e0 ) {s2pos/=apos;}
+   if ( aneg>0.0e0 ) {s2neg/=aneg;}
+   pidev/=atot;
+   solreal s2tot=s2pos+s2neg;
+   solreal nu=((s2tot>0.0e0)? (s2pos*s2neg/(s2tot*s2tot)) : 0.0e0);
+   /* 1 hartree = 627.5095 kcal/mol  */
+   const solreal h2k=627.5095e0;
+   string fnam=getFieldTypeKeyLong(convertScalarFieldType2Char(vPropType));
+   os << "Surface statistics of " << fnam << " (isovalue: " << isoVal << ")" << endl;
+   os << "  Vertices: " << nVert << ", triangles: " << nTri << endl;
+   os << scientific << setprecision(6);
+   os << "                      a.u.             kcal/mol" << endl;
+   os << "  Vmin:      " << setw(16) << vProp[imin] << " " << setw(16) << (h2k*vProp[imin])
+      << "  at (" << vert[imin][0] << ", " << vert[imin][1] << ", " << vert[imin][2]
+      << ")" << endl;
+   os << "  Vmax:      " << setw(16) << vProp[imax] << " " << setw(16) << (h2k*vProp[imax])
+      << "  at (" << vert[imax][0] << ", " << vert[imax][1] << ", " << vert[imax][2]
+      << ")" << endl;
+   os << "  <V>:       " << setw(16) << vavg << " " << setw(16) << (h2k*vavg) << endl;
+   os << "  <V+>:      " << setw(16) << vpos << " " << setw(16) << (h2k*vpos) << endl;
+   os << "  <V->:      " << setw(16) << vneg << " " << setw(16) << (h2k*vneg) << endl;
+   os << "  Pi:        " << setw(16) << pidev << " " << setw(16) << (h2k*pidev) << endl;
+   os << "  sigma2+:   " << setw(16) << s2pos << " " << setw(16) << (h2k*h2k*s2pos)
+      << endl;
+   os << "  sigma2-:   " << setw(16) << s2neg << " " << setw(16) << (h2k*h2k*s2neg)
+      << endl;
+   os << "  sigma2tot: " << setw(16) << s2tot << " " << setw(16) << (h2k*h2k*s2tot)
+      << endl;
+   os << "  nu:        " << setw(16) << nu << endl;
+   os << "  Area (bohr^2), total: " << atot << ", positive: " << apos << ", negative: "
+      << aneg << endl;
+   os.unsetf(std::ios::floatfield);
+}
+/* ************************************************************************************ */
+bool isoSurface::writeOBJFile(string &onam)
+{
+   ofstream ofil(onam.c_str());
+   if ( !ofil.good() ) {
+      displayErrorMessage(string("The file ")+onam+string(" could not be opened!"));
+      return false;
+   }
+   ofil << "# Isosurface (isovalue: " << isoVal << ")" << endl;
+   ofil << "# Vertices: " << nVert << ", triangles: " << nTri << endl;
+   /* The colors (if any) follow the coordinates, as r g b in [0,1].  */
+   solreal rgb[3],rng=((vProp!=NULL)? getColorRange() : 1.0e0);
+   for ( int i=0 ; i<nVert ; i++ ) {
+      ofil << scientific << setprecision(8);
+      ofil << "v " << vert[i][0] << " " << vert[i][1] << " " << vert[i][2];
+      if ( vProp!=NULL ) {
+         getVertexColor(i,rng,rgb);
+         ofil << fixed << setprecision(4);
+         ofil << " " << rgb[0] << " " << rgb[1] << " " << rgb[2];
+      }
+      ofil << '\n';
+   }
+   ofil << scientific;
+   ofil << setprecision(5);
+   for ( int i=0 ; i<nVert ; i++ ) {
+      ofil << "vn " << norm[i][0] << " " << norm[i][1] << " " << norm[i][2] << '\n';
+   }
+   for ( int t=0 ; t<nTri ; t++ ) {
+      ofil << "f";
+      for ( int l=0 ; l<3 ; l++ ) {ofil << " " << (tri[t][l]+1) << "//" << (tri[t][l]+1);}
+      ofil << '\n';
+   }
+   ofil.close();
+   return true;
+}
+/* ************************************************************************************ */
+bool isoSurface::writePLYFile(string &onam)
+{
+   ofstream ofil(onam.c_str());
+   if ( !ofil.good() ) {
+      displayErrorMessage(string("The file ")+onam+string(" could not be opened!"));
+      return false;
+   }
+   ofil << "ply" << endl << "format ascii 1.0" << endl;
+   ofil << "comment Isosurface (isovalue: " << isoVal << ")" << endl;
+   ofil << "element vertex " << nVert << endl;
+   ofil << "property float x" << endl << "property float y" << endl
+        << "property float z" << endl;
+   ofil << "property float nx" << endl << "property float ny" << endl
+        << "property float nz" << endl;
+   if ( vProp!=NULL ) {
+      ofil << "property uchar red" << endl << "property uchar green" << endl
+           << "property uchar blue" << endl;
+      ofil << "property float value" << endl;
+   }
+   ofil << "element face " << nTri << endl;
+   ofil << "property list uchar int vertex_indices" << endl;
+   ofil << "end_header" << endl;
+   ofil << scientific << setprecision(8);
+   solreal rgb[3],rng=((vProp!=NULL)? getColorRange() : 1.0e0);
+   for ( int i=0 ; i<nVert ; i++ ) {
+      ofil << vert[i][0] << " " << vert[i][1] << " " << vert[i][2] << " "
+           << norm[i][0] << " " << norm[i][1] << " " << norm[i][2];
+      if ( vProp!=NULL ) {
+         getVertexColor(i,rng,rgb);
+         for ( int l=0 ; l<3 ; l++ ) {ofil << " " << int(255.0e0*rgb[l]+0.5e0);}
+         ofil << " " << vProp[i];
+      }
+      ofil << '\n';
+   }
+   for ( int t=0 ; t<nTri ; t++ ) {
+      ofil << "3 " << tri[t][0] << " " << tri[t][1] << " " << tri[t][2] << '\n';
+   }
+   ofil.close();
+   return true;
+}
+/* ************************************************************************************ */
+bool isoSurface::writePOVMesh2File(string &onam,const string &decnam)
+{
+   ofstream ofil(onam.c_str());
+   if ( !ofil.good() ) {
+      displayErrorMessage(string("The file ")+onam+string(" could not be opened!"));
+      return false;
+   }
+   ofil << "// Isosurface (isovalue: " << isoVal << "), " << nVert << " vertices, "
+        << nTri << " triangles." << endl;
+   ofil << "#declare " << decnam << " = mesh2 {" << endl;
+   ofil << scientific << setprecision(8);
+   ofil << "  vertex_vectors { " << nVert;
+   for ( int i=0 ; i<nVert ; i++ ) {
+      ofil << ",\n    <" << vert[i][0] << "," << vert[i][1] << "," << vert[i][2] << ">";
+   }
+   ofil << "\n  }" << endl;
+   ofil << setprecision(5);
+   ofil << "  normal_vectors { " << nVert;
+   for ( int i=0 ; i<nVert ; i++ ) {
+      ofil << ",\n    <" << norm[i][0] << "," << norm[i][1] << "," << norm[i][2] << ">";
+   }
+   ofil << "\n  }" << endl;
+   /* With a field on the vertices, every vertex has its own texture, and the colors
+      are interpolated over the triangles.  */
+   if ( vProp!=NULL ) {
+      solreal rgb[3],rng=getColorRange();
+      ofil << fixed << setprecision(4);
+      ofil << "  texture_list { " << nVert;
+      for ( int i=0 ; i<nVert ; i++ ) {
+         getVertexColor(i,rng,rgb);
+         ofil << ",\n    texture{pigment{rgb <" << rgb[0] << "," << rgb[1] << ","
+              << rgb[2] << ">}}";
+      }
+      ofil << "\n  }" << endl;
+   }
+   ofil << "  face_indices { " << nTri;
+   for ( int t=0 ; t<nTri ; t++ ) {
+      ofil << ",\n    <" << tri[t][0] << "," << tri[t][1] << "," << tri[t][2] << ">";
+      if ( vProp!=NULL ) {
+         ofil << "," << tri[t][0] << "," << tri[t][1] << "," << tri[t][2];
+      }
+   }
+   ofil << "\n  }" << endl;
+   ofil << "}" << endl;
+   ofil.close();
+   return true;
+}
+/* ************************************************************************************ */
+
+#endif//_ISOSURFACE_CPP_
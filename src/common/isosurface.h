@@ -0,0 +1,185 @@
+/*
+ *                    This source code is part of
+ *
+ *                  D  E  N  S  T  O  O  L  K  I  T
+ *
+ *                         VERSION: 1.2.0
+ *
+ *             Contributors: Juan Manuel Solano-Altamirano
+ *                           Julio Manuel Hernandez-Perez
+ *        Copyright (c) 2013-2015, Juan Manuel Solano-Altamirano
+ *                                 <jmsolanoalt@gmail.com>
+ *
+ * -------------------------------------------------------------------
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * ---------------------------------------------------------------------
+ *
+ * If you want to redistribute modifications of the suite, please
+ * consider to include your modifications in our official release.
+ * We will be pleased to consider the inclusion of your code
+ * within the official distribution. Please keep in mind that
+ * scientific software is very special, and version control is 
+ * crucial for tracing bugs. If in despite of this you distribute
+ * your modified version, please do not call it DensToolKit.
+ *
+ * If you find DensToolKit useful, we humbly ask that you cite
+ * the paper(s) on the package --- you can find them on the top
+ * README file.
+ *
+ */
+
+
+/*
+   isosurface.h
+
+   The class isoSurface extracts (triangulated) isosurfaces of scalar fields sampled on
+   uniform orthogonal grids. The grid is given plane by plane (planes of constant x),
+   and every slab between two consecutive planes is polygonised as soon as its second
+   plane arrives; thus, the memory needed is two planes plus the surface itself, and
+   the surface can be extracted while the grid is being computed (see
+   extractFromWaveFunction) or read (see extractFromCubeFile). Every cube of the grid
+   is split into six tetrahedra sharing the main diagonal of the cube (marching
+   tetrahedra), which gives a surface without cracks or ambiguous cases. The vertices
+   lie on the edges of the tetrahedra, and the vertices of edges shared by several
+   tetrahedra (or cubes) are welded together. The triangles are oriented towards the
+   region where the field is lower than the isovalue, and the normals can be taken
+   from the gradient of the field (computeNormals) or from the triangles
+   (computeNormalsFromFaces). A second field (e.g. the MEP on a density isosurface) can
+   be evaluated at the vertices only (evalFieldOnVertices); the surface is then written
+   colored by that field, and its surface statistics can be printed.
+ */
+
+#ifndef _ISOSURFACE_H_
+#define _ISOSURFACE_H_
+
+#ifndef _HAVE_DEF_SOLREAL_TYPE_
+#define _HAVE_DEF_SOLREAL_TYPE_
+typedef double solreal;
+#endif
+
+#include "gausswavefunction.h"
+#include "wfgrid3d.h"
+#include "fldtypesdef.h"
+#include <string>
+using std::string;
+#include <ostream>
+using std::ostream;
+
+#ifndef ISOSURF_INITCAPACITY
+#define ISOSURF_INITCAPACITY (4096)
+#endif
+/* The step of the finite differences used for the normals of the fields that lack an
+   analytic gradient.  */
+#ifndef ISOSURF_FDSTEP
+#define ISOSURF_FDSTEP (1.0e-04)
+#endif
+
+/* ************************************************************************************ */
+class isoSurface {
+/* ************************************************************************************ */
+public:
+/* ************************************************************************************ */
+   isoSurface();
+   ~isoSurface();
+/* ************************************************************************************ */
+   int nVert; /*!< The number of vertices.  */
+   int nTri; /*!< The number of triangles.  */
+   solreal **vert; /*!< The vertices, vert[i][0..2].  */
+   solreal **norm; /*!< The (unit) normals at the vertices.  */
+   int **tri; /*!< The triangles, tri[i][0..2] are indices to vert.  */
+   solreal *vProp; /*!< The field evaluated at the vertices (NULL if not evaluated).  */
+/* ************************************************************************************ */
+   /** Starts the extraction of the isosurface isov from a grid whose origin is x0, with
+    * spacings hh and nn points. Any previous surface is removed.  */
+   bool startExtraction(const solreal isov,const int (&nn)[3],solreal const (&x0)[3],\
+         solreal const (&hh)[3]);
+   /** Adds the next plane (of constant x) of the grid; pv[j*nn[2]+k] is the field at the
+    * point (j,k) of the plane. The slab between this plane and the previous one is
+    * polygonised.  */
+   void addPlane(const solreal *pv);
+   /** Ends the extraction (the memory of the planes is released).  */
+   void endExtraction(void);
+/* ************************************************************************************ */
+   /** Evaluates the field ft on the (orthogonal) grid grd, plane by plane, and extracts
+    * the isosurface isov on the fly. If cubnam is not NULL, the grid is also written
+    * into the cube file *cubnam. The normals are computed with computeNormals.  */
+   bool extractFromWaveFunction(waveFunctionGrid3D &grd,GaussWaveFunction &wf,\
+         const ScalarFieldType ft,const solreal isov,string *cubnam);
+   /** Reads the (orthogonal) cube file cubnam plane by plane, and extracts the
+    * isosurface isov. The normals are computed with computeNormalsFromFaces.  */
+   bool extractFromCubeFile(string &cubnam,const solreal isov);
+/* ************************************************************************************ */
+   /** Sets the normals to -grad(f)/|grad(f)|, where f is the field ft (the gradient is
+    * analytic for the density, and computed by finite differences for the other
+    * fields).  */
+   void computeNormals(GaussWaveFunction &wf,const ScalarFieldType ft);
+   /** Sets the normals to the (area weighted) average of the normals of the triangles
+    * that share each vertex.  */
+   void computeNormalsFromFaces(void);
+/* ************************************************************************************ */
+   /** Evaluates the field ft at the vertices (in vProp). Once evaluated, the surface is
+    * written colored by this field: red for negative values, white for zero and blue for
+    * positive values, saturated at the range given with setColorRange (by default, the
+    * largest absolute value of the field over the surface).  */
+   void evalFieldOnVertices(GaussWaveFunction &wf,const ScalarFieldType ft);
+   void setColorRange(const solreal rng) {colRange=rng;}
+   /** Prints the statistics of vProp over the surface: the extrema, the positive and
+    * negative areas and averages, the variances, the balance parameter and the average
+    * deviation (the averages are weighted by the areas of the triangles).  */
+   void printVertexPropStats(ostream &os);
+/* ************************************************************************************ */
+   solreal getIsoValue(void) {return isoVal;}
+   solreal getArea(void);
+/* ************************************************************************************ */
+   /** Writes the surface into the Wavefront obj file onam.  */
+   bool writeOBJFile(string &onam);
+   /** Writes the surface into the (ascii) PLY file onam.  */
+   bool writePLYFile(string &onam);
+   /** Writes the surface as a POV-Ray mesh2 object, declared as decnam, into the file
+    * onam (to be included into a POV-Ray scene, see povRayConfProp::setIncludedObject).  */
+   bool writePOVMesh2File(string &onam,const string &decnam);
+/* ************************************************************************************ */
+protected:
+/* ************************************************************************************ */
+   solreal isoVal,xin[3],dx[3],colRange;
+   ScalarFieldType vPropType;
+   int npts[3],nPlanes,capVert,capTri;
+   solreal *valA,*valB; /*!< The field at the lower and upper planes of the slab.  */
+   /** The vertices of the edges of the slab (-1 if not created yet): inA and inB hold
+    * the edges lying within the lower and upper planes (three per point: y, z and yz),
+    * and crs the edges that cross the slab (four per point: x, xy, xz and xyz).  */
+   int *inA,*inB,*crs;
+/* ************************************************************************************ */
+   void destroyPlanes(void);
+   /** Returns the field ft at (x,y,z); the density is evaluated directly, without the
+    * terms that evalMultipleFields shares among the fields.  */
+   solreal evalField(GaussWaveFunction &wf,const ScalarFieldType ft,const solreal x,\
+         const solreal y,const solreal z);
+   void polygonizeSlab(void);
+   void polygonizeTet(const int j,const int k,const int (&c)[4],solreal const (&val)[8]);
+   int getEdgeVertex(const int j,const int k,const int cu,const int cv,\
+         solreal const (&val)[8]);
+   void getCornerCoords(const int j,const int k,const int c,solreal (&x)[3]);
+   int addVertex(solreal const (&x)[3]);
+   solreal getTriangleArea(const int t);
+   solreal getColorRange(void);
+   void getVertexColor(const int i,const solreal rng,solreal (&rgb)[3]);
+   void addTriangle(const int a,const int b,const int c,solreal const (&dir)[3]);
+/* ************************************************************************************ */
+};
+/* ************************************************************************************ */
+
+#endif//_ISOSURFACE_H_
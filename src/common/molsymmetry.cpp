@@ -0,0 +1,447 @@
+/*
+ *                    This source code is part of
+ *
+ *                  D  E  N  S  T  O  O  L  K  I  T
+ *
+ *                         VERSION: 1.2.0
+ *
+ *             Contributors: Juan Manuel Solano-Altamirano
+ *                           Julio Manuel Hernandez-Perez
+ *        Copyright (c) 2013-2015, Juan Manuel Solano-Altamirano
+ *                                 <jmsolanoalt@gmail.com>
+ *
+ * -------------------------------------------------------------------
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * ---------------------------------------------------------------------
+ *
+ * If you want to redistribute modifications of the suite, please
+ * consider to include your modifications in our official release.
+ * We will be pleased to consider the inclusion of your code
+ * within the official distribution. Please keep in mind that
+ * scientific software is very special, and version control is 
+ * crucial for tracing bugs. If in despite of this you distribute
+ * your modified version, please do not call it DensToolKit.
+ *
+ * If you find DensToolKit useful, we humbly ask that you cite
+ * the paper(s) on the package --- you can find them on the top
+ * README file.
+ *
+ */
+
+
+#ifndef _MOLSYMMETRY_CPP_
+#define _MOLSYMMETRY_CPP_
+
+#include "molsymmetry.h"
+#include "solmemhand.h"
+#include "solscrutils.h"
+#include "eig2-4.h"
+#include "solmath.h"
+#include <cmath>
+
+#if PARALLELISEDTK
+#include <omp.h>
+#endif
+
+/* ************************************************************************************ */
+molSymmetry::molSymmetry()
+{
+   nOps=1;
+   distTol=MOLSYMM_DISTTOL;
+   for ( int k=0 ; k<3 ; k++ ) {
+      cen[k]=0.0e0;
+      for ( int l=0 ; l<3 ; l++ ) {frm[k][l]=op[0][k][l]=((k==l)? 1.0e0 : 0.0e0);}
+   }
+}
+/* ************************************************************************************ */
+bool molSymmetry::setUp(bondNetWork &bn)
+{
+   return setUp(bn.nNuc,bn.R,bn.atNum);
+}
+/* ************************************************************************************ */
+bool molSymmetry::setUp(GaussWaveFunction &wf)
+{
+   solreal **rr;
+   allocFlat2DRealArray(string("rr"),((wf.nNuc>0)? wf.nNuc : 1),3,rr);
+   for ( int i=0 ; i<wf.nNuc ; i++ ) {
+      for ( int k=0 ; k<3 ; k++ ) {rr[i][k]=wf.R[3*i+k];}
+   }
+   bool res=setUp(wf.nNuc,rr,wf.atNum);
+   deallocFlat2DRealArray(rr);
+   return res;
+}
+bool molSymmetry::setUp(const int nn,solreal ** const rr,const int *an)
+{
+   nOps=1;
+   if ( nn<1 ) {
+      displayErrorMessage("There are no nuclei to look for the symmetry!");
+      return false;
+   }
+   /* The symmetry elements cross at the center of the nuclear charge.  */
+   solreal zz,ztot=0.0e0;
+   for ( int k=0 ; k<3 ; k++ ) {cen[k]=0.0e0;}
+   for ( int i=0 ; i<nn ; i++ ) {
+      zz=((an[i]>=0)? solreal(an[i]+1) : 1.0e0);
+      for ( int k=0 ; k<3 ; k++ ) {cen[k]+=zz*rr[i][k];}
+      ztot+=zz;
+   }
+   for ( int k=0 ; k<3 ; k++ ) {cen[k]/=ztot;}
+   /* The principal axes of the nuclear charge.  */
+   solreal tt[3][3],vv[3][3],dd[3],r[3],r2;
+   for ( int k=0 ; k<3 ; k++ ) {for ( int l=0 ; l<3 ; l++ ) {tt[k][l]=0.0e0;}}
+   for ( int i=0 ; i<nn ; i++ ) {
+      zz=((an[i]>=0)? solreal(an[i]+1) : 1.0e0);
+      r2=0.0e0;
+      for ( int k=0 ; k<3 ; k++ ) {
+         r[k]=rr[i][k]-cen[k];
+         r2+=r[k]*r[k];
+      }
+      for ( int k=0 ; k<3 ; k++ ) {
+         for ( int l=0 ; l<3 ; l++ ) {tt[k][l]+=zz*(((k==l)? r2 : 0.0e0)-r[k]*r[l]);}
+      }
+   }
+   eigen_decomposition3(tt,vv,dd);
+   solreal ff[3][3],best[3][3];
+   int nbest,ncur;
+   /* The laboratory frame is tried first, so that it is kept when it is as good as the
+      others (e.g. for molecules in the standard orientation).  */
+   for ( int k=0 ; k<3 ; k++ ) {for ( int l=0 ; l<3 ; l++ ) {best[k][l]=frm[k][l];}}
+   nbest=findFrameOperations(nn,rr,an,best,false);
+   for ( int k=0 ; k<3 ; k++ ) {for ( int l=0 ; l<3 ; l++ ) {ff[k][l]=vv[l][k];}}
+   ncur=findFrameOperations(nn,rr,an,ff,false);
+   if ( ncur>nbest ) {
+      nbest=ncur;
+      for ( int k=0 ; k<3 ; k++ ) {for ( int l=0 ; l<3 ; l++ ) {best[k][l]=ff[k][l];}}
+   }
+   solreal dtol=1.0e-02*(fabs(dd[0])+fabs(dd[1])+fabs(dd[2]))+1.0e-08;
+   const bool deg01=(fabs(dd[1]-dd[0])<dtol),deg12=(fabs(dd[2]-dd[1])<dtol);
+   if ( deg01||deg12 ) {
+      /* Degenerate axes: the frames are built from the directions of the atoms, and
+         from the midpoints of pairs of equivalent atoms (same atomic number and same
+         distance to the center).  */
+      solreal cd[MOLSYMM_MAXCANDIDATES][3],u[3],v[3],ri,rj;
+      int nd=0,ua=(deg01? 2 : 0);
+      const bool symtop=(deg01!=deg12);
+      for ( int k=0 ; k<3 ; k++ ) {u[k]=vv[k][ua];}
+      for ( int pass=0 ; pass<2 ; pass++ ) {
+         for ( int i=0 ; i<nn ; i++ ) {
+            ri=0.0e0;
+            for ( int k=0 ; k<3 ; k++ ) {ri+=(rr[i][k]-cen[k])*(rr[i][k]-cen[k]);}
+            for ( int j=((pass==0)? (i+1) : i) ; j<((pass==0)? nn : (i+1)) ; j++ ) {
+               if ( an[i]!=an[j] ) {continue;}
+               rj=0.0e0;
+               for ( int k=0 ; k<3 ; k++ ) {rj+=(rr[j][k]-cen[k])*(rr[j][k]-cen[k]);}
+               if ( fabs(sqrt(ri)-sqrt(rj))>distTol ) {continue;}
+               for ( int k=0 ; k<3 ; k++ ) {v[k]=0.5e0*(rr[i][k]+rr[j][k])-cen[k];}
+               if ( symtop ) {
+                  r2=v[0]*u[0]+v[1]*u[1]+v[2]*u[2];
+                  for ( int k=0 ; k<3 ; k++ ) {v[k]-=r2*u[k];}
+               }
+               addCandidateDirection(v,cd,nd);
+            }
+         }
+      }
+      for ( int a=0 ; a<nd ; a++ ) {
+         for ( int b=(symtop? a : 0) ; b<(symtop? (a+1) : a) ; b++ ) {
+            /* Symmetric tops: the frame is (cd[a],u x cd[a],u). Spherical tops: the
+               frame is made out of two (almost) orthogonal directions.  */
+            for ( int k=0 ; k<3 ; k++ ) {ff[0][k]=cd[a][k];}
+            if ( symtop ) {
+               for ( int k=0 ; k<3 ; k++ ) {ff[2][k]=u[k];}
+               crossProductV3(ff[2],ff[0],ff[1]);
+            } else {
+               r2=cd[a][0]*cd[b][0]+cd[a][1]*cd[b][1]+cd[a][2]*cd[b][2];
+               if ( fabs(r2)>MOLSYMM_ANGTOL ) {continue;}
+               for ( int k=0 ; k<3 ; k++ ) {ff[1][k]=cd[b][k]-r2*cd[a][k];}
+               normalizeV3(ff[1]);
+               crossProductV3(ff[0],ff[1],ff[2]);
+            }
+            ncur=findFrameOperations(nn,rr,an,ff,false);
+            if ( ncur>nbest ) {
+               nbest=ncur;
+               for ( int k=0 ; k<3 ; k++ ) {for ( int l=0 ; l<3 ; l++ ) {best[k][l]=ff[k][l];}}
+            }
+         }
+      }
+   }
+   for ( int k=0 ; k<3 ; k++ ) {for ( int l=0 ; l<3 ; l++ ) {frm[k][l]=best[k][l];}}
+   nOps=findFrameOperations(nn,rr,an,frm,true);
+   return true;
+}
+/* ************************************************************************************ */
+void molSymmetry::addCandidateDirection(solreal (&v)[3],\
+      solreal (&dd)[MOLSYMM_MAXCANDIDATES][3],int &nd)
+{
+   if ( nd>=MOLSYMM_MAXCANDIDATES ) {return;}
+   solreal vm=sqrt(v[0]*v[0]+v[1]*v[1]+v[2]*v[2]);
+   if ( vm<distTol ) {return;}
+   for ( int k=0 ; k<3 ; k++ ) {v[k]/=vm;}
+   for ( int d=0 ; d<nd ; d++ ) {
+      vm=v[0]*dd[d][0]+v[1]*dd[d][1]+v[2]*dd[d][2];
+      if ( fabs(vm)>(1.0e0-MOLSYMM_ANGTOL*MOLSYMM_ANGTOL) ) {return;}
+   }
+   for ( int k=0 ; k<3 ; k++ ) {dd[nd][k]=v[k];}
+   ++nd;
+}
+/* ************************************************************************************ */
+bool molSymmetry::isSymmetryOperation(const int nn,solreal ** const rr,const int *an,\
+      solreal const (&mm)[3][3])
+{
+   const solreal tol2=distTol*distTol;
+   solreal y[3],d2;
+   bool found;
+   for ( int i=0 ; i<nn ; i++ ) {
+      for ( int k=0 ; k<3 ; k++ ) {
+         y[k]=cen[k];
+         for ( int l=0 ; l<3 ; l++ ) {y[k]+=mm[k][l]*(rr[i][l]-cen[l]);}
+      }
+      found=false;
+      for ( int j=0 ; j<nn ; j++ ) {
+         if ( an[j]!=an[i] ) {continue;}
+         d2=(y[0]-rr[j][0])*(y[0]-rr[j][0])+(y[1]-rr[j][1])*(y[1]-rr[j][1])\
+            +(y[2]-rr[j][2])*(y[2]-rr[j][2]);
+         if ( d2<tol2 ) {
+            found=true;
+            break;
+         }
+      }
+      if ( !found ) {return false;}
+   }
+   return true;
+}
+/* ************************************************************************************ */
+int molSymmetry::findFrameOperations(const int nn,solreal ** const rr,const int *an,\
+      solreal const (&ff)[3][3],const bool keep)
+{
+   static const int perm[6][3]={{0,1,2},{1,2,0},{2,0,1},{0,2,1},{2,1,0},{1,0,2}};
+   solreal mm[3][3];
+   int no=0;
+   for ( int p=0 ; p<6 ; p++ ) {
+      for ( int s=0 ; s<8 ; s++ ) {
+         /* In the frame, the operation maps the axis perm[p][k] onto the axis k
+            (reversed if the k-th bit of s is set); in the laboratory frame it is
+            ff^T*P*ff.  */
+         for ( int a=0 ; a<3 ; a++ ) {
+            for ( int b=0 ; b<3 ; b++ ) {
+               mm[a][b]=0.0e0;
+               for ( int k=0 ; k<3 ; k++ ) {
+                  mm[a][b]+=ff[k][a]*((s&(1<<k))? -1.0e0 : 1.0e0)*ff[perm[p][k]][b];
+               }
+            }
+         }
+         if ( !isSymmetryOperation(nn,rr,an,mm) ) {continue;}
+         if ( keep ) {
+            for ( int a=0 ; a<3 ; a++ ) {for ( int b=0 ; b<3 ; b++ ) {op[no][a][b]=mm[a][b];}}
+         }
+         ++no;
+      }
+   }
+   return no;
+}
+/* ************************************************************************************ */
+void molSymmetry::setUpMomentumSpace(void)
+{
+   for ( int k=0 ; k<3 ; k++ ) {cen[k]=0.0e0;}
+   const int no=nOps;
+   bool found;
+   solreal d;
+   for ( int o=0 ; o<no ; o++ ) {
+      found=false;
+      for ( int q=0 ; q<nOps && !found ; q++ ) {
+         d=0.0e0;
+         for ( int a=0 ; a<3 ; a++ ) {
+            for ( int b=0 ; b<3 ; b++ ) {d+=fabs(op[q][a][b]+op[o][a][b]);}
+         }
+         found=(d<1.0e-06);
+      }
+      if ( found || nOps>=MOLSYMM_MAXOPS ) {continue;}
+      for ( int a=0 ; a<3 ; a++ ) {for ( int b=0 ; b<3 ; b++ ) {op[nOps][a][b]=-op[o][a][b];}}
+      ++nOps;
+   }
+}
+/* ************************************************************************************ */
+bool molSymmetry::checkWaveFunction(GaussWaveFunction &wf)
+{
+   static const solreal off[4][3]={{0.37e0,0.61e0,0.83e0},{1.13e0,-0.29e0,0.47e0},\
+      {-0.71e0,1.23e0,-1.31e0},{1.91e0,1.57e0,-0.53e0}};
+   solreal x[3],y[3],rx,ry;
+   bool allok=true,isok;
+   int no=1;
+   for ( int o=1 ; o<nOps ; o++ ) {
+      isok=true;
+      for ( int t=0 ; t<4 && isok ; t++ ) {
+         for ( int k=0 ; k<3 ; k++ ) {x[k]=cen[k]+off[t][k];}
+         for ( int k=0 ; k<3 ; k++ ) {
+            y[k]=cen[k];
+            for ( int l=0 ; l<3 ; l++ ) {y[k]+=op[o][k][l]*off[t][l];}
+         }
+         rx=wf.evalDensity(x[0],x[1],x[2]);
+         ry=wf.evalDensity(y[0],y[1],y[2]);
+         isok=(fabs(rx-ry)<=(MOLSYMM_RHOTOL*(fabs(rx)+1.0e-10)));
+      }
+      if ( !isok ) {
+         allok=false;
+         continue;
+      }
+      if ( no<o ) {
+         for ( int a=0 ; a<3 ; a++ ) {for ( int b=0 ; b<3 ; b++ ) {op[no][a][b]=op[o][a][b];}}
+      }
+      ++no;
+   }
+   nOps=no;
+   return allok;
+}
+/* ************************************************************************************ */
+string molSymmetry::getPointGroupName(void)
+{
+   int nc2=0,nc3=0,nc4=0,nsg=0,ns4=0,ns6=0;
+   bool inv=false;
+   solreal det,tr;
+   for ( int o=0 ; o<nOps ; o++ ) {
+      det=op[o][0][0]*(op[o][1][1]*op[o][2][2]-op[o][1][2]*op[o][2][1])\
+         -op[o][0][1]*(op[o][1][0]*op[o][2][2]-op[o][1][2]*op[o][2][0])\
+         +op[o][0][2]*(op[o][1][0]*op[o][2][1]-op[o][1][1]*op[o][2][0]);
+      tr=op[o][0][0]+op[o][1][1]+op[o][2][2];
+      if ( det>0.0e0 ) {
+         if ( fabs(tr+1.0e0)<1.0e-03 ) {++nc2;}
+         if ( fabs(tr)<1.0e-03 ) {++nc3;}
+         if ( fabs(tr-1.0e0)<1.0e-03 ) {++nc4;}
+      } else {
+         if ( fabs(tr+3.0e0)<1.0e-03 ) {inv=true;}
+         if ( fabs(tr-1.0e0)<1.0e-03 ) {++nsg;}
+         if ( fabs(tr+1.0e0)<1.0e-03 ) {++ns4;}
+         if ( fabs(tr)<1.0e-03 ) {++ns6;}
+      }
+   }
+   switch ( nOps ) {
+      case 48 :
+         return string("Oh");
+      case 24 :
+         if ( inv ) {return string("Th");}
+         return ((nc4>0)? string("O") : string("Td"));
+      case 16 :
+         return string("D4h");
+      case 12 :
+         return ((nc3==8)? string("T") : string("D3d"));
+      case 8 :
+         if ( inv ) {return ((nc4>0)? string("C4h") : string("D2h"));}
+         if ( nc4>0 ) {return ((nsg>0)? string("C4v") : string("D4"));}
+         return string("D2d");
+      case 6 :
+         if ( inv ) {return string("S6");}
+         return ((nsg>0)? string("C3v") : string("D3"));
+      case 4 :
+         if ( inv ) {return string("C2h");}
+         if ( nc4>0 ) {return string("C4");}
+         if ( ns4>0 ) {return string("S4");}
+         return ((nsg>0)? string("C2v") : string("D2"));
+      case 3 :
+         return string("C3");
+      case 2 :
+         if ( inv ) {return string("Ci");}
+         return ((nsg>0)? string("Cs") : string("C2"));
+      default :
+         break;
+   }
+   return string("C1");
+}
+/* ************************************************************************************ */
+void molSymmetry::getFrameAxis(const int k,solreal (&e)[3])
+{
+   for ( int l=0 ; l<3 ; l++ ) {e[l]=frm[k][l];}
+}
+/* ************************************************************************************ */
+void molSymmetry::getCenter(solreal (&c)[3])
+{
+   for ( int l=0 ; l<3 ; l++ ) {c[l]=cen[l];}
+}
+/* ************************************************************************************ */
+bool molSymmetry::axesAreEquivalent(const int k,const int l)
+{
+   solreal pkl;
+   for ( int o=0 ; o<nOps ; o++ ) {
+      pkl=0.0e0;
+      for ( int a=0 ; a<3 ; a++ ) {
+         for ( int b=0 ; b<3 ; b++ ) {pkl+=frm[l][a]*op[o][a][b]*frm[k][b];}
+      }
+      if ( fabs(pkl)>0.5e0 ) {return true;}
+   }
+   return false;
+}
+/* ************************************************************************************ */
+int molSymmetry::getGridRepresentatives(solreal const (&x0)[3],solreal const (&dx)[3][3],\
+      int const (&nn)[3],int * (&rep),int &nused)
+{
+   /* The index maps: the image of the point (i,j,k) is tt+bb*(i,j,k).  */
+   int tt[MOLSYMM_MAXOPS][3],bb[MOLSYMM_MAXOPS][3][3];
+   solreal len2[3],v[3],w[3],c,res;
+   int q;
+   bool isok;
+   for ( int l=0 ; l<3 ; l++ ) {len2[l]=dx[l][0]*dx[l][0]+dx[l][1]*dx[l][1]+dx[l][2]*dx[l][2];}
+   nused=0;
+   for ( int o=0 ; o<nOps ; o++ ) {
+      isok=true;
+      /* m=-1 is the image of the origin, m=0,1,2 are the images of the steps.  */
+      for ( int m=-1 ; m<3 && isok ; m++ ) {
+         for ( int a=0 ; a<3 ; a++ ) {
+            v[a]=0.0e0;
+            for ( int b=0 ; b<3 ; b++ ) {v[a]+=op[o][a][b]*((m<0)? (x0[b]-cen[b]) : dx[m][b]);}
+            if ( m<0 ) {v[a]+=(cen[a]-x0[a]);}
+            w[a]=v[a];
+         }
+         for ( int l=0 ; l<3 && isok ; l++ ) {
+            c=(v[0]*dx[l][0]+v[1]*dx[l][1]+v[2]*dx[l][2])/len2[l];
+            q=int(floor(c+0.5e0));
+            isok=(fabs(c-solreal(q))<1.0e-04);
+            if ( m<0 ) {tt[nused][l]=q;} else {bb[nused][l][m]=q;}
+            for ( int a=0 ; a<3 ; a++ ) {w[a]-=c*dx[l][a];}
+         }
+         res=w[0]*w[0]+w[1]*w[1]+w[2]*w[2];
+         isok=(isok&&(res<(1.0e-08*(len2[0]+len2[1]+len2[2]))));
+      }
+      /* The corners of the grid must be mapped onto corners of the grid.  */
+      for ( int corner=0 ; corner<8 && isok ; corner++ ) {
+         for ( int l=0 ; l<3 && isok ; l++ ) {
+            q=tt[nused][l];
+            for ( int m=0 ; m<3 ; m++ ) {q+=bb[nused][l][m]*((corner&(1<<m))? (nn[m]-1) : 0);}
+            isok=(q>=0 && q<nn[l]);
+         }
+      }
+      if ( isok ) {++nused;}
+   }
+   const int ntot=nn[0]*nn[1]*nn[2];
+   alloc1DIntArray(string("rep"),ntot,rep);
+   int nrep=0;
+#if PARALLELISEDTK
+#pragma omp parallel for reduction(+:nrep) schedule(static)
+#endif
+   for ( int p=0 ; p<ntot ; p++ ) {
+      int idx[3]={p/(nn[1]*nn[2]),(p/nn[2])%nn[1],p%nn[2]},img[3],r=p,s;
+      for ( int o=0 ; o<nused ; o++ ) {
+         for ( int l=0 ; l<3 ; l++ ) {
+            img[l]=tt[o][l]+bb[o][l][0]*idx[0]+bb[o][l][1]*idx[1]+bb[o][l][2]*idx[2];
+         }
+         s=(img[0]*nn[1]+img[1])*nn[2]+img[2];
+         if ( s<r ) {r=s;}
+      }
+      rep[p]=r;
+      if ( r==p ) {++nrep;}
+   }
+   return nrep;
+}
+/* ************************************************************************************ */
+#endif//_MOLSYMMETRY_CPP_
+
@@ -0,0 +1,178 @@
+/*
+ *                    This source code is part of
+ *
+ *                  D  E  N  S  T  O  O  L  K  I  T
+ *
+ *                         VERSION: 1.2.0
+ *
+ *             Contributors: Juan Manuel Solano-Altamirano
+ *                           Julio Manuel Hernandez-Perez
+ *        Copyright (c) 2013-2015, Juan Manuel Solano-Altamirano
+ *                                 <jmsolanoalt@gmail.com>
+ *
+ * -------------------------------------------------------------------
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * ---------------------------------------------------------------------
+ *
+ * If you want to redistribute modifications of the suite, please
+ * consider to include your modifications in our official release.
+ * We will be pleased to consider the inclusion of your code
+ * within the official distribution. Please keep in mind that
+ * scientific software is very special, and version control is 
+ * crucial for tracing bugs. If in despite of this you distribute
+ * your modified version, please do not call it DensToolKit.
+ *
+ * If you find DensToolKit useful, we humbly ask that you cite
+ * the paper(s) on the package --- you can find them on the top
+ * README file.
+ *
+ */
+
+
+/*
+   molsymmetry.h
+
+   The class molSymmetry detects the point-group symmetry of a molecule (from the
+   coordinates and the atomic numbers of its nuclei), and uses it to reduce the number
+   of points of a grid where a field must be evaluated.
+
+   A symmetry operation maps a grid point onto another grid point only if it permutes
+   the axes of the grid (possibly reversing them). Hence, the detection looks for the
+   orthonormal frame (the symmetry frame) in which the largest number of the 48 signed
+   permutations of the axes are symmetry operations of the molecule; the candidate
+   frames are the laboratory frame, the principal axes of the nuclear charge
+   distribution and, when these are degenerate, frames built from the directions of
+   the atoms. The group of the operations found is the subgroup of the molecular point
+   group that a grid aligned with the symmetry frame can exploit: all the group for
+   molecules such as CH4 (Td) or cubane (Oh), and D2h (8 operations) for benzene,
+   whose C6 and C3 axes do not map a lattice onto itself.
+
+   Given a grid (origin, step vectors, and number of points per axis), the operations
+   that map the grid onto itself are turned into permutations of the grid indices, and
+   getGridRepresentatives assigns to each point the representative (lowest index) of
+   its orbit; only the representatives need to be evaluated. The fields must be
+   invariant under the operations (all the scalar fields of DensToolKit are, except,
+   possibly, the custom fields); checkWaveFunction drops the operations under which
+   the density of the wave function is not invariant (e.g. symmetry-broken states).
+ */
+
+#ifndef _MOLSYMMETRY_H_
+#define _MOLSYMMETRY_H_
+
+#ifndef _HAVE_DEF_SOLREAL_TYPE_
+#define _HAVE_DEF_SOLREAL_TYPE_
+typedef double solreal;
+#endif
+
+#include "gausswavefunction.h"
+#include "bondnetwork.h"
+
+#include <string>
+using std::string;
+
+/* By default, two positions are equal if they are closer than MOLSYMM_DISTTOL (bohr);
+   see setTolerance. Two directions are parallel (perpendicular) if the cosine of their
+   angle differs from 1 (0) by less than MOLSYMM_ANGTOL.  */
+#ifndef MOLSYMM_DISTTOL
+#define MOLSYMM_DISTTOL (1.0e-03)
+#endif
+#ifndef MOLSYMM_ANGTOL
+#define MOLSYMM_ANGTOL (1.0e-02)
+#endif
+/* The relative difference of the density at symmetry-related points must be smaller
+   than MOLSYMM_RHOTOL (see checkWaveFunction).  */
+#ifndef MOLSYMM_RHOTOL
+#define MOLSYMM_RHOTOL (1.0e-03)
+#endif
+/* The maximum number of directions used to build candidate frames for molecules with
+   degenerate principal axes.  */
+#ifndef MOLSYMM_MAXCANDIDATES
+#define MOLSYMM_MAXCANDIDATES (60)
+#endif
+/* The maximum number of operations (the order of Oh).  */
+#define MOLSYMM_MAXOPS (48)
+
+/* ************************************************************************************ */
+class molSymmetry {
+/* ************************************************************************************ */
+public:
+/* ************************************************************************************ */
+   molSymmetry();
+/* ************************************************************************************ */
+   /** Sets the largest distance (bohr) between an atom and the image of an equivalent
+    * atom. The displacements of the atoms from the exact symmetry are of this order,
+    * and so are the errors of the replicated grid values near the nuclei.  */
+   void setTolerance(const solreal dtol) {distTol=dtol;}
+   /** Detects the symmetry of the nn nuclei at rr[i][0..2], whose atomic numbers are
+    * an[i]+1 (as in bondNetWork).  */
+   bool setUp(const int nn,solreal ** const rr,const int *an);
+   /** Same as above, with the nuclei of bn.  */
+   bool setUp(bondNetWork &bn);
+   /** Same as above, with the nuclei of wf.  */
+   bool setUp(GaussWaveFunction &wf);
+   /** Makes the group of the symmetry of a field in momentum space: the operations act
+    * around the origin, and the inversion is added (the momentum density is even).  */
+   void setUpMomentumSpace(void);
+   /** Evaluates the density at a few points and at their images, and removes the
+    * operations under which the density is not invariant. Returns false if some
+    * operation was removed.  */
+   bool checkWaveFunction(GaussWaveFunction &wf);
+/* ************************************************************************************ */
+   int getNOfOperations(void) {return nOps;}
+   /** Returns the name (Schoenflies) of the group of the operations found.  */
+   string getPointGroupName(void);
+   /** Returns the k-th axis of the symmetry frame.  */
+   void getFrameAxis(const int k,solreal (&e)[3]);
+   /** Returns the center of symmetry.  */
+   void getCenter(solreal (&c)[3]);
+   /** Returns true if the k-th and l-th axes of the frame are exchanged by some
+    * operation (the grid must then have the same spacing and number of points along
+    * both axes).  */
+   bool axesAreEquivalent(const int k,const int l);
+   /** Sets rep[p] to the representative of the orbit of the grid point p (rep[p]==p
+    * for the points that must be evaluated), for the grid of nn[0]*nn[1]*nn[2] points
+    * x0+i*dx[0]+j*dx[1]+k*dx[2], p=(i*nn[1]+j)*nn[2]+k. The step vectors must be
+    * mutually orthogonal (for a plane, nn[2]=1, and dx[2] is any normal vector). The
+    * array rep is allocated here. Returns the number of representatives, and sets
+    * nused to the number of operations that map the grid onto itself.  */
+   int getGridRepresentatives(solreal const (&x0)[3],solreal const (&dx)[3][3],\
+         int const (&nn)[3],int * (&rep),int &nused);
+/* ************************************************************************************ */
+protected:
+/* ************************************************************************************ */
+   int nOps;
+   solreal distTol;
+   solreal cen[3];
+   solreal frm[3][3]; /*!< The axes of the symmetry frame (rows).  */
+   solreal op[MOLSYMM_MAXOPS][3][3]; /*!< The operations (laboratory frame):
+                                        x'=cen+op*(x-cen).  */
+/* ************************************************************************************ */
+   /** Returns true if the operation mm maps the molecule onto itself.  */
+   bool isSymmetryOperation(const int nn,solreal ** const rr,const int *an,\
+         solreal const (&mm)[3][3]);
+   /** Counts (and, if keep is true, saves) the signed permutations of the axes of the
+    * frame ff that are symmetry operations.  */
+   int findFrameOperations(const int nn,solreal ** const rr,const int *an,\
+         solreal const (&ff)[3][3],const bool keep);
+   /** Adds the candidate direction v to dd (if it is neither null nor parallel to the
+    * directions already in dd).  */
+   void addCandidateDirection(solreal (&v)[3],solreal (&dd)[MOLSYMM_MAXCANDIDATES][3],\
+         int &nd);
+/* ************************************************************************************ */
+};
+/* ************************************************************************************ */
+#endif//_MOLSYMMETRY_H_
+
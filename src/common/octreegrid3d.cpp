@@ -0,0 +1,477 @@
+/*
+ *                    This source code is part of
+ *
+ *                  D  E  N  S  T  O  O  L  K  I  T
+ *
+ *                         VERSION: 1.2.0
+ *
+ *             Contributors: Juan Manuel Solano-Altamirano
+ *                           Julio Manuel Hernandez-Perez
+ *        Copyright (c) 2013-2015, Juan Manuel Solano-Altamirano
+ *                                 <jmsolanoalt@gmail.com>
+ *
+ * -------------------------------------------------------------------
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * ---------------------------------------------------------------------
+ *
+ * If you want to redistribute modifications of the suite, please
+ * consider to include your modifications in our official release.
+ * We will be pleased to consider the inclusion of your code
+ * within the official distribution. Please keep in mind that
+ * scientific software is very special, and version control is 
+ * crucial for tracing bugs. If in despite of this you distribute
+ * your modified version, please do not call it DensToolKit.
+ *
+ * If you find DensToolKit useful, we humbly ask that you cite
+ * the paper(s) on the package --- you can find them on the top
+ * README file.
+ *
+ */
+
+
+#ifndef _OCTREEGRID3D_CPP_
+#define _OCTREEGRID3D_CPP_
+
+#include "octreegrid3d.h"
+#include "solmemhand.h"
+#include "solscrutils.h"
+#include "solcubetools.h"
+#include "solstringtools.h"
+#include <iostream>
+using std::cout;
+using std::endl;
+#include <fstream>
+using std::ofstream;
+#include <iomanip>
+using std::setprecision;
+using std::scientific;
+#include <cmath>
+
+/* ************************************************************************************ */
+octreeGrid3D::octreeGrid3D()
+{
+   imsetup=imbuilt=useIso=false;
+   maxLev=0;
+   for ( int k=0 ; k<3 ; k++ ) {
+      nr[k]=nf[k]=0;
+      x0[k]=0.0e0;
+      hf[k]=1.0e0;
+   }
+   relTol=OCTREE_DEFAULTRELTOL;
+   absTol=OCTREE_DEFAULTABSTOL;
+   isoVal=0.0e0;
+   fldType=NONE;
+   nPts=capPts=nBuck=0;
+   head=next=lat=NULL;
+   val=NULL;
+   nCell=capCell=0;
+   cell=NULL;
+}
+/* ************************************************************************************ */
+octreeGrid3D::~octreeGrid3D()
+{
+   destroy();
+}
+/* ************************************************************************************ */
+void octreeGrid3D::destroy(void)
+{
+   dealloc1DIntArray(head);
+   dealloc1DIntArray(next);
+   dealloc1DIntArray(lat);
+   dealloc1DRealArray(val);
+   deallocFlat2DIntArray(cell);
+   nPts=capPts=nBuck=0;
+   nCell=capCell=0;
+   imbuilt=false;
+}
+/* ************************************************************************************ */
+bool octreeGrid3D::setUp(waveFunctionGrid3D &grd,const int maxlev)
+{
+   if ( maxlev<1 || maxlev>OCTREE_MAXLEVEL ) {
+      displayErrorMessage("The number of levels of the octree must be between 1 and "
+            +getStringFromInt(OCTREE_MAXLEVEL)+"!");
+      return false;
+   }
+   destroy();
+   maxLev=maxlev;
+   const int ss=(1<<maxLev);
+   int n;
+   for ( int k=0 ; k<3 ; k++ ) {
+      for ( int l=0 ; l<3 ; l++ ) {
+         if ( l!=k && grd.dx[k][l]!=0.0e0 ) {
+            displayErrorMessage("The grid for the octree must be orthogonal!");
+            return false;
+         }
+      }
+      n=grd.getNPts(k);
+      nr[k]=(n-1+ss-1)/ss;
+      if ( nr[k]<1 ) {nr[k]=1;}
+      nf[k]=nr[k]*ss+1;
+      x0[k]=grd.xin[k];
+      hf[k]=grd.dx[k][k];
+   }
+   imsetup=true;
+   return true;
+}
+/* ************************************************************************************ */
+bool octreeGrid3D::growPointArrays(void)
+{
+   int newcap=((capPts>0)? (2*capPts) : OCTREE_INITCAPACITY);
+   bool res=resize1DIntArray(string("next"),capPts,newcap,next,-1);
+   res=(res&&resize1DIntArray(string("lat"),3*capPts,3*newcap,lat));
+   res=(res&&resize1DRealArray(string("val"),capPts,newcap,val));
+   if ( res ) {capPts=newcap;}
+   return res;
+}
+/* ************************************************************************************ */
+void octreeGrid3D::rehash(const int newnbuck)
+{
+   dealloc1DIntArray(head);
+   nBuck=newnbuck;
+   alloc1DIntArray(string("head"),nBuck,head,-1);
+   int b;
+   for ( int p=0 ; p<nPts ; p++ ) {
+      b=getBucket(lat[3*p],lat[3*p+1],lat[3*p+2]);
+      next[p]=head[b];
+      head[b]=p;
+   }
+}
+/* ************************************************************************************ */
+int octreeGrid3D::findPoint(const int i,const int j,const int k)
+{
+   if ( nBuck==0 ) {return -1;}
+   for ( int p=head[getBucket(i,j,k)] ; p>=0 ; p=next[p] ) {
+      if ( lat[3*p]==i && lat[3*p+1]==j && lat[3*p+2]==k ) {return p;}
+   }
+   return -1;
+}
+/* ************************************************************************************ */
+void octreeGrid3D::addPoint(const int i,const int j,const int k)
+{
+   if ( findPoint(i,j,k)>=0 ) {return;}
+   if ( nPts==capPts && !growPointArrays() ) {
+      displayErrorMessage("The point could not be added to the octree!");
+      return;
+   }
+   //Keeps (on average) less than two points per bucket.
+   if ( nPts>=(2*nBuck) ) {rehash((nBuck>0)? (2*nBuck) : OCTREE_INITCAPACITY);}
+   int p=nPts;
+   lat[3*p]=i;
+   lat[3*p+1]=j;
+   lat[3*p+2]=k;
+   val[p]=0.0e0;
+   int b=getBucket(i,j,k);
+   next[p]=head[b];
+   head[b]=p;
+   ++nPts;
+}
+/* ************************************************************************************ */
+solreal octreeGrid3D::evalField(GaussWaveFunction &wf,const solreal x,const solreal y,\
+      const solreal z)
+{
+   if ( fldType==DENS ) {return wf.evalDensity(x,y,z);}
+   solreal res;
+   wf.evalMultipleFields(x,y,z,&fldType,1,&res);
+   return res;
+}
+/* ************************************************************************************ */
+void octreeGrid3D::evalNewPoints(GaussWaveFunction &wf,const int from)
+{
+#if PARALLELISEDTK
+#pragma omp parallel if((nPts-from)>1)
+   {
+      GaussWaveFunction twf;
+      GaussWaveFunction *pwf=&wf;
+      if ( omp_get_thread_num()>0 ) {
+         twf.shareDataFrom(wf);
+         pwf=&twf;
+      }
+#pragma omp for schedule(dynamic,64)
+      for ( int p=from ; p<nPts ; p++ ) {
+         val[p]=evalField(*pwf,x0[0]+solreal(lat[3*p])*hf[0],\
+               x0[1]+solreal(lat[3*p+1])*hf[1],x0[2]+solreal(lat[3*p+2])*hf[2]);
+      }
+   }
+#else
+   for ( int p=from ; p<nPts ; p++ ) {
+      val[p]=evalField(wf,x0[0]+solreal(lat[3*p])*hf[0],\
+            x0[1]+solreal(lat[3*p+1])*hf[1],x0[2]+solreal(lat[3*p+2])*hf[2]);
+   }
+#endif
+}
+/* ************************************************************************************ */
+bool octreeGrid3D::needsRefinement(const int c)
+{
+   const int s=((1<<maxLev)>>cell[c][0]),h=s/2;
+   const int *o=&cell[c][1];
+   solreal f,fmin,fmax,avg=0.0e0;
+   const solreal fc=val[findPoint(o[0]+h,o[1]+h,o[2]+h)];
+   fmin=fmax=fc;
+   for ( int a=0 ; a<8 ; a++ ) {
+      f=val[findPoint(o[0]+((a&4)? s : 0),o[1]+((a&2)? s : 0),o[2]+((a&1)? s : 0))];
+      avg+=f;
+      if ( f<fmin ) {fmin=f;}
+      if ( f>fmax ) {fmax=f;}
+   }
+   avg*=0.125e0;
+   if ( useIso && fmin<=isoVal && fmax>=isoVal ) {return true;}
+   f=relTol*fabs(fc);
+   if ( f<absTol ) {f=absTol;}
+   return (fabs(fc-avg)>f);
+}
+/* ************************************************************************************ */
+bool octreeGrid3D::build(GaussWaveFunction &wf,const ScalarFieldType ft)
+{
+   if ( !imsetup ) {
+      displayErrorMessage("The octree must be set up before being built!");
+      return false;
+   }
+   destroy();
+   fldType=ft;
+   const int ss=(1<<maxLev);
+   capCell=nr[0]*nr[1]*nr[2];
+   allocFlat2DIntArray(string("cell"),capCell,5,cell,-1);
+   nCell=0;
+   for ( int a=0 ; a<nr[0] ; a++ ) {
+      for ( int b=0 ; b<nr[1] ; b++ ) {
+         for ( int d=0 ; d<nr[2] ; d++ ) {
+            cell[nCell][0]=0;
+            cell[nCell][1]=a*ss;
+            cell[nCell][2]=b*ss;
+            cell[nCell][3]=d*ss;
+            ++nCell;
+         }
+      }
+   }
+   int beg=0,end=nCell,from,s,h,nref,newcap;
+   bool *ref;
+   for ( int lev=0 ; lev<=maxLev ; lev++ ) {
+      s=(ss>>lev);
+      h=s/2;
+      from=nPts;
+      for ( int c=beg ; c<end ; c++ ) {
+         for ( int a=0 ; a<8 ; a++ ) {
+            addPoint(cell[c][1]+((a&4)? s : 0),cell[c][2]+((a&2)? s : 0),\
+                  cell[c][3]+((a&1)? s : 0));
+         }
+         if ( s>1 ) {addPoint(cell[c][1]+h,cell[c][2]+h,cell[c][3]+h);}
+      }
+      evalNewPoints(wf,from);
+      cout << "  Level " << lev << ": " << (end-beg) << " cells, " << (nPts-from)
+           << " new points." << endl;
+      if ( lev==maxLev ) {break;}
+      ref=new bool[end-beg];
+      nref=0;
+#if PARALLELISEDTK
+#pragma omp parallel for reduction(+:nref)
+#endif
+      for ( int c=beg ; c<end ; c++ ) {
+         ref[c-beg]=needsRefinement(c);
+         if ( ref[c-beg] ) {++nref;}
+      }
+      if ( nref==0 ) {
+         delete[] ref;
+         break;
+      }
+      newcap=nCell+8*nref;
+      if ( !resizeFlat2DIntArray(string("cell"),capCell,newcap,5,cell,-1) ) {
+         delete[] ref;
+         return false;
+      }
+      capCell=newcap;
+      for ( int c=beg ; c<end ; c++ ) {
+         if ( !ref[c-beg] ) {continue;}
+         cell[c][4]=nCell;
+         for ( int a=0 ; a<8 ; a++ ) {
+            cell[nCell][0]=lev+1;
+            cell[nCell][1]=cell[c][1]+((a&4)? h : 0);
+            cell[nCell][2]=cell[c][2]+((a&2)? h : 0);
+            cell[nCell][3]=cell[c][3]+((a&1)? h : 0);
+            cell[nCell][4]=-1;
+            ++nCell;
+         }
+      }
+      delete[] ref;
+      beg=end;
+      end=nCell;
+   }
+   imbuilt=true;
+   return true;
+}
+/* ************************************************************************************ */
+int octreeGrid3D::getNOfLeaves(void)
+{
+   int nl=0;
+   for ( int c=0 ; c<nCell ; c++ ) {if ( cell[c][4]<0 ) {++nl;}}
+   return nl;
+}
+/* ************************************************************************************ */
+int octreeGrid3D::findLeaf(const int i,const int j,const int k)
+{
+   const int ss=(1<<maxLev);
+   int a=i/ss,b=j/ss,d=k/ss;
+   if ( a>=nr[0] ) {a=nr[0]-1;}
+   if ( b>=nr[1] ) {b=nr[1]-1;}
+   if ( d>=nr[2] ) {d=nr[2]-1;}
+   int c=(a*nr[1]+b)*nr[2]+d,h;
+   while ( cell[c][4]>=0 ) {
+      h=((ss>>cell[c][0])/2);
+      c=cell[c][4]+(((i-cell[c][1])>=h)? 4 : 0)+(((j-cell[c][2])>=h)? 2 : 0)\
+        +(((k-cell[c][3])>=h)? 1 : 0);
+   }
+   return c;
+}
+/* ************************************************************************************ */
+solreal octreeGrid3D::getValue(const int i,const int j,const int k)
+{
+   int p=findPoint(i,j,k);
+   if ( p>=0 ) {return val[p];}
+   const int c=findLeaf(i,j,k),s=((1<<maxLev)>>cell[c][0]);
+   const int *o=&cell[c][1];
+   const solreal u=solreal(i-o[0])/solreal(s),v=solreal(j-o[1])/solreal(s),\
+                 w=solreal(k-o[2])/solreal(s);
+   solreal f=0.0e0,wt;
+   for ( int a=0 ; a<8 ; a++ ) {
+      wt=((a&4)? u : (1.0e0-u))*((a&2)? v : (1.0e0-v))*((a&1)? w : (1.0e0-w));
+      if ( wt==0.0e0 ) {continue;}
+      f+=wt*val[findPoint(o[0]+((a&4)? s : 0),o[1]+((a&2)? s : 0),o[2]+((a&1)? s : 0))];
+   }
+   return f;
+}
+/* ************************************************************************************ */
+void octreeGrid3D::getPlane(const int i,solreal *pv)
+{
+#if PARALLELISEDTK
+#pragma omp parallel for schedule(dynamic,1)
+#endif
+   for ( int j=0 ; j<nf[1] ; j++ ) {
+      for ( int k=0 ; k<nf[2] ; k++ ) {pv[j*nf[2]+k]=getValue(i,j,k);}
+   }
+}
+/* ************************************************************************************ */
+solreal octreeGrid3D::integrate(void)
+{
+   const int ss=(1<<maxLev);
+   const solreal dv=hf[0]*hf[1]*hf[2];
+   solreal res=0.0e0,fc,sc;
+   int s,h;
+   const int *o;
+   for ( int c=0 ; c<nCell ; c++ ) {
+      if ( cell[c][4]>=0 ) {continue;}
+      s=(ss>>cell[c][0]);
+      h=s/2;
+      o=&cell[c][1];
+      sc=0.0e0;
+      for ( int a=0 ; a<8 ; a++ ) {
+         sc+=val[findPoint(o[0]+((a&4)? s : 0),o[1]+((a&2)? s : 0),o[2]+((a&1)? s : 0))];
+      }
+      sc*=0.125e0;
+      if ( s>1 ) {
+         fc=val[findPoint(o[0]+h,o[1]+h,o[2]+h)];
+         sc=(sc+2.0e0*fc)/3.0e0;
+      }
+      res+=sc*dv*solreal(s*s*s);
+   }
+   return res;
+}
+/* ************************************************************************************ */
+bool octreeGrid3D::writeCubeFile(string &onam,GaussWaveFunction &wf,string &comm)
+{
+   if ( !imbuilt ) {
+      displayErrorMessage("The octree has not been built!");
+      return false;
+   }
+   ofstream ofil(onam.c_str());
+   if ( !ofil.good() ) {
+      displayErrorMessage(string("The file ")+onam+string(" could not be opened!"));
+      return false;
+   }
+   solreal dx[3][3];
+   for ( int k=0 ; k<3 ; k++ ) {
+      for ( int l=0 ; l<3 ; l++ ) {dx[k][l]=((k==l)? hf[k] : 0.0e0);}
+   }
+   writeCubeHeader(ofil,wf.title[0],comm,nf,x0,dx,wf.nNuc,wf.atCharge,wf.R);
+   solreal *pv,*row;
+   alloc1DRealArray(string("pv"),nf[1]*nf[2],pv);
+   for ( int i=0 ; i<nf[0] ; i++ ) {
+      getPlane(i,pv);
+      for ( int j=0 ; j<nf[1] ; j++ ) {
+         row=&pv[j*nf[2]];
+         writeCubeProp(ofil,nf[2],row);
+      }
+   }
+   dealloc1DRealArray(pv);
+   ofil.close();
+   return true;
+}
+/* ************************************************************************************ */
+bool octreeGrid3D::writeOctreeFile(string &onam,GaussWaveFunction &wf,string &comm)
+{
+   if ( !imbuilt ) {
+      displayErrorMessage("The octree has not been built!");
+      return false;
+   }
+   ofstream ofil(onam.c_str());
+   if ( !ofil.good() ) {
+      displayErrorMessage(string("The file ")+onam+string(" could not be opened!"));
+      return false;
+   }
+   ofil << "#DensToolKit octree grid" << endl;
+   ofil << "#" << wf.title[0] << endl;
+   ofil << "#" << comm << endl;
+   ofil << "#Origin, spacings of the finest level, root cells per axis and levels:" << endl;
+   ofil << scientific << setprecision(12);
+   ofil << x0[0] << " " << x0[1] << " " << x0[2] << endl;
+   ofil << hf[0] << " " << hf[1] << " " << hf[2] << endl;
+   ofil << nr[0] << " " << nr[1] << " " << nr[2] << " " << maxLev << endl;
+   ofil << "#Points (lattice indices and value):" << endl << nPts << endl;
+   ofil << setprecision(10);
+   for ( int p=0 ; p<nPts ; p++ ) {
+      ofil << lat[3*p] << " " << lat[3*p+1] << " " << lat[3*p+2] << " " << val[p] << endl;
+   }
+   const int nl=getNOfLeaves();
+   ofil << "#Leaves (level and lattice indices of the lowest corner):" << endl << nl << endl;
+   for ( int c=0 ; c<nCell ; c++ ) {
+      if ( cell[c][4]>=0 ) {continue;}
+      ofil << cell[c][0] << " " << cell[c][1] << " " << cell[c][2] << " " << cell[c][3]
+           << endl;
+   }
+   ofil.close();
+   return true;
+}
+/* ************************************************************************************ */
+bool octreeGrid3D::extractIsoSurface(isoSurface &iso,GaussWaveFunction &wf,\
+      const solreal isov)
+{
+   if ( !imbuilt ) {
+      displayErrorMessage("The octree has not been built!");
+      return false;
+   }
+   if ( !iso.startExtraction(isov,nf,x0,hf) ) {return false;}
+   solreal *pv;
+   alloc1DRealArray(string("pv"),nf[1]*nf[2],pv);
+   for ( int i=0 ; i<nf[0] ; i++ ) {
+      getPlane(i,pv);
+      iso.addPlane(pv);
+   }
+   dealloc1DRealArray(pv);
+   iso.endExtraction();
+   iso.computeNormals(wf,fldType);
+   return true;
+}
+/* ************************************************************************************ */
+#endif//_OCTREEGRID3D_CPP_
+
@@ -0,0 +1,187 @@
+/*
+ *                    This source code is part of
+ *
+ *                  D  E  N  S  T  O  O  L  K  I  T
+ *
+ *                         VERSION: 1.2.0
+ *
+ *             Contributors: Juan Manuel Solano-Altamirano
+ *                           Julio Manuel Hernandez-Perez
+ *        Copyright (c) 2013-2015, Juan Manuel Solano-Altamirano
+ *                                 <jmsolanoalt@gmail.com>
+ *
+ * -------------------------------------------------------------------
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * ---------------------------------------------------------------------
+ *
+ * If you want to redistribute modifications of the suite, please
+ * consider to include your modifications in our official release.
+ * We will be pleased to consider the inclusion of your code
+ * within the official distribution. Please keep in mind that
+ * scientific software is very special, and version control is 
+ * crucial for tracing bugs. If in despite of this you distribute
+ * your modified version, please do not call it DensToolKit.
+ *
+ * If you find DensToolKit useful, we humbly ask that you cite
+ * the paper(s) on the package --- you can find them on the top
+ * README file.
+ *
+ */
+
+
+/*
+   octreegrid3d.h
+
+   The class octreeGrid3D samples a scalar field on an adaptive octree. The box is
+   divided into root cells (level 0), and every cell whose field cannot be described
+   by the trilinear interpolation of its corners (the value at its center differs
+   from the average of its corners by more than the tolerances), or which is crossed
+   by an isovalue (if one is set), is split into eight children, down to the level
+   maxLev. Thus the vacuum is covered by a few large cells, while the regions where
+   the field varies (the nuclei, the bonds, the isosurface) get the finest spacing.
+
+   All the points lie on the lattice of the finest level, and they are identified by
+   their (integer) lattice indices; every point is evaluated once, even if it is shared
+   by several cells. The cells of each level are tested and refined together, and the
+   new points of each level are evaluated in parallel. The octree can be resampled on
+   the finest lattice (getPlane, writeCubeFile), integrated (integrate), used for the
+   extraction of an isosurface (extractIsoSurface), or written in a sparse format
+   (writeOctreeFile, which stores only the evaluated points and the leaves).
+ */
+
+#ifndef _OCTREEGRID3D_H_
+#define _OCTREEGRID3D_H_
+
+#ifndef _HAVE_DEF_SOLREAL_TYPE_
+#define _HAVE_DEF_SOLREAL_TYPE_
+typedef double solreal;
+#endif
+
+#include "gausswavefunction.h"
+#include "wfgrid3d.h"
+#include "isosurface.h"
+#include "fldtypesdef.h"
+#include <string>
+using std::string;
+
+#ifndef OCTREE_DEFAULTMAXLEVEL
+#define OCTREE_DEFAULTMAXLEVEL (3)
+#endif
+#ifndef OCTREE_MAXLEVEL
+#define OCTREE_MAXLEVEL (8)
+#endif
+/* A cell is refined if |f(center)-<f(corners)>| > max(OCTREE_DEFAULTRELTOL*|f(center)|,
+   OCTREE_DEFAULTABSTOL) (see setTolerances).  */
+#ifndef OCTREE_DEFAULTRELTOL
+#define OCTREE_DEFAULTRELTOL (1.0e-02)
+#endif
+#ifndef OCTREE_DEFAULTABSTOL
+#define OCTREE_DEFAULTABSTOL (1.0e-04)
+#endif
+#ifndef OCTREE_INITCAPACITY
+#define OCTREE_INITCAPACITY (4096)
+#endif
+
+/* ************************************************************************************ */
+class octreeGrid3D {
+/* ************************************************************************************ */
+public:
+/* ************************************************************************************ */
+   octreeGrid3D();
+   ~octreeGrid3D();
+/* ************************************************************************************ */
+   /** Sets up the octree on the box of the (orthogonal) grid grd. The spacings of grd
+    * are the spacings of the finest level (maxlev), and the root cells are 2^maxlev
+    * times larger; the box is enlarged (in the positive directions), if needed, to
+    * hold a whole number of root cells.  */
+   bool setUp(waveFunctionGrid3D &grd,const int maxlev);
+   /** Sets the relative and absolute tolerances of the interpolation error.  */
+   void setTolerances(const solreal rtol,const solreal atol) {relTol=rtol; absTol=atol;}
+   /** Every cell crossed by the isovalue isov is refined down to the finest level.  */
+   void setIsoValue(const solreal isov) {isoVal=isov; useIso=true;}
+/* ************************************************************************************ */
+   /** Evaluates the field ft, refining the octree level by level.  */
+   bool build(GaussWaveFunction &wf,const ScalarFieldType ft);
+/* ************************************************************************************ */
+   int getNOfEvaluations(void) {return nPts;}
+   int getNOfLeaves(void);
+   /** Returns the number of points of the finest lattice along the k-th axis.  */
+   int getNPts(const int k) {return nf[k];}
+   /** Returns the field at the point (i,j,k) of the finest lattice: the evaluated value
+    * if the point was evaluated, otherwise the trilinear interpolation within the leaf
+    * that contains the point.  */
+   solreal getValue(const int i,const int j,const int k);
+   /** Resamples the plane i of the finest lattice: pv[j*nf[2]+k]=getValue(i,j,k).  */
+   void getPlane(const int i,solreal *pv);
+   /** Returns the integral of the field over the box (a Simpson-like rule is used in the
+    * leaves that have a center point, and the trapezoidal rule in the finest ones).  */
+   solreal integrate(void);
+/* ************************************************************************************ */
+   /** Writes the octree, resampled on the finest lattice, into the cube file onam.  */
+   bool writeCubeFile(string &onam,GaussWaveFunction &wf,string &comm);
+   /** Writes the octree into the (text) file onam: the origin, the spacings of the
+    * finest level, the number of root cells per axis and maxLev, followed by the
+    * evaluated points (lattice indices i j k and the value) and the leaves (level and
+    * the lattice indices of the lowest corner).  */
+   bool writeOctreeFile(string &onam,GaussWaveFunction &wf,string &comm);
+   /** Extracts the isosurface isov from the octree (resampled plane by plane on the
+    * finest lattice); the normals are computed from the wave function.  */
+   bool extractIsoSurface(isoSurface &iso,GaussWaveFunction &wf,const solreal isov);
+/* ************************************************************************************ */
+protected:
+/* ************************************************************************************ */
+   bool imsetup,imbuilt,useIso;
+   int maxLev;
+   int nr[3]; /*!< The number of root cells along each axis.  */
+   int nf[3]; /*!< The number of points of the finest lattice along each axis.  */
+   solreal x0[3],hf[3],relTol,absTol,isoVal;
+   ScalarFieldType fldType;
+   /* The evaluated points: lattice indices (lat[3*p+k]) and values, hashed by their
+      lattice indices.  */
+   int nPts,capPts,nBuck;
+   int *head,*next,*lat;
+   solreal *val;
+   /* The cells: cell[c][0] is the level, cell[c][1..3] are the lattice indices of the
+      lowest corner, and cell[c][4] is the index of the first of the eight children (the
+      children are consecutive), or -1 if the cell is a leaf. The first nr[0]*nr[1]*nr[2]
+      cells are the root cells.  */
+   int nCell,capCell;
+   int **cell;
+/* ************************************************************************************ */
+   inline int getBucket(const int i,const int j,const int k) {
+      return int(((unsigned int)(i)*73856093u^(unsigned int)(j)*19349663u\
+               ^(unsigned int)(k)*83492791u)&(unsigned int)(nBuck-1));
+   }
+   /** Returns the index of the point (i,j,k), or -1 if it has not been added.  */
+   int findPoint(const int i,const int j,const int k);
+   /** Adds the point (i,j,k) (if it was not already added); the new points are
+    * evaluated later by evalNewPoints.  */
+   void addPoint(const int i,const int j,const int k);
+   bool growPointArrays(void);
+   void rehash(const int newnbuck);
+   /** Evaluates the points from the index from on.  */
+   void evalNewPoints(GaussWaveFunction &wf,const int from);
+   solreal evalField(GaussWaveFunction &wf,const solreal x,const solreal y,const solreal z);
+   /** Returns true if the cell c must be split.  */
+   bool needsRefinement(const int c);
+   /** Returns the leaf that contains the lattice point (i,j,k).  */
+   int findLeaf(const int i,const int j,const int k);
+   void destroy(void);
+/* ************************************************************************************ */
+};
+/* ************************************************************************************ */
+#endif//_OCTREEGRID3D_H_
+
@@ -0,0 +1,362 @@
+/*
+ *                    This source code is part of
+ *
+ *                  D  E  N  S  T  O  O  L  K  I  T
+ *
+ *                         VERSION: 1.2.0
+ *
+ *             Contributors: Juan Manuel Solano-Altamirano
+ *                           Julio Manuel Hernandez-Perez
+ *        Copyright (c) 2013-2015, Juan Manuel Solano-Altamirano
+ *                                 <jmsolanoalt@gmail.com>
+ *
+ * -------------------------------------------------------------------
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * ---------------------------------------------------------------------
+ *
+ * If you want to redistribute modifications of the suite, please
+ * consider to include your modifications in our official release.
+ * We will be pleased to consider the inclusion of your code
+ * within the official distribution. Please keep in mind that
+ * scientific software is very special, and version control is 
+ * crucial for tracing bugs. If in despite of this you distribute
+ * your modified version, please do not call it DensToolKit.
+ *
+ * If you find DensToolKit useful, we humbly ask that you cite
+ * the paper(s) on the package --- you can find them on the top
+ * README file.
+ *
+ */
+
+
+#ifndef _PROMOLDENSITY_CPP_
+#define _PROMOLDENSITY_CPP_
+
+#include "promoldensity.h"
+#include "solmemhand.h"
+#include "solscrutils.h"
+#include "solstringtools.h"
+#include <iostream>
+using std::cout;
+using std::endl;
+#include <string>
+using std::string;
+#include <cmath>
+
+/* ************************************************************************************ */
+proMolDensity::proMolDensity()
+{
+   imsetup=false;
+   nNuc=nEl=0;
+   R=NULL;
+   atEl=NULL;
+   rCut2=NULL;
+   idt=NULL;
+   tab=NULL;
+}
+/* ************************************************************************************ */
+proMolDensity::~proMolDensity()
+{
+   destroy();
+}
+/* ************************************************************************************ */
+void proMolDensity::destroy(void)
+{
+   dealloc1DRealArray(R);
+   dealloc1DIntArray(atEl);
+   dealloc1DRealArray(rCut2);
+   dealloc1DRealArray(idt);
+   deallocFlat2DRealArray(tab);
+   nNuc=nEl=0;
+   imsetup=false;
+}
+/* ************************************************************************************ */
+void proMolDensity::getSlaterShells(const int z,int &ns,int (&ne)[20],\
+      solreal (&nst)[20],solreal (&zet)[20])
+{
+   /* Slater's groups: (1s)(2s,2p)(3s,3p)(3d)(4s,4p)(4d)(4f)(5s,5p)(5d)(5f)(6s,6p)(6d)
+      (7s,7p). gk is 0 for the (s,p) groups, 2 for d and 3 for f.  */
+   static const int ngr=13;
+   static const int gn[ngr]={1,2,3,3,4,4,4,5,5,5,6,6,7};
+   static const int gk[ngr]={0,0,0,2,0,2,3,0,2,3,0,2,0};
+   static const solreal nstar[8]={0.0e0,1.0e0,2.0e0,3.0e0,3.7e0,4.0e0,4.2e0,4.2e0};
+   /* The aufbau (Madelung) order of the subshells, as (n,l) pairs.  */
+   static const int nsub=19;
+   static const int sn[nsub]={1,2,2,3,3,4,3,4,5,4,5,6,4,5,6,7,5,6,7};
+   static const int sl[nsub]={0,0,1,0,1,0,2,1,0,2,1,0,3,2,1,0,3,2,1};
+   int cnt[ngr],left=z,gl,take;
+   for ( int g=0 ; g<ngr ; g++ ) {cnt[g]=0;}
+   for ( int s=0 ; (s<nsub)&&(left>0) ; s++ ) {
+      gl=((sl[s]<2)? 0 : sl[s]);
+      for ( int g=0 ; g<ngr ; g++ ) {
+         if ( gn[g]==sn[s] && gk[g]==gl ) {
+            take=2*(2*sl[s]+1);
+            if ( take>left ) {take=left;}
+            cnt[g]+=take;
+            left-=take;
+            break;
+         }
+      }
+   }
+   solreal sc;
+   ns=0;
+   for ( int g=0 ; g<ngr ; g++ ) {
+      if ( cnt[g]==0 ) {continue;}
+      sc=((g==0)? 0.30e0 : 0.35e0)*solreal(cnt[g]-1);
+      for ( int h=0 ; h<ngr ; h++ ) {
+         if ( h==g || cnt[h]==0 ) {continue;}
+         if ( gk[g]==0 ) {
+            if ( gn[h]==(gn[g]-1) ) {
+               sc+=0.85e0*solreal(cnt[h]);
+            } else if ( gn[h]<(gn[g]-1) ) {
+               sc+=solreal(cnt[h]);
+            }
+         } else if ( h<g ) {
+            sc+=solreal(cnt[h]);
+         }
+      }
+      ne[ns]=cnt[g];
+      nst[ns]=nstar[gn[g]];
+      zet[ns]=(solreal(z)-sc)/nst[ns];
+      ++ns;
+   }
+}
+/* ************************************************************************************ */
+void proMolDensity::evalAtomicLogDensity(const int z,const solreal r,solreal &g,\
+      solreal &gt,solreal &gtt)
+{
+   /* Each shell contributes c r^a exp(-b r), with a=2n*-2 and b=2zeta, and
+      c=N(2zeta)^(2n*+1)/(4pi Gamma(2n*+1)).  */
+   static const solreal lfourpi=2.53102424696929079e0; /* ln(4\pi)  */
+   int ns,ne[20];
+   solreal nst[20],zet[20],a,b,lc,t,u,rho=0.0e0,rp=0.0e0,rpp=0.0e0;
+   getSlaterShells(z,ns,ne,nst,zet);
+   const solreal lr=log(r);
+   for ( int s=0 ; s<ns ; s++ ) {
+      a=2.0e0*nst[s]-2.0e0;
+      b=2.0e0*zet[s];
+      lc=log(solreal(ne[s]))+(2.0e0*nst[s]+1.0e0)*log(b)-lgamma(2.0e0*nst[s]+1.0e0)-lfourpi;
+      t=exp(lc+a*lr-b*r);
+      u=a/r-b;
+      rho+=t;
+      rp+=t*u;
+      rpp+=t*(u*u-a/(r*r));
+   }
+   g=log(rho);
+   gt=r*rp/rho;
+   gtt=gt+r*r*rpp/rho-gt*gt;
+}
+/* ************************************************************************************ */
+solreal proMolDensity::evalAtomicDensity(const int z,const solreal r)
+{
+   solreal g,gt,gtt;
+   evalAtomicLogDensity(z,((r<PROMOLDENS_RMIN)? PROMOLDENS_RMIN : r),g,gt,gtt);
+   return exp(g);
+}
+/* ************************************************************************************ */
+bool proMolDensity::setUp(const int nn,const solreal *rr,const int *zz)
+{
+   destroy();
+   if ( nn<1 ) {
+      displayErrorMessage("There are no nuclei for the promolecular density!");
+      return false;
+   }
+   int elz[PROMOLDENS_MAXZ+1],zel[PROMOLDENS_MAXZ+1];
+   for ( int z=0 ; z<=PROMOLDENS_MAXZ ; z++ ) {elz[z]=-1;}
+   nEl=0;
+   for ( int i=0 ; i<nn ; i++ ) {
+      if ( zz[i]>PROMOLDENS_MAXZ ) {
+         displayErrorMessage("The promolecular density is not available for Z>"
+               +getStringFromInt(PROMOLDENS_MAXZ)+"!");
+         nEl=0;
+         return false;
+      }
+      if ( zz[i]>0 && elz[zz[i]]<0 ) {
+         elz[zz[i]]=nEl;
+         zel[nEl++]=zz[i];
+      }
+   }
+   nNuc=nn;
+   alloc1DRealArray(string("R"),3*nNuc,R);
+   alloc1DIntArray(string("atEl"),nNuc,atEl,0);
+   alloc1DRealArray(string("rCut2"),nNuc,rCut2);
+   alloc1DRealArray(string("idt"),((nEl>0)? nEl : 1),idt);
+   allocFlat2DRealArray(string("tab"),((nEl>0)? nEl : 1),3*PROMOLDENS_NGRIDPTS,tab,0.0e0);
+   /* The tables run from PROMOLDENS_RMIN to the radius where the density falls below
+      PROMOLDENS_RHOCUTOFF (the last such crossing, looking inwards from 60 bohr).  */
+   static const solreal t0=log(PROMOLDENS_RMIN);
+   solreal *rce,rc,t,dt;
+   alloc1DRealArray(string("rce"),((nEl>0)? nEl : 1),rce);
+   for ( int e=0 ; e<nEl ; e++ ) {
+      rc=60.0e0;
+      while ( rc>1.0e0 && evalAtomicDensity(zel[e],rc)<PROMOLDENS_RHOCUTOFF ) {
+         rc-=0.05e0;
+      }
+      rce[e]=rc;
+      dt=(log(rc)-t0)/solreal(PROMOLDENS_NGRIDPTS-1);
+      idt[e]=1.0e0/dt;
+      for ( int i=0 ; i<PROMOLDENS_NGRIDPTS ; i++ ) {
+         t=t0+solreal(i)*dt;
+         evalAtomicLogDensity(zel[e],exp(t),tab[e][3*i],tab[e][3*i+1],tab[e][3*i+2]);
+      }
+   }
+   for ( int i=0 ; i<nNuc ; i++ ) {
+      for ( int k=0 ; k<3 ; k++ ) {R[3*i+k]=rr[3*i+k];}
+      if ( zz[i]>0 ) {
+         atEl[i]=elz[zz[i]];
+         rCut2[i]=rce[atEl[i]]*rce[atEl[i]];
+      } else {
+         rCut2[i]=-1.0e0;
+      }
+   }
+   dealloc1DRealArray(rce);
+   imsetup=true;
+   return true;
+}
+/* ************************************************************************************ */
+solreal proMolDensity::getCutoffRadius(const int i)
+{
+   return ((rCut2[i]>0.0e0)? sqrt(rCut2[i]) : 0.0e0);
+}
+/* ************************************************************************************ */
+void proMolDensity::interpolate(const int e,const solreal r,const bool wantd,\
+      solreal &rho,solreal &rp,solreal &rpp)
+{
+   static const solreal t0=log(PROMOLDENS_RMIN);
+   const solreal rr=((r<PROMOLDENS_RMIN)? PROMOLDENS_RMIN : r);
+   solreal s=(log(rr)-t0)*idt[e];
+   int i=int(s);
+   if ( i>(PROMOLDENS_NGRIDPTS-2) ) {i=PROMOLDENS_NGRIDPTS-2;}
+   const solreal u=s-solreal(i),u2=u*u,u3=u2*u,u4=u3*u,u5=u4*u,h=1.0e0/idt[e];
+   const solreal *ga=&tab[e][3*i],*gb=&tab[e][3*i+3];
+   /* Quintic Hermite interpolation of g=ln(rho) (values, first and second derivatives
+      at both ends of the interval).  */
+   solreal g=(1.0e0-10.0e0*u3+15.0e0*u4-6.0e0*u5)*ga[0]\
+             +(u-6.0e0*u3+8.0e0*u4-3.0e0*u5)*h*ga[1]\
+             +0.5e0*(u2-3.0e0*u3+3.0e0*u4-u5)*h*h*ga[2]\
+             +0.5e0*(u3-2.0e0*u4+u5)*h*h*gb[2]\
+             +(-4.0e0*u3+7.0e0*u4-3.0e0*u5)*h*gb[1]\
+             +(10.0e0*u3-15.0e0*u4+6.0e0*u5)*gb[0];
+   rho=exp(g);
+   if ( !wantd ) {return;}
+   solreal gt=(-30.0e0*u2+60.0e0*u3-30.0e0*u4)*(ga[0]-gb[0])\
+              +(1.0e0-18.0e0*u2+32.0e0*u3-15.0e0*u4)*h*ga[1]\
+              +0.5e0*(2.0e0*u-9.0e0*u2+12.0e0*u3-5.0e0*u4)*h*h*ga[2]\
+              +0.5e0*(3.0e0*u2-8.0e0*u3+5.0e0*u4)*h*h*gb[2]\
+              +(-12.0e0*u2+28.0e0*u3-15.0e0*u4)*h*gb[1];
+   solreal gtt=(-60.0e0*u+180.0e0*u2-120.0e0*u3)*(ga[0]-gb[0])\
+               +(-36.0e0*u+96.0e0*u2-60.0e0*u3)*h*ga[1]\
+               +0.5e0*(2.0e0-18.0e0*u+36.0e0*u2-20.0e0*u3)*h*h*ga[2]\
+               +0.5e0*(6.0e0*u-24.0e0*u2+20.0e0*u3)*h*h*gb[2]\
+               +(-24.0e0*u+84.0e0*u2-60.0e0*u3)*h*gb[1];
+   gt*=idt[e];
+   gtt*=(idt[e]*idt[e]);
+   /* d(rho)/dr=rho g_t/r, d2(rho)/dr2=rho(g_t^2+g_tt-g_t)/r^2  */
+   rp=rho*gt/rr;
+   rpp=rho*(gt*gt+gtt-gt)/(rr*rr);
+}
+/* ************************************************************************************ */
+solreal proMolDensity::evalDensity(solreal x,solreal y,solreal z)
+{
+   solreal rho=0.0e0,dx,dy,dz,d2,ra,rp,rpp;
+   for ( int i=0 ; i<nNuc ; i++ ) {
+      dx=x-R[3*i];
+      dy=y-R[3*i+1];
+      dz=z-R[3*i+2];
+      d2=dx*dx+dy*dy+dz*dz;
+      if ( d2>=rCut2[i] ) {continue;}
+      interpolate(atEl[i],sqrt(d2),false,ra,rp,rpp);
+      rho+=ra;
+   }
+   return rho;
+}
+/* ************************************************************************************ */
+void proMolDensity::evalRhoGradRho(solreal x,solreal y,solreal z,solreal &rho,\
+      solreal (&g)[3])
+{
+   solreal d[3],d2,r,ra,rp,rpp;
+   rho=g[0]=g[1]=g[2]=0.0e0;
+   for ( int i=0 ; i<nNuc ; i++ ) {
+      d[0]=x-R[3*i];
+      d[1]=y-R[3*i+1];
+      d[2]=z-R[3*i+2];
+      d2=d[0]*d[0]+d[1]*d[1]+d[2]*d[2];
+      if ( d2>=rCut2[i] ) {continue;}
+      r=sqrt(d2);
+      interpolate(atEl[i],r,true,ra,rp,rpp);
+      rho+=ra;
+      /* Below PROMOLDENS_RMIN the radial derivative is taken as linear in r.  */
+      rp/=((r<PROMOLDENS_RMIN)? PROMOLDENS_RMIN : r);
+      for ( int k=0 ; k<3 ; k++ ) {g[k]+=rp*d[k];}
+   }
+}
+/* ************************************************************************************ */
+void proMolDensity::evalHessian(solreal x,solreal y,solreal z,solreal &rho,\
+      solreal (&g)[3],solreal (&h)[3][3])
+{
+   solreal d[3],d2,r,ra,rp,rpp,cc;
+   rho=0.0e0;
+   for ( int k=0 ; k<3 ; k++ ) {
+      g[k]=0.0e0;
+      for ( int l=0 ; l<3 ; l++ ) {h[k][l]=0.0e0;}
+   }
+   for ( int i=0 ; i<nNuc ; i++ ) {
+      d[0]=x-R[3*i];
+      d[1]=y-R[3*i+1];
+      d[2]=z-R[3*i+2];
+      d2=d[0]*d[0]+d[1]*d[1]+d[2]*d[2];
+      if ( d2>=rCut2[i] ) {continue;}
+      r=sqrt(d2);
+      interpolate(atEl[i],r,true,ra,rp,rpp);
+      rho+=ra;
+      if ( r<PROMOLDENS_RMIN ) {
+         rp/=PROMOLDENS_RMIN;
+         for ( int k=0 ; k<3 ; k++ ) {
+            g[k]+=rp*d[k];
+            h[k][k]+=rp;
+         }
+         continue;
+      }
+      /* H=rho'' d d^T/r^2 + (rho'/r)(I - d d^T/r^2)  */
+      rp/=r;
+      cc=(rpp-rp)/d2;
+      for ( int k=0 ; k<3 ; k++ ) {
+         g[k]+=rp*d[k];
+         h[k][k]+=rp;
+         for ( int l=0 ; l<3 ; l++ ) {h[k][l]+=cc*d[k]*d[l];}
+      }
+   }
+}
+/* ************************************************************************************ */
+solreal proMolDensity::evalLapRho(solreal x,solreal y,solreal z)
+{
+   solreal dx,dy,dz,d2,r,ra,rp,rpp,lap=0.0e0;
+   for ( int i=0 ; i<nNuc ; i++ ) {
+      dx=x-R[3*i];
+      dy=y-R[3*i+1];
+      dz=z-R[3*i+2];
+      d2=dx*dx+dy*dy+dz*dz;
+      if ( d2>=rCut2[i] ) {continue;}
+      r=sqrt(d2);
+      interpolate(atEl[i],r,true,ra,rp,rpp);
+      /* The Laplacian of a spherical function is rho''+2rho'/r.  */
+      lap+=((r<PROMOLDENS_RMIN)? (3.0e0*rp/PROMOLDENS_RMIN) : (rpp+2.0e0*rp/r));
+   }
+   return lap;
+}
+/* ************************************************************************************ */
+#endif//_PROMOLDENSITY_CPP_
+
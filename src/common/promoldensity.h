@@ -0,0 +1,154 @@
+/*
+ *                    This source code is part of
+ *
+ *                  D  E  N  S  T  O  O  L  K  I  T
+ *
+ *                         VERSION: 1.2.0
+ *
+ *             Contributors: Juan Manuel Solano-Altamirano
+ *                           Julio Manuel Hernandez-Perez
+ *        Copyright (c) 2013-2015, Juan Manuel Solano-Altamirano
+ *                                 <jmsolanoalt@gmail.com>
+ *
+ * -------------------------------------------------------------------
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * ---------------------------------------------------------------------
+ *
+ * If you want to redistribute modifications of the suite, please
+ * consider to include your modifications in our official release.
+ * We will be pleased to consider the inclusion of your code
+ * within the official distribution. Please keep in mind that
+ * scientific software is very special, and version control is 
+ * crucial for tracing bugs. If in despite of this you distribute
+ * your modified version, please do not call it DensToolKit.
+ *
+ * If you find DensToolKit useful, we humbly ask that you cite
+ * the paper(s) on the package --- you can find them on the top
+ * README file.
+ *
+ */
+
+
+/*
+   promoldensity.h
+
+   The class proMolDensity evaluates the promolecular density, i.e., the sum of
+   spherical (isolated, neutral) atomic densities placed at the nuclei of a molecule,
+   together with its analytic gradient and Hessian. The promolecular density is a cheap
+   approximation to the molecular density; it has the same nuclear maxima and, for most
+   molecules, the same topology, hence it can be used as a fast approximate mode of the
+   density-derived fields (density, gradient, Laplacian and reduced density gradient),
+   or for seeding and culling before the evaluations of the actual wave function.
+
+   The atomic densities are built from Slater-type shells whose exponents are given by
+   Slater's rules (with the aufbau occupations), rho(r)=sum_s N_s R_s(r)^2/(4pi), and
+   they are tabulated as g=ln(rho) on a uniform grid of t=ln(r). The table stores g and
+   its first two derivatives, and it is interpolated with quintic Hermite polynomials;
+   thus the interpolant is twice continuously differentiable and the gradient and
+   Hessian of the density are consistent with the density itself. Beyond the radius
+   where the atomic density falls below PROMOLDENS_RHOCUTOFF the contribution of an
+   atom is neglected (this is what makes the evaluation cheap for large molecules).
+ */
+
+#ifndef _PROMOLDENSITY_H_
+#define _PROMOLDENSITY_H_
+
+#ifndef _HAVE_DEF_SOLREAL_TYPE_
+#define _HAVE_DEF_SOLREAL_TYPE_
+typedef double solreal;
+#endif
+
+/* The number of points of the radial tables.  */
+#ifndef PROMOLDENS_NGRIDPTS
+#define PROMOLDENS_NGRIDPTS (600)
+#endif
+/* The smallest radius of the tables; below it the atomic density is taken as
+   constant.  */
+#ifndef PROMOLDENS_RMIN
+#define PROMOLDENS_RMIN (1.0e-04)
+#endif
+/* The atomic densities are neglected when they are smaller than this value.  */
+#ifndef PROMOLDENS_RHOCUTOFF
+#define PROMOLDENS_RHOCUTOFF (1.0e-12)
+#endif
+/* The largest atomic number supported.  */
+#ifndef PROMOLDENS_MAXZ
+#define PROMOLDENS_MAXZ (103)
+#endif
+
+/* ************************************************************************************ */
+class proMolDensity {
+/* ************************************************************************************ */
+public:
+/* ************************************************************************************ */
+   proMolDensity();
+   ~proMolDensity();
+/* ************************************************************************************ */
+   /** Builds the promolecular density of the nn nuclei whose coordinates are
+    * rr[3*i+k] and whose atomic numbers are zz[i] (Z, not Z-1). The coordinates are
+    * copied.  */
+   bool setUp(const int nn,const solreal *rr,const int *zz);
+   bool isSetUp(void) {return imsetup;}
+/* ************************************************************************************ */
+   /** Returns the promolecular density at (x,y,z).  */
+   solreal evalDensity(solreal x,solreal y,solreal z);
+   /** Computes the promolecular density and its gradient at (x,y,z).  */
+   void evalRhoGradRho(solreal x,solreal y,solreal z,solreal &rho,solreal (&g)[3]);
+   /** Computes the promolecular density, its gradient and its Hessian at (x,y,z).  */
+   void evalHessian(solreal x,solreal y,solreal z,solreal &rho,solreal (&g)[3],\
+         solreal (&h)[3][3]);
+   /** Returns the Laplacian of the promolecular density at (x,y,z).  */
+   solreal evalLapRho(solreal x,solreal y,solreal z);
+/* ************************************************************************************ */
+   /** Returns the radius (in bohr) beyond which the density of the i-th atom is
+    * neglected.  */
+   solreal getCutoffRadius(const int i);
+   /** Returns the density of the isolated atom of atomic number z at the distance r,
+    * computed analytically (not interpolated).  */
+   static solreal evalAtomicDensity(const int z,const solreal r);
+/* ************************************************************************************ */
+protected:
+/* ************************************************************************************ */
+   bool imsetup;
+   int nNuc,nEl;
+   solreal *R; /*!< The coordinates of the nuclei, R[3*i+k].  */
+   int *atEl; /*!< atEl[i] is the index (to the tables) of the element of the i-th atom.  */
+   solreal *rCut2; /*!< The square of the cutoff radius of every atom (negative for the
+                        atoms without density, e.g. ghost atoms).  */
+   solreal *idt; /*!< The inverse of the step (in t=ln(r)) of the table of every element.  */
+   solreal **tab; /*!< tab[e][3*i+d] is the d-th derivative of ln(rho) of the e-th element
+                       at the i-th point of the table.  */
+/* ************************************************************************************ */
+   /** Computes the Slater-type shells of the neutral atom of atomic number z: ns shells,
+    * the s-th one with occupation ne[s], effective principal quantum number nst[s] and
+    * exponent zet[s].  */
+   static void getSlaterShells(const int z,int &ns,int (&ne)[20],solreal (&nst)[20],\
+         solreal (&zet)[20]);
+   /** Computes ln(rho) and its first two derivatives with respect to t=ln(r) of the
+    * atom of atomic number z, analytically.  */
+   static void evalAtomicLogDensity(const int z,const solreal r,solreal &g,solreal &gt,\
+         solreal &gtt);
+   /** Interpolates the table of the element e at the distance r, and returns the atomic
+    * density (rho) and its first (rp) and second (rpp) radial derivatives. If wantd is
+    * false, only rho is computed.  */
+   void interpolate(const int e,const solreal r,const bool wantd,solreal &rho,\
+         solreal &rp,solreal &rpp);
+   void destroy(void);
+/* ************************************************************************************ */
+};
+/* ************************************************************************************ */
+#endif//_PROMOLDENSITY_H_
+
@@ -0,0 +1,245 @@
+/*
+ *                    This source code is part of
+ *
+ *                  D  E  N  S  T  O  O  L  K  I  T
+ *
+ *                         VERSION: 1.2.0
+ *
+ *             Contributors: Juan Manuel Solano-Altamirano
+ *                           Julio Manuel Hernandez-Perez
+ *        Copyright (c) 2013-2015, Juan Manuel Solano-Altamirano
+ *                                 <jmsolanoalt@gmail.com>
+ *
+ * -------------------------------------------------------------------
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * ---------------------------------------------------------------------
+ *
+ * If you want to redistribute modifications of the suite, please
+ * consider to include your modifications in our official release.
+ * We will be pleased to consider the inclusion of your code
+ * within the official distribution. Please keep in mind that
+ * scientific software is very special, and version control is 
+ * crucial for tracing bugs. If in despite of this you distribute
+ * your modified version, please do not call it DensToolKit.
+ *
+ * If you find DensToolKit useful, we humbly ask that you cite
+ * the paper(s) on the package --- you can find them on the top
+ * README file.
+ *
+ */
+
+
+
+#ifndef _SOL_BATCH_TOOLS_CPP_
+#define _SOL_BATCH_TOOLS_CPP_
+
+#include "solbatchtools.h"
+#include "solmemhand.h"
+#include "solscrutils.h"
+#include "iofuncts-wfx.h"
+#include "iofuncts-wfn.h"
+#include <fstream>
+using std::ifstream;
+using std::ofstream;
+#include <iomanip>
+using std::setw;
+#include <ctime>
+#include <cstdio>
+#if PARALLELISEDTK
+#include <omp.h>
+#include <thread>
+#include <chrono>
+#endif
+using std::cout;
+using std::endl;
+
+/* ******************************************************************************************* */
+int readBatchList(const string &lstnam,string* &wfnam)
+{
+   ifstream lfil(lstnam.c_str());
+   if ( !lfil.good() ) {return 0;}
+   string line;
+   int nwf=0;
+   size_t pos;
+   //The first pass counts the names, the second one stores them.
+   for ( int pass=0 ; pass<2 ; pass++ ) {
+      if ( pass==1 ) {
+         if ( nwf==0 ) {break;}
+         alloc1DStringArray(string("wfnam"),nwf,wfnam);
+         lfil.clear();
+         lfil.seekg(0,lfil.beg);
+         nwf=0;
+      }
+      while ( getline(lfil,line) ) {
+         pos=line.find_first_not_of(" \t\r");
+         if ( pos==string::npos || line[pos]=='#' ) {continue;}
+         if ( pass==1 ) {
+            line.erase(0,pos);
+            line.erase(line.find_last_not_of(" \t\r")+1);
+            wfnam[nwf]=line;
+         }
+         ++nwf;
+      }
+   }
+   lfil.close();
+   return nwf;
+}
+/* ******************************************************************************************* */
+solreal estimateWaveFunctionMemory(const string &wfnam)
+{
+   ifstream ifil(wfnam.c_str());
+   if ( !ifil.good() || wfnam.length()<4 ) {return -1.0e0;}
+   string ext=wfnam.substr(wfnam.length()-3,3);
+   int npr=0,nmo=0,nnu=0;
+   if ( (ext=="wfn")||(ext=="WFN") ) {
+      string *tit=NULL,orbdesc;
+      processFirstDataStringinWFNFile(ifil,tit,orbdesc,nmo,npr,nnu);
+      dealloc1DStringArray(tit);
+   } else if ( (ext=="wfx")||(ext=="WFX") ) {
+      getNofPrimFromFileWFX(ifil,npr);
+      getNofMolOrbFromFileWFX(ifil,nmo);
+   } else if ( ext=="tkb" ) {
+      //The binary cache holds the same data as the text file, but cab.
+      ifil.seekg(0,ifil.end);
+      solreal mb=solreal(ifil.tellg())/1048576.0e0;
+      ifil.close();
+      return (2.0e0*mb+1.0e0);
+   } else {
+      ifil.close();
+      return -1.0e0;
+   }
+   ifil.close();
+   solreal np=solreal(npr);
+   return (8.0e0*np*(solreal(nmo)+np+16.0e0)/1048576.0e0+1.0e0);
+}
+/* ******************************************************************************************* */
+string mkBatchSummaryFileName(const string &lstnam,const string &lbl)
+{
+   string sumnam=lstnam;
+   size_t pos=sumnam.find_last_of('.');
+   if ( (pos!=string::npos)&&(sumnam.find_first_of('/',pos)==string::npos) ) {
+      sumnam.erase(pos);
+   }
+   sumnam+=(string("-")+lbl+string("Batch.log"));
+   return sumnam;
+}
+/* ******************************************************************************************* */
+solreal getBatchMemoryBudget(char ** (&argv),const int pos)
+{
+   if ( pos==0 ) {return SOLBATCH_DEFAULTMEMBUDGETMB;}
+   string str=argv[pos];
+   size_t eqpos=str.find_first_of('=');
+   double mb=0.0e0;
+   if ( (eqpos==string::npos)||(sscanf(str.substr(eqpos+1).c_str(),"%lf",&mb)!=1)||(mb<=0.0e0) ) {
+      displayWarningMessage(string("Wrong memory budget (")+str+string("), using the default."));
+      return SOLBATCH_DEFAULTMEMBUDGETMB;
+   }
+   return solreal(mb);
+}
+/* ******************************************************************************************* */
+int runBatchJobs(const int njobs,string* &wfnam,batchJobFunction job,void *ctx,\
+      const solreal membudget,const string &sumnam,const bool verbose)
+{
+   if ( njobs<1 ) {return 0;}
+   solreal *mem,*wtim;
+   int *stat;
+   string *info;
+   alloc1DRealArray(string("mem"),njobs,mem);
+   alloc1DRealArray(string("wtim"),njobs,wtim);
+   alloc1DIntArray(string("stat"),njobs,stat,0);
+   alloc1DStringArray(string("info"),njobs,info);
+   solreal totmem=0.0e0;
+   for ( int i=0 ; i<njobs ; i++ ) {
+      mem[i]=estimateWaveFunctionMemory(wfnam[i]);
+      if ( mem[i]>totmem ) {totmem=mem[i];}
+   }
+   cout << "Running " << njobs << " jobs (largest memory estimate: " << totmem
+        << " MB, memory budget: " << membudget << " MB)..." << endl;
+   std::ostream scr(cout.rdbuf());
+   std::streambuf *coutbuf=cout.rdbuf();
+   std::ios coutfmt(NULL);
+   coutfmt.copyfmt(cout);
+   if ( !verbose ) {cout.rdbuf(NULL);}
+   int ndone=0,nfail=0;
+#if PARALLELISEDTK
+   solreal inuse=0.0e0;
+#pragma omp parallel for schedule(dynamic,1)
+#endif
+   for ( int i=0 ; i<njobs ; i++ ) {
+      if ( mem[i]<0.0e0 ) {
+         info[i]="Not a readable wave function file.";
+         stat[i]=-1;
+      } else {
+#if PARALLELISEDTK
+         bool canrun=false;
+         while ( !canrun ) {
+#pragma omp critical(batchmemory)
+            {
+               if ( (inuse<=0.0e0)||((inuse+mem[i])<=membudget) ) {
+                  inuse+=mem[i];
+                  canrun=true;
+               }
+            }
+            if ( !canrun ) {std::this_thread::sleep_for(std::chrono::milliseconds(10));}
+         }
+         solreal tini=omp_get_wtime();
+         stat[i]=(job(wfnam[i],ctx,info[i])? 1 : -1);
+         wtim[i]=omp_get_wtime()-tini;
+#pragma omp critical(batchmemory)
+         inuse-=mem[i];
+#else
+         clock_t tini=clock();
+         stat[i]=(job(wfnam[i],ctx,info[i])? 1 : -1);
+         wtim[i]=solreal(clock()-tini)/CLOCKS_PER_SEC;
+#endif
+      }
+#if PARALLELISEDTK
+#pragma omp critical(batchscreen)
+#endif
+      {
+         ++ndone;
+         if ( stat[i]<0 ) {++nfail;}
+         scr << "[" << ndone << "/" << njobs << "] " << wfnam[i]
+             << ((stat[i]>0)? " done (" : " FAILED (") << wtim[i] << "s)" << endl;
+      }
+   }
+   if ( !verbose ) {
+      cout.rdbuf(coutbuf);
+      cout.clear();
+   }
+   cout.copyfmt(coutfmt);
+   ofstream sfil(sumnam.c_str());
+   sfil << "#Job  Status   Wall(s)   Mem(MB)  WaveFunction  Info" << endl;
+   sfil << std::fixed;
+   for ( int i=0 ; i<njobs ; i++ ) {
+      sfil << setw(4) << i << "  " << ((stat[i]>0)? "done  " : "FAILED") << " "
+           << std::setprecision(3) << setw(9) << wtim[i] << " " << setw(9) << mem[i]
+           << "  " << wfnam[i] << "  " << info[i] << endl;
+   }
+   sfil << "#Jobs: " << njobs << ", failed: " << nfail << endl;
+   sfil.close();
+   cout << "Jobs: " << njobs << ", failed: " << nfail << endl;
+   cout << "Summary written in file: " << sumnam << endl;
+   dealloc1DStringArray(info);
+   dealloc1DIntArray(stat);
+   dealloc1DRealArray(wtim);
+   dealloc1DRealArray(mem);
+   return nfail;
+}
+/* ******************************************************************************************* */
+
+#endif /* _SOL_BATCH_TOOLS_CPP_ */
+
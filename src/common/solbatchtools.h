@@ -0,0 +1,107 @@
+/*
+ *                    This source code is part of
+ *
+ *                  D  E  N  S  T  O  O  L  K  I  T
+ *
+ *                         VERSION: 1.2.0
+ *
+ *             Contributors: Juan Manuel Solano-Altamirano
+ *                           Julio Manuel Hernandez-Perez
+ *        Copyright (c) 2013-2015, Juan Manuel Solano-Altamirano
+ *                                 <jmsolanoalt@gmail.com>
+ *
+ * -------------------------------------------------------------------
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * ---------------------------------------------------------------------
+ *
+ * If you want to redistribute modifications of the suite, please
+ * consider to include your modifications in our official release.
+ * We will be pleased to consider the inclusion of your code
+ * within the official distribution. Please keep in mind that
+ * scientific software is very special, and version control is 
+ * crucial for tracing bugs. If in despite of this you distribute
+ * your modified version, please do not call it DensToolKit.
+ *
+ * If you find DensToolKit useful, we humbly ask that you cite
+ * the paper(s) on the package --- you can find them on the top
+ * README file.
+ *
+ */
+
+
+
+#ifndef _SOL_BATCH_TOOLS_H_
+#define _SOL_BATCH_TOOLS_H_
+
+#include <iostream>
+#include <string>
+using std::string;
+
+#ifndef SOLBATCH_DEFAULTMEMBUDGETMB
+#define SOLBATCH_DEFAULTMEMBUDGETMB (4096.0e0)
+#endif
+
+/* ******************************************************************************************* */
+typedef bool (*batchJobFunction)(string &wfnam,void *ctx,string &info);
+/*
+   A batch job processes the wave function file wfnam, writing its own output files.
+   ctx points to the data the program needs (options, etc.), and info is a short line
+   that will be shown in the summary table. It returns false if the job failed.
+   Jobs may run concurrently, hence they must not write to shared data.
+ */
+/* ******************************************************************************************* */
+int readBatchList(const string &lstnam,string* &wfnam);
+/*
+   Reads the names of the wave function files (one per line; empty lines and lines
+   starting with '#' are skipped) of the list lstnam. wfnam is allocated here.
+   Returns the number of names (0 if the file could not be read).
+ */
+/* ******************************************************************************************* */
+solreal estimateWaveFunctionMemory(const string &wfnam);
+/*
+   Returns an estimate (in MB) of the memory used by a GaussWaveFunction loaded from wfnam
+   (dominated by the MO coefficients and the matrix cab). Only the header of the file is
+   read. Returns a negative number if wfnam is not a readable wfn/wfx/dtkb file.
+ */
+/* ******************************************************************************************* */
+string mkBatchSummaryFileName(const string &lstnam,const string &lbl);
+/*
+   Returns the name of the summary file of a batch: the list name lstnam (without
+   extension), followed by "-", lbl and "Batch.log".
+ */
+/* ******************************************************************************************* */
+solreal getBatchMemoryBudget(char ** (&argv),const int pos);
+/*
+   Returns the memory budget (MB) given in the option "--batch-mem=MB", which is argv[pos].
+   If pos is 0, returns SOLBATCH_DEFAULTMEMBUDGETMB.
+ */
+/* ******************************************************************************************* */
+int runBatchJobs(const int njobs,string* &wfnam,batchJobFunction job,void *ctx,\
+      const solreal membudget,const string &sumnam,const bool verbose);
+/*
+   Runs job for each one of the njobs files wfnam[i]. If PARALLELISEDTK is on, the jobs
+   are taken by the threads from a shared queue (dynamic scheduling); a job waits
+   until the sum of the estimated memories (see estimateWaveFunctionMemory) of the
+   running jobs plus its own is not larger than membudget (MB) --a job is always
+   started if nothing else is running. Unless verbose is true, the screen output of the
+   jobs is discarded, and only one line per job is printed. A summary table (status,
+   wall-clock time, memory estimate and info of every job) is written to sumnam.
+   Returns the number of failed jobs.
+ */
+/* ******************************************************************************************* */
+
+#endif /* _SOL_BATCH_TOOLS_H_ */
+
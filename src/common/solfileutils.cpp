@@ -110,7 +110,15 @@
 # define MAX_ROWS (3000)
 # define MAX_COLS (3000)
 #include <cstdlib>
+#include <cstring>
 #include <string>
+#if (defined(__APPLE__)||defined(__linux__)||defined(__CYGWIN__))
+#define SOL_HAVE_MMAP 1
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
 
 
 /* ******************************************************************************************* */
@@ -563,6 +571,92 @@ int countColumnsInFile(string fnam)
    return numtabs;
 }
 /* ******************************************************************************************* */
+bool mapFileToMemory(const string &fnam,char* &buf,size_t &len,bool &ismapped)
+{
+   buf=NULL;
+   len=0;
+   ismapped=false;
+#ifdef SOL_HAVE_MMAP
+   int fd=open(fnam.c_str(),O_RDONLY);
+   if ( fd<0 ) {return false;}
+   struct stat st;
+   if ( (fstat(fd,&st)!=0)||(st.st_size<=0) ) {
+      close(fd);
+      return false;
+   }
+   len=size_t(st.st_size);
+   void *addr=mmap(NULL,len,PROT_READ,MAP_PRIVATE,fd,0);
+   close(fd);
+   if ( addr!=MAP_FAILED ) {
+#ifdef MADV_SEQUENTIAL
+      madvise(addr,len,MADV_SEQUENTIAL);
+#endif
+      buf=static_cast<char*>(addr);
+      ismapped=true;
+      return true;
+   }
+   len=0;
+#endif
+   ifstream ifil(fnam.c_str(),std::ios::in|std::ios::binary);
+   if ( !ifil.good() ) {return false;}
+   ifil.seekg(0,std::ios::end);
+   std::streamoff sz=ifil.tellg();
+   if ( sz<=0 ) {return false;}
+   ifil.seekg(0,std::ios::beg);
+   len=size_t(sz);
+   buf=new char[len];
+   ifil.read(buf,sz);
+   ifil.close();
+   return true;
+}
+/* ******************************************************************************************* */
+void unmapFileFromMemory(char* &buf,size_t &len,const bool ismapped)
+{
+   if ( buf==NULL ) {return;}
+#ifdef SOL_HAVE_MMAP
+   if ( ismapped ) {
+      munmap(buf,len);
+   } else {
+      delete[] buf;
+   }
+#else
+   delete[] buf;
+#endif
+   buf=NULL;
+   len=0;
+}
+/* ******************************************************************************************* */
+unsigned long long getBufferChecksum(const char* buf,const size_t len)
+{
+   const unsigned long long fnvprime=1099511628211ULL;
+   unsigned long long h=14695981039346656037ULL,w;
+   size_t nw=len/8,i;
+   for ( i=0 ; i<nw ; ++i ) {
+      memcpy(&w,buf+8*i,8);
+      h^=w;
+      h*=fnvprime;
+      h^=(h>>29);
+   }
+   for ( i=8*nw ; i<len ; ++i ) {
+      h^=(unsigned long long)((unsigned char)buf[i]);
+      h*=fnvprime;
+   }
+   h^=(unsigned long long)len;
+   h*=fnvprime;
+   return h;
+}
+/* ******************************************************************************************* */
+bool getFileChecksum(const string &fnam,unsigned long long &chk,size_t &len)
+{
+   char *buf;
+   bool ismapped;
+   if ( !mapFileToMemory(fnam,buf,len,ismapped) ) {return false;}
+   chk=getBufferChecksum(buf,len);
+   size_t tmplen=len;
+   unmapFileFromMemory(buf,tmplen,ismapped);
+   return true;
+}
+/* ******************************************************************************************* */
 /* ******************************************************************************************* */
 /* ******************************************************************************************* */
 /* ******************************************************************************************* */
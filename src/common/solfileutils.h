@@ -174,6 +174,21 @@ void genRandomTmpFileName(string &s, const int len);
 /* ******************************************************************************************* */
 int countColumnsInFile(string fnam);
 /* ******************************************************************************************* */
+bool mapFileToMemory(const string &fnam,char* &buf,size_t &len,bool &ismapped);
+/* Makes the whole content of the file fnam available (read only) in buf[0..len-1].
+   Whenever possible, the file is memory-mapped (ismapped=true); otherwise the file
+   is read into a heap buffer (ismapped=false). buf must be released with
+   unmapFileFromMemory. Returns false if the file could not be opened or is empty. */
+/* ******************************************************************************************* */
+void unmapFileFromMemory(char* &buf,size_t &len,const bool ismapped);
+/* ******************************************************************************************* */
+unsigned long long getBufferChecksum(const char* buf,const size_t len);
+/* 64-bit FNV-1a-like hash of buf[0..len-1], processed in 8-byte words. It is meant to detect
+   changes in a file (e.g. to validate caches), not as a cryptographic digest. */
+/* ******************************************************************************************* */
+bool getFileChecksum(const string &fnam,unsigned long long &chk,size_t &len);
+/* Checksum (see getBufferChecksum) and size of the file fnam. */
+/* ******************************************************************************************* */
 /* ******************************************************************************************* */
 /* ******************************************************************************************* */
 /* ******************************************************************************************* */
@@ -116,21 +116,22 @@ inline void sort2intmin2max(int &a,int&b)
 solreal rfactorial(const int n)
 {
    static const int RFNMAX=121;
-   static solreal rf[RFNMAX];
-   static bool initme=true;
-   if (initme) {
-      std::cout << "Init rf array..." << std::endl;
-      initme=false;
-      rf[0]=1.0e0;
-      for (int i=1; i<RFNMAX; i++) {rf[i]=solreal(i)*rf[i-1];}
-   }
+   //The initialisation of a function-local static is thread-safe (C++11).
+   static const struct rfTable {
+      solreal v[RFNMAX];
+      rfTable() {
+         std::cout << "Init rf array..." << std::endl;
+         v[0]=1.0e0;
+         for (int i=1; i<RFNMAX; i++) {v[i]=solreal(i)*v[i-1];}
+      }
+   } rf;
 #if _SOL_USE_SAFE_CHECKS_
    if ((n<0)||(n>(RFNMAX-1))) {
       std::cout << "Error: requested a factorial value out of range..." << std::endl;
       return 1.0e0;
    }
 #endif
-   return rf[n];
+   return rf.v[n];
 }
 /* ************************************************************************** */
 solreal BoysFunction(const int m,solreal x)
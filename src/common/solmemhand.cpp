@@ -458,5 +458,213 @@ bool appendTo1DRealArray(string ptrname,const int n,solreal* &thptr,solreal then
    return res;
 }
 /* ************************************************************************************** */
+bool resize1DRealArray(string ptrname,const int n,const int newn,solreal* &thptr,\
+      const solreal inval)
+{
+   solreal *tmpptr;
+   bool res=alloc1DRealArray("tmpptr",newn,tmpptr,inval);
+   if ( res ) {
+      if ( thptr!=NULL ) {memcpy( tmpptr, thptr, ((n<newn)? n : newn) * sizeof(solreal) );}
+      dealloc1DRealArray(thptr);
+      thptr=tmpptr;
+   } else {
+      std::cout << "Error: something went wrong while trying to resize"
+         << std::endl << "the array " << ptrname << std::endl;
+   }
+   return res;
+}
+/* ************************************************************************************** */
+bool resize1DIntArray(string ptrname,const int n,const int newn,int* &thptr,const int inval)
+{
+   int *tmpptr;
+   bool res=alloc1DIntArray("tmpptr",newn,tmpptr,inval);
+   if ( res ) {
+      if ( thptr!=NULL ) {memcpy( tmpptr, thptr, ((n<newn)? n : newn) * sizeof(int) );}
+      dealloc1DIntArray(thptr);
+      thptr=tmpptr;
+   } else {
+      std::cout << "Error: something went wrong while trying to resize"
+         << std::endl << "the array " << ptrname << std::endl;
+   }
+   return res;
+}
+/* ************************************************************************************** */
+bool resize1DStringArray(string ptrname,const int n,const int newn,string* &thptr)
+{
+   string *tmpptr;
+   bool res=alloc1DStringArray("tmpptr",newn,tmpptr);
+   if ( res ) {
+      if ( thptr!=NULL ) {
+         for ( int i=0 ; i<((n<newn)? n : newn) ; ++i ) {tmpptr[i].swap(thptr[i]);}
+      }
+      dealloc1DStringArray(thptr);
+      thptr=tmpptr;
+   } else {
+      std::cout << "Error: something went wrong while trying to resize"
+         << std::endl << "the array " << ptrname << std::endl;
+   }
+   return res;
+}
+/* ************************************************************************************** */
+bool allocFlat2DRealArray(string ptrname,const int rows,const int cols,solreal** &thptr,\
+      const solreal inval)
+{
+   int nr=((rows>0)? rows : 1);
+   solreal *blk;
+   if (!(blk=new solreal[nr*cols])) {
+      std::cout << "Warning: cannot allocate "<< ptrname <<", in allocFlat2DRealArray(...) function.\n";
+      std::cout << __FILE__ << "" << __LINE__ << std::endl;
+      thptr=NULL;
+      return false;
+   }
+   if (!(thptr=new solreal*[nr])) {
+      std::cout << "Warning: cannot allocate "<< ptrname <<", in allocFlat2DRealArray(...) function.\n";
+      std::cout << __FILE__ << "" << __LINE__ << std::endl;
+      delete[] blk;
+      return false;
+   }
+   for ( int i=0 ; i<nr ; ++i ) {thptr[i]=blk+(i*cols);}
+   for ( int i=0 ; i<(nr*cols) ; ++i ) {blk[i]=inval;}
+   return true;
+}
+/* ************************************************************************************** */
+bool deallocFlat2DRealArray(solreal** &tp)
+{
+   if (tp!=NULL) {
+      delete[] tp[0];
+      delete[] tp;
+      tp=NULL;
+      return true;
+   } else {
+      return false;
+   }
+}
+/* ************************************************************************************** */
+bool resizeFlat2DRealArray(string ptrname,const int rows,const int newrows,const int cols,\
+      solreal** &thptr,const solreal inval)
+{
+   solreal **tmpptr;
+   bool res=allocFlat2DRealArray(ptrname,newrows,cols,tmpptr,inval);
+   if ( res ) {
+      if ( thptr!=NULL ) {
+         memcpy(tmpptr[0],thptr[0],((rows<newrows)? rows : newrows)*cols*sizeof(solreal));
+      }
+      deallocFlat2DRealArray(thptr);
+      thptr=tmpptr;
+   } else {
+      std::cout << "Error: something went wrong while trying to resize"
+         << std::endl << "the array " << ptrname << std::endl;
+   }
+   return res;
+}
+/* ************************************************************************************** */
+bool allocFlat2DIntArray(string ptrname,const int rows,const int cols,int** &thptr,\
+      const int inval)
+{
+   int nr=((rows>0)? rows : 1);
+   int *blk;
+   if (!(blk=new int[nr*cols])) {
+      std::cout << "Warning: cannot allocate "<< ptrname <<", in allocFlat2DIntArray(...) function.\n";
+      std::cout << __FILE__ << "" << __LINE__ << std::endl;
+      thptr=NULL;
+      return false;
+   }
+   if (!(thptr=new int*[nr])) {
+      std::cout << "Warning: cannot allocate "<< ptrname <<", in allocFlat2DIntArray(...) function.\n";
+      std::cout << __FILE__ << "" << __LINE__ << std::endl;
+      delete[] blk;
+      return false;
+   }
+   for ( int i=0 ; i<nr ; ++i ) {thptr[i]=blk+(i*cols);}
+   for ( int i=0 ; i<(nr*cols) ; ++i ) {blk[i]=inval;}
+   return true;
+}
+/* ************************************************************************************** */
+bool deallocFlat2DIntArray(int** &tp)
+{
+   if (tp!=NULL) {
+      delete[] tp[0];
+      delete[] tp;
+      tp=NULL;
+      return true;
+   } else {
+      return false;
+   }
+}
+/* ************************************************************************************** */
+bool resizeFlat2DIntArray(string ptrname,const int rows,const int newrows,const int cols,\
+      int** &thptr,const int inval)
+{
+   int **tmpptr;
+   bool res=allocFlat2DIntArray(ptrname,newrows,cols,tmpptr,inval);
+   if ( res ) {
+      if ( thptr!=NULL ) {
+         memcpy(tmpptr[0],thptr[0],((rows<newrows)? rows : newrows)*cols*sizeof(int));
+      }
+      deallocFlat2DIntArray(thptr);
+      thptr=tmpptr;
+   } else {
+      std::cout << "Error: something went wrong while trying to resize"
+         << std::endl << "the array " << ptrname << std::endl;
+   }
+   return res;
+}
+/* ************************************************************************************** */
+bool allocFlat3DIntArray(string ptrname,const int idx1,const int idx2,const int idx3,\
+      int*** &thptr,const int inval)
+{
+   int n1=((idx1>0)? idx1 : 1);
+   int **rows;
+   if (!allocFlat2DIntArray(ptrname,n1*idx2,idx3,rows,inval)) {
+      thptr=NULL;
+      return false;
+   }
+   if (!(thptr=new int**[n1])) {
+      std::cout << "Warning: cannot allocate "<< ptrname <<", in allocFlat3DIntArray(...) function.\n";
+      std::cout << __FILE__ << "" << __LINE__ << std::endl;
+      deallocFlat2DIntArray(rows);
+      return false;
+   }
+   for ( int i=0 ; i<n1 ; ++i ) {thptr[i]=rows+(i*idx2);}
+   return true;
+}
+/* ************************************************************************************** */
+bool deallocFlat3DIntArray(int*** &tp)
+{
+   if (tp!=NULL) {
+      int **rows=tp[0];
+      deallocFlat2DIntArray(rows);
+      delete[] tp;
+      tp=NULL;
+      return true;
+   } else {
+      return false;
+   }
+}
+/* ************************************************************************************** */
+bool resizeFlat3DIntArray(string ptrname,const int idx1,const int idx2,const int idx3,\
+      const int newidx1,const int newidx3,int*** &thptr,const int inval)
+{
+   int ***tmpptr;
+   bool res=allocFlat3DIntArray(ptrname,newidx1,idx2,newidx3,tmpptr,inval);
+   if ( res ) {
+      if ( thptr!=NULL ) {
+         int n1=((idx1<newidx1)? idx1 : newidx1);
+         int n3=((idx3<newidx3)? idx3 : newidx3);
+         for ( int i=0 ; i<n1 ; ++i ) {
+            for ( int j=0 ; j<idx2 ; ++j ) {
+               memcpy(tmpptr[i][j],thptr[i][j],n3*sizeof(int));
+            }
+         }
+      }
+      deallocFlat3DIntArray(thptr);
+      thptr=tmpptr;
+   } else {
+      std::cout << "Error: something went wrong while trying to resize"
+         << std::endl << "the array " << ptrname << std::endl;
+   }
+   return res;
+}
+/* ************************************************************************************** */
 #endif//_SOLMEMHANDLE_CPP_
 
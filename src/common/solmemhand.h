@@ -109,6 +109,40 @@ bool dealloc3DIntArray(int*** & tp,const int idx1,const int idx2);
 /** This function extends the array to which thptr points to, and assign
  *  theptr[n]=thenewval. @b Caution: this function @b do @b not modify n.  */
 bool appendTo1DRealArray(string ptrname,const int n,solreal* &thptr,solreal thenewval);
+/** Changes the size of the array thptr from n to newn, keeping its first min(n,newn) 
+   elements. New elements are set to inval.  */
+bool resize1DRealArray(string ptrname,const int n,const int newn,solreal* &thptr,\
+      const solreal inval=0.0e0);
+bool resize1DIntArray(string ptrname,const int n,const int newn,int* &thptr,const int inval=0);
+bool resize1DStringArray(string ptrname,const int n,const int newn,string* &thptr);
+/* ************************************************************************************ */
+/** The Flat* functions allocate the whole array as a single contiguous block (thptr[0]
+ * points to its beginning), plus the arrays of pointers needed for keeping the usual
+ * thptr[i][j] (or thptr[i][j][k]) indexing. Arrays allocated with these functions must be
+ * deallocated and resized with the corresponding Flat* functions. At least one row is
+ * always allocated.  */
+bool allocFlat2DRealArray(string ptrname,const int rows,const int cols,solreal** &thptr,\
+      const solreal inval=0.0e0);
+bool deallocFlat2DRealArray(solreal** &tp);
+/** Changes the number of rows of thptr from rows to newrows, keeping the first
+ * min(rows,newrows) rows. New elements are set to inval.  */
+bool resizeFlat2DRealArray(string ptrname,const int rows,const int newrows,const int cols,\
+      solreal** &thptr,const solreal inval=0.0e0);
+/* ************************************************************************************ */
+bool allocFlat2DIntArray(string ptrname,const int rows,const int cols,int** &thptr,\
+      const int inval=0);
+bool deallocFlat2DIntArray(int** &tp);
+bool resizeFlat2DIntArray(string ptrname,const int rows,const int newrows,const int cols,\
+      int** &thptr,const int inval=0);
+/* ************************************************************************************ */
+bool allocFlat3DIntArray(string ptrname,const int idx1,const int idx2,const int idx3,\
+      int*** &thptr,const int inval=0);
+bool deallocFlat3DIntArray(int*** &tp);
+/** Changes the first and third dimensions of thptr from idx1 and idx3 to newidx1 and
+ * newidx3, keeping the elements that fit into the new shape. New elements are
+ * set to inval.  */
+bool resizeFlat3DIntArray(string ptrname,const int idx1,const int idx2,const int idx3,\
+      const int newidx1,const int newidx3,int*** &thptr,const int inval=0);
 /* ************************************************************************************ */
 /* ************************************************************************************ */
 /* ************************************************************************************ */
@@ -71,6 +71,8 @@ povRayConfProp::povRayConfProp()
    currIndLev=0;
    shine=false;
    inccolors=true;
+   incObjFile=incObjName=string("");
+   incObjRGBT[0]=0.2e0; incObjRGBT[1]=0.45e0; incObjRGBT[2]=0.9e0; incObjRGBT[3]=0.6e0;
 }
 //**********************************************************************************************
 povRayConfProp::~povRayConfProp()
@@ -165,6 +167,31 @@ void povRayConfProp::addLightSource(solreal xx,solreal yy,solreal zz)
    return;
 }
 //**************************************************************************************************
+void povRayConfProp::setIncludedObject(const string &fnam,const string &onam)
+{
+   incObjFile=fnam;
+   incObjName=onam;
+   return;
+}
+//**************************************************************************************************
+void povRayConfProp::writeIncludedObject(ofstream &ofil,solreal const (&trn)[3])
+{
+   if ( incObjName.length()==0 ) {return;}
+   ofil << endl << "#include \"" << incObjFile << "\"" << endl;
+   ofil << "object {" << endl;
+   currIndLev++;
+   string thetabs=indTabsStr(currIndLev);
+   ofil << thetabs << incObjName << endl;
+   ofil << thetabs << "translate ";
+   writePoVVector(ofil,-trn[0],-trn[1],-trn[2]);
+   ofil << endl << thetabs << "texture { pigment { rgbt ";
+   ofil << "<" << incObjRGBT[0] << "," << incObjRGBT[1] << "," << incObjRGBT[2] << ","
+        << incObjRGBT[3] << "> } }" << endl;
+   currIndLev--;
+   ofil << "}" << endl;
+   return;
+}
+//**************************************************************************************************
 void povRayConfProp::writeIncColors(ofstream &ofil)
 {
    if (inccolors) {
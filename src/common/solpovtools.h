@@ -80,6 +80,11 @@ public:
    int currIndLev;
    solreal defLightSource[3];
    bool shine,inccolors;
+   /** An object (e.g. an isosurface mesh) that is included into the scene: the file
+    * incObjFile is included, and the object declared there as incObjName is placed,
+    * unless incObjName is empty.  */
+   string incObjFile,incObjName;
+   solreal incObjRGBT[4];
    //**********************************************************************************************
    povRayConfProp();
    //**********************************************************************************************
@@ -107,6 +112,11 @@ public:
    //**********************************************************************************************
    void scaleLightSources(solreal scfactor);
    //**********************************************************************************************
+   void setIncludedObject(const string &fnam,const string &onam);
+   //**********************************************************************************************
+   /** Writes the included object (if any), translated by -trn, into ofil.  */
+   void writeIncludedObject(ofstream &ofil,solreal const (&trn)[3]);
+   //**********************************************************************************************
    //**********************************************************************************************
    //**********************************************************************************************
    //**********************************************************************************************
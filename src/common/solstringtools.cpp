@@ -50,6 +50,7 @@
 #include <sstream>
 #include <iomanip>
 #include <cstdlib>
+#include <cstring>
 
 
 /* ******************************************************************************************* */
@@ -173,6 +174,141 @@ string getFirstChunk(const string &line,char delim)
    return res;
 }
 /* ******************************************************************************************* */
+#define SOLMAXFASTPOW10 22
+static const double solExactPow10Tab[SOLMAXFASTPOW10+1]={
+   1.0e0,1.0e1,1.0e2,1.0e3,1.0e4,1.0e5,1.0e6,1.0e7,1.0e8,1.0e9,1.0e10,1.0e11,
+   1.0e12,1.0e13,1.0e14,1.0e15,1.0e16,1.0e17,1.0e18,1.0e19,1.0e20,1.0e21,1.0e22
+};
+/* ******************************************************************************************* */
+static inline bool isBufferSpace(const char c)
+{
+   return ((c==' ')||(c=='\n')||(c=='\t')||(c=='\r')||(c=='\f')||(c=='\v'));
+}
+/* ******************************************************************************************* */
+static inline bool isBufferDigit(const char c)
+{
+   return ((c>='0')&&(c<='9'));
+}
+/* ******************************************************************************************* */
+static bool parseRealFromBuffer(const char* &p,const char* end,solreal &val,const bool signexp)
+{
+   while ( (p<end)&&isBufferSpace(*p) ) {++p;}
+   if ( p>=end ) {return false;}
+   const char *st=p;
+   bool neg=false;
+   if ( (*p=='-')||(*p=='+') ) {neg=(*p=='-'); ++p;}
+   unsigned long long mant=0;
+   int nsig=0,e10=0,ndig=0;
+   while ( (p<end)&&isBufferDigit(*p) ) {
+      if ( nsig<19 ) {
+         mant=10ULL*mant+(unsigned long long)(*p-'0');
+         if ( mant>0ULL ) {++nsig;}
+      } else {
+         ++e10;
+         ++nsig;
+      }
+      ++ndig; ++p;
+   }
+   if ( (p<end)&&(*p=='.') ) {
+      ++p;
+      while ( (p<end)&&isBufferDigit(*p) ) {
+         if ( nsig<19 ) {
+            mant=10ULL*mant+(unsigned long long)(*p-'0');
+            if ( mant>0ULL ) {++nsig;}
+            --e10;
+         } else {
+            ++nsig;
+         }
+         ++ndig; ++p;
+      }
+   }
+   if ( ndig==0 ) {p=st; return false;}
+   if ( p<end ) {
+      const char *ep=p;
+      bool haveexp=false;
+      if ( (*ep=='e')||(*ep=='E')||(*ep=='d')||(*ep=='D') ) {
+         ++ep;
+         haveexp=true;
+      } else if ( signexp&&((*ep=='+')||(*ep=='-'))&&((ep+1)<end)&&isBufferDigit(ep[1]) ) {
+         haveexp=true; //Fortran E/D edit descriptor with a three-digit exponent.
+      }
+      if ( haveexp ) {
+         bool eneg=false;
+         if ( (ep<end)&&((*ep=='+')||(*ep=='-')) ) {eneg=(*ep=='-'); ++ep;}
+         if ( (ep<end)&&isBufferDigit(*ep) ) {
+            int ex=0;
+            while ( (ep<end)&&isBufferDigit(*ep) ) {
+               if ( ex<100000 ) {ex=10*ex+(*ep-'0');}
+               ++ep;
+            }
+            e10+=(eneg? -ex : ex);
+            p=ep;
+         }
+      }
+   }
+   if ( mant==0ULL ) {
+      val=(neg? -0.0e0 : 0.0e0);
+      return true;
+   }
+   if ( (nsig<=15)&&(e10>=-SOLMAXFASTPOW10)&&(e10<=SOLMAXFASTPOW10) ) {
+      double dv=double(mant);
+      if ( e10<0 ) {
+         dv/=solExactPow10Tab[-e10];
+      } else {
+         dv*=solExactPow10Tab[e10];
+      }
+      val=solreal(neg? -dv : dv);
+      return true;
+   }
+   char tmp[128];
+   size_t len=size_t(p-st);
+   if ( len>127 ) {len=127;}
+   for ( size_t i=0 ; i<len ; ++i ) {
+      tmp[i]=st[i];
+      if ( (tmp[i]=='d')||(tmp[i]=='D') ) {tmp[i]='e';}
+   }
+   tmp[len]='\0';
+   if ( (len>1)&&(!strpbrk(tmp,"eE")) ) {
+      for ( size_t i=len-1 ; i>0 ; --i ) {
+         if ( ((tmp[i]=='+')||(tmp[i]=='-'))&&(len<127) ) {
+            for ( size_t j=len ; j>i ; --j ) {tmp[j]=tmp[j-1];}
+            tmp[i]='e';
+            tmp[++len]='\0';
+            break;
+         }
+      }
+   }
+   val=solreal(strtod(tmp,NULL));
+   return true;
+}
+/* ******************************************************************************************* */
+bool getRealFromBuffer(const char* &p,const char* end,solreal &val)
+{
+   return parseRealFromBuffer(p,end,val,false);
+}
+/* ******************************************************************************************* */
+bool getFortranRealFromField(const char* &p,const char* end,solreal &val)
+{
+   return parseRealFromBuffer(p,end,val,true);
+}
+/* ******************************************************************************************* */
+bool getIntFromBuffer(const char* &p,const char* end,int &val)
+{
+   while ( (p<end)&&isBufferSpace(*p) ) {++p;}
+   if ( p>=end ) {return false;}
+   const char *st=p;
+   bool neg=false;
+   if ( (*p=='-')||(*p=='+') ) {neg=(*p=='-'); ++p;}
+   if ( (p>=end)||(!isBufferDigit(*p)) ) {p=st; return false;}
+   long res=0;
+   while ( (p<end)&&isBufferDigit(*p) ) {
+      res=10L*res+long(*p-'0');
+      ++p;
+   }
+   val=int(neg? -res : res);
+   return true;
+}
+/* ******************************************************************************************* */
 /* ******************************************************************************************* */
 /* ******************************************************************************************* */
 /* ******************************************************************************************* */
@@ -85,6 +85,22 @@ string getStrFromRealForFileNaming(solreal number,int prev=2,int post=2);
 /* ******************************************************************************************* */
 string getFirstChunk(const string &line,char delim=' ');
 /* ******************************************************************************************* */
+bool getRealFromBuffer(const char* &p,const char* end,solreal &val);
+/* Reads the next real number stored in the character buffer [p,end), skipping any
+   leading white space, and leaves p right after the last character of the number.
+   Fortran d/D exponents are accepted.
+   Numbers with at most 15 significant digits and a decimal exponent within
+   [-22,22] are converted exactly with a single multiplication/division;
+   otherwise the conversion falls back to strtod. Returns false if no number is found. */
+/* ******************************************************************************************* */
+bool getFortranRealFromField(const char* &p,const char* end,solreal &val);
+/* Same as getRealFromBuffer, but [p,end) must be a single fixed-width Fortran field:
+   a sign right after the digits is also read as the exponent (E/D edit descriptors
+   drop the letter for three-digit exponents, e.g. 0.1234567890-100). */
+/* ******************************************************************************************* */
+bool getIntFromBuffer(const char* &p,const char* end,int &val);
+/* Same as above, for (signed) integers. */
+/* ******************************************************************************************* */
 /* ******************************************************************************************* */
 /* ******************************************************************************************* */
 /* ******************************************************************************************* */
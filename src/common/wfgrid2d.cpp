@@ -84,12 +84,15 @@ waveFunctionGrid2D::waveFunctionGrid2D()
    prop2d=NULL;
    prop2plot=NONE;
    imsetup=false;
+   symRep=NULL;
+   nSymUnique=0;
 }
 /* ********************************************************************************* */
 waveFunctionGrid2D::~waveFunctionGrid2D()
 {
    dealloc1DRealArray(prop1d);
    dealloc2DRealArray(prop2d,npts[1]);
+   dealloc1DIntArray(symRep);
 }
 /* ********************************************************************************* */
 void waveFunctionGrid2D::setNPts(int nx,int ny)
@@ -414,6 +417,12 @@ void waveFunctionGrid2D::makeTsv(string &onam,GaussWaveFunction &wf,ScalarFieldT
       ofil.close();
       return;
    }
+   /* The vector fields are not invariant, and the custom field may not be.  */
+   if ( (symRep!=NULL)&&(ft!=GLOL)&&(ft!=LEDV)&&(ft!=VCFD)&&(ft!=SCFD) ) {
+      writeSymmetricPlaneTsv(ofil,wf,ft);
+      ofil.close();
+      return;
+   }
 #if USEPROGRESSBAR
    printProgressBar(0);
 #endif
@@ -481,6 +490,102 @@ void waveFunctionGrid2D::makeTsv(string &onam,GaussWaveFunction &wf,ScalarFieldT
    return;
 }
 /* ********************************************************************************* */
+int waveFunctionGrid2D::setUpSymmetry(molSymmetry &sym)
+{
+   if ( !imsetup ) {
+      cout << "Error: the grid has not been set up!" << endl;
+      return 0;
+   }
+   /* The plane is seen as a grid of npts[0] x npts[1] x 1 points, whose third
+      step is the normal of the plane; hence, the operations that take a point out of
+      the plane are discarded by getGridRepresentatives.  */
+   solreal x0[3],st[3][3];
+   int nn[3]={npts[0],npts[1],1},nused=1;
+   crossProductV3(dircos1,dircos2,st[2]);
+   normalizeV3(st[2]);
+   for ( int k=0 ; k<3 ; ++k ) {
+      x0[k]=Ca[k];
+      st[0][k]=maxdim*dx[0]*dircos1[k];
+      st[1][k]=maxdim*dx[1]*dircos2[k];
+   }
+   dealloc1DIntArray(symRep);
+   nSymUnique=sym.getGridRepresentatives(x0,st,nn,symRep,nused);
+   if ( nused<2 ) {
+      dealloc1DIntArray(symRep);
+      nSymUnique=0;
+   }
+   return nused;
+}
+/* ********************************************************************************* */
+int waveFunctionGrid2D::getNOfSymmetryUniquePoints(void)
+{
+   if ( symRep==NULL ) {return npts[0]*npts[1];}
+   return nSymUnique;
+}
+/* ********************************************************************************* */
+bool waveFunctionGrid2D::writeSymmetricPlaneTsv(ofstream &ofil,GaussWaveFunction &wf,\
+      ScalarFieldType ft)
+{
+   const int ntot=npts[0]*npts[1];
+   int nuni=0,*uni;
+   alloc1DIntArray(string("uni"),ntot,uni);
+   for ( int p=0 ; p<ntot ; ++p ) {if ( symRep[p]==p ) {uni[nuni++]=p;}}
+   solreal *vals;
+   alloc1DRealArray(string("vals"),ntot,vals);
+   solreal e1,e2;
+#if PARALLELISEDTK
+#pragma omp parallel
+   {
+      GaussWaveFunction twf;
+      GaussWaveFunction *pwf=&wf;
+      if ( omp_get_thread_num()>0 ) {
+         twf.shareDataFrom(wf);
+         pwf=&twf;
+      }
+#pragma omp for schedule(dynamic,64)
+      for ( int u=0 ; u<nuni ; ++u ) {
+         int p=uni[u];
+         solreal e1=maxdim*dx[0]*solreal(p/npts[1]),e2=maxdim*dx[1]*solreal(p%npts[1]);
+         solreal xx[3];
+         for ( int k=0 ; k<3 ; ++k ) {xx[k]=Ca[k]+e1*dircos1[k]+e2*dircos2[k];}
+         if ( ft==DENS ) {
+            vals[p]=pwf->evalDensity(xx[0],xx[1],xx[2]);
+         } else {
+            pwf->evalMultipleFields(xx[0],xx[1],xx[2],&ft,1,&vals[p]);
+         }
+      }
+   }
+#else
+   int p;
+   solreal xx[3];
+   for ( int u=0 ; u<nuni ; ++u ) {
+      p=uni[u];
+      e1=maxdim*dx[0]*solreal(p/npts[1]);
+      e2=maxdim*dx[1]*solreal(p%npts[1]);
+      for ( int k=0 ; k<3 ; ++k ) {xx[k]=Ca[k]+e1*dircos1[k]+e2*dircos2[k];}
+      if ( ft==DENS ) {
+         vals[p]=wf.evalDensity(xx[0],xx[1],xx[2]);
+      } else {
+         wf.evalMultipleFields(xx[0],xx[1],xx[2],&ft,1,&vals[p]);
+      }
+   }
+#endif
+   dealloc1DIntArray(uni);
+   ofil << scientific << setprecision (10);
+   e1=-1.0e0;
+   for (int i=0; i<npts[0]; i++) {
+      e2=-1.0e0*maxdim;
+      for (int j=0; j<npts[1]; j++) {
+         ofil << e1*maxdim << "\t" << e2 << "\t" << vals[symRep[i*npts[1]+j]] << endl;
+         e2+=dx[1]*maxdim;
+      }
+      e1+=dx[0];
+      ofil << endl;
+   }
+   dealloc1DRealArray(vals);
+   return true;
+}
+/* ********************************************************************************* */
 bool waveFunctionGrid2D::writePlaneTsvLapRho(ofstream &ofil,GaussWaveFunction &wf)
 {
    ofil << scientific << setprecision (10);
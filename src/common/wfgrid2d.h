@@ -63,6 +63,7 @@ typedef double solreal;
 #include "gausswavefunction.h"
 #include "bondnetwork.h"
 #include "fldtypesdef.h"
+#include "molsymmetry.h"
 
 #ifndef DEBUG
 #define DEBUG 0
@@ -171,9 +172,23 @@ public:
    /* *************************************************************************** */
    void makeTsv(string &onam,GaussWaveFunction &wf,ScalarFieldType ft);
    /* *************************************************************************** */
+   /** Looks for the operations of sym that map the (already set up) plane grid onto
+    * itself. If any operation besides the identity is found, makeTsv evaluates the
+    * scalar fields only at the symmetry-unique points of the plane, and copies the
+    * values to the rest of the points. Returns the number of such operations.  */
+   int setUpSymmetry(molSymmetry &sym);
+   /** Returns the number of points that are actually evaluated (the whole plane if
+    * the symmetry is not used).  */
+   int getNOfSymmetryUniquePoints(void);
+   /* *************************************************************************** */
 private:
    bool imsetup;
    int npts[2];
+   /* symRep[p] is the representative of the symmetry orbit of the point p=i*npts[1]+j
+      (see molSymmetry::getGridRepresentatives), or symRep is NULL.  */
+   int *symRep,nSymUnique;
+   /** Writes the scalar field ft, evaluated only at the representatives.  */
+   bool writeSymmetricPlaneTsv(ofstream &ofil,GaussWaveFunction &wf,ScalarFieldType ft);
 };
 
 
@@ -56,6 +56,7 @@
 #include "wfgrid3d.h"
 #include "solcubetools.h"
 #include "bondnetwork.h"
+#include "eig2-4.h"
 
 #ifndef PARALLELIZEDTK
 #define PARALLELIZEDTK 0
@@ -75,11 +76,15 @@ waveFunctionGrid3D::waveFunctionGrid3D()
    prop1d=NULL;
    prop2plot=NONE;
    imsetup=false;
+   symRep=NULL;
+   nSymUnique=0;
+   nSymOps=1;
 }
 /* ********************************************************************************** */
 waveFunctionGrid3D::~waveFunctionGrid3D()
 {
    dealloc1DRealArray(prop1d);
+   dealloc1DIntArray(symRep);
 }
 /* ********************************************************************************** */
 void waveFunctionGrid3D::setUpSimpleGrid(GaussWaveFunction &wf,bondNetWork &bn)
@@ -124,6 +129,118 @@ void waveFunctionGrid3D::setUpSmartCuboidGrid(GaussWaveFunction &wf,bondNetWork
    return;
 }
 /* ********************************************************************************** */
+void waveFunctionGrid3D::setUpSpacedCuboidGrid(GaussWaveFunction &,bondNetWork &bn,\
+      const solreal hh,const solreal mrg)
+{
+   if (!(bn.imstp())) {
+      cout << "Error: Trying to use a non set-up bondNetWork object!\n";
+      cout << "The grid could not be set up." << endl;
+      return;
+   }
+   if (hh<=0.0e0) {
+      cout << "Error: The spacing of the grid must be positive!\n";
+      cout << "The grid could not be set up." << endl;
+      return;
+   }
+   for (int i=0; i<3; i++) {
+      npts[i]=int(ceil((bn.bbmax[i]-bn.bbmin[i]+2.0e0*mrg)/hh))+1;
+      xin[i]=0.5e0*(bn.bbmin[i]+bn.bbmax[i]-solreal(npts[i]-1)*hh);
+      dx[i][i]=hh;
+   }
+   alloc1DRealArray("prop1d",npts[2],prop1d);
+   imsetup=true;
+   return;
+}
+/* ********************************************************************************** */
+void waveFunctionGrid3D::setUpDensityCuboidGrid(GaussWaveFunction &wf,const solreal rhocut,\
+      const int nmx,const solreal hh)
+{
+   solreal bbmin[3],bbmax[3];
+   if ( !wf.getDensityBoundingBox(rhocut,bbmin,bbmax) ) {
+      cout << "Error: The density is smaller than " << rhocut << " everywhere!\n";
+      cout << "The grid could not be set up." << endl;
+      return;
+   }
+   solreal maxdim=0.0e0;
+   for ( int i=0 ; i<3 ; i++ ) {
+      if ( (bbmax[i]-bbmin[i])>maxdim ) {maxdim=bbmax[i]-bbmin[i];}
+   }
+   for ( int i=0 ; i<3 ; i++ ) {
+      if ( hh>0.0e0 ) {
+         npts[i]=int(ceil((bbmax[i]-bbmin[i])/hh))+1;
+         dx[i][i]=hh;
+      } else {
+         npts[i]=int(ceil(((bbmax[i]-bbmin[i])/maxdim)*solreal(nmx-1)))+1;
+         if ( npts[i]<2 ) {npts[i]=2;}
+         dx[i][i]=maxdim/solreal(nmx-1);
+      }
+      xin[i]=0.5e0*(bbmin[i]+bbmax[i]-solreal(npts[i]-1)*dx[i][i]);
+   }
+   alloc1DRealArray("prop1d",npts[2],prop1d);
+   imsetup=true;
+   return;
+}
+/* ********************************************************************************** */
+void waveFunctionGrid3D::setUpSymmetricGrid(GaussWaveFunction &,bondNetWork &bn,\
+      molSymmetry &sym,const int nmx)
+{
+   if (!(bn.imstp())) {
+      cout << "Error: Trying to use a non set-up bondNetWork object!\n";
+      cout << "The grid could not be set up." << endl;
+      return;
+   }
+   solreal cc[3],ee[3][3],hl[3],tmp,maxdim=0.0e0;
+   sym.getCenter(cc);
+   for (int k=0; k<3; k++) {
+      sym.getFrameAxis(k,ee[k]);
+      hl[k]=0.0e0;
+      for (int i=0; i<bn.nNuc; i++) {
+         tmp=fabs((bn.R[i][0]-cc[0])*ee[k][0]+(bn.R[i][1]-cc[1])*ee[k][1]\
+               +(bn.R[i][2]-cc[2])*ee[k][2]);
+         if (tmp>hl[k]) {hl[k]=tmp;}
+      }
+      //Same margins as bn.bbmin/bbmax plus the extra space of setUpSmartCuboidGrid.
+      hl[k]+=((0.5e0+EXTRASPACECUBEFACTOR)*bn.maxBondDist);
+      if (hl[k]>maxdim) {maxdim=hl[k];}
+   }
+   if (nmx>0) {
+      for (int k=0; k<3; k++) {npts[k]=int(floor((hl[k]/maxdim)*solreal(nmx)));}
+   }
+   /* The axes exchanged by an operation must have the same length and points (twice,
+      since the equivalence is transitive).  */
+   for (int pass=0; pass<2; pass++) {
+      for (int k=0; k<3; k++) {
+         for (int l=k+1; l<3; l++) {
+            if (!sym.axesAreEquivalent(k,l)) {continue;}
+            if (hl[l]>hl[k]) {hl[k]=hl[l];} else {hl[l]=hl[k];}
+            if (npts[l]>npts[k]) {npts[k]=npts[l];} else {npts[l]=npts[k];}
+         }
+      }
+   }
+   for (int k=0; k<3; k++) {
+      if (npts[k]<2) {npts[k]=2;}
+      xin[k]=cc[k];
+   }
+   for (int k=0; k<3; k++) {
+      for (int l=0; l<3; l++) {
+         dx[k][l]=ee[k][l]*(2.0e0*hl[k]/solreal(npts[k]-1));
+         xin[l]-=hl[k]*ee[k][l];
+      }
+   }
+   dealloc1DRealArray(prop1d);
+   alloc1DRealArray("prop1d",npts[2],prop1d);
+   dealloc1DIntArray(symRep);
+   nSymUnique=sym.getGridRepresentatives(xin,dx,npts,symRep,nSymOps);
+   imsetup=true;
+   return;
+}
+/* ********************************************************************************** */
+int waveFunctionGrid3D::getNOfSymmetryUniquePoints(void)
+{
+   if (symRep==NULL) {return npts[0]*npts[1]*npts[2];}
+   return nSymUnique;
+}
+/* ********************************************************************************** */
 void waveFunctionGrid3D::setNPts(int nx,int ny,int nz)
 {
    npts[0]=nx;
@@ -169,6 +286,75 @@ void waveFunctionGrid3D::writeCubeRho(ofstream &ofil,GaussWaveFunction &wf)
    return;
 }
 /* ********************************************************************************** */
+void waveFunctionGrid3D::writeCubeRhoTiled(ofstream &ofil,GaussWaveFunction &wf)
+{
+   const int ts=WFGRID3DTILESIZE;
+   const int ntil=((npts[1]+ts-1)/ts)*((npts[2]+ts-1)/ts);
+   solreal *rr,*slab;
+   alloc1DRealArray(string("rr"),wf.totPri,rr);
+   alloc1DRealArray(string("slab"),ts*npts[1]*npts[2],slab);
+   wf.getPrimitiveDecayRadii(WFGRID3DTILECULLTOL,rr);
+   int ni;
+   for ( int i0=0 ; i0<npts[0] ; i0+=ts ) {
+      ni=((npts[0]-i0)<ts)? (npts[0]-i0) : ts;
+      //evalDensityOnTile keeps its work arrays local, so wf can be shared by the threads.
+#if PARALLELISEDTK
+#pragma omp parallel for schedule(dynamic)
+#endif
+      for ( int t=0 ; t<ntil ; ++t ) {evalRhoOnTile(wf,i0,ni,t,rr,slab);}
+      for ( int di=0 ; di<ni ; ++di ) {
+         for ( int j=0 ; j<npts[1] ; ++j ) {
+            for ( int k=0 ; k<npts[2] ; ++k ) {prop1d[k]=slab[(di*npts[1]+j)*npts[2]+k];}
+            writeCubeProp(ofil,npts[2],prop1d);
+         }
+      }
+#if USEPROGRESSBAR
+      printProgressBar(int(100.0e0*solreal(i0+ni-1)/solreal((npts[0]-1))));
+#endif
+   }
+   dealloc1DRealArray(slab);
+   dealloc1DRealArray(rr);
+   return;
+}
+/* ********************************************************************************** */
+void waveFunctionGrid3D::evalRhoOnTile(GaussWaveFunction &wf,const int i0,const int ni,\
+      const int t,const solreal *rr,solreal *slab)
+{
+   const int ts=WFGRID3DTILESIZE;
+   const int ntk=(npts[2]+ts-1)/ts;
+   const int j0=(t/ntk)*ts,k0=(t%ntk)*ts;
+   const int nj=((npts[1]-j0)<ts)? (npts[1]-j0) : ts;
+   const int nk=((npts[2]-k0)<ts)? (npts[2]-k0) : ts;
+   if ( (ni<=0)||(nj<=0)||(nk<=0) ) {return;}
+   solreal xx[3*ts*ts*ts],rho[ts*ts*ts],bbmin[3],bbmax[3];
+   const int i1[3]={i0,j0,k0},nn[3]={ni,nj,nk};
+   for ( int l=0 ; l<3 ; ++l ) {
+      bbmin[l]=xin[l]+solreal(i1[l])*dx[l][l];
+      bbmax[l]=xin[l]+solreal(i1[l]+nn[l]-1)*dx[l][l];
+   }
+   int np=0;
+   for ( int di=0 ; di<ni ; ++di ) {
+      for ( int dj=0 ; dj<nj ; ++dj ) {
+         for ( int dk=0 ; dk<nk ; ++dk ) {
+            xx[3*np  ]=xin[0]+solreal(i0+di)*dx[0][0];
+            xx[3*np+1]=xin[1]+solreal(j0+dj)*dx[1][1];
+            xx[3*np+2]=xin[2]+solreal(k0+dk)*dx[2][2];
+            ++np;
+         }
+      }
+   }
+   wf.evalDensityOnTile(np,xx,bbmin,bbmax,rr,rho);
+   np=0;
+   for ( int di=0 ; di<ni ; ++di ) {
+      for ( int dj=0 ; dj<nj ; ++dj ) {
+         for ( int dk=0 ; dk<nk ; ++dk ) {
+            slab[(di*npts[1]+(j0+dj))*npts[2]+(k0+dk)]=rho[np++];
+         }
+      }
+   }
+   return;
+}
+/* ********************************************************************************** */
 void waveFunctionGrid3D::writeCubeLapRho(ofstream &ofil,GaussWaveFunction &wf)
 {
    solreal xx,yy,zz;
@@ -523,6 +709,10 @@ void waveFunctionGrid3D::makeCube(string &onam,GaussWaveFunction &wf,ScalarField
       cout << "Error: trying to use a non loaded wave function object!\nNothing done!\n";
       return;
    }
+   if (symRep!=NULL) {
+      makeSymmetricCubes(&onam,wf,&ft,1);
+      return;
+   }
    char cft=convertScalarFieldType2Char(ft);
    comments+=string("Property: ");
    comments+=getFieldTypeKeyLong(cft);
@@ -534,7 +724,7 @@ void waveFunctionGrid3D::makeCube(string &onam,GaussWaveFunction &wf,ScalarField
 #endif
    switch (ft) {
       case DENS:
-         writeCubeRho(ofil,wf);
+         writeCubeRhoTiled(ofil,wf);
          break;
       case LAPD:
          writeCubeLapRho(ofil,wf);
@@ -586,6 +776,286 @@ void waveFunctionGrid3D::makeCube(string &onam,GaussWaveFunction &wf,ScalarField
    ofil.close();
    return;
 }
+void waveFunctionGrid3D::makeMultipleCubes(string *onam,GaussWaveFunction &wf,\
+      ScalarFieldType *ft,const int nf)
+{
+   if (!wf.imldd) {
+      cout << "Error: trying to use a non loaded wave function object!\nNothing done!\n";
+      return;
+   }
+   if ( nf<1 ) {
+      cout << "Error: no fields were requested!\nNothing done!\n";
+      return;
+   }
+   if (symRep!=NULL) {
+      makeSymmetricCubes(onam,wf,ft,nf);
+      return;
+   }
+   ofstream *ofil=new ofstream[nf];
+   string comm;
+   char cft;
+   for ( int f=0 ; f<nf ; ++f ) {
+      cft=convertScalarFieldType2Char(ft[f]);
+      comm=comments+string("Property: ");
+      comm+=getFieldTypeKeyLong(cft);
+      ofil[f].open(onam[f].c_str());
+      writeCubeHeader(ofil[f],wf.title[0],comm,npts,xin,dx,wf.nNuc,wf.atCharge,wf.R);
+   }
+   solreal **mprop,*val;
+   alloc2DRealArray(string("mprop"),nf,npts[2],mprop);
+   alloc1DRealArray(string("val"),nf,val);
+#if USEPROGRESSBAR
+   printProgressBar(0);
+#endif
+   solreal xx,yy,zz;
+   xx=xin[0];
+   for (int i=0; i<npts[0]; i++) {
+      yy=xin[1];
+      for (int j=0; j<npts[1]; j++) {
+         zz=xin[2];
+         for (int k=0; k<npts[2]; k++) {
+            wf.evalMultipleFields(xx,yy,zz,ft,nf,val);
+            for ( int f=0 ; f<nf ; ++f ) { mprop[f][k]=val[f]; }
+            zz+=dx[2][2];
+         }
+         for ( int f=0 ; f<nf ; ++f ) { writeCubeProp(ofil[f],npts[2],mprop[f]); }
+         yy+=dx[1][1];
+      }
+      xx+=dx[0][0];
+#if USEPROGRESSBAR
+      printProgressBar(int(100.0e0*solreal(i)/solreal((npts[0]-1))));
+#endif
+   }
+#if USEPROGRESSBAR
+   printProgressBar(100);
+   cout << endl;
+#endif
+   for ( int f=0 ; f<nf ; ++f ) { ofil[f].close(); }
+   delete[] ofil;
+   dealloc2DRealArray(mprop,nf);
+   dealloc1DRealArray(val);
+   return;
+}
+/* ********************************************************************************** */
+void waveFunctionGrid3D::makeSymmetricCubes(string *onam,GaussWaveFunction &wf,\
+      ScalarFieldType *ft,const int nf)
+{
+   /* The custom fields may not be invariant under the symmetry operations.  */
+   bool usesym=true;
+   for ( int f=0 ; f<nf ; ++f ) {if ( ft[f]==SCFD ) {usesym=false;}}
+   if ( !usesym ) {
+      displayWarningMessage("The custom field may not be symmetric, the whole grid will be evaluated.");
+   }
+   const int ntot=npts[0]*npts[1]*npts[2];
+   int nuni=0,*uni;
+   alloc1DIntArray(string("uni"),ntot,uni);
+   for ( int p=0 ; p<ntot ; ++p ) {if ( (!usesym)||(symRep[p]==p) ) {uni[nuni++]=p;}}
+   solreal *vals;
+   alloc1DRealArray(string("vals"),nf*ntot,vals);
+#if PARALLELISEDTK
+#pragma omp parallel
+   {
+      GaussWaveFunction twf;
+      GaussWaveFunction *pwf=&wf;
+      if ( omp_get_thread_num()>0 ) {
+         twf.shareDataFrom(wf);
+         pwf=&twf;
+      }
+#pragma omp for schedule(dynamic,64)
+      for ( int u=0 ; u<nuni ; ++u ) {
+         int p=uni[u],idx[3]={p/(npts[1]*npts[2]),(p/npts[2])%npts[1],p%npts[2]};
+         solreal xx[3];
+         for ( int l=0 ; l<3 ; ++l ) {
+            xx[l]=xin[l]+solreal(idx[0])*dx[0][l]+solreal(idx[1])*dx[1][l]\
+                  +solreal(idx[2])*dx[2][l];
+         }
+         if ( nf==1 && ft[0]==DENS ) {
+            vals[p]=pwf->evalDensity(xx[0],xx[1],xx[2]);
+         } else {
+            pwf->evalMultipleFields(xx[0],xx[1],xx[2],ft,nf,&vals[p*nf]);
+         }
+      }
+   }
+#else
+   int p,idx[3];
+   solreal xx[3];
+   for ( int u=0 ; u<nuni ; ++u ) {
+      p=uni[u];
+      idx[0]=p/(npts[1]*npts[2]);
+      idx[1]=(p/npts[2])%npts[1];
+      idx[2]=p%npts[2];
+      for ( int l=0 ; l<3 ; ++l ) {
+         xx[l]=xin[l]+solreal(idx[0])*dx[0][l]+solreal(idx[1])*dx[1][l]\
+               +solreal(idx[2])*dx[2][l];
+      }
+      if ( nf==1 && ft[0]==DENS ) {
+         vals[p]=wf.evalDensity(xx[0],xx[1],xx[2]);
+      } else {
+         wf.evalMultipleFields(xx[0],xx[1],xx[2],ft,nf,&vals[p*nf]);
+      }
+   }
+#endif
+   dealloc1DIntArray(uni);
+   if ( usesym ) {
+      for ( int p=0 ; p<ntot ; ++p ) {
+         if ( symRep[p]==p ) {continue;}
+         for ( int f=0 ; f<nf ; ++f ) {vals[p*nf+f]=vals[symRep[p]*nf+f];}
+      }
+   }
+   ofstream ofil;
+   string comm;
+   for ( int f=0 ; f<nf ; ++f ) {
+      comm=comments+string("Property: ");
+      comm+=getFieldTypeKeyLong(convertScalarFieldType2Char(ft[f]));
+      ofil.open(onam[f].c_str());
+      writeCubeHeader(ofil,wf.title[0],comm,npts,xin,dx,wf.nNuc,wf.atCharge,wf.R);
+      for ( int ij=0 ; ij<(npts[0]*npts[1]) ; ++ij ) {
+         for ( int k=0 ; k<npts[2] ; ++k ) {prop1d[k]=vals[(ij*npts[2]+k)*nf+f];}
+         writeCubeProp(ofil,npts[2],prop1d);
+      }
+      ofil.close();
+   }
+   dealloc1DRealArray(vals);
+   return;
+}
+/* ********************************************************************************** */
+int waveFunctionGrid3D::makeNCICubes(string &srhonam,string &rdgnam,string &histnam,\
+      GaussWaveFunction &wf,const solreal rhocut,const solreal scut,proMolDensity *pmcull)
+{
+   if (!wf.imldd) {
+      cout << "Error: trying to use a non loaded wave function object!\nNothing done!\n";
+      return 0;
+   }
+   static const solreal rdgcc=0.161620459673995481331661e0; /* $(2(3\pi^2)^{1/3})^{-1}$  */
+   static const solreal fouo3=4.0e0/3.0e0;
+   ofstream sfil,rfil;
+   string comm=comments+string("Property: sign(lambda2)rho");
+   sfil.open(srhonam.c_str());
+   writeCubeHeader(sfil,wf.title[0],comm,npts,xin,dx,wf.nNuc,wf.atCharge,wf.R);
+   comm=comments+string("Property: ")+getFieldTypeKeyLong('s');
+   rfil.open(rdgnam.c_str());
+   writeCubeHeader(rfil,wf.title[0],comm,npts,xin,dx,wf.nNuc,wf.atCharge,wf.R);
+   const int nsl=npts[1]*npts[2];
+   solreal *srho,*rdg,*row;
+   alloc1DRealArray(string("srho"),nsl,srho);
+   alloc1DRealArray(string("rdg"),nsl,rdg);
+   int **hist;
+   allocFlat2DIntArray(string("hist"),NCIHISTNBINSRHO,NCIHISTNBINSRDG,hist,0);
+   const solreal hbr=2.0e0*rhocut/solreal(NCIHISTNBINSRHO);
+   const solreal hbs=scut/solreal(NCIHISTNBINSRDG);
+   int nkept=0,ib,jb;
+#if USEPROGRESSBAR
+   printProgressBar(0);
+#endif
+   for ( int i=0 ; i<npts[0] ; i++ ) {
+      const solreal xx=xin[0]+solreal(i)*dx[0][0];
+#if PARALLELISEDTK
+#pragma omp parallel
+      {
+         GaussWaveFunction twf;
+         GaussWaveFunction *pwf=&wf;
+         if ( omp_get_thread_num()>0 ) {
+            twf.shareDataFrom(wf);
+            pwf=&twf;
+         }
+#else
+      {
+         GaussWaveFunction *pwf=&wf;
+#endif
+         /* The Hessians of the points of the row that survive the cutoffs.  */
+         solreal *hbat,*ebat,rho,g[3],h[3][3],yy,zz,s;
+         int *idx,nb;
+         alloc1DRealArray(string("hbat"),6*npts[2],hbat);
+         alloc1DRealArray(string("ebat"),3*npts[2],ebat);
+         alloc1DIntArray(string("idx"),npts[2],idx);
+#if PARALLELISEDTK
+#pragma omp for schedule(dynamic,1)
+#endif
+         for ( int j=0 ; j<npts[1] ; j++ ) {
+            yy=xin[1]+solreal(j)*dx[1][1];
+            nb=0;
+            for ( int k=0 ; k<npts[2] ; k++ ) {
+               zz=xin[2]+solreal(k)*dx[2][2];
+               if ( pmcull!=NULL ) {
+                  pmcull->evalRhoGradRho(xx,yy,zz,rho,g);
+                  s=((rho>0.0e0)? (rdgcc*sqrt(g[0]*g[0]+g[1]*g[1]+g[2]*g[2])/pow(rho,fouo3))\
+                        : NCICULLEDPOINTVALUE);
+                  if ( rho>(NCIPROMOLCULLFACTOR*rhocut) || s>(NCIPROMOLCULLFACTOR*scut) ) {
+                     srho[j*npts[2]+k]=rdg[j*npts[2]+k]=NCICULLEDPOINTVALUE;
+                     continue;
+                  }
+               }
+               pwf->evalRhoGradRho(xx,yy,zz,rho,g);
+               s=((rho>0.0e0)? (rdgcc*sqrt(g[0]*g[0]+g[1]*g[1]+g[2]*g[2])/pow(rho,fouo3))\
+                     : NCICULLEDPOINTVALUE);
+               if ( rho>rhocut || s>scut ) {
+                  srho[j*npts[2]+k]=rdg[j*npts[2]+k]=NCICULLEDPOINTVALUE;
+                  continue;
+               }
+               rdg[j*npts[2]+k]=s;
+               srho[j*npts[2]+k]=rho;
+               pwf->evalHessian(xx,yy,zz,h);
+               hbat[6*nb]=h[0][0];
+               hbat[6*nb+1]=h[1][1];
+               hbat[6*nb+2]=h[2][2];
+               hbat[6*nb+3]=h[0][1];
+               hbat[6*nb+4]=h[0][2];
+               hbat[6*nb+5]=h[1][2];
+               idx[nb++]=j*npts[2]+k;
+            }
+            eigen_values3_packed(nb,hbat,ebat);
+            for ( int b=0 ; b<nb ; b++ ) {
+               if ( ebat[3*b+1]<0.0e0 ) {srho[idx[b]]=-srho[idx[b]];}
+            }
+         }
+         dealloc1DRealArray(hbat);
+         dealloc1DRealArray(ebat);
+         dealloc1DIntArray(idx);
+      }
+      for ( int j=0 ; j<npts[1] ; j++ ) {
+         row=&srho[j*npts[2]];
+         writeCubeProp(sfil,npts[2],row);
+         row=&rdg[j*npts[2]];
+         writeCubeProp(rfil,npts[2],row);
+      }
+      for ( int m=0 ; m<nsl ; m++ ) {
+         if ( rdg[m]==NCICULLEDPOINTVALUE ) {continue;}
+         ++nkept;
+         ib=int((srho[m]+rhocut)/hbr);
+         jb=int(rdg[m]/hbs);
+         if ( ib>=NCIHISTNBINSRHO ) {ib=NCIHISTNBINSRHO-1;}
+         if ( jb>=NCIHISTNBINSRDG ) {jb=NCIHISTNBINSRDG-1;}
+         if ( ib<0 ) {ib=0;}
+         ++hist[ib][jb];
+      }
+#if USEPROGRESSBAR
+      printProgressBar(int(100.0e0*solreal(i)/solreal((npts[0]-1))));
+#endif
+   }
+#if USEPROGRESSBAR
+   printProgressBar(100);
+   cout << endl;
+#endif
+   sfil.close();
+   rfil.close();
+   ofstream hfil(histnam.c_str());
+   hfil << "#NCI histogram: sign(lambda2)rho (bin center), s (bin center), counts" << endl;
+   hfil << "#rho cutoff: " << rhocut << ", s cutoff: " << scut << ", points: " << nkept
+        << endl;
+   hfil << scientific << setprecision(6);
+   for ( int a=0 ; a<NCIHISTNBINSRHO ; a++ ) {
+      for ( int b=0 ; b<NCIHISTNBINSRDG ; b++ ) {
+         hfil << (-rhocut+(solreal(a)+0.5e0)*hbr) << " " << ((solreal(b)+0.5e0)*hbs) << " "
+              << hist[a][b] << endl;
+      }
+      hfil << endl;
+   }
+   hfil.close();
+   dealloc1DRealArray(srho);
+   dealloc1DRealArray(rdg);
+   deallocFlat2DIntArray(hist);
+   return nkept;
+}
 /* ********************************************************************************** */
 /* ********************************************************************************** */
 /* ********************************************************************************** */
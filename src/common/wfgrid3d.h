@@ -63,14 +63,53 @@ typedef double solreal;
 #include "bondnetwork.h"
 #include "solmemhand.h"
 #include "fldtypesdef.h"
+#include "promoldensity.h"
+#include "molsymmetry.h"
 
 #ifndef DEFAULTPOINTSPERDIRECTION
 #define DEFAULTPOINTSPERDIRECTION (80)
 #endif
 #define EXTRASPACECUBEFACTOR (1.0e0)
+/* Default density threshold of the box of setUpDensityCuboidGrid.  */
+#ifndef DEFAULTRHOCUTFORBOX
+#define DEFAULTRHOCUTFORBOX (1.0e-06)
+#endif
 #ifndef USEPROGRESSBAR
 #define USEPROGRESSBAR 0
 #endif
+/* Defaults of the NCI analysis (see waveFunctionGrid3D::makeNCICubes): the density and
+   reduced density gradient cutoffs, the value written into the cubes at the culled
+   points, and the number of bins of the (sign(lambda2)rho,s) histogram.  */
+#ifndef NCIDEFAULTRHOCUTOFF
+#define NCIDEFAULTRHOCUTOFF (0.05e0)
+#endif
+#ifndef NCIDEFAULTRDGCUTOFF
+#define NCIDEFAULTRDGCUTOFF (2.0e0)
+#endif
+#ifndef NCICULLEDPOINTVALUE
+#define NCICULLEDPOINTVALUE (100.0e0)
+#endif
+#ifndef NCIHISTNBINSRHO
+#define NCIHISTNBINSRHO (200)
+#endif
+#ifndef NCIHISTNBINSRDG
+#define NCIHISTNBINSRDG (100)
+#endif
+/* With a promolecular pre-culling, the points whose promolecular rho or s exceed
+   NCIPROMOLCULLFACTOR times the cutoffs are culled without evaluating the wave
+   function.  */
+#ifndef NCIPROMOLCULLFACTOR
+#define NCIPROMOLCULLFACTOR (3.0e0)
+#endif
+/* The density cubes are evaluated in tiles of WFGRID3DTILESIZE^3 points; for each tile,
+   only the primitives whose terms of the density add up to more than WFGRID3DTILECULLTOL
+   somewhere in the tile are used (see GaussWaveFunction::evalDensityOnTile).  */
+#ifndef WFGRID3DTILESIZE
+#define WFGRID3DTILESIZE (6)
+#endif
+#ifndef WFGRID3DTILECULLTOL
+#define WFGRID3DTILECULLTOL (1.0e-12)
+#endif
 
 #include <iostream>
 using std::cout;
@@ -109,6 +148,36 @@ public:
    /* ******************************************************************************* */
    void setUpSmartCuboidGrid(GaussWaveFunction &wf,bondNetWork &bn,const int nmx);
    /* ******************************************************************************* */
+   /** Sets up a cuboid grid with spacing hh (in every direction), which encloses the
+    * bounding box of the molecule plus a margin mrg on each side. wf is not used; it
+    * keeps the signature of the other setUp functions.  */
+   void setUpSpacedCuboidGrid(GaussWaveFunction &wf,bondNetWork &bn,const solreal hh,\
+         const solreal mrg);
+   /* ******************************************************************************* */
+   /** Sets up a cuboid grid that encloses the box outside of which the density is smaller
+    * than rhocut, as estimated from the decay radii of the primitives (see
+    * GaussWaveFunction::getDensityBoundingBox). If hh>0, hh is the spacing of the grid
+    * in every direction; otherwise, the largest axis has nmx points, and the others
+    * have a proportional number of points (as in setUpSmartCuboidGrid).  */
+   void setUpDensityCuboidGrid(GaussWaveFunction &wf,const solreal rhocut,const int nmx,\
+         const solreal hh);
+   /* ******************************************************************************* */
+   /** Sets up a grid centered at the center of symmetry of sym, whose axes are the axes
+    * of the symmetry frame (so the step vectors dx[k] need not be parallel to the
+    * Cartesian axes), and which encloses the molecule as setUpSimpleGrid does. If
+    * nmx>0, the largest axis has nmx points and the others have a proportional number
+    * of points (as in setUpSmartCuboidGrid); otherwise, the points set with setNPts
+    * are used. The axes exchanged by the symmetry get the same size. The cubes made
+    * afterwards (makeCube, makeMultipleCubes) are evaluated only at the points of the
+    * asymmetric unit, and replicated by the symmetry operations. wf is not used.  */
+   void setUpSymmetricGrid(GaussWaveFunction &wf,bondNetWork &bn,molSymmetry &sym,\
+         const int nmx=0);
+   /** Returns the number of points that are actually evaluated (the whole grid if the
+    * symmetry is not used).  */
+   int getNOfSymmetryUniquePoints(void);
+   /** Returns the number of symmetry operations that map the grid onto itself.  */
+   int getNOfGridSymmetryOperations(void) {return nSymOps;}
+   /* ******************************************************************************* */
    void setNPts(int nx,int ny,int nz);
    /* ******************************************************************************* */
    void setNPts(int nn);
@@ -116,6 +185,10 @@ public:
    int getNPts(int ii);
    /* ******************************************************************************* */
    void writeCubeRho(ofstream &ofil,GaussWaveFunction &wf);
+   /** Same as writeCubeRho, but the grid is evaluated in tiles, each one with only the
+    * primitives that reach it. The tiles of each slab of WFGRID3DTILESIZE planes are
+    * shared among the threads.  */
+   void writeCubeRhoTiled(ofstream &ofil,GaussWaveFunction &wf);
    /* ******************************************************************************* */
    void writeCubeLapRho(ofstream &ofil,GaussWaveFunction &wf);
    /* ******************************************************************************* */
@@ -145,9 +218,39 @@ public:
    /* ******************************************************************************* */
    void writeCubeScalarCustFld(ofstream &ofil,GaussWaveFunction &wf);
    /* ******************************************************************************* */
+   /** Evaluates the nf fields ft[0],...,ft[nf-1] within a single traversal of the grid,
+    * and writes each field into the cube file onam[i]. The primitives (and their
+    * derivatives) are computed once per point for all the fields
+    * (see GaussWaveFunction::evalMultipleFields).  */
+   void makeMultipleCubes(string *onam,GaussWaveFunction &wf,ScalarFieldType *ft,const int nf);
+   /* ******************************************************************************* */
+   /** Non-covalent interactions (NCI) analysis: writes the cubes of sign(lambda2)rho
+    * (srhonam) and of the reduced density gradient s (rdgnam), and the histogram of the
+    * points in the (sign(lambda2)rho,s) plane (histnam). The density and its gradient are
+    * evaluated first; the points where rho>rhocut or s>scut are culled (both cubes take
+    * the value NCICULLEDPOINTVALUE there), and only the remaining points of each row
+    * need the Hessian, whose eigenvalues are computed in closed form for the whole row
+    * at once. If pmcull is not NULL, the points are first tested with the promolecular
+    * density pmcull (see NCIPROMOLCULLFACTOR), and the wave function is evaluated only
+    * at the points that pass this test. Returns the number of points that were not
+    * culled.  */
+   int makeNCICubes(string &srhonam,string &rdgnam,string &histnam,GaussWaveFunction &wf,\
+         const solreal rhocut,const solreal scut,proMolDensity *pmcull=NULL);
+   /* ******************************************************************************* */
 private:
    bool imsetup;
    int npts[3];
+   /* symRep[p] is the representative of the symmetry orbit of the point p (see
+      molSymmetry::getGridRepresentatives), or symRep is NULL.  */
+   int *symRep,nSymUnique,nSymOps;
+   /** Evaluates the fields ft on the representatives of the grid, and writes the
+    * (replicated) cubes onam.  */
+   void makeSymmetricCubes(string *onam,GaussWaveFunction &wf,ScalarFieldType *ft,\
+         const int nf);
+   /** Evaluates the density on the t-th tile of the slab of ni planes that starts at the
+    * plane i0, and saves it in slab (see writeCubeRhoTiled).  */
+   void evalRhoOnTile(GaussWaveFunction &wf,const int i0,const int ni,const int t,\
+         const solreal *rr,solreal *slab);
 };
 /* ********************************************************************************** */
 /* ********************************************************************************** */
@@ -80,6 +80,18 @@ void mkFileNames(char ** (&argv), optFlags &opts, string &i_fn, string &o_fn,str
     */
    //+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
    i_fn=string(argv[1]);
+   mkFileNamesFromWFName(argv,opts,i_fn,o_fn,l_fn);
+   if (opts.outfname) {
+      o_fn=argv[opts.outfname];
+      l_fn=o_fn;
+      o_fn.append(".cub");
+      l_fn.append("Cube.log");
+   }
+   return;
+}
+//**************************************************************************************************
+void mkFileNamesFromWFName(char ** (&argv),optFlags &opts,string &i_fn,string &o_fn,string &l_fn)
+{
    size_t pos;
    //string sl="wfn";
    //pos=i_fn.find(sl);
@@ -97,8 +109,10 @@ void mkFileNames(char ** (&argv), optFlags &opts, string &i_fn, string &o_fn,str
    o_fn.append("cub");
    l_fn.append("log");
    char prop;
+   bool multifld=false;
    if (opts.prop2plot) {
       prop=argv[opts.prop2plot][0];
+      multifld=(string(argv[opts.prop2plot]).length()>1);
    } else {
       prop='d';
    }
@@ -106,15 +120,54 @@ void mkFileNames(char ** (&argv), optFlags &opts, string &i_fn, string &o_fn,str
    if (pos!=string::npos) {
       string plbl=getFieldTypeKeyShort(prop);
       o_fn.insert(pos,plbl);
+      if ( multifld ) {plbl="MultiField";}
       plbl+=(string("Cube"));
       l_fn.insert(pos,plbl);
    }
+   return;
+}
+//**************************************************************************************************
+void mkMultiFieldFileNames(char ** (&argv), optFlags &opts,const string &i_fn,string* &o_fn,
+                           const int nf)
+{
+   string base;
    if (opts.outfname) {
-      o_fn=argv[opts.outfname];
-      l_fn=o_fn;
-      o_fn.append(".cub");
-      l_fn.append("Cube.log");
+      base=string(argv[opts.outfname]);
+   } else {
+      base=i_fn.substr(0,(i_fn.length()-4));
+   }
+   string props=(opts.prop2plot ? string(argv[opts.prop2plot]) : string("d"));
+   for ( int i=0 ; i<nf ; ++i ) {
+      o_fn[i]=base;
+      o_fn[i]+=getFieldTypeKeyShort(props[i]);
+      o_fn[i]+=string(".cub");
+   }
+   return;
+}
+//**************************************************************************************************
+string mkIsoSurfaceFileName(const string &cubnam,const string &ext,const string &sfx)
+{
+   string o_fn=cubnam;
+   size_t pos=o_fn.find_last_of('.');
+   if ( pos!=string::npos && o_fn.find_first_of('/',pos)==string::npos ) {o_fn.erase(pos);}
+   o_fn+=sfx;
+   o_fn+=string(".");
+   o_fn+=ext;
+   return o_fn;
+}
+//**************************************************************************************************
+void mkNCIFileNames(char ** (&argv),optFlags &opts,const string &i_fn,string &s_fn,
+                    string &r_fn,string &h_fn)
+{
+   string base;
+   if (opts.outfname) {
+      base=string(argv[opts.outfname]);
+   } else {
+      base=i_fn.substr(0,(i_fn.length()-4));
    }
+   s_fn=base+string("NCI-SL2Rho.cub");
+   r_fn=base+string("NCI-RDG.cub");
+   h_fn=base+string("NCI-Hist.dat");
    return;
 }
 
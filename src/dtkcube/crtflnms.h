@@ -80,6 +80,35 @@ using std::string;
  */
 void mkFileNames(char ** (&argv), optFlags &opts, string &i_fn, string &o_fn,string  &l_fn);
 
+/** This function makes the names of the cube (o_fn) and log (l_fn) files out of the name
+ of the wave function file i_fn (which is checked to be a wfn/wfx file). It is used by
+ mkFileNames, and for each wave function of the batch mode.
+ */
+void mkFileNamesFromWFName(char ** (&argv),optFlags &opts,string &i_fn,string &o_fn,string &l_fn);
+
+/** This function creates the names of the nf cube files that are written when
+   several fields are requested at once (e.g. -p dlE). The i-th name is built
+   as in mkFileNames, using the i-th character of the argument of option -p.
+   The array o_fn must have been allocated (nf strings) before calling this function.
+ */
+void mkMultiFieldFileNames(char ** (&argv), optFlags &opts,const string &i_fn,string* &o_fn,
+                           const int nf);
+
+/** This function makes the name of an isosurface file out of the name of the cube file
+   cubnam (the grid where the isosurface is extracted from), e.g. nameRho.cub
+   becomes nameRhoIso.ext (the suffix Iso can be replaced with sfx).
+ */
+string mkIsoSurfaceFileName(const string &cubnam,const string &ext,
+                            const string &sfx=string("Iso"));
+
+/** This function makes the names of the files of the NCI analysis (option --nci): the
+   cubes of sign(lambda2)rho (s_fn) and of the reduced density gradient (r_fn), and
+   the histogram (h_fn). The base name is the name of the wave function (or the one
+   given with -o).
+ */
+void mkNCIFileNames(char ** (&argv),optFlags &opts,const string &i_fn,string &s_fn,
+                    string &r_fn,string &h_fn);
+
 #endif //_CRTFLNMS_H
 
 
@@ -74,9 +74,69 @@ using std::setprecision;
 #include "../common/gausswavefunction.h"
 #include "../common/bondnetwork.h"
 #include "../common/wfgrid3d.h"
+#include "../common/solbatchtools.h"
+#include "../common/solstringtools.h"
+#include "../common/solpovtools.h"
+#include "../common/isosurface.h"
+#include "../common/octreegrid3d.h"
 #include "optflags.h"
 #include "crtflnms.h"
 
+/* Returns the field type associated to the character prop (as given to option -p),
+   or NONE if prop is not a field that dtkcube can evaluate.  */
+ScalarFieldType getCubeFieldType(const char prop);
+
+/* Evaluates the field(s) requested in the command line on a grid around the molecule of
+   the wave function infilnam, and writes the cube file(s) outfilnam (and the log file
+   logfilnam if requested). info is set to a brief description of the grid. The options
+   must have been checked with checkCubeOptions. Returns false if the wave function could
+   not be loaded or the cube(s) could not be made.  */
+bool makeCubesOfWaveFunction(char ** (&argv),optFlags &options,string &infilnam,
+      string &outfilnam,string &logfilnam,const clock_t begin_time,
+      const solreal begin_walltime,string &info);
+
+/* Makes the cube files of every wave function listed in argv[1] (batch mode).  */
+void makeCubesInBatch(char ** (&argv),optFlags &options);
+
+/* Checks the options that do not depend on the wave function (spacing, properties,
+   isovalue and the combinations of options). It is called once, before any wave function
+   is loaded. Returns false (after printing the error) if the options are wrong.  */
+bool checkCubeOptions(char ** (&argv),optFlags &options);
+
+/* Sets hh to the spacing given with the option --spacing=H. Returns false if it is
+   wrong.  */
+bool getGridSpacing(char ** (&argv),optFlags &options,solreal &hh);
+
+/* Sets isov to the isovalue given with the option --iso=VAL (or --mep-iso[=VAL]).
+   Returns false if it is missing or wrong.  */
+bool getIsoSurfaceValue(char ** (&argv),optFlags &options,solreal &isov);
+
+/* Writes the isosurface iso in the format chosen with --iso-fmt; the name of the file
+   is made out of cubnam, and returned in isonam.  */
+bool writeIsoSurface(char ** (&argv),optFlags &options,isoSurface &iso,\
+      const string &cubnam,string &isonam);
+
+/* Evaluates the MEP at the vertices of iso (option --mep-iso), and writes the statistics
+   of the MEP over the surface to the screen and to the file statnam.  */
+void mapMEPOnIsoSurface(char ** (&argv),optFlags &options,GaussWaveFunction &gwf,\
+      isoSurface &iso,const string &statnam);
+
+/* Non-covalent interactions analysis (option --nci) of the wave function gwf on the grid
+   grd. Returns false if the analysis could not be done.  */
+bool makeNCICubesOfWaveFunction(char ** (&argv),optFlags &options,GaussWaveFunction &gwf,\
+      waveFunctionGrid3D &grd,string &infilnam,string &logfilnam,const clock_t begin_time,\
+      const solreal begin_walltime);
+
+/* Evaluates the field ft (prop is its character) of gwf on an adaptive octree (option
+   --octree), whose finest level is the grid grd. If doiso is true, the isosurface isov
+   is extracted from the octree. Returns false if the octree could not be built.  */
+bool makeOctreeOfWaveFunction(char ** (&argv),optFlags &options,GaussWaveFunction &gwf,\
+      bondNetWork &bnw,waveFunctionGrid3D &grd,const ScalarFieldType ft,const char prop,\
+      const bool doiso,const solreal isov,string &infilnam,string &outfilnam,\
+      string &logfilnam,const clock_t begin_time,const solreal begin_walltime);
+
+/* Extracts the isosurface requested with --iso=VAL from the cube file argv[1].  */
+void extractIsoSurfaceFromCube(char ** (&argv),optFlags &options);
 
 
 int main (int argc, char ** argv)
@@ -90,9 +150,79 @@ int main (int argc, char ** argv)
    ofstream ofile;
    
    getOptions(argc,argv,options); //This processes the options from the command line.
-   mkFileNames(argv,options,infilnam,outfilnam,logfilnam); //This creates the names used.
-   printHappyStart(argv,CURRENTVERSION,PROGRAMCONTRIBUTORS); //Just to let the user know that the initial configuration is OK
+   if ( (!options.isofromcube)&&(!checkCubeOptions(argv,options)) ) {exit(1);}
+   if ( options.isofromcube ) {
+      printHappyStart(argv,CURRENTVERSION,PROGRAMCONTRIBUTORS);
+      extractIsoSurfaceFromCube(argv,options);
+   } else if ( options.batch ) {
+      printHappyStart(argv,CURRENTVERSION,PROGRAMCONTRIBUTORS);
+      makeCubesInBatch(argv,options);
+   } else {
+      mkFileNames(argv,options,infilnam,outfilnam,logfilnam); //This creates the names used.
+      printHappyStart(argv,CURRENTVERSION,PROGRAMCONTRIBUTORS); //Just to let the user know that the initial configuration is OK
+      string info;
+      if ( !makeCubesOfWaveFunction(argv,options,infilnam,outfilnam,logfilnam,\
+               begin_time,begin_walltime,info) ) {
+         exit(1);
+      }
+   }
    
+   setScrGreenBoldFont();
+   printHappyEnding();
+   printScrStarLine();
+   cout << setprecision(3) << "CPU Time: " << solreal( clock () - begin_time ) / CLOCKS_PER_SEC << "s" << endl;
+   solreal end_walltime=time(NULL);
+   cout << "Wall-clock time: " << solreal (end_walltime-begin_walltime) << "s" << endl;
+#if DEBUG
+   cout << "Debugging mode (under construction)..." << endl;
+#endif
+   printScrStarLine();
+   setScrNormalFont();
+   return 0;
+}
+//**************************************************************************************************
+ScalarFieldType getCubeFieldType(const char prop)
+{
+   switch (prop) {
+      case 'd':
+         return DENS;
+      case 'g':
+         return MGRD;
+      case 'l':
+         return LAPD;
+      case 'E':
+         return ELFD;
+      case 'P' :
+         return MLED;
+      case 'r' :
+         return ROSE;
+      case 's' :
+         return REDG;
+      case 'S':
+         return SENT;
+      case 'L':
+         return LOLD;
+      case 'M':
+         return MGLD;
+      case 'G':
+         return KEDG;
+      case 'K':
+         return KEDK;
+      case 'u' :
+         return SCFD;
+      case 'V':
+         return MEPD;
+      default:
+         break;
+   }
+   return NONE;
+}
+//**************************************************************************************************
+//**************************************************************************************************
+bool makeCubesOfWaveFunction(char ** (&argv),optFlags &options,string &infilnam,\
+      string &outfilnam,string &logfilnam,const clock_t begin_time,\
+      const solreal begin_walltime,string &info)
+{
    cout << endl << "Loading wave function from file: " << infilnam << endl;
    
    GaussWaveFunction gwf;
@@ -100,13 +230,18 @@ int main (int argc, char ** argv)
       setScrRedBoldFont();
       cout << "Error: the wave function could not be loaded!\n";
       setScrNormalFont();
-      exit(1);
+      return false;
    }
    
    
+   if ( options.promol ) {
+      if ( !gwf.useProMolecularDensity(true) ) {return false;}
+      cout << "Using the promolecular density instead of the wave function." << endl;
+   }
+   
    bondNetWork bnw;
-   bnw.readFromFile(infilnam); //Loading the bond-network (if the wave function
-                               //was read, there souldn't be problems here.
+   bnw.readFromWaveFunction(gwf); //Loading the bond-network from the wave function
+                                  //already in memory (the file is not parsed again).
    bnw.setUpBNW(); //To setup the bond network.
    
    waveFunctionGrid3D grid;
@@ -130,7 +265,48 @@ int main (int argc, char ** argv)
       grid.setNPts(nn);
    }
    
-   if ((options.setsmcub)||(options.setsmcub1)) {
+   solreal hh=0.0e0,rhocut=DEFAULTRHOCUTFORBOX;
+   if ( options.spacing && (!getGridSpacing(argv,options,hh)) ) {return false;}
+   if ( options.rhobox ) {
+      string str=argv[options.rhobox];
+      double tmp;
+      if ( str.find_first_of('=')!=string::npos ) {
+         if ( (sscanf(str.substr(str.find_first_of('=')+1).c_str(),"%lf",&tmp)!=1)||\
+               (tmp<=0.0e0) ) {
+            displayWarningMessage(string("Wrong threshold (")+str+string("), using the default."));
+         } else {
+            rhocut=solreal(tmp);
+         }
+      }
+   }
+   
+   if ( options.symm ) {
+      molSymmetry sym;
+      string str=argv[options.symm];
+      double tol;
+      if ( str.find_first_of('=')!=string::npos ) {
+         if ( (sscanf(str.substr(str.find_first_of('=')+1).c_str(),"%lf",&tol)!=1)||\
+               (tol<=0.0e0) ) {
+            displayWarningMessage(string("Wrong tolerance (")+str+string("), using the default."));
+         } else {
+            sym.setTolerance(solreal(tol));
+         }
+      }
+      if ( !sym.setUp(bnw) ) {return false;}
+      if ( !sym.checkWaveFunction(gwf) ) {
+         displayWarningMessage("The wave function is less symmetric than the nuclei!");
+      }
+      grid.setUpSymmetricGrid(gwf,bnw,sym,\
+            (((options.setsmcub)||(options.setsmcub1))? nn : 0));
+      cout << "Point group (operations that map a grid onto itself): "
+           << sym.getPointGroupName() << " (" << sym.getNOfOperations()
+           << " operations)." << endl;
+   } else if ( options.rhobox ) {
+      grid.setUpDensityCuboidGrid(gwf,rhocut,nn,hh);
+      cout << "Grid enclosing the region where rho>" << rhocut << "." << endl;
+   } else if ( options.spacing ) {
+      grid.setUpSpacedCuboidGrid(gwf,bnw,hh,EXTRASPACECUBEFACTOR*bnw.maxBondDist);
+   } else if ((options.setsmcub)||(options.setsmcub1)) {
       grid.setUpSmartCuboidGrid(gwf,bnw,nn);
    } else {
       grid.setUpSimpleGrid(gwf,bnw);
@@ -140,80 +316,116 @@ int main (int argc, char ** argv)
         << grid.getNPts(1) << " x " << grid.getNPts(2) << endl;
    cout << "Total number of points that will be computed: " 
         << (grid.getNPts(0)*grid.getNPts(1)*grid.getNPts(2)) << endl;
+   if ( options.symm ) {
+      cout << "Points that will be evaluated (symmetry-unique): "
+           << grid.getNOfSymmetryUniquePoints() << " (" << grid.getNOfGridSymmetryOperations()
+           << " operations used)" << endl;
+   }
+   info=string("Grid: ")+getStringFromInt(grid.getNPts(0))+string("x")
+      +getStringFromInt(grid.getNPts(1))+string("x")+getStringFromInt(grid.getNPts(2));
+   
+   if ( options.nci ) {
+      if ( options.ncipromol && (!options.promol) && (!gwf.setUpProMolecularDensity()) ) {
+         return false;
+      }
+      return makeNCICubesOfWaveFunction(argv,options,gwf,grid,infilnam,logfilnam,\
+            begin_time,begin_walltime);
+   }
    
-   /* Setting the property to be computed */
+   /* Setting the property (or properties) to be computed */
    
-   char prop;
+   string props;
    if (options.prop2plot) {
-      prop=argv[options.prop2plot][0];
+      props=string(argv[options.prop2plot]);
    } else {
-      prop='d';
+      props=string("d");
+   }
+   int nfld=props.length();
+   ScalarFieldType *flds=new ScalarFieldType[nfld];
+   //The properties and the combinations of options were checked by checkCubeOptions.
+   for ( int i=0 ; i<nfld ; ++i ) {flds[i]=getCubeFieldType(props[i]);}
+   solreal isov=0.0e0;
+   const bool doiso=(options.iso||options.mepiso);
+   const string isosfx=(options.mepiso ? string("IsoMEP") : string("Iso"));
+   if ( doiso && (!getIsoSurfaceValue(argv,options,isov)) ) {
+      delete[] flds;
+      return false;
+   }
+   if ( options.octree ) {
+      bool res=makeOctreeOfWaveFunction(argv,options,gwf,bnw,grid,flds[0],props[0],doiso,\
+            isov,infilnam,outfilnam,logfilnam,begin_time,begin_walltime);
+      delete[] flds;
+      return res;
+   }
+   bool wrtcube=!(doiso && (options.isoonly||options.mepiso));
+   string *outfilnams=NULL;
+   if ( nfld>1 ) {
+      alloc1DStringArray("outfilnams",nfld,outfilnams);
+      mkMultiFieldFileNames(argv,options,infilnam,outfilnams,nfld);
    }
    
    /* Main calculation loop, chooses between different available fields. */
    
    cout << "Evaluating and writing property..." << endl;
-   cout << "(Scalar Field to plot: " << getFieldTypeKeyLong(prop) << ")." << endl << endl;
-   switch (prop) {
-      case 'd':
-         grid.makeCube(outfilnam,gwf,DENS);
-         cout << endl;
-         break;
-      case 'g':
-         grid.makeCube(outfilnam,gwf,MGRD);
-         break;
-      case 'l':
-         grid.makeCube(outfilnam,gwf,LAPD);
-         cout << endl;
-         break;
-      case 'E':
-         grid.makeCube(outfilnam,gwf,ELFD);
-         break;
-      case 'P' :
-         grid.makeCube(outfilnam,gwf,MLED);
-         break;
-      case 'r' :
-         grid.makeCube(outfilnam,gwf,ROSE);
-         break;
-      case 's' :
-         grid.makeCube(outfilnam,gwf,REDG);
-         break;
-      case 'S':
-         grid.makeCube(outfilnam,gwf,SENT);
-         break;
-      case 'L':
-         grid.makeCube(outfilnam,gwf,LOLD);
-         break;
-      case 'M':
-         grid.makeCube(outfilnam,gwf,MGLD);
-         break;
-      case 'G':
-         grid.makeCube(outfilnam,gwf,KEDG);
-         break;
-      case 'K':
-         grid.makeCube(outfilnam,gwf,KEDK);
-         break;
-      case 'u' :
-         grid.makeCube(outfilnam,gwf,SCFD);
-         break;
-      case 'V':
-         grid.makeCube(outfilnam,gwf,MEPD);
-         break;
-      default:
-         setScrRedBoldFont();
-         cout << "Error: The property \"" << prop << "\" does not exist!" << endl;
-         setScrNormalFont();
-         exit(1);
-         break;
+   isoSurface iso;
+   string isonam;
+   if ( doiso ) {
+      cout << "(Scalar Field to plot: " << getFieldTypeKeyLong(props[0])
+           << ", isovalue: " << isov << ")." << endl << endl;
+      iso.extractFromWaveFunction(grid,gwf,flds[0],isov,(wrtcube? (&outfilnam) : NULL));
+      cout << "Isosurface: " << iso.nVert << " vertices, " << iso.nTri
+           << " triangles, area: " << iso.getArea() << endl;
+      if ( options.mepiso ) {
+         mapMEPOnIsoSurface(argv,options,gwf,iso,\
+               mkIsoSurfaceFileName(outfilnam,string("log"),isosfx));
+      }
+      writeIsoSurface(argv,options,iso,outfilnam,isonam);
+      if ( options.isoscene ) {
+         string incnam=mkIsoSurfaceFileName(outfilnam,string("inc"),isosfx);
+         string povnam=mkIsoSurfaceFileName(outfilnam,string("pov"),isosfx);
+         iso.writePOVMesh2File(incnam,string("DTKIsoSurface"));
+         /* The scene and the mesh are in the same directory.  */
+         size_t pos=incnam.find_last_of('/');
+         if ( pos!=string::npos ) {incnam.erase(0,pos+1);}
+         povRayConfProp pvp;
+         pvp.setIncludedObject(incnam,string("DTKIsoSurface"));
+         bnw.makePOVFile(povnam,pvp);
+         cout << "POV-Ray scene written in file: " << povnam << endl;
+      }
+   } else if ( nfld==1 ) {
+      cout << "(Scalar Field to plot: " << getFieldTypeKeyLong(props[0]) << ")." << endl << endl;
+      grid.makeCube(outfilnam,gwf,flds[0]);
+   } else {
+      cout << "(Scalar Fields to plot (single pass):";
+      for ( int i=0 ; i<nfld ; ++i ) {
+         cout << " " << getFieldTypeKeyLong(props[i]) << (i<(nfld-1) ? "," : "");
+      }
+      cout << ")." << endl << endl;
+      grid.makeMultipleCubes(outfilnams,gwf,flds,nfld);
    }
    
-   cout << endl << "Output written in file: " << outfilnam << endl;
+   if ( doiso ) {
+      cout << endl << "Isosurface written in file: " << isonam << endl;
+      if ( wrtcube ) {cout << "Cube written in file: " << outfilnam << endl;}
+   } else if ( nfld==1 ) {
+      cout << endl << "Output written in file: " << outfilnam << endl;
+   } else {
+      cout << endl << "Output written in files: " << endl;
+      for ( int i=0 ; i<nfld ; ++i ) { cout << "  " << outfilnams[i] << endl; }
+   }
 #if (defined(__APPLE__)||defined(__linux__)||defined(__CYGWIN__))
-   if (options.zipcube) {
+   if (options.zipcube && wrtcube) {
       string cmdl;
-      cmdl=string("gzip -9f ")+outfilnam;
       cout << "Calling gzip...";
-      system(cmdl.c_str());
+      if ( nfld==1 ) {
+         cmdl=string("gzip -9f ")+outfilnam;
+         system(cmdl.c_str());
+      } else {
+         for ( int i=0 ; i<nfld ; ++i ) {
+            cmdl=string("gzip -9f ")+outfilnams[i];
+            system(cmdl.c_str());
+         }
+      }
       cout << " Done!" << endl;
    }
 #endif
@@ -225,11 +437,21 @@ int main (int argc, char ** argv)
       lfil.open(logfilnam.c_str(),ios::out);
       writeCommentedHappyStart(argv,lfil,CURRENTVERSION,PROGRAMCONTRIBUTORS);
       lfil << "#Wave function file name: " << endl << infilnam << endl;
+      lfil << "#Field(s) evaluated: " << endl << props << endl;
+      if ( options.promol ) {lfil << "#(Evaluated from the promolecular density)" << endl;}
       lfil << "#Number of primitives: "  << endl << gwf.nPri << endl;
       lfil << "#Grid dimensions:" << endl
            << grid.getNPts(0) << " " << grid.getNPts(1) << " " << grid.getNPts(2) << endl;
       lfil << "#Total number of points in the cube:" << endl
            << (grid.getNPts(0)*grid.getNPts(1)*grid.getNPts(2)) << endl;
+      if ( options.symm ) {
+         lfil << "#Symmetry-unique points evaluated:" << endl
+              << grid.getNOfSymmetryUniquePoints() << endl;
+      }
+      if ( doiso ) {
+         lfil << "#Isovalue, vertices and triangles of the isosurface:" << endl
+              << isov << " " << iso.nVert << " " << iso.nTri << endl;
+      }
       lfil << "#CPU Time (sec):" << endl;
       lfil << scientific << setprecision(4)
            <<  solreal( clock () - begin_time ) / CLOCKS_PER_SEC << endl;
@@ -239,17 +461,404 @@ int main (int argc, char ** argv)
       lfil.close();
    }
    
-   setScrGreenBoldFont();
-   printHappyEnding();
-   printScrStarLine();
-   cout << setprecision(3) << "CPU Time: " << solreal( clock () - begin_time ) / CLOCKS_PER_SEC << "s" << endl;
-   solreal end_walltime=time(NULL);
-   cout << "Wall-clock time: " << solreal (end_walltime-begin_walltime) << "s" << endl;
-#if DEBUG
-   cout << "Debugging mode (under construction)..." << endl;
+   delete[] flds;
+   dealloc1DStringArray(outfilnams);
+   return true;
+}
+//**************************************************************************************************
+/* Data shared by the jobs of the batch mode (see makeCubesOfBatchJob).  */
+struct cubeBatchData {
+   char **argv;
+   optFlags *options;
+};
+//**************************************************************************************************
+bool makeCubesOfBatchJob(string &infilnam,void *ctx,string &info)
+{
+   cubeBatchData *dat=static_cast<cubeBatchData *>(ctx);
+   const clock_t begin_time = clock();
+   const solreal begin_walltime = time(NULL);
+   string outfilnam,logfilnam;
+   mkFileNamesFromWFName(dat->argv,*(dat->options),infilnam,outfilnam,logfilnam);
+   return makeCubesOfWaveFunction(dat->argv,*(dat->options),infilnam,outfilnam,logfilnam,\
+         begin_time,begin_walltime,info);
+}
+//**************************************************************************************************
+void makeCubesInBatch(char ** (&argv),optFlags &options)
+{
+   string lstfilnam=argv[1],*wfnams=NULL;
+   int nwf=readBatchList(lstfilnam,wfnams);
+   if ( nwf==0 ) {
+      setScrRedBoldFont();
+      cout << "Error: no wave function files could be read from " << lstfilnam << "!\n";
+      setScrNormalFont();
+      exit(1);
+   }
+   //The names of the output files are made out of the names of the wave functions.
+   optFlags jobopts=options;
+   jobopts.outfname=0;
+   cubeBatchData dat;
+   dat.argv=argv;
+   dat.options=&jobopts;
+   runBatchJobs(nwf,wfnams,makeCubesOfBatchJob,&dat,getBatchMemoryBudget(argv,options.batchmem),\
+         mkBatchSummaryFileName(lstfilnam,string("Cube")),false);
+   dealloc1DStringArray(wfnams);
+}
+//**************************************************************************************************
+bool checkCubeOptions(char ** (&argv),optFlags &options)
+{
+   solreal tmp;
+   if ( options.spacing && (!getGridSpacing(argv,options,tmp)) ) {return false;}
+   if ( options.symm && (options.iso||options.mepiso||options.nci||options.octree||\
+            options.rhobox||options.spacing) ) {
+      setScrRedBoldFont();
+      cout << "Error: The option --symm cannot be combined with --iso, --mep-iso, --nci, "
+           << "--octree, --rho-box or --spacing!" << endl;
+      setScrNormalFont();
+      return false;
+   }
+   if ( options.nci ) {
+      if ( options.iso||options.mepiso||options.prop2plot ) {
+         setScrRedBoldFont();
+         cout << "Error: The option --nci cannot be combined with -p, --iso or --mep-iso!"
+              << endl;
+         setScrNormalFont();
+         return false;
+      }
+      return true;
+   }
+   string props=(options.prop2plot ? string(argv[options.prop2plot]) : string("d"));
+   const int nfld=props.length();
+   ScalarFieldType ft;
+   for ( int i=0 ; i<nfld ; ++i ) {
+      ft=getCubeFieldType(props[i]);
+      if ( ft==NONE ) {
+         setScrRedBoldFont();
+         cout << "Error: The property \"" << props[i] << "\" does not exist!" << endl;
+         setScrNormalFont();
+         return false;
+      }
+      if ( options.promol && (!GaussWaveFunction::isProMolecularField(ft)) ) {
+         setScrRedBoldFont();
+         cout << "Error: The property \"" << props[i] << "\" cannot be evaluated from the "
+              << "promolecular density!" << endl;
+         setScrNormalFont();
+         return false;
+      }
+   }
+   if ( options.mepiso && options.promol ) {
+      setScrRedBoldFont();
+      cout << "Error: The option --mep-iso cannot be combined with --promol!" << endl;
+      setScrNormalFont();
+      return false;
+   }
+   if ( options.mepiso && ((nfld>1)||(getCubeFieldType(props[0])!=DENS)) ) {
+      setScrRedBoldFont();
+      cout << "Error: The MEP is mapped on an isosurface of the density (-p d)!" << endl;
+      setScrNormalFont();
+      return false;
+   }
+   if ( options.iso||options.mepiso ) {
+      if ( nfld>1 ) {
+         setScrRedBoldFont();
+         cout << "Error: The isosurface can be extracted from only one field!" << endl;
+         setScrNormalFont();
+         return false;
+      }
+      if ( !getIsoSurfaceValue(argv,options,tmp) ) {return false;}
+   }
+   if ( options.octree && (options.mepiso||(nfld>1)) ) {
+      setScrRedBoldFont();
+      cout << "Error: The option --octree admits only one field, and cannot be "
+           << "combined with --mep-iso!" << endl;
+      setScrNormalFont();
+      return false;
+   }
+   return true;
+}
+//**************************************************************************************************
+bool getGridSpacing(char ** (&argv),optFlags &options,solreal &hh)
+{
+   string str=argv[options.spacing];
+   double tmp;
+   if ( (sscanf(str.substr(str.find_first_of('=')+1).c_str(),"%lf",&tmp)!=1)||\
+         (tmp<=0.0e0) ) {
+      setScrRedBoldFont();
+      cout << "Error: Wrong spacing (" << str << ")!" << endl;
+      setScrNormalFont();
+      return false;
+   }
+   hh=solreal(tmp);
+   return true;
+}
+//**************************************************************************************************
+bool getIsoSurfaceValue(char ** (&argv),optFlags &options,solreal &isov)
+{
+   double val=0.0e0;
+   if ( options.mepiso ) {
+      string str=argv[options.mepiso];
+      if ( str.find_first_of('=')==string::npos ) {isov=0.001e0; return true;}
+      if ( sscanf(str.substr(str.find_first_of('=')+1).c_str(),"%lf",&val)!=1 ) {
+         setScrRedBoldFont();
+         cout << "Error: wrong isovalue in '" << str << "'!" << endl;
+         setScrNormalFont();
+         return false;
+      }
+      isov=solreal(val);
+      return true;
+   }
+   string str=(options.iso ? string(argv[options.iso]) : string(""));
+   if ( (!options.iso)||\
+         (sscanf(str.substr(str.find_first_of('=')+1).c_str(),"%lf",&val)!=1) ) {
+      setScrRedBoldFont();
+      cout << "Error: a valid isovalue must be given with the option --iso=VAL!" << endl;
+      setScrNormalFont();
+      return false;
+   }
+   isov=solreal(val);
+   return true;
+}
+//**************************************************************************************************
+bool writeIsoSurface(char ** (&argv),optFlags &options,isoSurface &iso,\
+      const string &cubnam,string &isonam)
+{
+   string fmt("obj");
+   if ( options.isofmt ) {
+      fmt=string(argv[options.isofmt]);
+      fmt=fmt.substr(fmt.find_first_of('=')+1);
+   }
+   const string sfx=(options.mepiso ? string("IsoMEP") : string("Iso"));
+   isonam=mkIsoSurfaceFileName(cubnam,(fmt==string("pov") ? string("inc") : fmt),sfx);
+   if ( fmt==string("ply") ) {
+      return iso.writePLYFile(isonam);
+   } else if ( fmt==string("pov") ) {
+      return iso.writePOVMesh2File(isonam,string("DTKIsoSurface"));
+   } else if ( fmt!=string("obj") ) {
+      displayWarningMessage(string("Unknown format '")+fmt+string("', using obj."));
+      isonam=mkIsoSurfaceFileName(cubnam,string("obj"),sfx);
+   }
+   return iso.writeOBJFile(isonam);
+}
+//**************************************************************************************************
+void mapMEPOnIsoSurface(char ** (&argv),optFlags &options,GaussWaveFunction &gwf,\
+      isoSurface &iso,const string &statnam)
+{
+   if ( options.meprange ) {
+      string str=argv[options.meprange];
+      double rng=0.0e0;
+      if ( (sscanf(str.substr(str.find_first_of('=')+1).c_str(),"%lf",&rng)!=1)||\
+            (rng<=0.0e0) ) {
+         displayWarningMessage(string("Wrong range (")+str+string("), using the default."));
+      } else {
+         iso.setColorRange(solreal(rng));
+      }
+   }
+   cout << "Evaluating the MEP at " << iso.nVert << " vertices..." << endl;
+   iso.evalFieldOnVertices(gwf,MEPD);
+   cout << endl;
+   iso.printVertexPropStats(cout);
+   ofstream ofil(statnam.c_str());
+   writeCommentedHappyStart(argv,ofil,CURRENTVERSION,PROGRAMCONTRIBUTORS);
+   iso.printVertexPropStats(ofil);
+   ofil.close();
+   cout << endl << "Surface statistics written in file: " << statnam << endl;
+}
+//**************************************************************************************************
+bool makeNCICubesOfWaveFunction(char ** (&argv),optFlags &options,GaussWaveFunction &gwf,\
+      waveFunctionGrid3D &grd,string &infilnam,string &logfilnam,const clock_t begin_time,\
+      const solreal begin_walltime)
+{
+   solreal rhocut=NCIDEFAULTRHOCUTOFF,scut=NCIDEFAULTRDGCUTOFF;
+   double val;
+   string str;
+   if ( options.ncirho ) {
+      str=argv[options.ncirho];
+      if ( (sscanf(str.substr(str.find_first_of('=')+1).c_str(),"%lf",&val)!=1)||\
+            (val<=0.0e0) ) {
+         displayWarningMessage(string("Wrong cutoff (")+str+string("), using the default."));
+      } else {
+         rhocut=solreal(val);
+      }
+   }
+   if ( options.ncis ) {
+      str=argv[options.ncis];
+      if ( (sscanf(str.substr(str.find_first_of('=')+1).c_str(),"%lf",&val)!=1)||\
+            (val<=0.0e0) ) {
+         displayWarningMessage(string("Wrong cutoff (")+str+string("), using the default."));
+      } else {
+         scut=solreal(val);
+      }
+   }
+   string srhonam,rdgnam,histnam;
+   mkNCIFileNames(argv,options,infilnam,srhonam,rdgnam,histnam);
+   cout << "Non-covalent interactions analysis (rho cutoff: " << rhocut << ", s cutoff: "
+        << scut << ")..." << endl << endl;
+   int ntot=grd.getNPts(0)*grd.getNPts(1)*grd.getNPts(2);
+   proMolDensity *pmcull=NULL;
+   if ( options.ncipromol && (!options.promol) ) {
+      pmcull=gwf.getProMolecularDensity();
+      cout << "(Points culled first with the promolecular density.)" << endl;
+   }
+   int nkept=grd.makeNCICubes(srhonam,rdgnam,histnam,gwf,rhocut,scut,pmcull);
+   cout << "Points within the cutoffs: " << nkept << " (" << setprecision(3)
+        << (100.0e0*solreal(nkept)/solreal(ntot)) << "%; the Hessian was evaluated only "
+        << "at these points)." << endl;
+   cout << endl << "Output written in files: " << endl
+        << "  " << srhonam << endl << "  " << rdgnam << endl << "  " << histnam << endl;
+#if (defined(__APPLE__)||defined(__linux__)||defined(__CYGWIN__))
+   if (options.zipcube) {
+      cout << "Calling gzip...";
+      string cmdl=string("gzip -9f ")+srhonam;
+      system(cmdl.c_str());
+      cmdl=string("gzip -9f ")+rdgnam;
+      system(cmdl.c_str());
+      cout << " Done!" << endl;
+   }
 #endif
-   printScrStarLine();
-   setScrNormalFont();
-   return 0;
+   if (options.wrtlog) {
+      ofstream lfil;
+      lfil.open(logfilnam.c_str(),ios::out);
+      writeCommentedHappyStart(argv,lfil,CURRENTVERSION,PROGRAMCONTRIBUTORS);
+      lfil << "#Wave function file name: " << endl << infilnam << endl;
+      lfil << "#NCI analysis, rho and s cutoffs: " << endl << rhocut << " " << scut << endl;
+      if ( options.promol ) {
+         lfil << "#(Evaluated from the promolecular density)" << endl;
+      } else if ( pmcull!=NULL ) {
+         lfil << "#(Points culled first with the promolecular density)" << endl;
+      }
+      lfil << "#Grid dimensions:" << endl
+           << grd.getNPts(0) << " " << grd.getNPts(1) << " " << grd.getNPts(2) << endl;
+      lfil << "#Points within the cutoffs:" << endl << nkept << endl;
+      lfil << "#CPU Time (sec):" << endl;
+      lfil << scientific << setprecision(4)
+           <<  solreal( clock () - begin_time ) / CLOCKS_PER_SEC << endl;
+      lfil << "#Wall-clock Time (sec):" << endl;
+      solreal tmp_walltime=time(NULL);
+      lfil << solreal (tmp_walltime-begin_walltime) << endl;
+      lfil.close();
+   }
+   return true;
+}
+//**************************************************************************************************
+bool makeOctreeOfWaveFunction(char ** (&argv),optFlags &options,GaussWaveFunction &gwf,\
+      bondNetWork &bnw,waveFunctionGrid3D &grd,const ScalarFieldType ft,const char prop,\
+      const bool doiso,const solreal isov,string &infilnam,string &outfilnam,\
+      string &logfilnam,const clock_t begin_time,const solreal begin_walltime)
+{
+   int maxlev=OCTREE_DEFAULTMAXLEVEL;
+   string str=argv[options.octree];
+   if ( (str.find_first_of('=')!=string::npos)&&\
+         (sscanf(str.substr(str.find_first_of('=')+1).c_str(),"%d",&maxlev)!=1) ) {
+      displayWarningMessage(string("Wrong number of levels (")+str+string("), using the default."));
+      maxlev=OCTREE_DEFAULTMAXLEVEL;
+   }
+   octreeGrid3D oct;
+   if ( !oct.setUp(grd,maxlev) ) {return false;}
+   if ( options.octtol ) {
+      str=argv[options.octtol];
+      double val;
+      if ( (sscanf(str.substr(str.find_first_of('=')+1).c_str(),"%lf",&val)!=1)||\
+            (val<=0.0e0) ) {
+         displayWarningMessage(string("Wrong tolerance (")+str+string("), using the default."));
+      } else {
+         oct.setTolerances(solreal(val),OCTREE_DEFAULTABSTOL*solreal(val)/OCTREE_DEFAULTRELTOL);
+      }
+   }
+   if ( doiso ) {oct.setIsoValue(isov);}
+   const int nfin=oct.getNPts(0)*oct.getNPts(1)*oct.getNPts(2);
+   cout << "Octree of " << maxlev << " levels (finest grid: " << oct.getNPts(0) << " x "
+        << oct.getNPts(1) << " x " << oct.getNPts(2) << ")." << endl;
+   cout << "(Scalar Field to plot: " << getFieldTypeKeyLong(prop);
+   if ( doiso ) {cout << ", isovalue: " << isov;}
+   cout << ")." << endl << endl;
+   if ( !oct.build(gwf,ft) ) {return false;}
+   const int neval=oct.getNOfEvaluations();
+   const solreal intg=oct.integrate();
+   cout << endl << "Evaluations: " << neval << " (" << setprecision(3)
+        << (100.0e0*solreal(neval)/solreal(nfin)) << "% of the finest grid), leaves: "
+        << oct.getNOfLeaves() << endl;
+   cout << "Integral of the field: " << setprecision(10) << intg << endl;
+   string comm=string("Octree of ")+getStringFromInt(maxlev)+string(" levels, field: ")
+      +getFieldTypeKeyLong(prop);
+   string octnam=mkIsoSurfaceFileName(outfilnam,string("oct"),string("Oct"));
+   oct.writeOctreeFile(octnam,gwf,comm);
+   cout << endl << "Octree written in file: " << octnam << endl;
+   if ( options.octcube ) {
+      oct.writeCubeFile(outfilnam,gwf,comm);
+      cout << "Cube (resampled) written in file: " << outfilnam << endl;
+   }
+   isoSurface iso;
+   if ( doiso ) {
+      string isonam;
+      oct.extractIsoSurface(iso,gwf,isov);
+      cout << "Isosurface: " << iso.nVert << " vertices, " << iso.nTri
+           << " triangles, area: " << iso.getArea() << endl;
+      if ( writeIsoSurface(argv,options,iso,outfilnam,isonam) ) {
+         cout << "Isosurface written in file: " << isonam << endl;
+      }
+      if ( options.isoscene ) {
+         string incnam=mkIsoSurfaceFileName(outfilnam,string("inc"));
+         string povnam=mkIsoSurfaceFileName(outfilnam,string("pov"));
+         iso.writePOVMesh2File(incnam,string("DTKIsoSurface"));
+         size_t pos=incnam.find_last_of('/');
+         if ( pos!=string::npos ) {incnam.erase(0,pos+1);}
+         povRayConfProp pvp;
+         pvp.setIncludedObject(incnam,string("DTKIsoSurface"));
+         bnw.makePOVFile(povnam,pvp);
+         cout << "POV-Ray scene written in file: " << povnam << endl;
+      }
+   }
+#if (defined(__APPLE__)||defined(__linux__)||defined(__CYGWIN__))
+   if ( options.zipcube && options.octcube ) {
+      cout << "Calling gzip...";
+      string cmdl=string("gzip -9f ")+outfilnam;
+      system(cmdl.c_str());
+      cout << " Done!" << endl;
+   }
+#endif
+   if (options.wrtlog) {
+      ofstream lfil;
+      lfil.open(logfilnam.c_str(),ios::out);
+      writeCommentedHappyStart(argv,lfil,CURRENTVERSION,PROGRAMCONTRIBUTORS);
+      lfil << "#Wave function file name: " << endl << infilnam << endl;
+      lfil << "#Field evaluated on an octree: " << endl << prop << endl;
+      if ( options.promol ) {lfil << "#(Evaluated from the promolecular density)" << endl;}
+      lfil << "#Levels of the octree, and dimensions of the finest grid:" << endl
+           << maxlev << " " << oct.getNPts(0) << " " << oct.getNPts(1) << " "
+           << oct.getNPts(2) << endl;
+      lfil << "#Evaluations, points of the finest grid, and leaves:" << endl
+           << neval << " " << nfin << " " << oct.getNOfLeaves() << endl;
+      lfil << "#Integral of the field:" << endl << scientific << setprecision(10)
+           << intg << endl;
+      if ( doiso ) {
+         lfil << "#Isovalue, vertices and triangles of the isosurface:" << endl
+              << isov << " " << iso.nVert << " " << iso.nTri << endl;
+      }
+      lfil << "#CPU Time (sec):" << endl;
+      lfil << scientific << setprecision(4)
+           <<  solreal( clock () - begin_time ) / CLOCKS_PER_SEC << endl;
+      lfil << "#Wall-clock Time (sec):" << endl;
+      solreal tmp_walltime=time(NULL);
+      lfil << solreal (tmp_walltime-begin_walltime) << endl;
+      lfil.close();
+   }
+   return true;
+}
+//**************************************************************************************************
+void extractIsoSurfaceFromCube(char ** (&argv),optFlags &options)
+{
+   solreal isov;
+   if ( !getIsoSurfaceValue(argv,options,isov) ) {exit(1);}
+   string cubnam=argv[1],isonam;
+   if ( options.isoscene ) {
+      displayWarningMessage("The scene needs a wave function, the option --iso-scene is ignored.");
+   }
+   cout << endl << "Extracting the isosurface " << isov << " from the cube file: "
+        << cubnam << endl;
+   isoSurface iso;
+   if ( !iso.extractFromCubeFile(cubnam,isov) && iso.nTri==0 ) {exit(1);}
+   cout << "Isosurface: " << iso.nVert << " vertices, " << iso.nTri
+        << " triangles, area: " << iso.getArea() << endl;
+   if ( writeIsoSurface(argv,options,iso,cubnam,isonam) ) {
+      cout << endl << "Isosurface written in file: " << isonam << endl;
+   }
 }
-
@@ -74,6 +74,9 @@
 
 #include "optflags.h"
 #include "../common/solscrutils.h"
+#include "../common/wfgrid3d.h"
+#include "../common/octreegrid3d.h"
+#include "../common/molsymmetry.h"
 
 #include <iostream>
 using std::cout;
@@ -100,6 +103,14 @@ optFlags::optFlags()
    setsmcub1=0;
    zipcube=0;
    wrtlog=0;
+   batch=batchmem=0;
+   iso=isoonly=isofmt=isoscene=isofromcube=0;
+   mepiso=meprange=0;
+   nci=ncirho=ncis=0;
+   promol=ncipromol=0;
+   octree=octtol=octcube=0;
+   symm=0;
+   rhobox=spacing=0;
 }
 
 
@@ -242,6 +253,9 @@ void printHelpMenu(int &argc, char** &argv)
         << "         \t\tS (Shannon Entropy Density)" << endl;
    cout << "         \t\tV (Molecular Electrostatic Potential)" << endl;
    cout << "         \t\tu (Scalar Custom Field)" << endl;
+   cout << "         \t  Several fields can be requested at once (e.g. -p dlELs). In" << endl
+        << "         \t  such a case, all the fields are evaluated in a single pass" << endl
+        << "         \t  over the grid, and one cube file is written per field." << endl;
 #if (defined(__APPLE__)||defined(__linux__))
    cout << "  -z     \tCompress the cube file using gzip (which must be installed" << endl
         << "         \t   in your system)." << endl;
@@ -251,6 +265,79 @@ void printHelpMenu(int &argc, char** &argv)
    //-------------------------------------------------------------------------------------
    cout << "  --help    \t\tSame as -h" << endl;
    cout << "  --version \t\tSame as -V" << endl;
+   cout << "  --batch   \t\tTreat wf?name as a list of wave function files (one per" << endl
+        << "            \t\t  line), and process all of them within this run. If the" << endl
+        << "            \t\t  program was built with OpenMP, the files are shared" << endl
+        << "            \t\t  among the threads. The output files of each wave" << endl
+        << "            \t\t  function are named as usual, and a summary is written" << endl
+        << "            \t\t  to the file listname-CubeBatch.log." << endl;
+   cout << "  --batch-mem=MB \tSet the memory budget for the concurrent jobs of" << endl
+        << "                 \t  --batch (default: 4096 MB)." << endl;
+   cout << "  --iso=VAL \t\tExtract the isosurface VAL of the field while the grid is" << endl
+        << "            \t\t  being computed (only one field can be requested). The" << endl
+        << "            \t\t  surface is written to a file named as the cube file," << endl
+        << "            \t\t  with the suffix Iso.obj (e.g. nameRhoIso.obj), and its" << endl
+        << "            \t\t  normals are computed from the gradient of the field." << endl;
+   cout << "  --iso-only\t\tDo not write the cube file (only the isosurface)." << endl;
+   cout << "  --iso-fmt=F \t\tSet the format of the isosurface file; F can be obj" << endl
+        << "              \t\t  (Wavefront, default), ply, or pov (POV-Ray mesh2)." << endl;
+   cout << "  --iso-scene \t\tAlso write a POV-Ray scene (nameRhoIso.pov) with the" << endl
+        << "              \t\t  molecule and the isosurface." << endl;
+   cout << "  --iso-from-cube \tTreat wf?name as a cube file, and extract the" << endl
+        << "                  \t  isosurface given with --iso=VAL from it." << endl;
+   cout << "  --mep-iso[=VAL] \tExtract the isosurface VAL of the density (default: " << endl
+        << "                  \t  0.001), and evaluate the MEP only at its vertices." << endl
+        << "                  \t  No cube file is written; the surface is colored by" << endl
+        << "                  \t  the MEP (nameRhoIsoMEP.obj, see --iso-fmt), and its" << endl
+        << "                  \t  statistics are written to nameRhoIsoMEP.log." << endl;
+   cout << "  --mep-range=R \tSaturate the colors of --mep-iso at -R (red) and R" << endl
+        << "                \t  (blue). By default, R is the largest |MEP| on the" << endl
+        << "                \t  surface." << endl;
+   cout << "  --nci     \t\tNon-covalent interactions analysis. Writes the cubes" << endl
+        << "            \t\t  of sign(lambda2)rho (nameNCI-SL2Rho.cub) and of the" << endl
+        << "            \t\t  reduced density gradient s (nameNCI-RDG.cub), and the" << endl
+        << "            \t\t  histogram of the points in the (sign(lambda2)rho,s)" << endl
+        << "            \t\t  plane (nameNCI-Hist.dat), in a single pass. Points" << endl
+        << "            \t\t  where rho or s exceed the cutoffs are skipped (both" << endl
+        << "            \t\t  cubes are set to " << NCICULLEDPOINTVALUE << " there)." << endl;
+   cout << "  --nci-rho=VAL \tSet the density cutoff of --nci (default: "
+        << NCIDEFAULTRHOCUTOFF << ")." << endl;
+   cout << "  --nci-s=VAL \t\tSet the s cutoff of --nci (default: "
+        << NCIDEFAULTRDGCUTOFF << ")." << endl;
+   cout << "  --nci-promol \t\tSkip the points of --nci whose promolecular rho or s" << endl
+        << "               \t\t  exceed " << NCIPROMOLCULLFACTOR << " times the cutoffs, "
+        << "without evaluating" << endl
+        << "               \t\t  the wave function there." << endl;
+   cout << "  --promol  \t\tUse the promolecular density (sum of spherical atomic" << endl
+        << "            \t\t  densities) instead of the wave function. This is a" << endl
+        << "            \t\t  fast approximation, available for the fields d, g, l," << endl
+        << "            \t\t  P, s and S, and for --nci." << endl;
+   cout << "  --octree[=L] \t\tEvaluate the field on an adaptive octree of L levels" << endl
+        << "               \t\t  (default: " << OCTREE_DEFAULTMAXLEVEL << "). The root cells are 2^L times" << endl
+        << "               \t\t  larger than the spacing of the grid (-n, -N, -s, -S)," << endl
+        << "               \t\t  and they are split only where the field is not well" << endl
+        << "               \t\t  interpolated (or where it crosses the isovalue of" << endl
+        << "               \t\t  --iso). The octree is written to nameRhoOct.oct," << endl
+        << "               \t\t  and the integral of the field is reported." << endl;
+   cout << "  --oct-tol=VAL \tSet the relative tolerance of the interpolation" << endl
+        << "                \t  error of --octree (default: " << OCTREE_DEFAULTRELTOL << ")." << endl;
+   cout << "  --oct-cube \t\tAlso write the octree, resampled on the finest grid, to" << endl
+        << "             \t\t  a cube file." << endl;
+   cout << "  --symm[=TOL] \t\tDetect the point group of the molecule, align the" << endl
+        << "               \t\t  grid with its symmetry frame (the axes of the cube" << endl
+        << "               \t\t  may then not be the Cartesian axes), and evaluate" << endl
+        << "               \t\t  the fields only at the symmetry-unique points of the" << endl
+        << "               \t\t  grid. The atoms may depart from the exact symmetry by" << endl
+        << "               \t\t  TOL bohr (default: " << MOLSYMM_DISTTOL << "). It cannot be combined" << endl
+        << "               \t\t  with --iso, --mep-iso, --nci or --octree." << endl;
+   cout << "  --rho-box[=CUT] \tEnclose with the grid only the region where the density" << endl
+        << "                  \t  is larger than CUT (default: " << DEFAULTRHOCUTFORBOX << "), as estimated" << endl
+        << "                  \t  from the decay radii of the primitives, instead of" << endl
+        << "                  \t  padding the molecule by a fixed margin. The largest" << endl
+        << "                  \t  axis gets the points set with -n or -S (all the axes" << endl
+        << "                  \t  have the same spacing), unless --spacing is given." << endl;
+   cout << "  --spacing=H \t\tSet the spacing of the grid to H bohr in every direction" << endl
+        << "              \t\t  (the number of points follows from the size of the box)." << endl;
    //-------------------------------------------------------------------------------------
 }//end printHelpMenu
 
@@ -261,7 +348,7 @@ void printErrorMsg(char** &argv,char lab)
    cout << "\nError: the option \"" << lab << "\" ";
    switch (lab) {
       case 'p':
-         cout << "should be followed by a character." << endl;
+         cout << "should be followed by one or more characters." << endl;
          break;
       case 'n':
          cout << "should be followed by an integer." << endl;
@@ -299,6 +386,46 @@ void processDoubleDashOptions(int &argc,char** &argv,optFlags &flags,int pos)
    } else if (str==string("help")) {
       printHelpMenu(argc,argv);
       exit(0);
+   } else if (str==string("batch")) {
+      flags.batch=pos;
+   } else if (str.substr(0,10)==string("batch-mem=")) {
+      flags.batchmem=pos;
+   } else if (str.substr(0,4)==string("iso=")) {
+      flags.iso=pos;
+   } else if (str==string("iso-only")) {
+      flags.isoonly=pos;
+   } else if (str.substr(0,8)==string("iso-fmt=")) {
+      flags.isofmt=pos;
+   } else if (str==string("iso-scene")) {
+      flags.isoscene=pos;
+   } else if (str==string("iso-from-cube")) {
+      flags.isofromcube=pos;
+   } else if ((str==string("mep-iso"))||(str.substr(0,8)==string("mep-iso="))) {
+      flags.mepiso=pos;
+   } else if (str.substr(0,10)==string("mep-range=")) {
+      flags.meprange=pos;
+   } else if (str==string("nci")) {
+      flags.nci=pos;
+   } else if (str.substr(0,8)==string("nci-rho=")) {
+      flags.ncirho=pos;
+   } else if (str.substr(0,6)==string("nci-s=")) {
+      flags.ncis=pos;
+   } else if (str==string("nci-promol")) {
+      flags.ncipromol=pos;
+   } else if (str==string("promol")) {
+      flags.promol=pos;
+   } else if ((str==string("octree"))||(str.substr(0,7)==string("octree="))) {
+      flags.octree=pos;
+   } else if (str.substr(0,8)==string("oct-tol=")) {
+      flags.octtol=pos;
+   } else if (str==string("oct-cube")) {
+      flags.octcube=pos;
+   } else if ((str==string("symm"))||(str.substr(0,5)==string("symm="))) {
+      flags.symm=pos;
+   } else if ((str==string("rho-box"))||(str.substr(0,8)==string("rho-box="))) {
+      flags.rhobox=pos;
+   } else if (str.substr(0,8)==string("spacing=")) {
+      flags.spacing=pos;
    } else {
       setScrRedBoldFont();
       cout << "Error: Unrecognized option '" << argv[pos] << "'" << endl;
@@ -83,6 +83,14 @@ public:
    unsigned short int infname,outfname,prop2plot,setn1,setn3;
    unsigned short int setsmcub,setsmcub1;
    unsigned short int zipcube,wrtlog;
+   unsigned short int batch,batchmem;
+   unsigned short int iso,isoonly,isofmt,isoscene,isofromcube;
+   unsigned short int mepiso,meprange;
+   unsigned short int nci,ncirho,ncis;
+   unsigned short int promol,ncipromol;
+   unsigned short int octree,octtol,octcube;
+   unsigned short int symm;
+   unsigned short int rhobox,spacing;
 };//end class optsFlags
 void printErrorMsg(char** &argv,char lab);
 void printHelpMenu(int &argc, char** &argv);//self-described
@@ -143,8 +143,8 @@ int main (int argc, char ** argv)
    /* Setting the bond network of the molecule */
    
    bondNetWork bnw;
-   bnw.readFromFile(infilnam); //Loading the bond-network (if the wave function
-                               //was read, there souldn't be problems here.
+   bnw.readFromWaveFunction(gwf); //Loading the bond-network from the wave function
+                                  //already in memory (the file is not parsed again).
    bnw.setUpBNW();             //To setup the bond network.
    
    /* Defining the main critical point network object. */
@@ -80,6 +80,21 @@ void mkFileNames(char ** (&argv), optFlags &opts, string &i_fn,string &o_fn,stri
     */
    //+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
    i_fn=string(argv[1]);
+   mkFileNamesFromWFName(i_fn,o_fn,p_fn,n_fn,c_fn,cpt);
+   if (opts.outfname) {
+      o_fn=argv[opts.outfname];
+      p_fn=n_fn=c_fn=o_fn;
+      o_fn.append(".log");
+      p_fn.append(".pov");
+      n_fn.append(".png");
+      c_fn.append(".cpx");
+   }
+   return;
+}
+
+void mkFileNamesFromWFName(string &i_fn,string &o_fn,string &p_fn,string &n_fn,string &c_fn,
+                           ScalarFieldType &cpt)
+{
    size_t pos;
    //string sl="wfn";
    //pos=i_fn.find(sl);
@@ -117,14 +132,19 @@ void mkFileNames(char ** (&argv), optFlags &opts, string &i_fn,string &o_fn,stri
       n_fn.insert(pos,plbl);
       c_fn.insert(pos,plbl);
    }
+   return;
+}
+
+void mkTrajectoryFileName(char ** (&argv),optFlags &opts,string &t_fn)
+{
    if (opts.outfname) {
-      o_fn=argv[opts.outfname];
-      p_fn=n_fn=c_fn=o_fn;
-      o_fn.append(".log");
-      p_fn.append(".pov");
-      n_fn.append(".png");
-      c_fn.append(".cpx");
+      t_fn=argv[opts.outfname];
+   } else {
+      t_fn=string(argv[1]);
+      size_t pos=t_fn.find_last_of('.');
+      if ((pos!=string::npos)&&(t_fn.find_first_of('/',pos)==string::npos)) {t_fn.erase(pos);}
    }
+   t_fn.append("-CPTrack.dat");
    return;
 }
 
@@ -139,4 +159,18 @@ void mkDatMatFileNames(string &lgfn,string &acfn,string &cpfn,string &bpfn)
    return;
 }
 
+void mkBasinsFileName(string &lgfn,string &bsfn)
+{
+   bsfn=lgfn.substr(0,(lgfn.length()-4));
+   bsfn.append("-Basins.log");
+   return;
+}
+
+void mkIASFileName(string &lgfn,string &iasfn)
+{
+   iasfn=lgfn.substr(0,(lgfn.length()-4));
+   iasfn.append("-IAS.obj");
+   return;
+}
+
 #endif //_CRTFLNMS_CPP
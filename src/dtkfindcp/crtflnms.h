@@ -84,6 +84,19 @@ using std::string;
 void mkFileNames(char ** (&argv), optFlags &opts, string &i_fn,string &l_fn,string &p_fn,
                  string &n_fn,string &c_fn,ScalarFieldType &cpt);
 
+/** This function makes the names of the log (l_fn), pov (p_fn), png (n_fn) and cpx (c_fn)
+ files out of the name of the wave function file i_fn (which is checked to be a wfn/wfx
+ file). It is used by mkFileNames, and for each frame of a trajectory.
+ */
+void mkFileNamesFromWFName(string &i_fn,string &l_fn,string &p_fn,string &n_fn,string &c_fn,
+                           ScalarFieldType &cpt);
+
+/** This function makes the name of the file where the identities of the critical points
+ along a trajectory are saved. The base name is either the list of frames (argv[1],
+ without extension), or the name given with the option -o.
+ */
+void mkTrajectoryFileName(char ** (&argv),optFlags &opts,string &t_fn);
+
 /**
  This function creates some extra names. It takes as base name the string lgfn.
  It is assumed that lgfn is the name of the log file used in the program.
@@ -91,6 +104,16 @@ void mkFileNames(char ** (&argv), optFlags &opts, string &i_fn,string &l_fn,stri
  */
 void mkDatMatFileNames(string &lgfn,string &atfn,string &cpfn,string &bpfn);
 
+/** This function makes the name of the file where the basins of the density are saved
+ (bsfn), out of the name of the log file (lgfn).
+ */
+void mkBasinsFileName(string &lgfn,string &bsfn);
+
+/** This function makes the name of the (Wavefront obj) file where the interatomic
+ surfaces are saved (iasfn), out of the name of the log file (lgfn).
+ */
+void mkIASFileName(string &lgfn,string &iasfn);
+
 #endif //_CRTFLNMS_H
 
 
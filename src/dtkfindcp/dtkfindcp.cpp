@@ -95,10 +95,374 @@ using std::setprecision;
 #include "../common/gausswavefunction.h"
 #include "../common/bondnetwork.h"
 #include "../common/critptnetwork.h"
+#include "../common/wfgrid3d.h"
+#include "../common/basingrid3d.h"
+#include "../common/iasnetwork.h"
+#include "../common/solbatchtools.h"
+#include "../common/solstringtools.h"
 #include "optflags.h"
 #include "crtflnms.h"
 #include "custfmtmathfuncts.h"
 
+/* Passes the search options of the command line to the critical point network.  */
+void setCPSearchOptions(critPtNetWork &cpn,optFlags &options)
+{
+   if ( options.trustreg ) {cpn.setTrustRegionCPSearch(true);}
+   if ( options.hessupd ) {cpn.setHessianUpdateCPSearch(true);}
+   if ( options.mkgridsearch ) {cpn.setGridSearch(true);}
+}
+
+/* Returns a new network of critical points of the density of gwf. If --promol-seeds was
+   given, the CPs of the promolecular density are sought first, and they are followed
+   into the density of the wave function (critPtNetWork::setRhoCPsFromPreviousFrame, the
+   promolecular network playing the role of the previous frame). A full search is done
+   if the promolecular CPs do not satisfy the Poincare-Hopf relation, or if any of them
+   cannot be followed. seeded tells whether the promolecular seeds were used.  */
+critPtNetWork *newRhoCPNetWork(GaussWaveFunction &gwf,bondNetWork &bnw,optFlags &options,\
+      bool &seeded)
+{
+   critPtNetWork *cpn=new critPtNetWork(gwf,bnw);
+   setCPSearchOptions(*cpn,options);
+   seeded=false;
+   if ( options.promolseeds && (!gwf.usesProMolecularDensity()) ) {
+      GaussWaveFunction pwf;
+      if ( pwf.shareDataFrom(gwf) && pwf.useProMolecularDensity(true) ) {
+         cout << "Seeking the critical points of the promolecular density..." << endl;
+         critPtNetWork pcpn(pwf,bnw);
+         setCPSearchOptions(pcpn,options);
+         pcpn.setCriticalPoints(DENS);
+         if ( (pcpn.nACP-pcpn.nBCP+pcpn.nRCP-pcpn.nCCP)==1 ) {
+            seeded=cpn->setRhoCPsFromPreviousFrame(pcpn);
+         }
+      }
+      if ( !seeded ) {
+         cout << "The promolecular seeds failed, doing a full search..." << endl;
+         delete cpn;
+         cpn=new critPtNetWork(gwf,bnw);
+         setCPSearchOptions(*cpn,options);
+      }
+   }
+   if ( !seeded ) {cpn->setCriticalPoints(DENS);}
+   return cpn;
+}
+
+/* Finds the critical points of every frame of the trajectory listed in argv[1] (one wave
+   function file per line; empty lines and lines starting with '#' are skipped). From the
+   second frame on, the CPs of the density are sought from the CPs of the previous frame
+   (critPtNetWork::setRhoCPsFromPreviousFrame), and a full search is done only if they
+   cannot be tracked. Every CP gets an identity, which is kept along the trajectory, and
+   the identities are written to the file made by mkTrajectoryFileName.  */
+void findCPsAlongTrajectory(char ** (&argv),optFlags &options,ScalarFieldType critpttype)
+{
+   string lstfilnam=argv[1],trkfilnam,infilnam,outfilnam,povfilnam,pngfilnam,cpxfilnam;
+   ifstream lfil(lstfilnam.c_str());
+   if ( !lfil.good() ) {
+      setScrRedBoldFont();
+      cout << "Error: the list of frames " << lstfilnam << " could not be opened!\n";
+      setScrNormalFont();
+      exit(1);
+   }
+   mkTrajectoryFileName(argv,options,trkfilnam);
+   ofstream tfil(trkfilnam.c_str());
+   tfil << "#Frame Search nACP nBCP nRCP nCCP WaveFunction" << endl
+        << "#  followed by the identities of the ACPs, BCPs, RCPs and CCPs (in the" << endl
+        << "#  order of the log and cpx files of the frame)." << endl;
+   const char cpts[4]={'a','b','r','c'};
+   const string cplbls[4]={"ACPs:","BCPs:","RCPs:","CCPs:"};
+   GaussWaveFunction *gwf,*pgwf=NULL;
+   bondNetWork *bnw,*pbnw=NULL;
+   critPtNetWork *cpn,*pcpn=NULL;
+   int *ids[4],*pids[4]={NULL,NULL,NULL,NULL},nxtid[4]={0,0,0,0},ncp[4];
+   int nfr=0,ntrk=0;
+   bool tracked;
+   size_t pos;
+   while ( getline(lfil,infilnam) ) {
+      pos=infilnam.find_first_not_of(" \t\r");
+      if ( pos==string::npos || infilnam[pos]=='#' ) {continue;}
+      infilnam.erase(0,pos);
+      infilnam.erase(infilnam.find_last_not_of(" \t\r")+1);
+      mkFileNamesFromWFName(infilnam,outfilnam,povfilnam,pngfilnam,cpxfilnam,critpttype);
+      printScrStarLine();
+      cout << "Frame " << nfr << ": " << infilnam << endl;
+      gwf=new GaussWaveFunction();
+      if (!(gwf->readFromFile(infilnam))) {
+         setScrRedBoldFont();
+         cout << "Error: the wave function could not be loaded!\n";
+         setScrNormalFont();
+         exit(1);
+      }
+      bnw=new bondNetWork();
+      bnw->readFromWaveFunction(*gwf);
+      bnw->setUpBNW();
+      cpn=new critPtNetWork(*gwf,*bnw);
+      setCPSearchOptions(*cpn,options);
+      tracked=false;
+      if ( pcpn!=NULL && critpttype==DENS ) {
+         tracked=cpn->setRhoCPsFromPreviousFrame(*pcpn);
+         if ( !tracked ) {
+            delete cpn;
+            cpn=new critPtNetWork(*gwf,*bnw);
+            setCPSearchOptions(*cpn,options);
+         }
+      }
+      if ( !tracked ) {cpn->setCriticalPoints(critpttype);}
+      if ( critpttype==DENS && options.calcbgps ) {cpn->setBondPaths();}
+      if ( options.mkextsearch && !tracked ) {cpn->extendedSearchCPs();}
+      if (options.calcrgps) {
+         cpn->setRingPaths();
+         cpn->setCagePaths();
+      }
+      ncp[0]=cpn->nACP;
+      ncp[1]=cpn->nBCP;
+      ncp[2]=cpn->nRCP;
+      ncp[3]=cpn->nCCP;
+      for ( int t=0 ; t<4 ; t++ ) {
+         alloc1DIntArray(string("ids"),((ncp[t]>0)? ncp[t] : 1),ids[t],-1);
+         if ( tracked ) {
+            for ( int i=0 ; i<ncp[t] ; i++ ) {ids[t][i]=pids[t][i];}
+            continue;
+         }
+         if ( pcpn!=NULL ) {cpn->matchCPsToPreviousFrame(cpts[t],*pcpn,ids[t]);}
+         for ( int i=0 ; i<ncp[t] ; i++ ) {
+            ids[t][i]=((ids[t][i]>=0)? pids[t][ids[t][i]] : (nxtid[t]++));
+         }
+      }
+      if ( tracked ) {++ntrk;}
+      cpn->writeCPProps(outfilnam,infilnam);
+      writeCPXFile(cpxfilnam,infilnam,*cpn);
+      cout << "Output written in files: " << outfilnam << ", and " << cpxfilnam << endl;
+      tfil << nfr << (tracked? " tracked" : " full") << " " << ncp[0] << " " << ncp[1]
+           << " " << ncp[2] << " " << ncp[3] << " " << infilnam << endl;
+      for ( int t=0 ; t<4 ; t++ ) {
+         tfil << "   " << cplbls[t];
+         for ( int i=0 ; i<ncp[t] ; i++ ) {tfil << " " << ids[t][i];}
+         tfil << endl;
+      }
+      if ( pcpn!=NULL ) {
+         delete pcpn;
+         delete pbnw;
+         delete pgwf;
+         for ( int t=0 ; t<4 ; t++ ) {dealloc1DIntArray(pids[t]);}
+      }
+      pcpn=cpn;
+      pbnw=bnw;
+      pgwf=gwf;
+      for ( int t=0 ; t<4 ; t++ ) {pids[t]=ids[t];}
+      ++nfr;
+   }
+   lfil.close();
+   tfil.close();
+   if ( pcpn!=NULL ) {
+      delete pcpn;
+      delete pbnw;
+      delete pgwf;
+      for ( int t=0 ; t<4 ; t++ ) {dealloc1DIntArray(pids[t]);}
+   }
+   printScrStarLine();
+   cout << "Frames: " << nfr << " (tracked: " << ntrk << ", full searches: "
+        << (nfr-ntrk) << ")" << endl;
+   cout << "Identities of the critical points written in file: " << trkfilnam << endl;
+}
+
+/* Data shared by the jobs of the batch mode (see findCPsOfBatchJob).  */
+struct cpBatchData {
+   optFlags *options;
+   ScalarFieldType critpttype;
+};
+
+/* Finds the CPs of one wave function of the batch mode, and writes its log and cpx files.
+   ctx points to a cpBatchData object.  */
+bool findCPsOfBatchJob(string &infilnam,void *ctx,string &info)
+{
+   cpBatchData *dat=static_cast<cpBatchData *>(ctx);
+   string outfilnam,povfilnam,pngfilnam,cpxfilnam;
+   mkFileNamesFromWFName(infilnam,outfilnam,povfilnam,pngfilnam,cpxfilnam,dat->critpttype);
+   GaussWaveFunction gwf;
+   if (!(gwf.readFromFile(infilnam))) {
+      info="The wave function could not be loaded.";
+      return false;
+   }
+   bondNetWork bnw;
+   bnw.readFromWaveFunction(gwf);
+   bnw.setUpBNW();
+   if ( dat->options->promol && (!gwf.useProMolecularDensity(true)) ) {
+      info="The promolecular density could not be set up.";
+      return false;
+   }
+   critPtNetWork *cpnp;
+   bool seeded=false;
+   if ( dat->critpttype==DENS ) {
+      cpnp=newRhoCPNetWork(gwf,bnw,*(dat->options),seeded);
+   } else {
+      cpnp=new critPtNetWork(gwf,bnw);
+      setCPSearchOptions(*cpnp,*(dat->options));
+      cpnp->setCriticalPoints(dat->critpttype);
+   }
+   critPtNetWork &cpn=*cpnp;
+   if ( dat->critpttype==DENS && dat->options->calcbgps ) {cpn.setBondPaths();}
+   if ( dat->options->mkextsearch ) {cpn.extendedSearchCPs();}
+   if ( dat->options->calcrgps ) {
+      cpn.setRingPaths();
+      cpn.setCagePaths();
+   }
+   string wfdesc=infilnam+(gwf.usesProMolecularDensity()? \
+         string(" (promolecular density)") : string(""));
+   cpn.writeCPProps(outfilnam,wfdesc);
+   writeCPXFile(cpxfilnam,infilnam,cpn);
+   info=string("nACP,nBCP,nRCP,nCCP: ")+getStringFromInt(cpn.nACP)+string(",")
+      +getStringFromInt(cpn.nBCP)+string(",")+getStringFromInt(cpn.nRCP)+string(",")
+      +getStringFromInt(cpn.nCCP)+(seeded? string(" (promolecular seeds)") : string(""));
+   delete cpnp;
+   return true;
+}
+
+/* Finds the CPs of every wave function listed in argv[1] (batch mode).  */
+void findCPsInBatch(char ** (&argv),optFlags &options,ScalarFieldType critpttype)
+{
+   string lstfilnam=argv[1],*wfnams=NULL;
+   int nwf=readBatchList(lstfilnam,wfnams);
+   if ( nwf==0 ) {
+      setScrRedBoldFont();
+      cout << "Error: no wave function files could be read from " << lstfilnam << "!\n";
+      setScrNormalFont();
+      exit(1);
+   }
+   cpBatchData dat;
+   dat.options=&options;
+   dat.critpttype=critpttype;
+   runBatchJobs(nwf,wfnams,findCPsOfBatchJob,&dat,getBatchMemoryBudget(argv,options.batchmem),\
+         mkBatchSummaryFileName(lstfilnam,string("CP")),(options.quiet==0));
+   dealloc1DStringArray(wfnams);
+}
+
+/* Returns the field type associated to the character prop (the characters are those of
+   the option -p of dtkcube), or NONE if prop is not a field that can be integrated over
+   the basins.  */
+ScalarFieldType getBasinFieldType(const char prop)
+{
+   switch (prop) {
+      case 'd':
+         return DENS;
+      case 'g':
+         return MGRD;
+      case 'l':
+         return LAPD;
+      case 'E':
+         return ELFD;
+      case 'P' :
+         return MLED;
+      case 'r' :
+         return ROSE;
+      case 's' :
+         return REDG;
+      case 'S':
+         return SENT;
+      case 'L':
+         return LOLD;
+      case 'M':
+         return MGLD;
+      case 'G':
+         return KEDG;
+      case 'K':
+         return KEDK;
+      case 'u' :
+         return SCFD;
+      case 'V':
+         return MEPD;
+      default:
+         break;
+   }
+   return NONE;
+}
+
+/* Partitions a grid around the molecule into the basins of the ACPs of cpn, integrates
+   the populations (and the fields requested with --basins-fields) over the basins,
+   and writes the results to the screen and to the file made by mkBasinsFileName.  */
+void findBasins(char ** (&argv),optFlags &options,GaussWaveFunction &gwf,bondNetWork &bnw,
+      critPtNetWork &cpn,string &infilnam,string &outfilnam)
+{
+   solreal hh=BASINGRID_DEFAULTSPACING;
+   if ( options.basinsh ) {
+      string str=argv[options.basinsh];
+      double val=0.0e0;
+      if ( (sscanf(str.substr(str.find_first_of('=')+1).c_str(),"%lf",&val)!=1)||\
+            (val<=0.0e0) ) {
+         displayWarningMessage(string("Wrong spacing (")+str+string("), using the default."));
+      } else {
+         hh=solreal(val);
+      }
+   }
+   ScalarFieldType *flds=NULL;
+   int nfld=0;
+   if ( options.basinsfld ) {
+      string str=argv[options.basinsfld];
+      str.erase(0,str.find_first_of('=')+1);
+      nfld=str.length();
+      flds=new ScalarFieldType[((nfld>0)? nfld : 1)];
+      for ( int i=0 ; i<nfld ; ++i ) {
+         flds[i]=getBasinFieldType(str[i]);
+         if ( flds[i]==NONE ) {
+            setScrRedBoldFont();
+            cout << "Error: The property \"" << str[i] << "\" does not exist!" << endl;
+            setScrNormalFont();
+            exit(1);
+         }
+      }
+   }
+   waveFunctionGrid3D grid;
+   grid.setUpSpacedCuboidGrid(gwf,bnw,hh,BASINGRID_DEFAULTMARGIN);
+   basinGrid3D bsn;
+   if ( bsn.setUpFromGrid(grid) && bsn.assignBasins(gwf,cpn) ) {
+      if ( nfld>0 ) {bsn.integrateFields(gwf,flds,nfld);}
+      bsn.printResults(cout,gwf,cpn);
+      string bsfilnam;
+      mkBasinsFileName(outfilnam,bsfilnam);
+      bsn.writeResults(bsfilnam,infilnam,gwf,cpn);
+      cout << "Basins written in file: " << bsfilnam << endl;
+   }
+   if ( flds!=NULL ) {delete[] flds;}
+}
+
+/* Builds the interatomic surfaces of the BCPs of cpn, and writes them into the file made
+   by mkIASFileName.  */
+void findInterAtomicSurfaces(char ** (&argv),optFlags &options,GaussWaveFunction &gwf,
+      critPtNetWork &cpn,string &outfilnam)
+{
+   iaSurfaceNetWork ias;
+   if ( options.iasrays ) {
+      string str=argv[options.iasrays];
+      int nr=0;
+      if ( (sscanf(str.substr(str.find_first_of('=')+1).c_str(),"%d",&nr)!=1)||(nr<3) ) {
+         displayWarningMessage(string("Wrong number of rays (")+str+string("), using the default."));
+      } else {
+         ias.setNofRays(nr);
+      }
+   }
+   if ( !ias.buildSurfaces(gwf,cpn) ) {return;}
+   ias.printSummary(cout,cpn);
+   string iasfilnam;
+   mkIASFileName(outfilnam,iasfilnam);
+   ias.writeOBJFile(iasfilnam,cpn);
+   cout << "Interatomic surfaces written in file: " << iasfilnam << endl;
+}
+
+/* Prints the final message, with the CPU and wall-clock times.  */
+void printEndOfRun(const clock_t begin_time,const solreal begin_walltime)
+{
+   setScrGreenBoldFont();
+   printHappyEnding();
+   printScrStarLine();
+   cout << setprecision(3) << "CPU Time: "
+        << solreal( clock () - begin_time ) / CLOCKS_PER_SEC << "s" << endl;
+   solreal end_walltime=time(NULL);
+   cout << "Wall-clock time: " << solreal (end_walltime-begin_walltime) << "s" << endl;
+#if DEBUG
+   cout << "Debuggin mode (under construction...)" << endl;
+#endif
+   printScrStarLine();
+   setScrNormalFont();
+}
+
 int main (int argc, char ** argv)
 {
    const clock_t begin_time = clock();
@@ -130,6 +494,26 @@ int main (int argc, char ** argv)
       }
    }
    
+   if ( options.promol && critpttype!=DENS ) {
+      displayErrorMessage("The option --promol is only available for the density (-t d).");
+      exit(1);
+   }
+   if ( options.trajectory ) {
+      if ( options.promol||options.promolseeds ) {
+         displayWarningMessage("The promolecular options are ignored along trajectories.");
+      }
+      printHappyStart(argv,CURRENTVERSION,PROGRAMCONTRIBUTORS);
+      findCPsAlongTrajectory(argv,options,critpttype);
+      printEndOfRun(begin_time,begin_walltime);
+      return 0;
+   }
+   if ( options.batch ) {
+      printHappyStart(argv,CURRENTVERSION,PROGRAMCONTRIBUTORS);
+      findCPsInBatch(argv,options,critpttype);
+      printEndOfRun(begin_time,begin_walltime);
+      return 0;
+   }
+   
    mkFileNames(argv,options,infilnam,outfilnam,povfilnam,
                pngfilnam,cpxfilnam,critpttype); //This creates the names used.
    printHappyStart(argv,CURRENTVERSION,PROGRAMCONTRIBUTORS); //Just to let the user know that the initial configuration is OK
@@ -151,23 +535,29 @@ int main (int argc, char ** argv)
    //return 0;
    
    bondNetWork bnw;
-   bnw.readFromFile(infilnam); //Loading the bond-network (if the wave function
-                               //was read, there souldn't be problems here.
+   bnw.readFromWaveFunction(gwf); //Loading the bond-network from the wave function
+                                  //already in memory (the file is not parsed again).
    bnw.setUpBNW();             //To setup the bond network.
    
-   critPtNetWork cpn(gwf,bnw);
+   if ( options.promol ) {
+      if ( !gwf.useProMolecularDensity(true) ) {exit(1);}
+      cout << "Using the promolecular density instead of the wave function." << endl;
+   }
    
+   critPtNetWork *cpnp;
+   bool seeded=false;
    switch (critpttype) {
       case DENS:
-         cpn.setCriticalPoints(DENS);
-         if (options.calcbgps) {cpn.setBondPaths();}
-         break;
-      case LOLD:
-         cpn.setCriticalPoints(LOLD);
+         cpnp=newRhoCPNetWork(gwf,bnw,options,seeded);
+         if (options.calcbgps) {cpnp->setBondPaths();}
          break;
       default:
+         cpnp=new critPtNetWork(gwf,bnw);
+         setCPSearchOptions(*cpnp,options);
+         cpnp->setCriticalPoints(critpttype);
          break;
    }
+   critPtNetWork &cpn=*cpnp;
    if ( options.mkextsearch ) {
       cpn.extendedSearchCPs();
    }
@@ -175,13 +565,15 @@ int main (int argc, char ** argv)
       cpn.setRingPaths();
       cpn.setCagePaths();
    }
+   if ( !options.quiet ) {cpn.displayCPSearchStats();}
 
    //cpn.displayIHVCoords();
    //cpn.displayACPCoords();
    //cpn.displayBCPCoords();
    //cpn.printCPProps(gwf);
    
-   cpn.writeCPProps(outfilnam,infilnam);
+   string wfdesc=infilnam+(options.promol? string(" (promolecular density)") : string(""));
+   cpn.writeCPProps(outfilnam,wfdesc);
    ofstream lfil;
    lfil.open(outfilnam.c_str(),std::ofstream::app);
    lfil << setprecision(3) << "CPU Time: " << endl
@@ -191,6 +583,21 @@ int main (int argc, char ** argv)
    
    cout << endl << "Output written in files: " << outfilnam << ", and " << cpxfilnam << endl;
    
+   if ( options.basins ) {
+      if ( critpttype==DENS ) {
+         findBasins(argv,options,gwf,bnw,cpn,infilnam,outfilnam);
+      } else {
+         displayWarningMessage("The basins are only available for the density (-t d).");
+      }
+   }
+   if ( options.mkias ) {
+      if ( critpttype==DENS ) {
+         findInterAtomicSurfaces(argv,options,gwf,cpn,outfilnam);
+      } else {
+         displayWarningMessage("The interatomic surfaces are only available for the density (-t d).");
+      }
+   }
+   
 #if _HAVE_POVRAY_
    int cameravdir=1;
    if (options.camvdir) {sscanf(argv[options.camvdir],"%d",&cameravdir);}
@@ -266,18 +673,8 @@ int main (int argc, char ** argv)
    
    /* At this point the computation has ended. Usually this means no errors ocurred. */
    
-   setScrGreenBoldFont();
-   printHappyEnding();
-   printScrStarLine();
-   cout << setprecision(3) << "CPU Time: "
-        << solreal( clock () - begin_time ) / CLOCKS_PER_SEC << "s" << endl;
-   solreal end_walltime=time(NULL);
-   cout << "Wall-clock time: " << solreal (end_walltime-begin_walltime) << "s" << endl;
-#if DEBUG
-   cout << "Debuggin mode (under construction...)" << endl;
-#endif
-   printScrStarLine();
-   setScrNormalFont();
+   delete cpnp;
+   printEndOfRun(begin_time,begin_walltime);
    return 0;
 }
 
@@ -93,6 +93,13 @@ optFlags::optFlags()
    camvdir=0;
    mkdatmat=0;
    mkextsearch=0;
+   trustreg=hessupd=0;
+   mkgridsearch=0;
+   trajectory=0;
+   promol=promolseeds=0;
+   batch=batchmem=0;
+   basins=basinsh=basinsfld=0;
+   mkias=iasrays=0;
 }
 
 
@@ -269,6 +276,54 @@ void printHelpMenu(int &argc, char** &argv)
    //-------------------------------------------------------------------------------------
    cout << "  --help    \t\tSame as -h" << endl;
    cout << "  --version \t\tSame as -V" << endl;
+   cout << "  --trust-region \tUse a trust region Newton method for the search of the" << endl
+        << "                  \t  critical points of the density (instead of the" << endl
+        << "                  \t  fixed step size)." << endl;
+   cout << "  --hessian-update \tSame as --trust-region, but the Hessian of the density" << endl
+        << "                  \t  is updated from the gradients between (periodic)" << endl
+        << "                  \t  full evaluations." << endl;
+   cout << "  --grid-search \tComplete the search of critical points of the density" << endl
+        << "                  \t  using the seeds of a grid (the grid is refined until" << endl
+        << "                  \t  nACP-nBCP+nRCP-nCCP=1, or up to three times)." << endl;
+   cout << "  --promol-seeds \tSeek first the critical points of the promolecular" << endl
+        << "                  \t  density (sum of spherical atomic densities), and use" << endl
+        << "                  \t  them as the seeds of the critical points of the wave" << endl
+        << "                  \t  function. A full search is done if they do not lead to" << endl
+        << "                  \t  a complete set of critical points." << endl;
+   cout << "  --promol  \t\tFind the critical points of the promolecular density" << endl
+        << "            \t\t  instead of those of the wave function (only -t d). The" << endl
+        << "            \t\t  fields of the log file that need the orbitals are" << endl
+        << "            \t\t  still evaluated from the wave function." << endl;
+   cout << "  --trajectory \tTreat wf?name as a list of wave function files (one per" << endl
+        << "                  \t  line), which are the frames of a trajectory. The CPs of" << endl
+        << "                  \t  each frame are sought from the CPs of the previous one;" << endl
+        << "                  \t  a full search is done only if the topology changes." << endl
+        << "                  \t  The log and cpx files are written for every frame, and" << endl
+        << "                  \t  the identities of the CPs along the trajectory are" << endl
+        << "                  \t  saved in the file listname-CPTrack.dat." << endl;
+   cout << "  --batch   \t\tTreat wf?name as a list of wave function files (one per" << endl
+        << "            \t\t  line), and process all of them within this run. If the" << endl
+        << "            \t\t  program was built with OpenMP, the files are shared" << endl
+        << "            \t\t  among the threads. The output files of each wave" << endl
+        << "            \t\t  function are named as usual, and a summary is written" << endl
+        << "            \t\t  to the file listname-CPBatch.log." << endl;
+   cout << "  --batch-mem=MB \tSet the memory budget for the concurrent jobs of" << endl
+        << "                 \t  --batch (default: 4096 MB)." << endl;
+   cout << "  --basins  \t\tPartition a grid into the basins of the ACPs of the" << endl
+        << "            \t\t  density, and integrate the number of electrons, the" << endl
+        << "            \t\t  charge and the volume of every basin. The results are" << endl
+        << "            \t\t  saved in the file outname-Basins.log." << endl;
+   cout << "  --basins-h=H \tSet the spacing of the grid used by --basins (in bohr," << endl
+        << "                 \t  default: 0.15)." << endl;
+   cout << "  --basins-fields=fields \tIntegrate also the given fields over the basins" << endl
+        << "                 \t  (implies --basins). fields is a string made of the" << endl
+        << "                 \t  characters of the option -p of dtkcube (e.g. KGl)." << endl;
+   cout << "  --ias     \t\tBuild the interatomic (zero-flux) surface of every BCP," << endl
+        << "            \t\t  made of the gradient paths that end at the BCP. The" << endl
+        << "            \t\t  triangulated surfaces are saved in the (Wavefront)" << endl
+        << "            \t\t  file outname-IAS.obj." << endl;
+   cout << "  --ias-rays=N \tSet the number of gradient paths of every interatomic" << endl
+        << "                 \t  surface (implies --ias; default: 72)." << endl;
    //-------------------------------------------------------------------------------------
 #if _HAVE_POVRAY_
    printScrStarLine();
@@ -323,6 +378,32 @@ void processDoubleDashOptions(int &argc,char** &argv,optFlags &flags,int pos)
    } else if (str==string("help")) {
       printHelpMenu(argc,argv);
       exit(0);
+   } else if (str==string("trust-region")) {
+      flags.trustreg=pos;
+   } else if (str==string("hessian-update")) {
+      flags.trustreg=flags.hessupd=pos;
+   } else if (str==string("grid-search")) {
+      flags.mkgridsearch=pos;
+   } else if (str==string("trajectory")) {
+      flags.trajectory=pos;
+   } else if (str==string("promol-seeds")) {
+      flags.promolseeds=pos;
+   } else if (str==string("promol")) {
+      flags.promol=pos;
+   } else if (str==string("batch")) {
+      flags.batch=pos;
+   } else if (str.substr(0,10)==string("batch-mem=")) {
+      flags.batchmem=pos;
+   } else if (str==string("basins")) {
+      flags.basins=pos;
+   } else if (str.substr(0,9)==string("basins-h=")) {
+      flags.basinsh=pos;
+   } else if (str.substr(0,14)==string("basins-fields=")) {
+      flags.basins=flags.basinsfld=pos;
+   } else if (str==string("ias")) {
+      flags.mkias=pos;
+   } else if (str.substr(0,9)==string("ias-rays=")) {
+      flags.mkias=flags.iasrays=pos;
    } else {
       setScrRedBoldFont();
       cout << "Error: Unrecognized option '" << argv[pos] << "'" << endl;
@@ -86,6 +86,12 @@ public:
    unsigned short int drawnuc;
    unsigned short int calcbgps,calcrgps,drawbgps,bgptubes;
    unsigned short int mkdatmat,mkextsearch;
+   unsigned short int trustreg,hessupd,mkgridsearch;
+   unsigned short int trajectory;
+   unsigned short int batch,batchmem;
+   unsigned short int basins,basinsh,basinsfld;
+   unsigned short int mkias,iasrays;
+   unsigned short int promol,promolseeds;
 };//end class optsFlags
 void printErrorMsg(char** &argv,char lab);
 void printHelpMenu(int &argc, char** &argv);//self-described
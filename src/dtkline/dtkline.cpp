@@ -109,8 +109,8 @@ int main (int argc, char ** argv)
    cout << "Done." << endl;
    
    bondNetWork bnw;
-   bnw.readFromFile(infilnam); //Loading the bond-network (if the wave function
-                               //was read, there souldn't be problems here.
+   bnw.readFromWaveFunction(gwf); //Loading the bond-network from the wave function
+                                  //already in memory (the file is not parsed again).
    bnw.setUpBNW();             //To setup the bond network.
    
    waveFunctionGrid1D grid;    //Defining a grid object
@@ -76,6 +76,7 @@ using std::setprecision;
 #include "../common/gausswavefunction.h"
 //#include "../common/bondnetwork.h"
 #include "../common/solcubetools.h"
+#include "../common/molsymmetry.h"
 #include "optflags.h"
 #include "crtflnms.h"
 
@@ -87,7 +88,9 @@ void makeLineDatFile(optFlags &opts,string &datnam,GaussWaveFunction &wf,int the
 void makePlaneTsvFile(optFlags &opts,string &tsvnan,GaussWaveFunction &wf,int theplane,\
       int npts,char thefield);
 void makeCubeFile(optFlags &opts,string &cubnam,GaussWaveFunction &wf,int npts,\
-      char thefield,string &strfield);
+      char thefield,string &strfield,molSymmetry *sym);
+void makeSymmetricCubeFile(string &cubnam,GaussWaveFunction &wf,int npts,\
+      char thefield,string &comments,molSymmetry &sym);
 
 int main (int argc, char ** argv)
 {
@@ -223,7 +226,28 @@ int main (int argc, char ** argv)
    /* This evaluates the momentum density on a cube */
    
    if (dim==3) {
-      makeCubeFile(options,outfilnam,gwf,npts,field,strfield);
+      molSymmetry sym,*psym=NULL;
+      if ( options.symm ) {
+         string str=argv[options.symm];
+         double tol;
+         if ( str.find_first_of('=')!=string::npos ) {
+            if ( (sscanf(str.substr(str.find_first_of('=')+1).c_str(),"%lf",&tol)!=1)||\
+                  (tol<=0.0e0) ) {
+               displayWarningMessage(string("Wrong tolerance (")+str+string("), using the default."));
+            } else {
+               sym.setTolerance(solreal(tol));
+            }
+         }
+         if ( !sym.setUp(gwf) ) {exit(1);}
+         if ( !sym.checkWaveFunction(gwf) ) {
+            displayWarningMessage("The wave function is less symmetric than the nuclei!");
+         }
+         cout << "Point group: " << sym.getPointGroupName() << " (" << sym.getNOfOperations()
+              << " operations)." << endl;
+         sym.setUpMomentumSpace();
+         psym=&sym;
+      }
+      makeCubeFile(options,outfilnam,gwf,npts,field,strfield,psym);
       if (options.mkplt) {
          displayWarningMessage("Plotting can only be performed with options -1 or -2.");
       }
@@ -693,7 +717,7 @@ void makePlaneTsvFile(optFlags &opts,string &tsvnam,GaussWaveFunction &wf,int th
 }
 /* ************************************************************************************ */
 void makeCubeFile(optFlags &opts,string &cubnam,GaussWaveFunction &wf,int npts,\
-      char thefield,string &strfield)
+      char thefield,string &strfield,molSymmetry *sym)
 {
    string comments="#Property: ";
    switch ( thefield ) {
@@ -706,6 +730,11 @@ void makeCubeFile(optFlags &opts,string &cubnam,GaussWaveFunction &wf,int npts,\
       default :
          break;
    }
+   if ( sym!=NULL ) {
+      cout << "Evaluating and writing " << strfield << " on a cube..." << endl;
+      makeSymmetricCubeFile(cubnam,wf,npts,thefield,comments,*sym);
+      return;
+   }
    solreal px,py,pz;
    px=py=pz=0.0e0;
    int boxnpts[3];
@@ -782,4 +811,89 @@ void makeCubeFile(optFlags &opts,string &cubnam,GaussWaveFunction &wf,int npts,\
    dealloc1DRealArray(prop1d);
 }
 /* ************************************************************************************ */
+void makeSymmetricCubeFile(string &cubnam,GaussWaveFunction &wf,int npts,\
+      char thefield,string &comments,molSymmetry &sym)
+{
+   /* The cube is centered at P=0, and its axes are the axes of the symmetry frame.  */
+   int boxnpts[3]={npts,npts,npts},nused=1,*rep=NULL;
+   solreal xin[3],delta[3][3],ee[3];
+   for (int i=0; i<3; i++) {xin[i]=0.0e0;}
+   for (int i=0; i<3; i++) {
+      sym.getFrameAxis(i,ee);
+      for (int j=0; j<3; j++) {
+         delta[i][j]=ee[j]*2.0e0*DEFAULTMAXVALUEOFP/solreal(boxnpts[i]-1);
+         xin[j]-=ee[j]*DEFAULTMAXVALUEOFP;
+      }
+   }
+   const int ntot=boxnpts[0]*boxnpts[1]*boxnpts[2];
+   int nuni=sym.getGridRepresentatives(xin,delta,boxnpts,rep,nused);
+   cout << "The size of the grid will be " << boxnpts[0] << " x "
+      << boxnpts[1] << " x " << boxnpts[2] << endl;
+   cout << "The total number of points that will be computed is " << nuni
+      << " (symmetry-unique, " << nused << " operations used)" << endl;
+   int *uni;
+   alloc1DIntArray(string("uni"),nuni,uni);
+   nuni=0;
+   for (int p=0; p<ntot; p++) {if ( rep[p]==p ) {uni[nuni++]=p;}}
+   solreal *vals;
+   alloc1DRealArray(string("vals"),ntot,vals);
+#if PARALLELISEDTK
+#pragma omp parallel
+   {
+      GaussWaveFunction twf;
+      GaussWaveFunction *pwf=&wf;
+      if ( omp_get_thread_num()>0 ) {
+         twf.shareDataFrom(wf);
+         pwf=&twf;
+      }
+#pragma omp for schedule(dynamic,64)
+      for (int u=0; u<nuni; u++) {
+         int p=uni[u],idx[3]={p/(npts*npts),(p/npts)%npts,p%npts};
+         solreal pp[3];
+         for (int l=0; l<3; l++) {
+            pp[l]=xin[l]+solreal(idx[0])*delta[0][l]+solreal(idx[1])*delta[1][l]\
+                  +solreal(idx[2])*delta[2][l];
+         }
+         if ( thefield=='K' ) {
+            vals[p]=pwf->evalFTKineticEnergy(pp[0],pp[1],pp[2]);
+         } else {
+            vals[p]=pwf->evalFTDensity(pp[0],pp[1],pp[2]);
+         }
+      }
+   }
+#else
+   int p,idx[3];
+   solreal pp[3];
+   for (int u=0; u<nuni; u++) {
+      p=uni[u];
+      idx[0]=p/(npts*npts);
+      idx[1]=(p/npts)%npts;
+      idx[2]=p%npts;
+      for (int l=0; l<3; l++) {
+         pp[l]=xin[l]+solreal(idx[0])*delta[0][l]+solreal(idx[1])*delta[1][l]\
+               +solreal(idx[2])*delta[2][l];
+      }
+      if ( thefield=='K' ) {
+         vals[p]=wf.evalFTKineticEnergy(pp[0],pp[1],pp[2]);
+      } else {
+         vals[p]=wf.evalFTDensity(pp[0],pp[1],pp[2]);
+      }
+   }
+#endif
+   dealloc1DIntArray(uni);
+   for (int p=0; p<ntot; p++) {vals[p]=vals[rep[p]];}
+   dealloc1DIntArray(rep);
+   ofstream ofile;
+   ofile.open(cubnam.c_str(),ios::out);
+   writeCubeHeader(ofile,wf.title[0],comments,boxnpts,xin,delta,wf.nNuc,wf.atCharge,wf.R);
+   solreal *prop1d;
+   alloc1DRealArray("prop1d",boxnpts[2],prop1d);
+   for (int ij=0; ij<(boxnpts[0]*boxnpts[1]); ij++) {
+      for (int k=0; k<boxnpts[2]; k++) {prop1d[k]=vals[ij*boxnpts[2]+k];}
+      writeCubeProp(ofile,boxnpts[2],prop1d);
+   }
+   ofile.close();
+   dealloc1DRealArray(prop1d);
+   dealloc1DRealArray(vals);
+}
 
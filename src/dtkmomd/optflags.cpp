@@ -64,6 +64,7 @@
 
 #include "optflags.h"
 #include "../common/solscrutils.h"
+#include "../common/molsymmetry.h"
 
 #include <iostream>
 using std::cout;
@@ -90,6 +91,7 @@ optFlags::optFlags()
    kpgnp=0;
    quiet=1;
    setfld=0;
+   symm=0;
 }
 
 
@@ -249,6 +251,12 @@ void printHelpMenu(int &argc, char** &argv)
    //-------------------------------------------------------------------------------------
    cout << "  --help    \t\tSame as -h" << endl;
    cout << "  --version \t\tSame as -V" << endl;
+   cout << "  --symm[=TOL] \t\tWith -3, detect the point group of the molecule, align" << endl
+        << "               \t\t  the cube with its symmetry frame, and evaluate the" << endl
+        << "               \t\t  field only at the symmetry-unique points of the cube" << endl
+        << "               \t\t  (the momentum-space fields are also symmetric under" << endl
+        << "               \t\t  inversion). The atoms may depart from the exact" << endl
+        << "               \t\t  symmetry by TOL bohr (default: " << MOLSYMM_DISTTOL << ")." << endl;
    //-------------------------------------------------------------------------------------
 #if _HAVE_GNUPLOT_
    printScrStarLine();
@@ -311,6 +319,8 @@ void processDoubleDashOptions(int &argc,char** &argv,optFlags &flags,int pos)
    } else if (str==string("help")) {
       printHelpMenu(argc,argv);
       exit(0);
+   } else if ((str==string("symm"))||(str.substr(0,5)==string("symm="))) {
+      flags.symm=pos;
    } else {
       setScrRedBoldFont();
       cout << "Error: Unrecognized option '" << argv[pos] << "'" << endl;
@@ -81,6 +81,7 @@ public:
    optFlags();//default constructor, initialize all the flags to convenient (default) values.
    unsigned short int infname,outfname,setn1,evdim,setfld;
    unsigned short int zipdat,mkplt,kpgnp,quiet;
+   unsigned short int symm;
 };//end class optsFlags
 void printErrorMsg(char** &argv,char lab);
 void printHelpMenu(int &argc, char** &argv);//self-described
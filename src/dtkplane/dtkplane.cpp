@@ -75,6 +75,7 @@ using std::setprecision;
 #include "../common/gausswavefunction.h"
 #include "../common/bondnetwork.h"
 #include "../common/wfgrid2d.h"
+#include "../common/molsymmetry.h"
 #include "optflags.h"
 #include "crtflnms.h"
 
@@ -107,8 +108,8 @@ int main (int argc, char ** argv)
    cout << "Done." << endl;
    
    bondNetWork bnw;
-   bnw.readFromFile(infilnam); //Loading the bond-network (if the wave function
-                               //was read, there souldn't be problems here.
+   bnw.readFromWaveFunction(gwf); //Loading the bond-network from the wave function
+                                  //already in memory (the file is not parsed again).
    bnw.setUpBNW();             //To setup the bond network.
    
    waveFunctionGrid2D grid;    //Defining a grid object
@@ -174,6 +175,46 @@ int main (int argc, char ** argv)
    } else {
       prop='d';
    }
+   if ( options.promol ) {
+      if ( string("dglPsS").find(prop)==string::npos ) {
+         setScrRedBoldFont();
+         cout << "Error: The property \"" << prop << "\" cannot be evaluated from the "
+              << "promolecular density!" << endl;
+         setScrNormalFont();
+         exit(1);
+      }
+      if ( !gwf.useProMolecularDensity(true) ) {exit(1);}
+      cout << "Using the promolecular density instead of the wave function." << endl;
+   }
+   
+   /* Looking for the symmetry operations that map the plane onto itself */
+   
+   if ( options.symm ) {
+      molSymmetry sym;
+      string str=argv[options.symm];
+      double tol;
+      if ( str.find_first_of('=')!=string::npos ) {
+         if ( (sscanf(str.substr(str.find_first_of('=')+1).c_str(),"%lf",&tol)!=1)||\
+               (tol<=0.0e0) ) {
+            displayWarningMessage(string("Wrong tolerance (")+str+string("), using the default."));
+         } else {
+            sym.setTolerance(solreal(tol));
+         }
+      }
+      if ( !sym.setUp(bnw) ) {exit(1);}
+      if ( !sym.checkWaveFunction(gwf) ) {
+         displayWarningMessage("The wave function is less symmetric than the nuclei!");
+      }
+      cout << "Point group: " << sym.getPointGroupName() << " (" << sym.getNOfOperations()
+           << " operations)." << endl;
+      int nops=grid.setUpSymmetry(sym);
+      cout << "Points that will be evaluated (symmetry-unique): "
+           << grid.getNOfSymmetryUniquePoints() << " (" << nops
+           << " operations map the plane onto itself)" << endl;
+      if ( string("NpuU").find(prop)!=string::npos ) {
+         displayWarningMessage("The symmetry is not used for vector or custom fields.");
+      }
+   }
    
    /* Main calculation loop, chooses between different available fields. */
    
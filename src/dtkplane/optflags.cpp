@@ -61,6 +61,7 @@
 
 #include "optflags.h"
 #include "../common/solscrutils.h"
+#include "../common/molsymmetry.h"
 
 #include <iostream>
 using std::cout;
@@ -88,6 +89,8 @@ optFlags::optFlags()
    kpgnp=0;
    quiet=1;
    showcont=showatlbl=showallatlbl=0;
+   promol=0;
+   symm=0;
 }
 
 
@@ -259,6 +262,15 @@ void printHelpMenu(int &argc, char** &argv)
    //-------------------------------------------------------------------------------------
    cout << "  --help    \t\tSame as -h" << endl;
    cout << "  --version \t\tSame as -V" << endl;
+   cout << "  --promol  \t\tUse the promolecular density (sum of spherical atomic" << endl
+        << "            \t\t  densities) instead of the wave function. This is a" << endl
+        << "            \t\t  fast approximation, available for the fields d, g, l," << endl
+        << "            \t\t  P, s and S." << endl;
+   cout << "  --symm[=TOL] \t\tDetect the point group of the molecule, and evaluate" << endl
+        << "               \t\t  the (scalar) field only at the points of the plane" << endl
+        << "               \t\t  that are not related by a symmetry operation that" << endl
+        << "               \t\t  maps the plane onto itself. The atoms may depart" << endl
+        << "               \t\t  from the exact symmetry by TOL bohr (default: " << MOLSYMM_DISTTOL << ")." << endl;
    //-------------------------------------------------------------------------------------
 #if _HAVE_GNUPLOT_
    printScrStarLine();
@@ -315,6 +327,10 @@ void processDoubleDashOptions(int &argc,char** &argv,optFlags &flags,int pos)
    } else if (str==string("help")) {
       printHelpMenu(argc,argv);
       exit(0);
+   } else if (str==string("promol")) {
+      flags.promol=pos;
+   } else if ((str==string("symm"))||(str.substr(0,5)==string("symm="))) {
+      flags.symm=pos;
    } else {
       setScrRedBoldFont();
       cout << "Error: Unrecognized option '" << argv[pos] << "'" << endl;
@@ -81,6 +81,8 @@ public:
    optFlags();//default constructor, initialize all the flags to convenient (default) values.
    unsigned short int infname,outfname,prop2plot,setn1,setats;
    unsigned short int zipdat,mkplt,kpgnp,quiet,showcont,showatlbl,showallatlbl;
+   unsigned short int promol;
+   unsigned short int symm;
 };//end class optsFlags
 void printErrorMsg(char** &argv,char lab);
 void printHelpMenu(int &argc, char** &argv);//self-described
@@ -78,6 +78,16 @@ void mkFileNames(char ** (&argv), optFlags &opts, string &i_fn, string &o_fn)
     */
    //+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
    i_fn=string(argv[1]);
+   mkFileNamesFromWFName(argv,opts,i_fn,o_fn);
+   if (opts.outfname) {
+      o_fn=argv[opts.outfname];
+      o_fn.append(".log");
+   }
+   return;
+}
+
+void mkFileNamesFromWFName(char ** (&argv),optFlags &opts,string &i_fn,string &o_fn)
+{
    size_t pos;
    //string sl="wfn";
    //pos=i_fn.find(sl);
@@ -138,10 +148,6 @@ void mkFileNames(char ** (&argv), optFlags &opts, string &i_fn, string &o_fn)
       }
       o_fn.insert(pos,plbl);
    }
-   if (opts.outfname) {
-      o_fn=argv[opts.outfname];
-      o_fn.append(".log");
-   }
    return;
 }
 
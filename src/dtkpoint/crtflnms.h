@@ -81,6 +81,12 @@
  */
 void mkFileNames(char ** (&argv), optFlags &opts, string &i_fn, string &o_fn);
 
+/** This function makes the name of the log file (o_fn) out of the name of the wave
+   function file i_fn (which is checked to be a wfn/wfx file). It is used by mkFileNames,
+   and for each wave function of the batch mode.
+ */
+void mkFileNamesFromWFName(char ** (&argv),optFlags &opts,string &i_fn,string &o_fn);
+
 #endif //_CRTFLNMS_H
 
 
@@ -86,6 +86,18 @@ using std::setprecision;
 //#include "../common/bondnetwork.h"
 #include "optflags.h"
 #include "crtflnms.h"
+#include "../common/solbatchtools.h"
+#include "../common/solstringtools.h"
+#include "../common/solmemhand.h"
+
+/* Evaluates all the properties of the wave function infilnam at the point(s) requested
+   in the command line, and writes them to outfilnam. info is set to the integrated
+   number of electrons. Returns false if the wave function could not be loaded.  */
+bool evalPropertiesOfWaveFunction(char ** (&argv),optFlags &options,string &infilnam,
+      string &outfilnam,string &info);
+
+/* Evaluates the properties of every wave function listed in argv[1] (batch mode).  */
+void evalPropertiesInBatch(char ** (&argv),optFlags &options);
 
 int main (int argc, char ** argv)
 {
@@ -98,9 +110,39 @@ int main (int argc, char ** argv)
    ofstream ofile;
    
    getOptions(argc,argv,options); //This processes the options from the command line.
-   mkFileNames(argv,options,infilnam,outfilnam); //This creates the names used.
-   printHappyStart(argv,CURRENTVERSION,PROGRAMCONTRIBUTORS);
-   //Just to let the user know that the initial configuration is OK
+   if ( options.batch ) {
+      printHappyStart(argv,CURRENTVERSION,PROGRAMCONTRIBUTORS);
+      evalPropertiesInBatch(argv,options);
+   } else {
+      mkFileNames(argv,options,infilnam,outfilnam); //This creates the names used.
+      printHappyStart(argv,CURRENTVERSION,PROGRAMCONTRIBUTORS);
+      //Just to let the user know that the initial configuration is OK
+      string info;
+      if ( !evalPropertiesOfWaveFunction(argv,options,infilnam,outfilnam,info) ) {exit(1);}
+   }
+   
+   
+   /* At this point the computation has ended. Usually this means no errors ocurred. */
+   
+   setScrGreenBoldFont();
+   printHappyEnding();
+   printScrStarLine();
+   cout << setprecision(3) << "CPU Time: "
+        << solreal( clock () - begin_time ) / CLOCKS_PER_SEC << "s" << endl;
+   solreal end_walltime=time(NULL);
+   cout << "Wall-clock time: " << solreal (end_walltime-begin_walltime) << "s" << endl;
+#if DEBUG
+   cout << "Debuggin mode (under construction...)" << endl;
+#endif
+   printScrStarLine();
+   setScrNormalFont();
+   return 0;
+}
+//**************************************************************************************************
+bool evalPropertiesOfWaveFunction(char ** (&argv),optFlags &options,string &infilnam,\
+      string &outfilnam,string &info)
+{
+   ofstream ofile;
    
    cout << endl << "Loading wave function from file: " << infilnam << "... ";
    
@@ -109,7 +151,7 @@ int main (int argc, char ** argv)
       setScrRedBoldFont();
       cout << "Error: the wave function could not be loaded!\n";
       setScrNormalFont();
-      exit(1);
+      return false;
    }
    cout << "Done." << endl;
    
@@ -121,14 +163,15 @@ int main (int argc, char ** argv)
    cout << "N. Electrons (Integrated): " << Nofelec << endl;
    cout << setprecision(4);
    cout << "    Rel. Err. Integration: " << errinteg << "%" << endl;
+   info=string("N. Electrons (Integrated): ")+getStringFromReal(Nofelec);
    
    /* The following is left for future reference and possible implementation of 
       additional capabilities. 
    */
    
    //bondNetWork bnw;
-   //bnw.readFromFile(infilnam); //Loading the bond-network (if the wave function
-                               //was read, there souldn't be problems here.
+   //bnw.readFromWaveFunction(gwf); //Loading the bond-network from the wave function
+                                  //already in memory (the file is not parsed again).
    //bnw.setUpBNW();             //To setup the bond network.
    
    /* Setting the property to be computed */
@@ -227,22 +270,37 @@ int main (int argc, char ** argv)
    ofile.close();
    
    cout << endl << "Output written in file: " << outfilnam << endl;
-   
-   
-   /* At this point the computation has ended. Usually this means no errors ocurred. */
-   
-   setScrGreenBoldFont();
-   printHappyEnding();
-   printScrStarLine();
-   cout << setprecision(3) << "CPU Time: "
-        << solreal( clock () - begin_time ) / CLOCKS_PER_SEC << "s" << endl;
-   solreal end_walltime=time(NULL);
-   cout << "Wall-clock time: " << solreal (end_walltime-begin_walltime) << "s" << endl;
-#if DEBUG
-   cout << "Debuggin mode (under construction...)" << endl;
-#endif
-   printScrStarLine();
-   setScrNormalFont();
-   return 0;
+   return true;
+}
+//**************************************************************************************************
+/* Data shared by the jobs of the batch mode (see evalPropertiesOfBatchJob).  */
+struct pointBatchData {
+   char **argv;
+   optFlags *options;
+};
+//**************************************************************************************************
+bool evalPropertiesOfBatchJob(string &infilnam,void *ctx,string &info)
+{
+   pointBatchData *dat=static_cast<pointBatchData *>(ctx);
+   string outfilnam;
+   mkFileNamesFromWFName(dat->argv,*(dat->options),infilnam,outfilnam);
+   return evalPropertiesOfWaveFunction(dat->argv,*(dat->options),infilnam,outfilnam,info);
+}
+//**************************************************************************************************
+void evalPropertiesInBatch(char ** (&argv),optFlags &options)
+{
+   string lstfilnam=argv[1],*wfnams=NULL;
+   int nwf=readBatchList(lstfilnam,wfnams);
+   if ( nwf==0 ) {
+      setScrRedBoldFont();
+      cout << "Error: no wave function files could be read from " << lstfilnam << "!\n";
+      setScrNormalFont();
+      exit(1);
+   }
+   pointBatchData dat;
+   dat.argv=argv;
+   dat.options=&options;
+   runBatchJobs(nwf,wfnams,evalPropertiesOfBatchJob,&dat,getBatchMemoryBudget(argv,options.batchmem),\
+         mkBatchSummaryFileName(lstfilnam,string("Point")),false);
+   dealloc1DStringArray(wfnams);
 }
-
@@ -89,6 +89,7 @@ optFlags::optFlags()
    rcrds=0;
    setscustfld=0;
    setvcustfld=0;
+   batch=batchmem=0;
 }
 
 
@@ -233,6 +234,14 @@ void printHelpMenu(int &argc, char** &argv)
    //-------------------------------------------------------------------------------------
    cout << "  --help    \t\tSame as -h" << endl;
    cout << "  --version \t\tSame as -V" << endl;
+   cout << "  --batch   \t\tTreat wf?name as a list of wave function files (one per" << endl
+        << "            \t\t  line), and process all of them within this run. If the" << endl
+        << "            \t\t  program was built with OpenMP, the files are shared" << endl
+        << "            \t\t  among the threads. The output files of each wave" << endl
+        << "            \t\t  function are named as usual, and a summary is written" << endl
+        << "            \t\t  to the file listname-PointBatch.log." << endl;
+   cout << "  --batch-mem=MB \tSet the memory budget for the concurrent jobs of" << endl
+        << "                 \t  --batch (default: 4096 MB)." << endl;
    //-------------------------------------------------------------------------------------
 }//end printHelpMenu
 
@@ -281,6 +290,10 @@ void processDoubleDashOptions(int &argc,char** &argv,optFlags &flags,int pos)
    } else if (str==string("help")) {
       printHelpMenu(argc,argv);
       exit(0);
+   } else if (str==string("batch")) {
+      flags.batch=pos;
+   } else if (str.substr(0,10)==string("batch-mem=")) {
+      flags.batchmem=pos;
    } else {
       setScrRedBoldFont();
       cout << "Error: Unrecognized option '" << argv[pos] << "'" << endl;
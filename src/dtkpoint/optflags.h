@@ -80,6 +80,7 @@ class optFlags
 public: 
    optFlags();//default constructor, initialize all the flags to convenient (default) values.
    unsigned short int infname,outfname,prop2plot,setat,crdfil,rcrds,setscustfld,setvcustfld;
+   unsigned short int batch,batchmem;
 };//end class optsFlags
 void printErrorMsg(char** &argv,char lab);
 void printHelpMenu(int &argc, char** &argv);//self-described
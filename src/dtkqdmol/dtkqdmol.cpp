@@ -231,14 +231,11 @@ void makeMolGnuplotFile(string &gname,bondNetWork &bn,bool putHs,const string te
    int k;
    for (int i=0; i<bn.nNuc; i++) {
       if ( (!putHs)&&(bn.atNum[i]==0) ) { continue; }
-      for (int j=0; j<MAXBONDINGATOMS; j++) {
-         k=bn.bNet[i][j];
+      for (int j=bn.bNetStart[i]; j<bn.bNetStart[i+1]; j++) {
+         k=bn.bNetList[j];
          if ( (!putHs)&&(bn.atNum[k]==0) ) { continue; }
-         if (k>0) {
-            gfil << bn.R[i][0] << " " << bn.R[i][1] << " " << bn.R[i][2] << " ";
-            gfil << bn.R[k][0] << " " << bn.R[k][1] << " " << bn.R[k][2] << endl;
-         }
-         
+         gfil << bn.R[i][0] << " " << bn.R[i][1] << " " << bn.R[i][2] << " ";
+         gfil << bn.R[k][0] << " " << bn.R[k][1] << " " << bn.R[k][2] << endl;
       }
    }
    gfil << "e" << endl;
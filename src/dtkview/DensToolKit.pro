@@ -26,6 +26,8 @@ SOURCES += main.cpp\
     ../common/atomcolschjmol.cpp \
     ../common/solstringtools.cpp \
     ../common/critptnetwork.cpp \
+    ../common/cellgrid3d.cpp \
+    ../common/promoldensity.cpp \
     ../common/gausswavefunction.cpp \
     ../common/eig2-4.cpp \
     ../common/solmath.cpp \
@@ -48,6 +50,8 @@ HEADERS  += dtkmainwindow.h \
     ../common/atomcolschjmol.h \
     ../common/solstringtools.h \
     ../common/critptnetwork.h \
+    ../common/cellgrid3d.h \
+    ../common/promoldensity.h \
     ../common/gausswavefunction.h \
     ../common/eig2-4.h \
     ../common/solmath.h \
@@ -76,6 +76,26 @@ bool DTKGLBondNetWork::readFromFile(QString filename)
       bnw=NULL;
       return false;
    }
+   setUpAtomsAndLinks();
+   return true;
+}
+
+bool DTKGLBondNetWork::readFromWaveFunction(const GaussWaveFunction *wf)
+{
+   bnw=new bondNetWork();
+   if ( (wf==NULL)||(!(bnw->readFromWaveFunction(*wf))) ) {
+      QMessageBox::warning(this, tr("Error"),\
+            tr("The wave function has not been loaded!"));
+      delete bnw;
+      bnw=NULL;
+      return false;
+   }
+   setUpAtomsAndLinks();
+   return true;
+}
+
+void DTKGLBondNetWork::setUpAtomsAndLinks(void)
+{
    bnw->setUpBNW();
    bnw->calcViewRadius();
    atoms.resize((bnw->nNuc));
@@ -90,42 +110,39 @@ bool DTKGLBondNetWork::readFromFile(QString filename)
    int k=0,atni,atnk,currIdx=0;
    QVector3D startpt,va,vb,rot;
    for (int i=0; i<bnw->nNuc; i++) {
-      for (int j=0; j<MAXBONDINGATOMS; j++) {
-         k=bnw->bNet[i][j];
-         if (k>0) {
-            atni=bnw->atNum[i];
-            atnk=bnw->atNum[k];
-            frak1=getAtomicVDWRadius(atni)/(getAtomicVDWRadius(atni)\
-                                            +getAtomicVDWRadius(atnk));
-            for (int l=0; l<3; l++) {
-               va[l]=bnw->R[i][l];
-               vb[l]=bnw->R[k][l];
-               startpt[l]=va[l]*(1.0e0-frak1)+vb[l]*frak1;
-            }
-            dist=startpt.distanceToPoint(va);
-            dtkglutils::getRotationVectorAndAngle(startpt,va,rot,alpha);
-            links[currIdx].start=startpt;
-            links[currIdx].end=va;
-            links[currIdx].rotVec=rot;
-            links[currIdx].angle=alpha;
-            links[currIdx].height=dist;
-            links[currIdx].color[0]=float(getAtomicRColorReal(atni));
-            links[currIdx].color[1]=float(getAtomicGColorReal(atni));
-            links[currIdx].color[2]=float(getAtomicBColorReal(atni));
-            ++currIdx;
-            dist=startpt.distanceToPoint(vb);
-            dtkglutils::getRotationVectorAndAngle(startpt,vb,rot,alpha);
-            links[currIdx].start=startpt;
-            links[currIdx].end=vb;
-            links[currIdx].rotVec=rot;
-            links[currIdx].angle=alpha;
-            links[currIdx].height=dist;
-            links[currIdx].color[0]=float(getAtomicRColorReal(atnk));
-            links[currIdx].color[1]=float(getAtomicGColorReal(atnk));
-            links[currIdx].color[2]=float(getAtomicBColorReal(atnk));
-            ++currIdx;
+      for (int j=bnw->bNetStart[i]; j<bnw->bNetStart[i+1]; j++) {
+         k=bnw->bNetList[j];
+         atni=bnw->atNum[i];
+         atnk=bnw->atNum[k];
+         frak1=getAtomicVDWRadius(atni)/(getAtomicVDWRadius(atni)\
+                                         +getAtomicVDWRadius(atnk));
+         for (int l=0; l<3; l++) {
+            va[l]=bnw->R[i][l];
+            vb[l]=bnw->R[k][l];
+            startpt[l]=va[l]*(1.0e0-frak1)+vb[l]*frak1;
          }
+         dist=startpt.distanceToPoint(va);
+         dtkglutils::getRotationVectorAndAngle(startpt,va,rot,alpha);
+         links[currIdx].start=startpt;
+         links[currIdx].end=va;
+         links[currIdx].rotVec=rot;
+         links[currIdx].angle=alpha;
+         links[currIdx].height=dist;
+         links[currIdx].color[0]=float(getAtomicRColorReal(atni));
+         links[currIdx].color[1]=float(getAtomicGColorReal(atni));
+         links[currIdx].color[2]=float(getAtomicBColorReal(atni));
+         ++currIdx;
+         dist=startpt.distanceToPoint(vb);
+         dtkglutils::getRotationVectorAndAngle(startpt,vb,rot,alpha);
+         links[currIdx].start=startpt;
+         links[currIdx].end=vb;
+         links[currIdx].rotVec=rot;
+         links[currIdx].angle=alpha;
+         links[currIdx].height=dist;
+         links[currIdx].color[0]=float(getAtomicRColorReal(atnk));
+         links[currIdx].color[1]=float(getAtomicGColorReal(atnk));
+         links[currIdx].color[2]=float(getAtomicBColorReal(atnk));
+         ++currIdx;
       }
    }
-   return true;
 }
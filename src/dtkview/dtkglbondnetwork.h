@@ -62,6 +62,7 @@ public:
    DTKGLBondNetWork(QWidget *parent = 0);
    ~DTKGLBondNetWork();
    bool readFromFile(QString filename);
+   bool readFromWaveFunction(const GaussWaveFunction *wf);
    int numAtoms() {return atoms.size();}
    int numLinks() {return links.size();}
    QVector3D getAtomCoordinates(int idx) {return atoms[idx].r;}
@@ -90,6 +91,7 @@ public:
 protected:
    bondNetWork *bnw;
 private:
+   void setUpAtomsAndLinks(void);
    QVector<Link>   links;
    QVector<Atom>   atoms;
 };
@@ -65,22 +65,22 @@ public:
     int getNumCCPs(void) {return cpn->nCCP;}
     int getNumPtsOfBGP(int bcpIdx) {return cpn->conBCP[bcpIdx][2];}
     int getBCPIdxInConnRCP(int rcpIdx,int bcpBox) {
-       if (bcpBox<CPNW_MAXBCPSCONNECTEDTORCP) {
+       if (bcpBox<cpn->getMaxBCPsPerRCP()) {
          return cpn->conRCP[rcpIdx][0][bcpBox];
        } else { return -1; }
     }
     int getNumPtsOfRGP(int rcpIdx,int bcpBox) {
-       if (bcpBox<CPNW_MAXBCPSCONNECTEDTORCP) {
+       if (bcpBox<cpn->getMaxBCPsPerRCP()) {
           return cpn->conRCP[rcpIdx][1][bcpBox];
        } else { return -1; }
     }
     int getRCPIdxInConnCCP(int ccpIdx,int rcpBox) {
-       if (rcpBox<CPNW_MAXRCPSCONNECTEDTOCCP) {
+       if (rcpBox<cpn->getMaxRCPsPerCCP()) {
          return cpn->conCCP[ccpIdx][0][rcpBox];
        } else { return -1; }
     }
     int getNumPtsOfCGP(int ccpIdx,int rcpBox) {
-       if (rcpBox<CPNW_MAXRCPSCONNECTEDTOCCP) {
+       if (rcpBox<cpn->getMaxRCPsPerCCP()) {
           return cpn->conCCP[ccpIdx][1][rcpBox];
        } else { return -1; }
     }
@@ -464,7 +464,7 @@ void DTKGLWidget::addMolecule(QString fnam)
    waveFunction.push_back(wf_lcl);
 
    DTKGLBondNetWork *bn_lcl=new DTKGLBondNetWork(this);
-   if ( !(bn_lcl->readFromFile(wfnname)) ) {
+   if ( !(bn_lcl->readFromWaveFunction(wf_lcl)) ) {
       QMessageBox::warning(this, tr("Error"),\
             (tr("Could not open the file ")+wfnname+tr("!")));
       delete bn_lcl;